@@ -31,7 +31,7 @@
 #include "ns3/socket.h"
 
 #include <algorithm>
-#include <functional>
+#include <vector>
 
 namespace ns3
 {
@@ -51,21 +51,28 @@ bool
 RequestQueue::Enqueue(QueueEntry& entry)
 {
     Purge();
-    for (auto i = m_queue.begin(); i != m_queue.end(); ++i)
+    Ipv4Address dst = entry.GetIpv4Header().GetDestination();
+    auto destination = m_destinations.find(dst);
+    if (destination != m_destinations.end())
     {
-        if ((i->GetPacket()->GetUid() == entry.GetPacket()->GetUid()) &&
-            (i->GetIpv4Header().GetDestination() == entry.GetIpv4Header().GetDestination()))
+        for (uint64_t arrival : destination->second)
         {
-            return false;
+            if (m_queue.at(arrival).GetPacket()->GetUid() == entry.GetPacket()->GetUid())
+            {
+                return false;
+            }
         }
     }
     entry.SetExpireTime(m_queueTimeout);
     if (m_queue.size() == m_maxLen)
     {
-        Drop(m_queue.front(), "Drop the most aged packet"); // Drop the most aged packet
-        m_queue.erase(m_queue.begin());
+        Drop(m_queue.begin()->second, "Drop the most aged packet"); // Drop the most aged packet
+        Erase(m_queue.begin());
     }
-    m_queue.push_back(entry);
+    uint64_t arrival = m_nextArrival++;
+    m_queue.emplace_hint(m_queue.end(), arrival, entry);
+    m_destinations[dst].insert(arrival);
+    m_expirations.emplace(entry.GetExpireTime() + Simulator::Now(), arrival);
     return true;
 }
 
@@ -74,77 +81,76 @@ RequestQueue::DropPacketWithDst(Ipv4Address dst)
 {
     NS_LOG_FUNCTION(this << dst);
     Purge();
-    for (auto i = m_queue.begin(); i != m_queue.end(); ++i)
+    auto destination = m_destinations.find(dst);
+    if (destination == m_destinations.end())
     {
-        if (i->GetIpv4Header().GetDestination() == dst)
-        {
-            Drop(*i, "DropPacketWithDst ");
-        }
+        return;
+    }
+    std::set<uint64_t> arrivals = destination->second;
+    for (uint64_t arrival : arrivals)
+    {
+        Drop(m_queue.at(arrival), "DropPacketWithDst ");
+    }
+    for (uint64_t arrival : arrivals)
+    {
+        Erase(m_queue.find(arrival));
     }
-    auto new_end = std::remove_if(m_queue.begin(), m_queue.end(), [&](const QueueEntry& en) {
-        return en.GetIpv4Header().GetDestination() == dst;
-    });
-    m_queue.erase(new_end, m_queue.end());
 }
 
 bool
 RequestQueue::Dequeue(Ipv4Address dst, QueueEntry& entry)
 {
     Purge();
-    for (auto i = m_queue.begin(); i != m_queue.end(); ++i)
+    auto destination = m_destinations.find(dst);
+    if (destination == m_destinations.end())
     {
-        if (i->GetIpv4Header().GetDestination() == dst)
-        {
-            entry = *i;
-            m_queue.erase(i);
-            return true;
-        }
+        return false;
     }
-    return false;
+    auto it = m_queue.find(*destination->second.begin());
+    entry = it->second;
+    Erase(it);
+    return true;
 }
 
 bool
 RequestQueue::Find(Ipv4Address dst)
 {
-    for (auto i = m_queue.begin(); i != m_queue.end(); ++i)
-    {
-        if (i->GetIpv4Header().GetDestination() == dst)
-        {
-            return true;
-        }
-    }
-    return false;
+    return m_destinations.find(dst) != m_destinations.end();
 }
 
-/**
- * \brief IsExpired structure
- */
-struct IsExpired
+void
+RequestQueue::Erase(std::map<uint64_t, QueueEntry>::iterator it)
 {
-    /**
-     * Check if the entry is expired
-     *
-     * \param e QueueEntry entry
-     * \return true if expired, false otherwise
-     */
-    bool operator()(const QueueEntry& e) const
+    const QueueEntry& entry = it->second;
+    auto destination = m_destinations.find(entry.GetIpv4Header().GetDestination());
+    destination->second.erase(it->first);
+    if (destination->second.empty())
     {
-        return (e.GetExpireTime() < Seconds(0));
+        m_destinations.erase(destination);
     }
-};
+    m_expirations.erase(std::make_pair(entry.GetExpireTime() + Simulator::Now(), it->first));
+    m_queue.erase(it);
+}
 
 void
 RequestQueue::Purge()
 {
-    IsExpired pred;
-    for (auto i = m_queue.begin(); i != m_queue.end(); ++i)
+    // The expired entries are dropped in arrival order
+    Time now = Simulator::Now();
+    std::vector<uint64_t> expired;
+    for (auto it = m_expirations.begin(); it != m_expirations.end() && it->first < now; ++it)
     {
-        if (pred(*i))
-        {
-            Drop(*i, "Drop outdated packet ");
-        }
+        expired.push_back(it->second);
+    }
+    std::sort(expired.begin(), expired.end());
+    for (uint64_t arrival : expired)
+    {
+        Drop(m_queue.at(arrival), "Drop outdated packet ");
+    }
+    for (uint64_t arrival : expired)
+    {
+        Erase(m_queue.find(arrival));
     }
-    m_queue.erase(std::remove_if(m_queue.begin(), m_queue.end(), pred), m_queue.end());
 }
 
 void
@@ -30,7 +30,9 @@
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/simulator.h"
 
-#include <vector>
+#include <map>
+#include <set>
+#include <unordered_map>
 
 namespace ns3
 {
@@ -192,6 +194,9 @@ class QueueEntry
  * \brief AODV route request queue
  *
  * Since AODV is an on demand routing we queue requests while looking for route.
+ * The entries are kept in arrival order and indexed by destination and by
+ * expiration time, so that neither the lookups nor the purge of the expired
+ * entries walk the whole queue.
  */
 class RequestQueue
 {
@@ -203,7 +208,8 @@ class RequestQueue
      * \param routeToQueueTimeout the route to queue timeout
      */
     RequestQueue(uint32_t maxLen, Time routeToQueueTimeout)
-        : m_maxLen(maxLen),
+        : m_nextArrival(0),
+          m_maxLen(maxLen),
           m_queueTimeout(routeToQueueTimeout)
     {
     }
@@ -278,10 +284,21 @@ class RequestQueue
     }
 
   private:
-    /// The queue
-    std::vector<QueueEntry> m_queue;
+    /// The queue, by arrival number
+    std::map<uint64_t, QueueEntry> m_queue;
+    /// The arrival numbers of the entries, by destination
+    std::unordered_map<Ipv4Address, std::set<uint64_t>, Ipv4AddressHash> m_destinations;
+    /// The expiration times and arrival numbers of the entries, earliest first
+    std::set<std::pair<Time, uint64_t>> m_expirations;
+    /// The arrival number of the next entry
+    uint64_t m_nextArrival;
     /// Remove all expired entries
     void Purge();
+    /**
+     * Remove an entry from the queue and its indexes
+     * \param it the entry
+     */
+    void Erase(std::map<uint64_t, QueueEntry>::iterator it);
     /**
      * Notify that packet is dropped from queue by timeout
      * \param en the queue entry to drop
@@ -224,11 +224,106 @@ RoutingTableEntry::Print(Ptr<OutputStreamWrapper> stream, Time::Unit unit /* = T
  The Routing Table
  */
 
+ExpiryWheel::ExpiryWheel(Time granularity, uint32_t nSlots)
+    : m_slots(nSlots),
+      m_granularity(granularity.GetTimeStep()),
+      m_tick(0),
+      m_size(0)
+{
+    NS_ASSERT_MSG(m_granularity > 0 && nSlots > 0, "The wheel needs slots of positive length");
+}
+
+int64_t
+ExpiryWheel::GetTick(Time t) const
+{
+    int64_t step = t.GetTimeStep();
+    // Round down the negative times too
+    return step >= 0 ? step / m_granularity : -((-step - 1) / m_granularity) - 1;
+}
+
+void
+ExpiryWheel::Schedule(Ipv4Address dst, Time expiration)
+{
+    // The elapsed periods are not visited again, their times go in the current one
+    int64_t tick = GetTick(expiration);
+    if (tick <= m_tick)
+    {
+        m_current.emplace(expiration, dst);
+    }
+    else
+    {
+        m_slots[tick % m_slots.size()].emplace_back(expiration, dst);
+    }
+    m_size++;
+}
+
+void
+ExpiryWheel::Expire(Time now, std::vector<Expiration>& expired)
+{
+    std::size_t nCollected = expired.size();
+    int64_t nowTick = GetTick(now);
+    if (nowTick > m_tick)
+    {
+        // The current period elapsed
+        for (; !m_current.empty(); m_current.pop())
+        {
+            expired.push_back(m_current.top());
+        }
+        // The other elapsed periods, each slot once at most, and the new current one
+        int64_t nSlots = std::min<int64_t>(nowTick - m_tick, m_slots.size());
+        for (int64_t tick = nowTick - nSlots + 1; tick <= nowTick; tick++)
+        {
+            auto& slot = m_slots[tick % m_slots.size()];
+            auto kept = slot.begin();
+            for (auto& expiration : slot)
+            {
+                int64_t expirationTick = GetTick(expiration.first);
+                if (expirationTick < nowTick)
+                {
+                    expired.push_back(expiration);
+                }
+                else if (expirationTick == nowTick)
+                {
+                    m_current.push(expiration);
+                }
+                else
+                {
+                    *kept++ = expiration;
+                }
+            }
+            slot.erase(kept, slot.end());
+        }
+        m_tick = nowTick;
+    }
+    for (; !m_current.empty() && m_current.top().first < now; m_current.pop())
+    {
+        expired.push_back(m_current.top());
+    }
+    m_size -= expired.size() - nCollected;
+}
+
+void
+ExpiryWheel::Clear()
+{
+    for (auto& slot : m_slots)
+    {
+        slot.clear();
+    }
+    m_current = {};
+    m_size = 0;
+}
+
 RoutingTable::RoutingTable(Time t)
     : m_badLinkLifetime(t)
 {
 }
 
+void
+RoutingTable::ScheduleExpiry(const RoutingTableEntry& rt)
+{
+    m_expiries.Schedule(rt.GetDestination(), rt.GetLifeTime() + Simulator::Now());
+}
+
 bool
 RoutingTable::LookupRoute(Ipv4Address id, RoutingTableEntry& rt)
 {
@@ -288,6 +383,10 @@ RoutingTable::AddRoute(RoutingTableEntry& rt)
         rt.SetRreqCnt(0);
     }
     auto result = m_ipv4AddressEntry.insert(std::make_pair(rt.GetDestination(), rt));
+    if (result.second)
+    {
+        ScheduleExpiry(rt);
+    }
     return result.second;
 }
 
@@ -301,12 +400,18 @@ RoutingTable::Update(RoutingTableEntry& rt)
         NS_LOG_LOGIC("Route update to " << rt.GetDestination() << " fails; not found");
         return false;
     }
+    bool reschedule =
+        i->second.GetLifeTime() != rt.GetLifeTime() || i->second.GetFlag() != rt.GetFlag();
     i->second = rt;
     if (i->second.GetFlag() != IN_SEARCH)
     {
         NS_LOG_LOGIC("Route update to " << rt.GetDestination() << " set RreqCnt to 0");
         i->second.SetRreqCnt(0);
     }
+    if (reschedule)
+    {
+        ScheduleExpiry(i->second);
+    }
     return true;
 }
 
@@ -320,7 +425,12 @@ RoutingTable::SetEntryState(Ipv4Address id, RouteFlags state)
         NS_LOG_LOGIC("Route set entry state to " << id << " fails; not found");
         return false;
     }
-    i->second.SetFlag(state);
+    if (i->second.GetFlag() != state)
+    {
+        // An expired entry in search expires again with its new state
+        i->second.SetFlag(state);
+        ScheduleExpiry(i->second);
+    }
     i->second.SetRreqCnt(0);
     NS_LOG_LOGIC("Route set entry state to " << id << ": new state is " << state);
     return true;
@@ -348,15 +458,14 @@ RoutingTable::InvalidateRoutesWithDst(const std::map<Ipv4Address, uint32_t>& unr
 {
     NS_LOG_FUNCTION(this);
     Purge();
-    for (auto i = m_ipv4AddressEntry.begin(); i != m_ipv4AddressEntry.end(); ++i)
+    for (auto j = unreachable.begin(); j != unreachable.end(); ++j)
     {
-        for (auto j = unreachable.begin(); j != unreachable.end(); ++j)
+        auto i = m_ipv4AddressEntry.find(j->first);
+        if (i != m_ipv4AddressEntry.end() && i->second.GetFlag() == VALID)
         {
-            if ((i->first == j->first) && (i->second.GetFlag() == VALID))
-            {
-                NS_LOG_LOGIC("Invalidate route with destination address " << i->first);
-                i->second.Invalidate(m_badLinkLifetime);
-            }
+            NS_LOG_LOGIC("Invalidate route with destination address " << i->first);
+            i->second.Invalidate(m_badLinkLifetime);
+            ScheduleExpiry(i->second);
         }
     }
 }
@@ -392,30 +501,26 @@ RoutingTable::Purge()
     {
         return;
     }
-    for (auto i = m_ipv4AddressEntry.begin(); i != m_ipv4AddressEntry.end();)
+    Time now = Simulator::Now();
+    std::vector<ExpiryWheel::Expiration> expired;
+    m_expiries.Expire(now, expired);
+    for (const auto& [expiration, dst] : expired)
     {
-        if (i->second.GetLifeTime() < Seconds(0))
+        auto i = m_ipv4AddressEntry.find(dst);
+        // Skip the entries deleted or updated since
+        if (i == m_ipv4AddressEntry.end() || i->second.GetLifeTime() + now != expiration)
         {
-            if (i->second.GetFlag() == INVALID)
-            {
-                auto tmp = i;
-                ++i;
-                m_ipv4AddressEntry.erase(tmp);
-            }
-            else if (i->second.GetFlag() == VALID)
-            {
-                NS_LOG_LOGIC("Invalidate route with destination address " << i->first);
-                i->second.Invalidate(m_badLinkLifetime);
-                ++i;
-            }
-            else
-            {
-                ++i;
-            }
+            continue;
         }
-        else
+        if (i->second.GetFlag() == INVALID)
         {
-            ++i;
+            m_ipv4AddressEntry.erase(i);
+        }
+        else if (i->second.GetFlag() == VALID)
+        {
+            NS_LOG_LOGIC("Invalidate route with destination address " << i->first);
+            i->second.Invalidate(m_badLinkLifetime);
+            ScheduleExpiry(i->second);
         }
     }
 }
@@ -476,7 +581,8 @@ RoutingTable::MarkLinkAsUnidirectional(Ipv4Address neighbor, Time blacklistTimeo
 void
 RoutingTable::Print(Ptr<OutputStreamWrapper> stream, Time::Unit unit /* = Time::S */) const
 {
-    std::map<Ipv4Address, RoutingTableEntry> table = m_ipv4AddressEntry;
+    std::map<Ipv4Address, RoutingTableEntry> table(m_ipv4AddressEntry.begin(),
+                                                   m_ipv4AddressEntry.end());
     Purge(table);
     std::ostream* os = stream->GetStream();
     // Copy the current ostream state
@@ -34,9 +34,13 @@
 #include "ns3/timer.h"
 
 #include <cassert>
+#include <functional>
 #include <map>
+#include <queue>
 #include <stdint.h>
 #include <sys/types.h>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
@@ -416,6 +420,74 @@ class RoutingTableEntry
     Time m_blackListTimeout;
 };
 
+/**
+ * \ingroup aodv
+ * \brief Timer wheel of the expiration times of the routes
+ *
+ * The expiration times are hashed into slots covering a fixed period each,
+ * so that collecting the expired routes only visits the slots elapsed since
+ * the previous collection.  The times of the current period are kept in a
+ * heap, so that the collections within a period do not scan its slot.  A
+ * route scheduled again keeps its former expiration time in the wheel, the
+ * caller discards it when collected.  The simulation time must not go
+ * backwards.
+ */
+class ExpiryWheel
+{
+  public:
+    /// An expiration time and the destination of its route
+    typedef std::pair<Time, Ipv4Address> Expiration;
+
+    /**
+     * constructor
+     * \param granularity the period covered by a slot
+     * \param nSlots the number of slots
+     */
+    ExpiryWheel(Time granularity = MilliSeconds(100), uint32_t nSlots = 1024);
+
+    /**
+     * Schedule the expiration of a route
+     * \param dst the destination of the route
+     * \param expiration the expiration time
+     */
+    void Schedule(Ipv4Address dst, Time expiration);
+    /**
+     * Collect the expiration times before a given time
+     * \param now the time
+     * \param expired the expiration times before now, removed from the wheel
+     */
+    void Expire(Time now, std::vector<Expiration>& expired);
+
+    /**
+     * \returns the number of expiration times in the wheel
+     */
+    std::size_t GetSize() const
+    {
+        return m_size;
+    }
+
+    /// Remove all the expiration times
+    void Clear();
+
+  private:
+    /**
+     * \param t a time
+     * \returns the period of the time, in slot granularity
+     */
+    int64_t GetTick(Time t) const;
+
+    /// The slots, each with the expiration times of its periods
+    std::vector<std::vector<Expiration>> m_slots;
+    /// The expiration times of the current period, earliest first
+    std::priority_queue<Expiration, std::vector<Expiration>, std::greater<>> m_current;
+    /// The period covered by a slot, in time steps
+    int64_t m_granularity;
+    /// The current period, not entirely elapsed at the last collection
+    int64_t m_tick;
+    /// The number of expiration times in the wheel
+    std::size_t m_size;
+};
+
 /**
  * \ingroup aodv
  * \brief The Routing table used by AODV protocol
@@ -518,6 +590,7 @@ class RoutingTable
     void Clear()
     {
         m_ipv4AddressEntry.clear();
+        m_expiries.Clear();
     }
 
     /// Delete all outdated entries and invalidate valid entry if Lifetime is expired
@@ -538,9 +611,16 @@ class RoutingTable
 
   private:
     /// The routing table
-    std::map<Ipv4Address, RoutingTableEntry> m_ipv4AddressEntry;
+    std::unordered_map<Ipv4Address, RoutingTableEntry, Ipv4AddressHash> m_ipv4AddressEntry;
+    /// Expiration times of the entries
+    ExpiryWheel m_expiries;
     /// Deletion time for invalid routes
     Time m_badLinkLifetime;
+    /**
+     * Schedule the expiration of an entry
+     * \param rt the routing table entry
+     */
+    void ScheduleExpiry(const RoutingTableEntry& rt);
     /**
      * const version of Purge, for use by Print() method
      * \param table the routing table entry to purge
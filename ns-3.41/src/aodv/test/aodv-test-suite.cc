@@ -730,6 +730,191 @@ struct AodvRtableTest : public TestCase
     }
 };
 
+/**
+ * \ingroup aodv-test
+ *
+ * \brief Unit test for the expiration of the AODV routes
+ */
+struct AodvRtableExpiryTest : public TestCase
+{
+    AodvRtableExpiryTest()
+        : TestCase("RtableExpiry"),
+          rtable(Seconds(2))
+    {
+    }
+
+    /**
+     * Add a route
+     * \param dst the destination
+     * \param lifetime the lifetime of the route
+     */
+    void AddRoute(Ipv4Address dst, Time lifetime)
+    {
+        RoutingTableEntry rt(/*output device*/ nullptr,
+                             /*dst*/ dst,
+                             /*validSeqNo*/ true,
+                             /*seqNo*/ 1,
+                             /*interface*/ Ipv4InterfaceAddress(),
+                             /*hop*/ 1,
+                             /*next hop*/ dst,
+                             /*lifetime*/ lifetime);
+        rtable.AddRoute(rt);
+    }
+
+    /**
+     * Check the state of a route
+     * \param dst the destination
+     * \param exists whether the route must exist
+     * \param flag the expected flag of the route
+     */
+    void CheckRoute(Ipv4Address dst, bool exists, RouteFlags flag)
+    {
+        RoutingTableEntry rt;
+        NS_TEST_EXPECT_MSG_EQ(rtable.LookupRoute(dst, rt),
+                              exists,
+                              "Wrong route existence for " << dst << " at "
+                                                           << Simulator::Now().As(Time::S));
+        if (exists)
+        {
+            NS_TEST_EXPECT_MSG_EQ(rt.GetFlag(),
+                                  flag,
+                                  "Wrong flag for " << dst << " at "
+                                                    << Simulator::Now().As(Time::S));
+        }
+    }
+
+    /**
+     * Extend the lifetime of a route
+     * \param dst the destination
+     * \param lifetime the new lifetime
+     */
+    void ExtendRoute(Ipv4Address dst, Time lifetime)
+    {
+        RoutingTableEntry rt;
+        rtable.LookupRoute(dst, rt);
+        rt.SetLifeTime(lifetime);
+        rtable.Update(rt);
+    }
+
+    void DoRun() override
+    {
+        Ipv4Address a("10.0.0.1");
+        Ipv4Address b("10.0.0.2");
+        Ipv4Address c("10.0.0.3");
+        Ipv4Address d("10.0.0.4");
+        AddRoute(a, Seconds(1));
+        // Beyond a turn of the timer wheel
+        AddRoute(b, Seconds(150));
+        AddRoute(c, Seconds(5));
+        AddRoute(d, Seconds(1));
+        rtable.SetEntryState(d, IN_SEARCH);
+
+        auto check = [this](Time t, Ipv4Address dst, bool exists, RouteFlags flag) {
+            Simulator::Schedule(t, &AodvRtableExpiryTest::CheckRoute, this, dst, exists, flag);
+        };
+        check(Seconds(0.5), a, true, VALID);
+        // Invalidated when expired, deleted after the bad link lifetime
+        check(Seconds(1.05), a, true, INVALID);
+        check(Seconds(3), a, true, INVALID);
+        check(Seconds(3.1), a, false, VALID);
+        // An updated route expires at its new time
+        Simulator::Schedule(Seconds(3.1), &AodvRtableExpiryTest::ExtendRoute, this, c, Seconds(10));
+        check(Seconds(6), c, true, VALID);
+        check(Seconds(13.2), c, true, INVALID);
+        // A route in search is kept, and expires when it leaves the search
+        check(Seconds(2), d, true, IN_SEARCH);
+        Simulator::Schedule(Seconds(2.5), &RoutingTable::SetEntryState, &rtable, d, VALID);
+        check(Seconds(2.5), d, true, INVALID);
+        check(Seconds(140), b, true, VALID);
+        check(Seconds(140), c, false, VALID);
+        check(Seconds(151), b, true, INVALID);
+        check(Seconds(200), b, false, VALID);
+
+        Simulator::Run();
+        Simulator::Destroy();
+    }
+
+    /// Routing table
+    RoutingTable rtable;
+};
+
+/**
+ * \ingroup aodv-test
+ *
+ * \brief Unit test for the expiration of the queued AODV requests
+ */
+struct AodvRqueueExpiryTest : public TestCase
+{
+    AodvRqueueExpiryTest()
+        : TestCase("RqueueExpiry"),
+          q(64, Seconds(10))
+    {
+    }
+
+    /**
+     * Record a dropped packet
+     * \param p The packet
+     * \param h The header
+     * \param e the socket error
+     */
+    void Error(Ptr<const Packet> p, const Ipv4Header& h, Socket::SocketErrno e)
+    {
+        dropped.push_back(p->GetUid());
+    }
+
+    /**
+     * Enqueue a new packet
+     * \param dst the destination
+     * \return the packet uid
+     */
+    uint64_t Enqueue(Ipv4Address dst)
+    {
+        Ptr<Packet> packet = Create<Packet>();
+        Ipv4Header h;
+        h.SetDestination(dst);
+        QueueEntry e(packet,
+                     h,
+                     Ipv4RoutingProtocol::UnicastForwardCallback(),
+                     MakeCallback(&AodvRqueueExpiryTest::Error, this));
+        q.Enqueue(e);
+        return packet->GetUid();
+    }
+
+    /// Check the packets dropped by timeout
+    void CheckTimeout()
+    {
+        NS_TEST_EXPECT_MSG_EQ(q.GetSize(), 1, "The oldest packet must be kept");
+        NS_TEST_EXPECT_MSG_EQ(dropped.size(), 2, "Two packets must be dropped");
+        NS_TEST_EXPECT_MSG_EQ(dropped[0], second, "Packets must be dropped in arrival order");
+        NS_TEST_EXPECT_MSG_EQ(dropped[1], third, "Packets must be dropped in arrival order");
+        QueueEntry e;
+        NS_TEST_EXPECT_MSG_EQ(q.Dequeue(Ipv4Address("10.0.0.1"), e), true, "trivial");
+        NS_TEST_EXPECT_MSG_EQ(e.GetPacket()->GetUid(), first, "The oldest packet must be kept");
+        NS_TEST_EXPECT_MSG_EQ(q.Find(Ipv4Address("10.0.0.1")), false, "trivial");
+    }
+
+    void DoRun() override
+    {
+        first = Enqueue(Ipv4Address("10.0.0.1"));
+        // The later packets expire first
+        q.SetQueueTimeout(Seconds(2));
+        second = Enqueue(Ipv4Address("10.0.0.2"));
+        third = Enqueue(Ipv4Address("10.0.0.1"));
+        NS_TEST_EXPECT_MSG_EQ(q.GetSize(), 3, "trivial");
+        Simulator::Schedule(Seconds(3), &AodvRqueueExpiryTest::CheckTimeout, this);
+        Simulator::Run();
+        Simulator::Destroy();
+    }
+
+    /// Request queue
+    RequestQueue q;
+    /// Uids of the dropped packets
+    std::vector<uint64_t> dropped;
+    uint64_t first;  //!< Uid of the first packet
+    uint64_t second; //!< Uid of the second packet
+    uint64_t third;  //!< Uid of the third packet
+};
+
 /**
  * \ingroup aodv-test
  *
@@ -751,6 +936,8 @@ class AodvTestSuite : public TestSuite
         AddTestCase(new AodvRqueueTest, TestCase::QUICK);
         AddTestCase(new AodvRtableEntryTest, TestCase::QUICK);
         AddTestCase(new AodvRtableTest, TestCase::QUICK);
+        AddTestCase(new AodvRtableExpiryTest, TestCase::QUICK);
+        AddTestCase(new AodvRqueueExpiryTest, TestCase::QUICK);
     }
 } g_aodvTestSuite; ///< the test suite
 
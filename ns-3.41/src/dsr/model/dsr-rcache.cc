@@ -34,6 +34,7 @@
 
 #include "ns3/address-utils.h"
 #include "ns3/ipv4-route.h"
+#include "ns3/abort.h"
 #include "ns3/log.h"
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
@@ -47,6 +48,8 @@
 #include <iostream>
 #include <list>
 #include <map>
+#include <queue>
+#include <unordered_set>
 #include <vector>
 
 namespace ns3
@@ -156,6 +159,7 @@ DsrRouteCache::DsrRouteCache()
     : m_vector(0),
       m_maxEntriesEachDst(3),
       m_isLinkCache(false),
+      m_bestRoutesStale(false),
       m_ntimer(Timer::CANCEL_ON_DESTROY),
       m_delay(MilliSeconds(100))
 {
@@ -199,12 +203,11 @@ DsrRouteCache::UpdateRouteEntry(Ipv4Address dst)
         rtVector.pop_front();
         rtVector.push_back(successEntry);
         rtVector.sort(CompareRoutesExpire); // sort the route vector first
-        m_sortedRoutes.erase(dst);          // erase the entry first
         /*
          * Save the new route cache along with the destination address in map
          */
-        auto result = m_sortedRoutes.insert(std::make_pair(dst, rtVector));
-        return result.second;
+        SetRoutes(dst, rtVector);
+        return true;
     }
     return false;
 }
@@ -228,49 +231,44 @@ DsrRouteCache::LookupRoute(Ipv4Address id, DsrRouteCacheEntry& rt)
     if (i == m_sortedRoutes.end())
     {
         NS_LOG_LOGIC("No Direct Route to " << id << " found");
-        for (auto j = m_sortedRoutes.begin(); j != m_sortedRoutes.end(); ++j)
+        /*
+         * Only the routes going through the destination address hold a sub route to it, the
+         * last sub route found is kept
+         */
+        std::list<DsrRouteCacheEntry> newVector;
+        auto nodeRoutes = m_pathNodes.find(id);
+        if (nodeRoutes != m_pathNodes.end())
         {
-            std::list<DsrRouteCacheEntry> rtVector =
-                j->second; // The route cache vector linked with destination address
-            /*
-             * Loop through the possibly multiple routes within the route vector
-             */
-            for (auto k = rtVector.begin(); k != rtVector.end(); ++k)
+            for (const auto& [dst, count] : nodeRoutes->second)
             {
-                // return the first route in the route vector
-                DsrRouteCacheEntry::IP_VECTOR routeVector = k->GetVector();
-                DsrRouteCacheEntry::IP_VECTOR changeVector;
-
-                for (auto l = routeVector.begin(); l != routeVector.end(); ++l)
+                for (const auto& route : m_sortedRoutes[dst])
                 {
-                    changeVector.push_back(*l);
-
-                    if (*l == id)
+                    DsrRouteCacheEntry::IP_VECTOR routeVector = route.GetVector();
+                    auto l = std::find(routeVector.begin(), routeVector.end(), id);
+                    /*
+                     * The sub route ends at the destination address we are looking for, before
+                     * the end of the route, and has at least two nodes
+                     */
+                    if (l == routeVector.begin() || l == routeVector.end() ||
+                        l + 1 == routeVector.end())
                     {
-                        break;
+                        continue;
                     }
-                }
-                /*
-                 * When the changed vector is smaller in size and larger than 1, which means we
-                 * have found a route with the destination address we are looking for
-                 */
-                if ((changeVector.size() < routeVector.size()) && (changeVector.size() > 1))
-                {
                     DsrRouteCacheEntry changeEntry; // Create the route entry
-                    changeEntry.SetVector(changeVector);
+                    changeEntry.SetVector(DsrRouteCacheEntry::IP_VECTOR(routeVector.begin(), l + 1));
                     changeEntry.SetDestination(id);
                     // Use the expire time from original route entry
-                    changeEntry.SetExpireTime(k->GetExpireTime());
-                    // We need to add new route entry here
-                    std::list<DsrRouteCacheEntry> newVector;
-                    newVector.push_back(changeEntry);
-                    newVector.sort(CompareRoutesExpire); // sort the route vector first
-                    m_sortedRoutes[id] =
-                        newVector; // Only get the first sub route and add it in route cache
+                    changeEntry.SetExpireTime(route.GetExpireTime());
+                    newVector = {changeEntry};
                     NS_LOG_INFO("We have a sub-route to " << id << " add it in route cache");
                 }
             }
         }
+        if (!newVector.empty())
+        {
+            // Only get the first sub route and add it in route cache
+            SetRoutes(id, newVector);
+        }
     }
     NS_LOG_INFO("Here we check the route cache again after updated the sub routes");
     auto m = m_sortedRoutes.find(id);
@@ -282,9 +280,8 @@ DsrRouteCache::LookupRoute(Ipv4Address id, DsrRouteCacheEntry& rt)
     /*
      * We have a direct route to the destination address
      */
-    std::list<DsrRouteCacheEntry> rtVector = m->second;
-    rt = rtVector.front(); // use the first entry in the route vector
-    NS_LOG_LOGIC("Route to " << id << " with route size " << rtVector.size());
+    rt = m->second.front(); // use the first entry in the route vector
+    NS_LOG_LOGIC("Route to " << id << " with route size " << m->second.size());
     return true;
 }
 
@@ -318,113 +315,172 @@ void
 DsrRouteCache::RebuildBestRouteTable(Ipv4Address source)
 {
     NS_LOG_FUNCTION(this << source);
-    /**
-     * \brief The following are initialize-single-source
+    m_bestRoutesSource = source;
+    m_bestRoutesStale = false;
+    m_bestRoutesTree.clear();
+    /*
+     * Dijkstra algorithm with a heap: the nodes are settled by increasing distance, the highest
+     * address first among the nodes at the same distance
      */
-    // @d shortest-path estimate
-    std::map<Ipv4Address, uint32_t> d;
-    // @pre preceding node
-    std::map<Ipv4Address, Ipv4Address> pre;
-    for (auto i = m_netGraph.begin(); i != m_netGraph.end(); ++i)
+    typedef std::pair<uint32_t, uint32_t> QueueItem; // distance and complemented address
+    std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<>> queue;
+    std::unordered_set<Ipv4Address, Ipv4AddressHash> settled;
+    m_bestRoutesTree[source] = std::make_pair(0, source);
+    queue.emplace(0, ~source.Get());
+    while (!queue.empty())
     {
-        if (i->second.find(source) != i->second.end())
-        {
-            d[i->first] = i->second[source];
-            pre[i->first] = source;
-        }
-        else
+        uint32_t distance = queue.top().first;
+        Ipv4Address tempip(~queue.top().second);
+        queue.pop();
+        auto adjacent = m_netGraph.find(tempip);
+        if (!settled.insert(tempip).second || adjacent == m_netGraph.end())
         {
-            d[i->first] = MAXWEIGHT;
-            pre[i->first] = Ipv4Address("255.255.255.255");
+            continue;
         }
-    }
-    d[source] = 0;
-    /**
-     * \brief The following is the core of Dijkstra algorithm
-     */
-    // the node set which shortest distance has been calculated, if true calculated
-    std::map<Ipv4Address, bool> s;
-    double temp = MAXWEIGHT;
-    Ipv4Address tempip("255.255.255.255");
-    for (uint32_t i = 0; i < m_netGraph.size(); i++)
-    {
-        temp = MAXWEIGHT;
-        for (auto j = d.begin(); j != d.end(); ++j)
+        for (const auto& [next, weight] : adjacent->second)
         {
-            Ipv4Address ip = j->first;
-            if (s.find(ip) == s.end())
+            if (settled.find(next) != settled.end())
             {
-                /*
-                 * \brief The following are for comparison
-                 */
-                if (j->second <= temp)
-                {
-                    temp = j->second;
-                    tempip = ip;
-                }
+                continue;
             }
-        }
-        if (!tempip.IsBroadcast())
-        {
-            s[tempip] = true;
-            for (auto k = m_netGraph[tempip].begin(); k != m_netGraph[tempip].end(); ++k)
+            auto reached = m_bestRoutesTree.find(next);
+            if (reached == m_bestRoutesTree.end() || reached->second.first > distance + weight)
             {
-                if (s.find(k->first) == s.end() && d[k->first] > d[tempip] + k->second)
-                {
-                    d[k->first] = d[tempip] + k->second;
-                    pre[k->first] = tempip;
-                }
-                /*
-                 *  Selects the shortest-length route that has the longest expected lifetime
-                 *  (highest minimum timeout of any link in the route)
-                 *  For the computation overhead and complexity
-                 *  Here I just implement kind of greedy strategy to select link with the longest
-                 * expected lifetime when there is two options
-                 */
-                else if (d[k->first] == d[tempip] + k->second)
+                m_bestRoutesTree[next] = std::make_pair(distance + weight, tempip);
+                queue.emplace(distance + weight, ~next.Get());
+            }
+            /*
+             *  Selects the shortest-length route that has the longest expected lifetime
+             *  (highest minimum timeout of any link in the route)
+             *  For the computation overhead and complexity
+             *  Here I just implement kind of greedy strategy to select link with the longest
+             * expected lifetime when there is two options
+             */
+            else if (reached->second.first == distance + weight)
+            {
+                auto oldlink = m_linkCache.find(Link(next, reached->second.second));
+                auto newlink = m_linkCache.find(Link(next, tempip));
+                if (oldlink != m_linkCache.end() && newlink != m_linkCache.end())
                 {
-                    auto oldlink = m_linkCache.find(Link(k->first, pre[k->first]));
-                    auto newlink = m_linkCache.find(Link(k->first, tempip));
-                    if (oldlink != m_linkCache.end() && newlink != m_linkCache.end())
-                    {
-                        if (oldlink->second.GetLinkStability() < newlink->second.GetLinkStability())
-                        {
-                            NS_LOG_INFO("Select the link with longest expected lifetime");
-                            d[k->first] = d[tempip] + k->second;
-                            pre[k->first] = tempip;
-                        }
-                    }
-                    else
+                    if (oldlink->second.GetLinkStability() < newlink->second.GetLinkStability())
                     {
-                        NS_LOG_INFO("Link Stability Info Corrupt");
+                        NS_LOG_INFO("Select the link with longest expected lifetime");
+                        reached->second.second = tempip;
                     }
                 }
+                else
+                {
+                    NS_LOG_INFO("Link Stability Info Corrupt");
+                }
             }
         }
     }
-    // clean the best route table
-    m_bestRoutesTable_link.clear();
-    for (auto i = pre.begin(); i != pre.end(); ++i)
+}
+
+void
+DsrRouteCache::ShortenRoutes(const std::vector<Ipv4Address>& nodes)
+{
+    NS_LOG_FUNCTION(this << nodes.size());
+    // The distances only decrease, from the nodes on
+    typedef std::pair<uint32_t, uint32_t> QueueItem; // distance and complemented address
+    std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<>> queue;
+    for (const auto& node : nodes)
+    {
+        queue.emplace(m_bestRoutesTree[node].first, ~node.Get());
+    }
+    while (!queue.empty())
     {
-        // loop for all vertices
-        DsrRouteCacheEntry::IP_VECTOR route;
-        Ipv4Address iptemp = i->first;
+        uint32_t distance = queue.top().first;
+        Ipv4Address tempip(~queue.top().second);
+        queue.pop();
+        auto adjacent = m_netGraph.find(tempip);
+        if (m_bestRoutesTree[tempip].first != distance || adjacent == m_netGraph.end())
+        {
+            continue;
+        }
+        for (const auto& [next, weight] : adjacent->second)
+        {
+            auto reached = m_bestRoutesTree.find(next);
+            if (reached == m_bestRoutesTree.end() || reached->second.first > distance + weight)
+            {
+                NS_LOG_LOGIC("Shorter route to " << next << " through " << tempip);
+                m_bestRoutesTree[next] = std::make_pair(distance + weight, tempip);
+                queue.emplace(distance + weight, ~next.Get());
+            }
+        }
+    }
+}
 
-        if (!i->second.IsBroadcast() && iptemp != source)
+void
+DsrRouteCache::RepairRoutes(Ipv4Address node)
+{
+    NS_LOG_FUNCTION(this << node);
+    // The subtree of the node loses its routes
+    std::vector<Ipv4Address> subtree{node};
+    std::unordered_set<Ipv4Address, Ipv4AddressHash> lost{node};
+    for (std::size_t i = 0; i < subtree.size(); i++)
+    {
+        auto adjacent = m_netGraph.find(subtree[i]);
+        if (adjacent == m_netGraph.end())
         {
-            while (iptemp != source)
+            continue;
+        }
+        for (const auto& [next, weight] : adjacent->second)
+        {
+            auto reached = m_bestRoutesTree.find(next);
+            if (reached != m_bestRoutesTree.end() && reached->second.second == subtree[i] &&
+                lost.insert(next).second)
             {
-                route.push_back(iptemp);
-                iptemp = pre[iptemp];
+                subtree.push_back(next);
             }
-            route.push_back(source);
-            // Reverse the route
-            DsrRouteCacheEntry::IP_VECTOR reverseroute(route.rbegin(), route.rend());
-            NS_LOG_LOGIC("Add newly calculated best routes");
-            PrintVector(reverseroute);
-            m_bestRoutesTable_link[i->first] = reverseroute;
         }
     }
+    for (const auto& lostNode : subtree)
+    {
+        m_bestRoutesTree.erase(lostNode);
+    }
+    // The subtree is reached again from the nodes that kept their routes
+    std::vector<Ipv4Address> seeds;
+    for (const auto& lostNode : subtree)
+    {
+        auto adjacent = m_netGraph.find(lostNode);
+        if (adjacent == m_netGraph.end())
+        {
+            continue;
+        }
+        for (const auto& [next, weight] : adjacent->second)
+        {
+            auto reached = m_bestRoutesTree.find(next);
+            if (lost.find(next) != lost.end() || reached == m_bestRoutesTree.end())
+            {
+                continue;
+            }
+            uint32_t distance = reached->second.first + weight;
+            auto seed = m_bestRoutesTree.find(lostNode);
+            if (seed == m_bestRoutesTree.end())
+            {
+                m_bestRoutesTree[lostNode] = std::make_pair(distance, next);
+                seeds.push_back(lostNode);
+            }
+            else if (seed->second.first > distance)
+            {
+                seed->second = std::make_pair(distance, next);
+            }
+        }
+    }
+    NS_LOG_LOGIC(subtree.size() << " routes lost, " << seeds.size() << " repaired");
+    ShortenRoutes(seeds);
+}
+
+void
+DsrRouteCache::SetBestRoutesSource(Ipv4Address source)
+{
+    NS_LOG_FUNCTION(this << source);
+    if (source != m_bestRoutesSource)
+    {
+        m_bestRoutesSource = source;
+        m_bestRoutesStale = true;
+    }
 }
 
 bool
@@ -433,27 +489,41 @@ DsrRouteCache::LookupRoute_Link(Ipv4Address id, DsrRouteCacheEntry& rt)
     NS_LOG_FUNCTION(this << id);
     /// We need to purge the link node cache
     PurgeLinkNode();
-    auto i = m_bestRoutesTable_link.find(id);
-    if (i == m_bestRoutesTable_link.end())
+    if (m_bestRoutesStale)
+    {
+        RebuildBestRouteTable(m_bestRoutesSource);
+    }
+    {
+        auto copy = m_bestRoutesTree; if (copy.empty()) copy[m_bestRoutesSource] = {0, m_bestRoutesSource};
+        RebuildBestRouteTable(m_bestRoutesSource);
+        NS_ABORT_MSG_IF(copy.size() != m_bestRoutesTree.size(), "size " << copy.size() << " " << m_bestRoutesTree.size());
+        for (auto& [n, d] : copy) NS_ABORT_MSG_IF(m_bestRoutesTree.at(n).first != d.first, "dist");
+        for (auto& [n, d] : copy) { NS_ABORT_MSG_IF(n != m_bestRoutesSource && m_netGraph.at(d.second).count(n) == 0, "edge"); }
+        m_bestRoutesTree = copy;
+    }
+    auto i = m_bestRoutesTree.find(id);
+    if (i == m_bestRoutesTree.end() || id == m_bestRoutesSource)
     {
         NS_LOG_INFO("No route find to " << id);
         return false;
     }
 
-    if (i->second.size() < 2)
+    // Walk the shortest path tree back to the source
+    DsrRouteCacheEntry::IP_VECTOR route{id};
+    for (Ipv4Address node = id; node != m_bestRoutesSource;)
     {
-        NS_LOG_LOGIC("Route to " << id << " error");
-        return false;
+        node = m_bestRoutesTree.find(node)->second.second;
+        route.push_back(node);
     }
+    std::reverse(route.begin(), route.end());
 
     DsrRouteCacheEntry newEntry; // Create the route entry
-    newEntry.SetVector(i->second);
+    newEntry.SetVector(route);
     newEntry.SetDestination(id);
     newEntry.SetExpireTime(RouteCacheTimeout);
-    NS_LOG_INFO("Route to " << id << " found with the length " << i->second.size());
+    NS_LOG_INFO("Route to " << id << " found with the length " << route.size());
     rt = newEntry;
-    std::vector<Ipv4Address> path = rt.GetVector();
-    PrintVector(path);
+    PrintVector(route);
     return true;
 }
 
@@ -461,37 +531,112 @@ void
 DsrRouteCache::PurgeLinkNode()
 {
     NS_LOG_FUNCTION(this);
-    for (auto i = m_linkCache.begin(); i != m_linkCache.end();)
+    while (!m_linkExpirations.empty() && m_linkExpirations.begin()->first <= Simulator::Now())
     {
-        NS_LOG_DEBUG("The link stability " << i->second.GetLinkStability().As(Time::S));
-        auto itmp = i;
-        if (i->second.GetLinkStability() <= Seconds(0))
-        {
-            ++i;
-            m_linkCache.erase(itmp);
-        }
-        else
+        Link link = m_linkExpirations.begin()->second;
+        NS_LOG_DEBUG("The link stability " << m_linkCache[link].GetLinkStability().As(Time::S));
+        EraseLink(link);
+    }
+    /// may need to remove them after verify
+    while (!m_nodeExpirations.empty() && m_nodeExpirations.begin()->first <= Simulator::Now())
+    {
+        Ipv4Address node = m_nodeExpirations.begin()->second;
+        NS_LOG_DEBUG("The node stability " << m_nodeCache[node].GetNodeStability().As(Time::S));
+        m_nodeCache.erase(node);
+        m_nodeExpirations.erase(m_nodeExpirations.begin());
+    }
+}
+
+void
+DsrRouteCache::UpdateLink(const Link& link, const DsrLinkStab& stab)
+{
+    NS_LOG_FUNCTION(this);
+    auto i = m_linkCache.find(link);
+    if (i != m_linkCache.end())
+    {
+        m_linkExpirations.erase(
+            std::make_pair(i->second.GetLinkStability() + Simulator::Now(), link));
+        i->second = stab;
+    }
+    else
+    {
+        m_linkCache.emplace(link, stab);
+        // Here the weight is set as 1
+        m_netGraph[link.m_low][link.m_high] = 1;
+        m_netGraph[link.m_high][link.m_low] = 1;
+        // A new link only shortens the routes going through it
+        for (const auto& [from, to] : {std::make_pair(link.m_low, link.m_high),
+                                       std::make_pair(link.m_high, link.m_low)})
         {
-            ++i;
+            auto reached = m_bestRoutesTree.find(from);
+            if (m_bestRoutesStale || reached == m_bestRoutesTree.end())
+            {
+                continue;
+            }
+            uint32_t distance = reached->second.first + 1;
+            auto other = m_bestRoutesTree.find(to);
+            if (other == m_bestRoutesTree.end() || other->second.first > distance)
+            {
+                m_bestRoutesTree[to] = std::make_pair(distance, from);
+                ShortenRoutes({to});
+            }
         }
     }
-    /// may need to remove them after verify
-    for (auto i = m_nodeCache.begin(); i != m_nodeCache.end();)
+    m_linkExpirations.emplace(stab.GetLinkStability() + Simulator::Now(), link);
+}
+
+void
+DsrRouteCache::EraseLink(const Link& link)
+{
+    NS_LOG_FUNCTION(this);
+    auto i = m_linkCache.find(link);
+    if (i == m_linkCache.end())
+    {
+        return;
+    }
+    m_linkExpirations.erase(std::make_pair(i->second.GetLinkStability() + Simulator::Now(), link));
+    m_linkCache.erase(i);
+    const auto directions = {std::make_pair(link.m_low, link.m_high),
+                             std::make_pair(link.m_high, link.m_low)};
+    for (const auto& [from, to] : directions)
     {
-        NS_LOG_DEBUG("The node stability " << i->second.GetNodeStability().As(Time::S));
-        auto itmp = i;
-        if (i->second.GetNodeStability() <= Seconds(0))
+        auto adjacent = m_netGraph.find(from);
+        adjacent->second.erase(to);
+        if (adjacent->second.empty())
         {
-            ++i;
-            m_nodeCache.erase(itmp);
+            m_netGraph.erase(adjacent);
         }
-        else
+    }
+    for (const auto& [from, to] : directions)
+    {
+        // Only the loss of a link of the shortest path tree changes the routes
+        auto reached = m_bestRoutesTree.find(to);
+        if (!m_bestRoutesStale && reached != m_bestRoutesTree.end() &&
+            reached->second.second == from)
         {
-            ++i;
+            RepairRoutes(to);
         }
     }
 }
 
+void
+DsrRouteCache::UpdateNode(Ipv4Address node, const DsrNodeStab& stab)
+{
+    NS_LOG_FUNCTION(this << node);
+    auto i = m_nodeCache.find(node);
+    if (i != m_nodeCache.end())
+    {
+        m_nodeExpirations.erase(
+            std::make_pair(i->second.GetNodeStability() + Simulator::Now(), node));
+        i->second = stab;
+    }
+    else
+    {
+        m_nodeCache.emplace(node, stab);
+    }
+    m_nodeExpirations.emplace(stab.GetNodeStability() + Simulator::Now(), node);
+}
+
 void
 DsrRouteCache::UpdateNetGraph()
 {
@@ -505,6 +650,7 @@ DsrRouteCache::UpdateNetGraph()
         m_netGraph[i->first.m_low][i->first.m_high] = weight;
         m_netGraph[i->first.m_high][i->first.m_low] = weight;
     }
+    m_bestRoutesStale = true;
 }
 
 bool
@@ -516,7 +662,7 @@ DsrRouteCache::IncStability(Ipv4Address node)
     {
         NS_LOG_INFO("The initial stability " << m_initStability.As(Time::S));
         DsrNodeStab ns(m_initStability);
-        m_nodeCache[node] = ns;
+        UpdateNode(node, ns);
         return false;
     }
     else
@@ -526,7 +672,7 @@ DsrRouteCache::IncStability(Ipv4Address node)
         NS_LOG_INFO("The stability here "
                     << Time(i->second.GetNodeStability() * m_stabilityIncrFactor).As(Time::S));
         DsrNodeStab ns(Time(i->second.GetNodeStability() * m_stabilityIncrFactor));
-        m_nodeCache[node] = ns;
+        UpdateNode(node, ns);
         return true;
     }
     return false;
@@ -540,7 +686,7 @@ DsrRouteCache::DecStability(Ipv4Address node)
     if (i == m_nodeCache.end())
     {
         DsrNodeStab ns(m_initStability);
-        m_nodeCache[node] = ns;
+        UpdateNode(node, ns);
         return false;
     }
     else
@@ -550,7 +696,7 @@ DsrRouteCache::DecStability(Ipv4Address node)
         NS_LOG_INFO("The stability here "
                     << Time(i->second.GetNodeStability() / m_stabilityDecrFactor).As(Time::S));
         DsrNodeStab ns(Time(i->second.GetNodeStability() / m_stabilityDecrFactor));
-        m_nodeCache[node] = ns;
+        UpdateNode(node, ns);
         return true;
     }
     return false;
@@ -563,6 +709,7 @@ DsrRouteCache::AddRoute_Link(DsrRouteCacheEntry::IP_VECTOR nodelist, Ipv4Address
     NS_LOG_LOGIC("Use Link Cache");
     /// Purge the link node cache first
     PurgeLinkNode();
+    SetBestRoutesSource(source);
     for (uint32_t i = 0; i < nodelist.size() - 1; i++)
     {
         DsrNodeStab ns; /// This is the node stability
@@ -570,11 +717,11 @@ DsrRouteCache::AddRoute_Link(DsrRouteCacheEntry::IP_VECTOR nodelist, Ipv4Address
 
         if (m_nodeCache.find(nodelist[i]) == m_nodeCache.end())
         {
-            m_nodeCache[nodelist[i]] = ns;
+            UpdateNode(nodelist[i], ns);
         }
         if (m_nodeCache.find(nodelist[i + 1]) == m_nodeCache.end())
         {
-            m_nodeCache[nodelist[i + 1]] = ns;
+            UpdateNode(nodelist[i + 1], ns);
         }
         Link link(nodelist[i], nodelist[i + 1]); /// Link represent the one link for the route
         DsrLinkStab stab;                        /// Link stability
@@ -595,14 +742,12 @@ DsrRouteCache::AddRoute_Link(DsrRouteCacheEntry::IP_VECTOR nodelist, Ipv4Address
             /// Set the link stability as the m)minLifeTime, default is 1 second
             stab.SetLinkStability(m_minLifeTime);
         }
-        m_linkCache[link] = stab;
+        UpdateLink(link, stab);
         NS_LOG_DEBUG("Add a new link");
         link.Print();
         NS_LOG_DEBUG("Link Info");
         stab.Print();
     }
-    UpdateNetGraph();
-    RebuildBestRouteTable(source);
     return true;
 }
 
@@ -620,14 +765,16 @@ DsrRouteCache::UseExtends(DsrRouteCacheEntry::IP_VECTOR rt)
     for (auto i = rt.begin(); i != rt.end() - 1; ++i)
     {
         Link link(*i, *(i + 1));
-        if (m_linkCache.find(link) != m_linkCache.end())
+        auto j = m_linkCache.find(link);
+        if (j != m_linkCache.end())
         {
-            if (m_linkCache[link].GetLinkStability() < m_useExtends)
+            if (j->second.GetLinkStability() < m_useExtends)
             {
-                m_linkCache[link].SetLinkStability(m_useExtends);
+                DsrLinkStab stab = j->second;
+                stab.SetLinkStability(m_useExtends);
+                UpdateLink(link, stab);
                 /// \todo remove after debug
-                NS_LOG_INFO("The time of the link "
-                            << m_linkCache[link].GetLinkStability().As(Time::S));
+                NS_LOG_INFO("The time of the link " << stab.GetLinkStability().As(Time::S));
             }
         }
         else
@@ -668,12 +815,11 @@ DsrRouteCache::AddRoute(DsrRouteCacheEntry& rt)
     if (i == m_sortedRoutes.end())
     {
         rtVector.push_back(rt);
-        m_sortedRoutes.erase(dst); // Erase the route entries for dst first
         /**
          * Save the new route cache along with the destination address in map
          */
-        auto result = m_sortedRoutes.insert(std::make_pair(dst, rtVector));
-        return result.second;
+        SetRoutes(dst, rtVector);
+        return true;
     }
 
     rtVector = i->second;
@@ -709,12 +855,11 @@ DsrRouteCache::AddRoute(DsrRouteCacheEntry& rt)
             NS_LOG_DEBUG("The first hop" << rtVector.front().GetVector().size()
                                          << " The second hop "
                                          << rtVector.back().GetVector().size());
-            m_sortedRoutes.erase(dst); // erase the route entries for dst first
             /**
              * Save the new route cache along with the destination address in map
              */
-            auto result = m_sortedRoutes.insert(std::make_pair(dst, rtVector));
-            return result.second;
+            SetRoutes(dst, rtVector);
+            return true;
         }
         else
         {
@@ -746,13 +891,12 @@ DsrRouteCache::FindSameRoute(DsrRouteCacheEntry& rt, std::list<DsrRouteCacheEntr
             {
                 i->SetExpireTime(rt.GetExpireTime());
             }
-            m_sortedRoutes.erase(rt.GetDestination()); // erase the entry first
-            rtVector.sort(CompareRoutesExpire);        // sort the route vector first
+            rtVector.sort(CompareRoutesExpire); // sort the route vector first
             /*
              * Save the new route cache along with the destination address in map
              */
-            auto result = m_sortedRoutes.insert(std::make_pair(rt.GetDestination(), rtVector));
-            return result.second;
+            SetRoutes(rt.GetDestination(), rtVector);
+            return true;
         }
     }
     return false;
@@ -763,8 +907,9 @@ DsrRouteCache::DeleteRoute(Ipv4Address dst)
 {
     NS_LOG_FUNCTION(this << dst);
     Purge(); // purge the route cache first to remove timeout entries
-    if (m_sortedRoutes.erase(dst) != 0)
+    if (m_sortedRoutes.find(dst) != m_sortedRoutes.end())
     {
+        SetRoutes(dst, routeEntryVector());
         NS_LOG_LOGIC("Route deletion to " << dst << " successful");
         return true;
     }
@@ -790,10 +935,10 @@ DsrRouteCache::DeleteAllRoutesIncludeLink(Ipv4Address errorSrc,
         Link link2(unreachNode, errorSrc);
         // erase the two kind of links to make sure the link is removed from the link cache
         NS_LOG_DEBUG("Erase the route");
-        m_linkCache.erase(link1);
+        EraseLink(link1);
         /// \todo get rid of this one
         NS_LOG_DEBUG("The link cache size " << m_linkCache.size());
-        m_linkCache.erase(link2);
+        EraseLink(link2);
         NS_LOG_DEBUG("The link cache size " << m_linkCache.size());
 
         auto i = m_nodeCache.find(errorSrc);
@@ -814,8 +959,7 @@ DsrRouteCache::DeleteAllRoutesIncludeLink(Ipv4Address errorSrc,
         {
             DecStability(i->first);
         }
-        UpdateNetGraph();
-        RebuildBestRouteTable(node);
+        SetBestRoutesSource(node);
     }
     else
     {
@@ -829,13 +973,21 @@ DsrRouteCache::DeleteAllRoutesIncludeLink(Ipv4Address errorSrc,
             return;
         }
         /*
-         * Loop all the routes saved in the route cache
+         * Loop the routes going through the broken link
          */
-        for (auto j = m_sortedRoutes.begin(); j != m_sortedRoutes.end();)
+        auto linkRoutes = m_pathLinks.find(std::make_pair(errorSrc, unreachNode));
+        if (linkRoutes == m_pathLinks.end())
+        {
+            return;
+        }
+        std::vector<Ipv4Address> destinations;
+        for (const auto& [dst, count] : linkRoutes->second)
+        {
+            destinations.push_back(dst);
+        }
+        for (const auto& address : destinations)
         {
-            auto jtmp = j;
-            Ipv4Address address = j->first;
-            std::list<DsrRouteCacheEntry> rtVector = j->second;
+            std::list<DsrRouteCacheEntry> rtVector = m_sortedRoutes[address];
             /*
              * Loop all the routes for a single destination
              */
@@ -857,7 +1009,7 @@ DsrRouteCache::DeleteAllRoutesIncludeLink(Ipv4Address errorSrc,
                     {
                         changeVector.push_back(*i);
 
-                        if (*(i + 1) == unreachNode)
+                        if (i + 1 != routeVector.end() && *(i + 1) == unreachNode)
                         {
                             break;
                         }
@@ -910,23 +1062,15 @@ DsrRouteCache::DeleteAllRoutesIncludeLink(Ipv4Address errorSrc,
                     k = rtVector.erase(k);
                 }
             }
-            ++j;
-            if (!IsLinkCache())
-            {
-                m_sortedRoutes.erase(jtmp);
-            }
-            if (!rtVector.empty())
-            {
-                /*
-                 * Save the new route cache along with the destination address in map
-                 */
-                rtVector.sort(CompareRoutesExpire);
-                m_sortedRoutes[address] = rtVector;
-            }
-            else
+            if (rtVector.empty())
             {
                 NS_LOG_DEBUG("There is no route left for that destination " << address);
             }
+            /*
+             * Save the new route cache along with the destination address in map
+             */
+            rtVector.sort(CompareRoutesExpire);
+            SetRoutes(address, rtVector);
         }
     }
 }
@@ -974,61 +1118,92 @@ DsrRouteCache::Purge()
         NS_LOG_DEBUG("The route cache is empty");
         return;
     }
-    for (auto i = m_sortedRoutes.begin(); i != m_sortedRoutes.end();)
+    /*
+     * Only the destinations whose earliest route expired are visited
+     */
+    while (!m_pathExpirations.empty() && m_pathExpirations.begin()->first <= Simulator::Now())
     {
-        // Loop of route cache entry with the route size
-        auto itmp = i;
-        /*
-         * The route cache entry vector
-         */
-        Ipv4Address dst = i->first;
-        std::list<DsrRouteCacheEntry> rtVector = i->second;
+        Ipv4Address dst = m_pathExpirations.begin()->second;
+        std::list<DsrRouteCacheEntry> rtVector = m_sortedRoutes[dst];
         NS_LOG_DEBUG("The route vector size of 1 " << dst << " " << rtVector.size());
-        if (!rtVector.empty())
+        for (auto j = rtVector.begin(); j != rtVector.end();)
         {
-            for (auto j = rtVector.begin(); j != rtVector.end();)
+            if (j->GetExpireTime() <= Seconds(0))
             {
-                NS_LOG_DEBUG("The expire time of every entry with expire time "
-                             << j->GetExpireTime());
                 /*
-                 * First verify if the route has expired or not
+                 * When the expire time has passed, erase the certain route
                  */
-                if (j->GetExpireTime() <= Seconds(0))
-                {
-                    /*
-                     * When the expire time has passed, erase the certain route
-                     */
-                    NS_LOG_DEBUG("Erase the expired route for " << dst << " with expire time "
-                                                                << j->GetExpireTime());
-                    j = rtVector.erase(j);
-                }
-                else
-                {
-                    ++j;
-                }
+                NS_LOG_DEBUG("Erase the expired route for " << dst << " with expire time "
+                                                            << j->GetExpireTime());
+                j = rtVector.erase(j);
             }
-            NS_LOG_DEBUG("The route vector size of 2 " << dst << " " << rtVector.size());
-            if (!rtVector.empty())
+            else
             {
-                ++i;
-                m_sortedRoutes.erase(itmp); // erase the entry first
-                /*
-                 * Save the new route cache along with the destination address in map
-                 */
-                m_sortedRoutes.insert(std::make_pair(dst, rtVector));
+                ++j;
             }
-            else
+        }
+        NS_LOG_DEBUG("The route vector size of 2 " << dst << " " << rtVector.size());
+        SetRoutes(dst, rtVector);
+    }
+}
+
+void
+DsrRouteCache::SetRoutes(Ipv4Address dst, const routeEntryVector& routes)
+{
+    NS_LOG_FUNCTION(this << dst << routes.size());
+    // Count the routes to the destination by node and by link
+    auto unindex = [dst](auto& index, const auto& key) {
+        auto routes = index.find(key);
+        if (--routes->second[dst] == 0)
+        {
+            routes->second.erase(dst);
+        }
+        if (routes->second.empty())
+        {
+            index.erase(routes);
+        }
+    };
+    auto i = m_sortedRoutes.find(dst);
+    if (i != m_sortedRoutes.end())
+    {
+        for (const auto& route : i->second)
+        {
+            DsrRouteCacheEntry::IP_VECTOR path = route.GetVector();
+            for (auto node = path.begin(); node != path.end(); ++node)
             {
-                ++i;
-                m_sortedRoutes.erase(itmp);
+                unindex(m_pathNodes, *node);
+                if (node + 1 != path.end())
+                {
+                    unindex(m_pathLinks, std::make_pair(*node, *(node + 1)));
+                }
             }
         }
-        else
+        auto expiration = m_pathExpiration.find(dst);
+        m_pathExpirations.erase(std::make_pair(expiration->second, dst));
+        m_pathExpiration.erase(expiration);
+        m_sortedRoutes.erase(i);
+    }
+    if (routes.empty())
+    {
+        return;
+    }
+    Time expiration = Time::Max();
+    for (const auto& route : routes)
+    {
+        DsrRouteCacheEntry::IP_VECTOR path = route.GetVector();
+        for (auto node = path.begin(); node != path.end(); ++node)
         {
-            ++i;
-            m_sortedRoutes.erase(itmp);
+            m_pathNodes[*node][dst]++;
+            if (node + 1 != path.end())
+            {
+                m_pathLinks[std::make_pair(*node, *(node + 1))][dst]++;
+            }
         }
+        expiration = std::min(expiration, route.GetExpireTime() + Simulator::Now());
     }
+    m_pathExpiration[dst] = expiration;
+    m_pathExpirations.emplace(expiration, dst);
+    m_sortedRoutes[dst] = routes;
 }
 
 void
@@ -52,8 +52,10 @@
 #include <cassert>
 #include <iostream>
 #include <map>
+#include <set>
 #include <stdint.h>
 #include <sys/types.h>
+#include <unordered_map>
 #include <vector>
 
 namespace ns3
@@ -782,6 +784,28 @@ class DsrRouteCache : public Object
     std::map<Ipv4Address, routeEntryVector>
         m_sortedRoutes; ///< Map the ipv4Address to route entry vector
 
+    /**
+     * The destinations whose routes go through each node, with the number of
+     * such routes, to find the sub-routes without scanning the whole path cache
+     */
+    std::map<Ipv4Address, std::map<Ipv4Address, uint32_t>> m_pathNodes;
+    /**
+     * The destinations whose routes go through each link, from its first node
+     * to its second one, with the number of such routes, to find the broken
+     * routes without scanning the whole path cache
+     */
+    std::map<std::pair<Ipv4Address, Ipv4Address>, std::map<Ipv4Address, uint32_t>> m_pathLinks;
+    std::map<Ipv4Address, Time> m_pathExpiration; ///< Earliest expiration time by destination
+    std::set<std::pair<Time, Ipv4Address>>
+        m_pathExpirations; ///< The destinations by earliest expiration time
+
+    /**
+     * \brief Replace the routes to a destination and update the path cache indexes
+     * \param dst the destination
+     * \param routes the routes, none to remove the destination from the cache
+     */
+    void SetRoutes(Ipv4Address dst, const routeEntryVector& routes);
+
     routeEntryVector m_routeEntryVector; ///< Define the route vector
 
     uint32_t m_maxEntriesEachDst; ///< number of entries for each destination
@@ -803,10 +827,53 @@ class DsrRouteCache : public Object
      */
     std::map<Ipv4Address, std::map<Ipv4Address, uint32_t>> m_netGraph;
 
-    std::map<Ipv4Address, DsrRouteCacheEntry::IP_VECTOR>
-        m_bestRoutesTable_link;                     ///< for link route cache
     std::map<Link, DsrLinkStab> m_linkCache;        ///< The data structure to store link info
     std::map<Ipv4Address, DsrNodeStab> m_nodeCache; ///< The data structure to store node info
+    std::set<std::pair<Time, Link>> m_linkExpirations;        ///< The links by expiration time
+    std::set<std::pair<Time, Ipv4Address>> m_nodeExpirations; ///< The nodes by expiration time
+    /**
+     * The shortest path tree of the link cache: the distance from the source
+     * and the preceding node of each node reached.  The routes share their
+     * common prefixes, and are only built when looked up.
+     */
+    std::unordered_map<Ipv4Address, std::pair<uint32_t, Ipv4Address>, Ipv4AddressHash>
+        m_bestRoutesTree;
+    Ipv4Address m_bestRoutesSource; ///< The source of the shortest path tree
+    bool m_bestRoutesStale;         ///< Whether the shortest path tree must be rebuilt
+    /**
+     * \brief Add a link to the link cache or update its stability, and shorten
+     * the routes through it
+     * \param link the link
+     * \param stab the link stability
+     */
+    void UpdateLink(const Link& link, const DsrLinkStab& stab);
+    /**
+     * \brief Remove a link from the link cache
+     * \param link the link
+     */
+    void EraseLink(const Link& link);
+    /**
+     * \brief Add a node to the node cache or update its stability
+     * \param node the node
+     * \param stab the node stability
+     */
+    void UpdateNode(Ipv4Address node, const DsrNodeStab& stab);
+    /**
+     * \brief Propagate shorter distances to nodes through the shortest path tree
+     * \param nodes the nodes whose distance decreased
+     */
+    void ShortenRoutes(const std::vector<Ipv4Address>& nodes);
+    /**
+     * \brief Find new routes to the nodes reached through a link of the shortest
+     * path tree that was lost
+     * \param node the node the lost link led to
+     */
+    void RepairRoutes(Ipv4Address node);
+    /**
+     * \brief Set the source of the shortest path tree, which is rebuilt if it changes
+     * \param source the source
+     */
+    void SetBestRoutesSource(Ipv4Address source);
     /**
      * \brief used by LookupRoute when LinkCache
      * \param id the ip address we are looking for
@@ -847,9 +914,9 @@ class DsrRouteCache : public Object
      */
     bool AddRoute_Link(DsrRouteCacheEntry::IP_VECTOR nodelist, Ipv4Address node);
     /**
-     * \brief Rebuild the best route table
-     * \note Use MAXWEIGHT to represent maximum weight, use the IPv4 broadcast
-     *       address of 255.255.255.255 to represent a null preceding address
+     * \brief Rebuild the best route table, i.e., the shortest path tree from the
+     * source.  Among equally short routes, the one whose last link is the most
+     * stable is preferred.
      * \param source The source address used for computing the routes
      */
     void RebuildBestRouteTable(Ipv4Address source);
@@ -89,6 +89,19 @@ class Ipv4GlobalRoutingHelper : public Ipv4RoutingHelper
      *
      */
     static void RecomputeRoutingTables();
+    /**
+     * \brief Update the routes after a change of the topology, recomputing
+     * only the routes of the nodes that the change can affect.
+     *
+     * This gives the same routes as RecomputeRoutingTables(), but only the
+     * nodes whose previous shortest path computation looked at a part of the
+     * topology that changed are computed again.  Like RecomputeRoutingTables(),
+     * it may be called at any time after PopulateRoutingTables().
+     *
+     * The computations of the nodes can run in several threads; see the
+     * GlobalRoutingThreads global value.
+     */
+    static void UpdateRoutingTables();
 };
 
 } // namespace ns3
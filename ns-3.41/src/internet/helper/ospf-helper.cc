@@ -11,7 +11,7 @@ namespace ns3
 {
 OspfHelper::OspfHelper()
 {
-    m_factory.SetTypeId("ns3::OspfL4Protocol");
+    m_factory.SetTypeId("ns3::OspfRouting");
 }
 
 OspfHelper::OspfHelper(const OspfHelper& o)
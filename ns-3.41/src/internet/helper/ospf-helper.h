@@ -1,3 +1,6 @@
+#ifndef OSPF_HELPER_H
+#define OSPF_HELPER_H
+
 #include "ipv4-routing-helper.h"
 
 #include "ns3/node-container.h"
@@ -7,7 +10,7 @@
 namespace ns3
 {
 
-class OspfHelper : Ipv4RoutingHelper{
+class OspfHelper : public Ipv4RoutingHelper{
     public:
         OspfHelper();
         ~OspfHelper() override;
@@ -38,4 +41,6 @@ class OspfHelper : Ipv4RoutingHelper{
         std::map<Ptr<Node>, std::map<uint32_t, uint8_t>> m_interfaceMetrics;
 };
 
-}
\ No newline at end of file
+}
+
+#endif // OSPF_HELPER_H
@@ -58,20 +58,24 @@ operator<<(std::ostream& os, const SPFVertex::VertexType& t)
 std::ostream&
 operator<<(std::ostream& os, const CandidateQueue& q)
 {
-    const CandidateQueue::CandidateList_t& list = q.m_candidates;
+    std::vector<CandidateQueue::Candidate> candidates(q.m_heap);
+    std::sort(candidates.begin(), candidates.end(), &CandidateQueue::IsBefore);
 
     os << "*** CandidateQueue Begin (<id, distance, LSA-type>) ***" << std::endl;
-    for (auto iter = list.begin(); iter != list.end(); iter++)
+    for (const auto& candidate : candidates)
     {
-        os << "<" << (*iter)->GetVertexId() << ", " << (*iter)->GetDistanceFromRoot() << ", "
-           << (*iter)->GetVertexType() << ">" << std::endl;
+        os << "<" << candidate.vertex->GetVertexId() << ", "
+           << candidate.vertex->GetDistanceFromRoot() << ", " << candidate.vertex->GetVertexType()
+           << ">" << std::endl;
     }
     os << "*** CandidateQueue End ***";
     return os;
 }
 
 CandidateQueue::CandidateQueue()
-    : m_candidates()
+    : m_heap(),
+      m_order(0),
+      m_vertices()
 {
     NS_LOG_FUNCTION(this);
 }
@@ -86,7 +90,7 @@ void
 CandidateQueue::Clear()
 {
     NS_LOG_FUNCTION(this);
-    while (!m_candidates.empty())
+    while (!m_heap.empty())
     {
         SPFVertex* p = Pop();
         delete p;
@@ -99,24 +103,38 @@ CandidateQueue::Push(SPFVertex* vNew)
 {
     NS_LOG_FUNCTION(this << vNew);
 
-    auto i = std::upper_bound(m_candidates.begin(),
-                              m_candidates.end(),
-                              vNew,
-                              &CandidateQueue::CompareSPFVertex);
-    m_candidates.insert(i, vNew);
+    m_heap.push_back({GetPriority(vNew), m_order++, vNew});
+    vNew->m_candidatePosition = m_heap.size() - 1;
+    m_vertices.emplace(vNew->GetVertexId(), vNew);
+    SiftUp(m_heap.size() - 1);
 }
 
 SPFVertex*
 CandidateQueue::Pop()
 {
     NS_LOG_FUNCTION(this);
-    if (m_candidates.empty())
+    if (m_heap.empty())
     {
         return nullptr;
     }
 
-    SPFVertex* v = m_candidates.front();
-    m_candidates.pop_front();
+    SPFVertex* v = m_heap.front().vertex;
+    Candidate last = m_heap.back();
+    m_heap.pop_back();
+    if (!m_heap.empty())
+    {
+        Place(0, last);
+        SiftDown(0);
+    }
+    auto range = m_vertices.equal_range(v->GetVertexId());
+    for (auto i = range.first; i != range.second; i++)
+    {
+        if (i->second == v)
+        {
+            m_vertices.erase(i);
+            break;
+        }
+    }
     return v;
 }
 
@@ -124,44 +142,61 @@ SPFVertex*
 CandidateQueue::Top() const
 {
     NS_LOG_FUNCTION(this);
-    if (m_candidates.empty())
+    if (m_heap.empty())
     {
         return nullptr;
     }
 
-    return m_candidates.front();
+    return m_heap.front().vertex;
 }
 
 bool
 CandidateQueue::Empty() const
 {
     NS_LOG_FUNCTION(this);
-    return m_candidates.empty();
+    return m_heap.empty();
 }
 
 uint32_t
 CandidateQueue::Size() const
 {
     NS_LOG_FUNCTION(this);
-    return m_candidates.size();
+    return m_heap.size();
 }
 
 SPFVertex*
 CandidateQueue::Find(const Ipv4Address addr) const
 {
     NS_LOG_FUNCTION(this);
-    auto i = m_candidates.begin();
-
-    for (; i != m_candidates.end(); i++)
+    //
+    // When several vertices have the address (which the SPF calculation does
+    // not do), return the first one to be popped.
+    //
+    SPFVertex* found = nullptr;
+    auto range = m_vertices.equal_range(addr);
+    for (auto i = range.first; i != range.second; i++)
     {
-        SPFVertex* v = *i;
-        if (v->GetVertexId() == addr)
+        if (!found || IsBefore(m_heap[i->second->m_candidatePosition],
+                               m_heap[found->m_candidatePosition]))
         {
-            return v;
+            found = i->second;
         }
     }
+    return found;
+}
 
-    return nullptr;
+void
+CandidateQueue::DecreaseKey(SPFVertex* v)
+{
+    NS_LOG_FUNCTION(this << v);
+    uint32_t position = v->m_candidatePosition;
+    NS_ASSERT_MSG(position < m_heap.size() && m_heap[position].vertex == v,
+                  "Vertex " << v->GetVertexId() << " is not in the queue");
+    uint64_t priority = GetPriority(v);
+    NS_ASSERT_MSG(priority <= m_heap[position].priority, "The distance of the vertex increased");
+    m_heap[position].priority = priority;
+    m_heap[position].order = m_order++;
+    SiftUp(position);
 }
 
 void
@@ -169,7 +204,17 @@ CandidateQueue::Reorder()
 {
     NS_LOG_FUNCTION(this);
 
-    m_candidates.sort(&CandidateQueue::CompareSPFVertex);
+    for (auto& candidate : m_heap)
+    {
+        candidate.priority = GetPriority(candidate.vertex);
+    }
+    for (uint32_t i = m_heap.size() / ARITY + 1; i-- > 0;)
+    {
+        if (i < m_heap.size())
+        {
+            SiftDown(i);
+        }
+    }
     NS_LOG_LOGIC("After reordering the CandidateQueue");
     NS_LOG_LOGIC(*this);
 }
@@ -181,25 +226,71 @@ CandidateQueue::Reorder()
  *
  * This ordering is necessary for implementing ECMP
  */
+uint64_t
+CandidateQueue::GetPriority(const SPFVertex* v)
+{
+    return (static_cast<uint64_t>(v->GetDistanceFromRoot()) << 1) |
+           (v->GetVertexType() == SPFVertex::VertexNetwork ? 0 : 1);
+}
+
 bool
-CandidateQueue::CompareSPFVertex(const SPFVertex* v1, const SPFVertex* v2)
+CandidateQueue::IsBefore(const Candidate& a, const Candidate& b)
 {
-    NS_LOG_FUNCTION(&v1 << &v2);
+    return a.priority < b.priority || (a.priority == b.priority && a.order < b.order);
+}
 
-    bool result = false;
-    if (v1->GetDistanceFromRoot() < v2->GetDistanceFromRoot())
+void
+CandidateQueue::Place(uint32_t position, const Candidate& candidate)
+{
+    m_heap[position] = candidate;
+    candidate.vertex->m_candidatePosition = position;
+}
+
+void
+CandidateQueue::SiftUp(uint32_t position)
+{
+    Candidate candidate = m_heap[position];
+    while (position > 0)
     {
-        result = true;
+        uint32_t parent = (position - 1) / ARITY;
+        if (!IsBefore(candidate, m_heap[parent]))
+        {
+            break;
+        }
+        Place(position, m_heap[parent]);
+        position = parent;
     }
-    else if (v1->GetDistanceFromRoot() == v2->GetDistanceFromRoot())
+    Place(position, candidate);
+}
+
+void
+CandidateQueue::SiftDown(uint32_t position)
+{
+    Candidate candidate = m_heap[position];
+    uint32_t size = m_heap.size();
+    for (;;)
     {
-        if (v1->GetVertexType() == SPFVertex::VertexNetwork &&
-            v2->GetVertexType() == SPFVertex::VertexRouter)
+        uint32_t first = position * ARITY + 1;
+        if (first >= size)
+        {
+            break;
+        }
+        uint32_t best = first;
+        for (uint32_t child = first + 1; child < first + ARITY && child < size; child++)
+        {
+            if (IsBefore(m_heap[child], m_heap[best]))
+            {
+                best = child;
+            }
+        }
+        if (!IsBefore(m_heap[best], candidate))
         {
-            result = true;
+            break;
         }
+        Place(position, m_heap[best]);
+        position = best;
     }
-    return result;
+    Place(position, candidate);
 }
 
 } // namespace ns3
@@ -22,8 +22,9 @@
 
 #include "ns3/ipv4-address.h"
 
-#include <list>
 #include <stdint.h>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
@@ -45,9 +46,14 @@ class SPFVertex;
  * priority queue.
  *
  * Although a STL priority_queue almost does what we want, the requirement
- * for a Find () operation, the dynamic nature of the data and the derived
- * requirement for a Reorder () operation led us to implement this simple
- * enhanced priority queue.
+ * for a Find () operation and the dynamic nature of the data led us to
+ * implement this enhanced priority queue: an indexed 4-ary heap, where each
+ * vertex knows its position so that its distance can be decreased in place
+ * (DecreaseKey ()), and a hash table of the vertices by ID for Find ().
+ *
+ * Vertices at the same distance are popped networks first, then in the order
+ * they were pushed; a vertex whose distance is decreased is popped after the
+ * vertices already at its new distance.
  */
 class CandidateQueue
 {
@@ -144,6 +150,18 @@ class CandidateQueue
      */
     SPFVertex* Find(const Ipv4Address addr) const;
 
+    /**
+     * @brief Move a vertex whose distance was decreased to its new place in
+     * the queue.
+     *
+     * The vertex is placed after the vertices already in the queue at its new
+     * distance, as if it was pushed again.
+     *
+     * @see SPFVertex
+     * @param v The Shortest Path First Vertex, which must be in the queue.
+     */
+    void DecreaseKey(SPFVertex* v);
+
     /**
      * @brief Reorders the Candidate Queue according to the priority scheme.
      *
@@ -153,7 +171,9 @@ class CandidateQueue
      * increasing distance.
      *
      * This method is provided in case the values of m_distanceFromRoot change
-     * during the routing calculations.
+     * during the routing calculations.  Vertices at the same distance keep
+     * the order in which they were pushed.  When only one vertex got closer
+     * to the root, DecreaseKey () is cheaper.
      *
      * @see SPFVertex
      */
@@ -161,20 +181,59 @@ class CandidateQueue
 
   private:
     /**
-     * \brief return true if v1 < v2
+     * \brief An entry of the heap.
+     */
+    struct Candidate
+    {
+        uint64_t priority; //!< distance from root and vertex type, see GetPriority ()
+        uint64_t order;    //!< order of insertion among equal priorities
+        SPFVertex* vertex; //!< the vertex
+    };
+
+    /**
+     * \brief Get the priority of a vertex in the queue.
      *
-     * SPFVertexes are added into the queue according to the ordering
-     * defined by this method. If v1 should be popped before v2, this
-     * method return true; false otherwise
+     * The lower the priority, the earlier the vertex is popped: vertices are
+     * ranked by distance from the root, then networks before routers.
      *
-     * \param v1 first operand
-     * \param v2 second operand
-     * \return True if v1 should be popped before v2; false otherwise
+     * \param v the vertex
+     * \return the priority
      */
-    static bool CompareSPFVertex(const SPFVertex* v1, const SPFVertex* v2);
+    static uint64_t GetPriority(const SPFVertex* v);
+
+    /**
+     * \brief Compare two heap entries.
+     * \param a first operand
+     * \param b second operand
+     * \return True if a should be popped before b
+     */
+    static bool IsBefore(const Candidate& a, const Candidate& b);
+
+    /**
+     * \brief Move an entry towards the top of the heap until it is in place.
+     * \param position the position of the entry
+     */
+    void SiftUp(uint32_t position);
+
+    /**
+     * \brief Move an entry towards the bottom of the heap until it is in place.
+     * \param position the position of the entry
+     */
+    void SiftDown(uint32_t position);
+
+    /**
+     * \brief Store an entry at a position of the heap.
+     * \param position the position
+     * \param candidate the entry
+     */
+    void Place(uint32_t position, const Candidate& candidate);
+
+    static const uint32_t ARITY = 4; //!< number of children of each heap entry
 
-    typedef std::list<SPFVertex*> CandidateList_t; //!< container of SPFVertex pointers
-    CandidateList_t m_candidates;                  //!< SPFVertex candidates
+    std::vector<Candidate> m_heap; //!< SPFVertex candidates, as a heap
+    uint64_t m_order;              //!< order given to the next vertex pushed
+    /// SPFVertex candidates by vertex ID
+    std::unordered_multimap<Ipv4Address, SPFVertex*, Ipv4AddressHash> m_vertices;
 
     /**
      * \brief Stream insertion operator.
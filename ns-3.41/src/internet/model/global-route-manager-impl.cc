@@ -30,13 +30,18 @@
 
 #include "ns3/assert.h"
 #include "ns3/fatal-error.h"
+#include "ns3/global-value.h"
 #include "ns3/log.h"
 #include "ns3/node-list.h"
 #include "ns3/simulator.h"
+#include "ns3/uinteger.h"
 
 #include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <memory>
 #include <queue>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -45,6 +50,38 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("GlobalRouteManagerImpl");
 
+/**
+ * \ingroup globalrouting
+ * Number of threads running the per-router SPF calculations.
+ */
+static GlobalValue g_globalRoutingThreads =
+    GlobalValue("GlobalRoutingThreads",
+                "The number of threads computing the global routes of the routers "
+                "(0 uses one thread per hardware thread)",
+                UintegerValue(1),
+                MakeUintegerChecker<uint32_t>());
+
+/**
+ * \brief Check whether any log component is enabled.
+ *
+ * Logging is not thread-safe, so the SPF calculations run in the main thread
+ * when it is in use.
+ *
+ * \returns true if a log component is enabled
+ */
+static bool
+IsLoggingEnabled()
+{
+    for (const auto& component : *LogComponent::GetComponentList())
+    {
+        if (!component.second->IsNoneEnabled())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
 /**
  * \brief Stream insertion operator.
  *
@@ -94,7 +131,8 @@ SPFVertex::SPFVertex()
       m_nextHop("0.0.0.0"),
       m_parents(),
       m_children(),
-      m_vertexProcessed(false)
+      m_vertexProcessed(false),
+      m_candidatePosition(0)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -107,7 +145,8 @@ SPFVertex::SPFVertex(GlobalRoutingLSA* lsa)
       m_nextHop("0.0.0.0"),
       m_parents(),
       m_children(),
-      m_vertexProcessed(false)
+      m_vertexProcessed(false),
+      m_candidatePosition(0)
 {
     NS_LOG_FUNCTION(this << lsa);
 
@@ -418,6 +457,56 @@ SPFVertex::ClearVertexProcessed()
     this->SetVertexProcessed(false);
 }
 
+// ---------------------------------------------------------------------------
+//
+// GlobalRouteManagerImpl::SPFVertexArena Implementation
+//
+// ---------------------------------------------------------------------------
+
+GlobalRouteManagerImpl::SPFVertexArena::SPFVertexArena()
+    : m_chunks(),
+      m_size(0)
+{
+}
+
+GlobalRouteManagerImpl::SPFVertexArena::~SPFVertexArena()
+{
+    Clear();
+    std::allocator<SPFVertex> allocator;
+    for (auto chunk : m_chunks)
+    {
+        allocator.deallocate(chunk, CHUNK_SIZE);
+    }
+}
+
+SPFVertex*
+GlobalRouteManagerImpl::SPFVertexArena::Create(GlobalRoutingLSA* lsa)
+{
+    if (m_size == m_chunks.size() * CHUNK_SIZE)
+    {
+        m_chunks.push_back(std::allocator<SPFVertex>().allocate(CHUNK_SIZE));
+    }
+    SPFVertex* v = m_chunks[m_size / CHUNK_SIZE] + m_size % CHUNK_SIZE;
+    new (v) SPFVertex(lsa);
+    m_size++;
+    return v;
+}
+
+void
+GlobalRouteManagerImpl::SPFVertexArena::Clear()
+{
+    for (std::size_t i = 0; i < m_size; i++)
+    {
+        SPFVertex* v = m_chunks[i / CHUNK_SIZE] + i % CHUNK_SIZE;
+        // The other vertices are released too, do not let the destructor
+        // walk the tree
+        v->m_parents.clear();
+        v->m_children.clear();
+        v->~SPFVertex();
+    }
+    m_size = 0;
+}
+
 // ---------------------------------------------------------------------------
 //
 // GlobalRouteManagerLSDB Implementation
@@ -448,6 +537,7 @@ GlobalRouteManagerLSDB::~GlobalRouteManagerLSDB()
     }
     NS_LOG_LOGIC("clear map");
     m_database.clear();
+    m_linkDataIndex.clear();
 }
 
 void
@@ -469,9 +559,26 @@ GlobalRouteManagerLSDB::Insert(Ipv4Address addr, GlobalRoutingLSA* lsa)
     {
         m_extdatabase.push_back(lsa);
     }
-    else
+    else if (m_database.insert(LSDBPair_t(addr, lsa)).second)
     {
-        m_database.insert(LSDBPair_t(addr, lsa));
+        //
+        // Index the transit network link records.  When several LSAs share a
+        // link data, the one with the lowest address is kept, which is the one
+        // a walk of the database would find first.
+        //
+        for (uint32_t j = 0; j < lsa->GetNLinkRecords(); j++)
+        {
+            GlobalRoutingLinkRecord* lr = lsa->GetLinkRecord(j);
+            if (lr->GetLinkType() != GlobalRoutingLinkRecord::TransitNetwork)
+            {
+                continue;
+            }
+            auto result = m_linkDataIndex.emplace(lr->GetLinkData(), lsa);
+            if (!result.second && addr < result.first->second->GetLinkStateId())
+            {
+                result.first->second = lsa;
+            }
+        }
     }
 }
 
@@ -496,14 +603,8 @@ GlobalRouteManagerLSDB::GetLSA(Ipv4Address addr) const
     //
     // Look up an LSA by its address.
     //
-    for (auto i = m_database.begin(); i != m_database.end(); i++)
-    {
-        if (i->first == addr)
-        {
-            return i->second;
-        }
-    }
-    return nullptr;
+    auto i = m_database.find(addr);
+    return i != m_database.end() ? i->second : nullptr;
 }
 
 GlobalRoutingLSA*
@@ -511,23 +612,10 @@ GlobalRouteManagerLSDB::GetLSAByLinkData(Ipv4Address addr) const
 {
     NS_LOG_FUNCTION(this << addr);
     //
-    // Look up an LSA by its address.
+    // Look up an LSA by the link data of its transit network link records.
     //
-    for (auto i = m_database.begin(); i != m_database.end(); i++)
-    {
-        GlobalRoutingLSA* temp = i->second;
-        // Iterate among temp's Link Records
-        for (uint32_t j = 0; j < temp->GetNLinkRecords(); j++)
-        {
-            GlobalRoutingLinkRecord* lr = temp->GetLinkRecord(j);
-            if (lr->GetLinkType() == GlobalRoutingLinkRecord::TransitNetwork &&
-                lr->GetLinkData() == addr)
-            {
-                return temp;
-            }
-        }
-    }
-    return nullptr;
+    auto i = m_linkDataIndex.find(addr);
+    return i != m_linkDataIndex.end() ? i->second : nullptr;
 }
 
 // ---------------------------------------------------------------------------
@@ -537,16 +625,32 @@ GlobalRouteManagerLSDB::GetLSAByLinkData(Ipv4Address addr) const
 // ---------------------------------------------------------------------------
 
 GlobalRouteManagerImpl::GlobalRouteManagerImpl()
-    : m_spfroot(nullptr)
+    : m_spfroot(nullptr),
+      m_ownsLsdb(true),
+      m_spfrootNode(nullptr),
+      m_keys(&m_lsaKeys),
+      m_keysComplete(true),
+      m_dependencies(nullptr)
 {
     NS_LOG_FUNCTION(this);
     m_lsdb = new GlobalRouteManagerLSDB();
 }
 
+GlobalRouteManagerImpl::GlobalRouteManagerImpl(GlobalRouteManagerLSDB* lsdb, const LSAKeys* keys)
+    : m_spfroot(nullptr),
+      m_lsdb(lsdb),
+      m_ownsLsdb(false),
+      m_spfrootNode(nullptr),
+      m_keys(keys),
+      m_keysComplete(true),
+      m_dependencies(nullptr)
+{
+}
+
 GlobalRouteManagerImpl::~GlobalRouteManagerImpl()
 {
     NS_LOG_FUNCTION(this);
-    if (m_lsdb)
+    if (m_lsdb && m_ownsLsdb)
     {
         delete m_lsdb;
     }
@@ -561,10 +665,28 @@ GlobalRouteManagerImpl::DebugUseLsdb(GlobalRouteManagerLSDB* lsdb)
         delete m_lsdb;
     }
     m_lsdb = lsdb;
+    // The keys of a database built elsewhere are unknown
+    m_keysComplete = false;
+    m_rootDependencies.clear();
 }
 
 void
 GlobalRouteManagerImpl::DeleteGlobalRoutes()
+{
+    NS_LOG_FUNCTION(this);
+    ClearRoutes();
+    if (m_lsdb)
+    {
+        NS_LOG_LOGIC("Deleting LSDB, creating new one");
+        delete m_lsdb;
+        m_lsdb = new GlobalRouteManagerLSDB();
+    }
+    m_keysComplete = true;
+    m_rootDependencies.clear();
+}
+
+void
+GlobalRouteManagerImpl::ClearRoutes()
 {
     NS_LOG_FUNCTION(this);
     for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
@@ -576,24 +698,13 @@ GlobalRouteManagerImpl::DeleteGlobalRoutes()
             continue;
         }
         Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-        uint32_t j = 0;
-        uint32_t nRoutes = gr->GetNRoutes();
         NS_LOG_LOGIC("Deleting " << gr->GetNRoutes() << " routes from node " << node->GetId());
-        // Each time we delete route 0, the route index shifts downward
-        // We can delete all routes if we delete the route numbered 0
-        // nRoutes times
-        for (j = 0; j < nRoutes; j++)
-        {
-            NS_LOG_LOGIC("Deleting global route " << j << " from node " << node->GetId());
-            gr->RemoveRoute(0);
-        }
-        NS_LOG_LOGIC("Deleted " << j << " global routes from node " << node->GetId());
-    }
-    if (m_lsdb)
-    {
-        NS_LOG_LOGIC("Deleting LSDB, creating new one");
-        delete m_lsdb;
-        m_lsdb = new GlobalRouteManagerLSDB();
+        //
+        // Swap in an empty table and release the old routes in one go rather
+        // than removing them one index at a time.
+        //
+        Ipv4RoutingTable empty;
+        gr->SwapRoutes(empty);
     }
 }
 
@@ -650,6 +761,7 @@ GlobalRouteManagerImpl::BuildGlobalRoutingDatabase()
             //
             // Write the newly discovered link state advertisement to the database.
             //
+            AddLSAKeys(lsa);
             m_lsdb->Insert(lsa->GetLinkStateId(), lsa);
         }
     }
@@ -696,6 +808,109 @@ GlobalRouteManagerImpl::InitializeRoutes()
     // Walk the list of nodes in the system.
     //
     NS_LOG_INFO("About to start SPF calculation");
+    m_rootDependencies.clear();
+    ComputeRoutes(GetSPFRoots());
+    NS_LOG_INFO("Finished SPF calculation");
+}
+
+void
+GlobalRouteManagerImpl::UpdateRoutes()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_rootDependencies.empty())
+    {
+        NS_LOG_LOGIC("No previous SPF calculation, computing all the routes");
+        DeleteGlobalRoutes();
+        BuildGlobalRoutingDatabase();
+        InitializeRoutes();
+        return;
+    }
+    //
+    // Build the new database next to the one the current routes were computed
+    // from.
+    //
+    GlobalRouteManagerLSDB* oldLsdb = m_lsdb;
+    m_lsdb = new GlobalRouteManagerLSDB();
+    BuildGlobalRoutingDatabase();
+    std::vector<SPFRoot> roots = GetSPFRoots();
+
+    bool sameRoots = roots.size() == m_rootDependencies.size();
+    for (auto i = roots.begin(); sameRoots && i != roots.end(); i++)
+    {
+        sameRoots = m_rootDependencies.find(i->routerId) != m_rootDependencies.end();
+    }
+    if (!sameRoots)
+    {
+        NS_LOG_LOGIC("The set of routers changed, computing all the routes");
+        delete oldLsdb;
+        ClearRoutes();
+        InitializeRoutes();
+        return;
+    }
+    //
+    // Find the lookups whose answer changed.
+    //
+    std::vector<uint32_t> changedLsas;
+    for (const auto& key : m_lsaKeys.lsas)
+    {
+        if (!IsSameLSA(oldLsdb->GetLSA(key.first), m_lsdb->GetLSA(key.first)))
+        {
+            changedLsas.push_back(key.second);
+        }
+    }
+    std::vector<uint32_t> changedLinkData;
+    for (const auto& key : m_lsaKeys.linkData)
+    {
+        GlobalRoutingLSA* oldLsa = oldLsdb->GetLSAByLinkData(key.first);
+        GlobalRoutingLSA* newLsa = m_lsdb->GetLSAByLinkData(key.first);
+        if ((oldLsa == nullptr) != (newLsa == nullptr) ||
+            (oldLsa && oldLsa->GetLinkStateId() != newLsa->GetLinkStateId()))
+        {
+            changedLinkData.push_back(key.second);
+        }
+    }
+    bool changedExternals = oldLsdb->GetNumExtLSAs() != m_lsdb->GetNumExtLSAs();
+    for (uint32_t i = 0; !changedExternals && i < m_lsdb->GetNumExtLSAs(); i++)
+    {
+        changedExternals = !IsSameLSA(oldLsdb->GetExtLSA(i), m_lsdb->GetExtLSA(i));
+    }
+    delete oldLsdb;
+    NS_LOG_LOGIC(changedLsas.size() << " LSAs, " << changedLinkData.size()
+                                    << " link data and "
+                                    << (changedExternals ? "the" : "no")
+                                    << " external LSAs changed");
+    //
+    // Compute the routes of the roots whose calculation used any of them.
+    //
+    std::vector<SPFRoot> affected;
+    for (auto& root : roots)
+    {
+        const SPFDependencies& dependencies = m_rootDependencies[root.routerId];
+        bool dirty = (dependencies.externals && changedExternals) ||
+                     dependencies.addresses != root.addresses;
+        for (auto i = changedLsas.begin(); !dirty && i != changedLsas.end(); i++)
+        {
+            dirty = *i < dependencies.lsas.size() && dependencies.lsas[*i];
+        }
+        for (auto i = changedLinkData.begin(); !dirty && i != changedLinkData.end(); i++)
+        {
+            dirty = *i < dependencies.linkData.size() && dependencies.linkData[*i];
+        }
+        if (dirty)
+        {
+            affected.push_back(std::move(root));
+        }
+    }
+    NS_LOG_INFO("Computing the routes of " << affected.size() << " of " << roots.size()
+                                           << " routers");
+    ComputeRoutes(affected);
+}
+
+std::vector<GlobalRouteManagerImpl::SPFRoot>
+GlobalRouteManagerImpl::GetSPFRoots() const
+{
+    NS_LOG_FUNCTION(this);
+    std::vector<SPFRoot> roots;
     for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
     {
         Ptr<Node> node = *i;
@@ -718,10 +933,227 @@ GlobalRouteManagerImpl::InitializeRoutes()
         //
         if (rtr && rtr->GetNumLSAs())
         {
-            SPFCalculate(rtr->GetRouterId());
+            roots.push_back(GetSPFRoot(node, rtr));
         }
     }
-    NS_LOG_INFO("Finished SPF calculation");
+    return roots;
+}
+
+GlobalRouteManagerImpl::SPFRoot
+GlobalRouteManagerImpl::GetSPFRoot(Ptr<Node> node, Ptr<GlobalRouter> router) const
+{
+    NS_LOG_FUNCTION(this << node << router);
+    SPFRoot root;
+    root.routerId = router->GetRouterId();
+    root.nodeId = node->GetId();
+    root.router = router;
+    //
+    // Routing information is updated using the Ipv4 interface.  If the node is
+    // acting as an IP version 4 router, it should absolutely have an Ipv4
+    // interface.
+    //
+    Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
+    NS_ASSERT_MSG(ipv4,
+                  "GlobalRouteManagerImpl::GetSPFRoot (): "
+                  "GetObject for <Ipv4> interface failed");
+    for (uint32_t i = 0; i < ipv4->GetNInterfaces(); i++)
+    {
+        for (uint32_t j = 0; j < ipv4->GetNAddresses(i); j++)
+        {
+            root.addresses.emplace_back(i, ipv4->GetAddress(i, j).GetLocal());
+        }
+    }
+    return root;
+}
+
+void
+GlobalRouteManagerImpl::ComputeRoutes(const std::vector<SPFRoot>& roots)
+{
+    NS_LOG_FUNCTION(this << roots.size());
+    UintegerValue value;
+    g_globalRoutingThreads.GetValue(value);
+    std::size_t nThreads = value.Get() ? value.Get() : std::thread::hardware_concurrency();
+    nThreads = std::min(nThreads, roots.size());
+    if (nThreads > 1 && IsLoggingEnabled())
+    {
+        nThreads = 1;
+    }
+
+    std::vector<SPFDependencies> dependencies(m_keysComplete ? roots.size() : 0);
+    for (auto& rootDependencies : dependencies)
+    {
+        rootDependencies.lsas.resize(m_lsaKeys.lsas.size());
+        rootDependencies.linkData.resize(m_lsaKeys.linkData.size());
+    }
+
+    if (nThreads <= 1)
+    {
+        for (std::size_t i = 0; i < roots.size(); i++)
+        {
+            m_spfrootNode = &roots[i];
+            m_dependencies = m_keysComplete ? &dependencies[i] : nullptr;
+            SPFCalculate(roots[i].routerId);
+            SPFInstallRoutes();
+        }
+    }
+    else
+    {
+        //
+        // The workers only read the LSDB and the gathered root data, and each
+        // accumulates the routes of a root in its own table.  The routes are
+        // installed here once all the calculations are done.
+        //
+        NS_LOG_LOGIC("Running the SPF calculations in " << nThreads << " threads");
+        std::vector<Ipv4RoutingTable> tables(roots.size());
+        std::atomic<std::size_t> next(0);
+        auto work = [&]() {
+            GlobalRouteManagerImpl worker(m_lsdb, &m_lsaKeys);
+            for (std::size_t i = next++; i < roots.size(); i = next++)
+            {
+                worker.m_spfrootNode = &roots[i];
+                worker.m_dependencies = m_keysComplete ? &dependencies[i] : nullptr;
+                worker.SPFCalculate(roots[i].routerId);
+                tables[i].Swap(worker.m_stagedRoutes);
+            }
+        };
+        std::vector<std::thread> threads;
+        for (std::size_t i = 1; i < nThreads; i++)
+        {
+            threads.emplace_back(work);
+        }
+        work();
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        for (std::size_t i = 0; i < roots.size(); i++)
+        {
+            m_spfrootNode = &roots[i];
+            m_stagedRoutes.Swap(tables[i]);
+            SPFInstallRoutes();
+        }
+    }
+    m_spfrootNode = nullptr;
+    m_dependencies = nullptr;
+
+    for (std::size_t i = 0; i < dependencies.size(); i++)
+    {
+        dependencies[i].addresses = roots[i].addresses;
+        m_rootDependencies[roots[i].routerId] = std::move(dependencies[i]);
+    }
+}
+
+void
+GlobalRouteManagerImpl::AddLSAKeys(const GlobalRoutingLSA* lsa)
+{
+    NS_LOG_FUNCTION(this << lsa);
+    //
+    // Register every address the SPF calculation may look an LSA up with: the
+    // link state IDs and the link records pointing to other LSAs.
+    //
+    auto addKey = [](std::unordered_map<Ipv4Address, uint32_t, Ipv4AddressHash>& keys,
+                     Ipv4Address address) { keys.emplace(address, keys.size()); };
+    if (lsa->GetLSType() == GlobalRoutingLSA::ASExternalLSAs)
+    {
+        return;
+    }
+    addKey(m_lsaKeys.lsas, lsa->GetLinkStateId());
+    for (uint32_t i = 0; i < lsa->GetNLinkRecords(); i++)
+    {
+        GlobalRoutingLinkRecord* l = lsa->GetLinkRecord(i);
+        if (l->GetLinkType() == GlobalRoutingLinkRecord::PointToPoint ||
+            l->GetLinkType() == GlobalRoutingLinkRecord::TransitNetwork)
+        {
+            addKey(m_lsaKeys.lsas, l->GetLinkId());
+        }
+        if (l->GetLinkType() == GlobalRoutingLinkRecord::TransitNetwork)
+        {
+            addKey(m_lsaKeys.linkData, l->GetLinkData());
+        }
+    }
+    for (uint32_t i = 0; i < lsa->GetNAttachedRouters(); i++)
+    {
+        addKey(m_lsaKeys.linkData, lsa->GetAttachedRouter(i));
+    }
+}
+
+GlobalRoutingLSA*
+GlobalRouteManagerImpl::LookupLSA(Ipv4Address id)
+{
+    NS_LOG_FUNCTION(this << id);
+    if (m_dependencies)
+    {
+        auto key = m_keys->lsas.find(id);
+        NS_ASSERT_MSG(key != m_keys->lsas.end(), "No key registered for LSA " << id);
+        m_dependencies->lsas[key->second] = true;
+    }
+    return m_lsdb->GetLSA(id);
+}
+
+GlobalRoutingLSA*
+GlobalRouteManagerImpl::LookupLSAByLinkData(Ipv4Address linkData)
+{
+    NS_LOG_FUNCTION(this << linkData);
+    GlobalRoutingLSA* lsa = m_lsdb->GetLSAByLinkData(linkData);
+    if (m_dependencies)
+    {
+        auto key = m_keys->linkData.find(linkData);
+        NS_ASSERT_MSG(key != m_keys->linkData.end(), "No key registered for link data " << linkData);
+        m_dependencies->linkData[key->second] = true;
+        if (lsa)
+        {
+            m_dependencies->lsas[m_keys->lsas.at(lsa->GetLinkStateId())] = true;
+        }
+    }
+    return lsa;
+}
+
+GlobalRoutingLSA::SPFStatus
+GlobalRouteManagerImpl::GetLSAStatus(const GlobalRoutingLSA* lsa) const
+{
+    auto i = m_lsaStatus.find(lsa);
+    return i != m_lsaStatus.end() ? i->second : GlobalRoutingLSA::LSA_SPF_NOT_EXPLORED;
+}
+
+void
+GlobalRouteManagerImpl::SetLSAStatus(const GlobalRoutingLSA* lsa, GlobalRoutingLSA::SPFStatus status)
+{
+    m_lsaStatus[lsa] = status;
+}
+
+bool
+GlobalRouteManagerImpl::IsSameLSA(const GlobalRoutingLSA* a, const GlobalRoutingLSA* b)
+{
+    if (!a || !b)
+    {
+        return a == b;
+    }
+    if (a->GetLSType() != b->GetLSType() || a->GetLinkStateId() != b->GetLinkStateId() ||
+        a->GetAdvertisingRouter() != b->GetAdvertisingRouter() ||
+        a->GetNetworkLSANetworkMask() != b->GetNetworkLSANetworkMask() ||
+        a->GetNLinkRecords() != b->GetNLinkRecords() ||
+        a->GetNAttachedRouters() != b->GetNAttachedRouters())
+    {
+        return false;
+    }
+    for (uint32_t i = 0; i < a->GetNLinkRecords(); i++)
+    {
+        GlobalRoutingLinkRecord* la = a->GetLinkRecord(i);
+        GlobalRoutingLinkRecord* lb = b->GetLinkRecord(i);
+        if (la->GetLinkType() != lb->GetLinkType() || la->GetLinkId() != lb->GetLinkId() ||
+            la->GetLinkData() != lb->GetLinkData() || la->GetMetric() != lb->GetMetric())
+        {
+            return false;
+        }
+    }
+    for (uint32_t i = 0; i < a->GetNAttachedRouters(); i++)
+    {
+        if (a->GetAttachedRouter(i) != b->GetAttachedRouter(i))
+        {
+            return false;
+        }
+    }
+    return true;
 }
 
 //
@@ -790,14 +1222,14 @@ GlobalRouteManagerImpl::SPFNext(SPFVertex* v, CandidateQueue& candidate)
                 // Lookup the link state advertisement of the new link -- we call it <w> in
                 // the link state database.
                 //
-                w_lsa = m_lsdb->GetLSA(l->GetLinkId());
+                w_lsa = LookupLSA(l->GetLinkId());
                 NS_ASSERT(w_lsa);
                 NS_LOG_LOGIC("Found a P2P record from " << v->GetVertexId() << " to "
                                                         << w_lsa->GetLinkStateId());
             }
             else if (l->GetLinkType() == GlobalRoutingLinkRecord::TransitNetwork)
             {
-                w_lsa = m_lsdb->GetLSA(l->GetLinkId());
+                w_lsa = LookupLSA(l->GetLinkId());
                 NS_ASSERT(w_lsa);
                 NS_LOG_LOGIC("Found a Transit record from " << v->GetVertexId() << " to "
                                                             << w_lsa->GetLinkStateId());
@@ -810,7 +1242,7 @@ GlobalRouteManagerImpl::SPFNext(SPFVertex* v, CandidateQueue& candidate)
         // Get w_lsa:  In case of V is Network-LSA
         if (v->GetVertexType() == SPFVertex::VertexNetwork)
         {
-            w_lsa = m_lsdb->GetLSAByLinkData(v->GetLSA()->GetAttachedRouter(i));
+            w_lsa = LookupLSAByLinkData(v->GetLSA()->GetAttachedRouter(i));
             if (!w_lsa)
             {
                 continue;
@@ -827,7 +1259,7 @@ GlobalRouteManagerImpl::SPFNext(SPFVertex* v, CandidateQueue& candidate)
         // If the link is to a router that is already in the shortest path first tree
         // then we have it covered -- ignore it.
         //
-        if (w_lsa->GetStatus() == GlobalRoutingLSA::LSA_SPF_IN_SPFTREE)
+        if (GetLSAStatus(w_lsa) == GlobalRoutingLSA::LSA_SPF_IN_SPFTREE)
         {
             NS_LOG_LOGIC("Skipping ->  LSA " << w_lsa->GetLinkStateId() << " already in SPF tree");
             continue;
@@ -851,7 +1283,7 @@ GlobalRouteManagerImpl::SPFNext(SPFVertex* v, CandidateQueue& candidate)
         NS_LOG_LOGIC("Considering w_lsa " << w_lsa->GetLinkStateId());
 
         // Is there already vertex w in candidate list?
-        if (w_lsa->GetStatus() == GlobalRoutingLSA::LSA_SPF_NOT_EXPLORED)
+        if (GetLSAStatus(w_lsa) == GlobalRoutingLSA::LSA_SPF_NOT_EXPLORED)
         {
             // Calculate nexthop to w
             // We need to figure out how to actually get to the new router represented
@@ -860,10 +1292,10 @@ GlobalRouteManagerImpl::SPFNext(SPFVertex* v, CandidateQueue& candidate)
             // used to forward the packets.
 
             // prepare vertex w
-            w = new SPFVertex(w_lsa);
+            w = m_vertices.Create(w_lsa);
             if (SPFNexthopCalculation(v, w, l, distance))
             {
-                w_lsa->SetStatus(GlobalRoutingLSA::LSA_SPF_CANDIDATE);
+                SetLSAStatus(w_lsa, GlobalRoutingLSA::LSA_SPF_CANDIDATE);
                 //
                 // Push this new vertex onto the priority queue (ordered by distance from the
                 // root node).
@@ -880,7 +1312,7 @@ GlobalRouteManagerImpl::SPFNext(SPFVertex* v, CandidateQueue& candidate)
                                   << "return false, but it does now!");
             }
         }
-        else if (w_lsa->GetStatus() == GlobalRoutingLSA::LSA_SPF_CANDIDATE)
+        else if (GetLSAStatus(w_lsa) == GlobalRoutingLSA::LSA_SPF_CANDIDATE)
         {
             //
             // We have already considered the link represented by <w>.  What wse have to
@@ -925,8 +1357,9 @@ GlobalRouteManagerImpl::SPFNext(SPFVertex* v, CandidateQueue& candidate)
                 // (ospf_spf.c::859), although the detail implementation
                 // is very different from quagga (blame ns3::GlobalRouteManagerImpl)
 
-                // prepare vertex w
-                w = new SPFVertex(w_lsa);
+                // prepare vertex w, which only lives for the merge
+                SPFVertex ecmp(w_lsa);
+                w = &ecmp;
                 SPFNexthopCalculation(v, w, l, distance);
                 cw->MergeRootExitDirections(w);
                 cw->MergeParent(w);
@@ -934,7 +1367,6 @@ GlobalRouteManagerImpl::SPFNext(SPFVertex* v, CandidateQueue& candidate)
                 // SPFVertex checks if the vertex and its parent is linked
                 // bidirectionally
                 SPFVertexAddParent(w);
-                delete w;
             }
             else // cw->GetDistanceFromRoot () > w->GetDistanceFromRoot ()
             {
@@ -950,9 +1382,9 @@ GlobalRouteManagerImpl::SPFNext(SPFVertex* v, CandidateQueue& candidate)
                 {
                     //
                     // If we've changed the cost to get to the vertex represented by <w>, we
-                    // must reorder the priority queue keyed to that cost.
+                    // must move it up the priority queue keyed to that cost.
                     //
-                    candidate.Reorder();
+                    candidate.DecreaseKey(cw);
                 }
             } // new lower cost path found
         }     // end W is already on the candidate list
@@ -1234,7 +1666,22 @@ void
 GlobalRouteManagerImpl::DebugSPFCalculate(Ipv4Address root)
 {
     NS_LOG_FUNCTION(this << root);
+    SPFRoot spfroot;
+    spfroot.routerId = root;
+    spfroot.nodeId = 0;
+    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
+    {
+        Ptr<GlobalRouter> rtr = (*i)->GetObject<GlobalRouter>();
+        if (rtr && rtr->GetRouterId() == root)
+        {
+            spfroot = GetSPFRoot(*i, rtr);
+            break;
+        }
+    }
+    m_spfrootNode = &spfroot;
     SPFCalculate(root);
+    SPFInstallRoutes();
+    m_spfrootNode = nullptr;
 }
 
 //
@@ -1247,7 +1694,7 @@ bool
 GlobalRouteManagerImpl::CheckForStubNode(Ipv4Address root)
 {
     NS_LOG_FUNCTION(this << root);
-    GlobalRoutingLSA* rlsa = m_lsdb->GetLSA(root);
+    GlobalRoutingLSA* rlsa = LookupLSA(root);
     Ipv4Address myRouterId = rlsa->GetLinkStateId();
     int transits = 0;
     GlobalRoutingLinkRecord* transitLink = nullptr;
@@ -1291,7 +1738,7 @@ GlobalRouteManagerImpl::CheckForStubNode(Ipv4Address root)
             // Install default route to next hop
             // The link record LinkID is the router ID of the peer.
             // The Link Data is the local IP interface address
-            GlobalRoutingLSA* w_lsa = m_lsdb->GetLSA(transitLink->GetLinkId());
+            GlobalRoutingLSA* w_lsa = LookupLSA(transitLink->GetLinkId());
             uint32_t nLinkRecords = w_lsa->GetNLinkRecords();
             for (uint32_t j = 0; j < nLinkRecords; ++j)
             {
@@ -1307,14 +1754,11 @@ GlobalRouteManagerImpl::CheckForStubNode(Ipv4Address root)
                 if (lr->GetLinkId() == myRouterId)
                 {
                     // Next hop is stored in the LinkID field of lr
-                    Ptr<GlobalRouter> router = rlsa->GetNode()->GetObject<GlobalRouter>();
-                    NS_ASSERT(router);
-                    Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-                    NS_ASSERT(gr);
-                    gr->AddNetworkRouteTo(Ipv4Address("0.0.0.0"),
-                                          Ipv4Mask("0.0.0.0"),
-                                          lr->GetLinkData(),
-                                          FindOutgoingInterfaceId(transitLink->GetLinkData()));
+                    m_stagedRoutes.AddNetworkRouteTo(
+                        Ipv4Address("0.0.0.0"),
+                        Ipv4Mask("0.0.0.0"),
+                        lr->GetLinkData(),
+                        FindOutgoingInterfaceId(transitLink->GetLinkData()));
                     NS_LOG_LOGIC("Inserting default route for node "
                                  << myRouterId << " to next hop " << lr->GetLinkData()
                                  << " via interface "
@@ -1335,9 +1779,10 @@ GlobalRouteManagerImpl::SPFCalculate(Ipv4Address root)
 
     SPFVertex* v;
     //
-    // Initialize the Link State Database.
+    // Initialize the status of the LSAs.  It is kept here rather than in the
+    // LSAs so that the calculations of several roots can share the database.
     //
-    m_lsdb->Initialize();
+    m_lsaStatus.clear();
     //
     // The candidate queue is a priority queue of SPFVertex objects, with the top
     // of the queue being the closest vertex in terms of distance from the root
@@ -1350,14 +1795,14 @@ GlobalRouteManagerImpl::SPFCalculate(Ipv4Address root)
     // calculation.  Each router (and corresponding network) is a vertex in the
     // shortest path first (SPF) tree.
     //
-    v = new SPFVertex(m_lsdb->GetLSA(root));
+    v = m_vertices.Create(LookupLSA(root));
     //
     // This vertex is the root of the SPF tree and it is distance 0 from the root.
     // We also mark this vertex as being in the SPF tree.
     //
     m_spfroot = v;
     v->SetDistanceFromRoot(0);
-    v->GetLSA()->SetStatus(GlobalRoutingLSA::LSA_SPF_IN_SPFTREE);
+    SetLSAStatus(v->GetLSA(), GlobalRoutingLSA::LSA_SPF_IN_SPFTREE);
     NS_LOG_LOGIC("Starting SPFCalculate for node " << root);
 
     //
@@ -1367,10 +1812,11 @@ GlobalRouteManagerImpl::SPFCalculate(Ipv4Address root)
     // reached.  Instead, short-circuit this computation and just install
     // a default route in the CheckForStubNode() method.
     //
-    if (NodeList::GetNNodes() > 0 && CheckForStubNode(root))
+    if (m_spfrootNode && m_spfrootNode->router && CheckForStubNode(root))
     {
         NS_LOG_LOGIC("SPFCalculate truncated for stub node " << root);
-        delete m_spfroot;
+        m_vertices.Clear();
+        m_spfroot = nullptr;
         return;
     }
 
@@ -1418,7 +1864,7 @@ GlobalRouteManagerImpl::SPFCalculate(Ipv4Address root)
         // Update the status field of the vertex to indicate that it is in the SPF
         // tree.
         //
-        v->GetLSA()->SetStatus(GlobalRoutingLSA::LSA_SPF_IN_SPFTREE);
+        SetLSAStatus(v->GetLSA(), GlobalRoutingLSA::LSA_SPF_IN_SPFTREE);
         //
         // The current vertex has a parent pointer.  By calling this rather oddly
         // named method (blame quagga) we add the current vertex to the list of
@@ -1477,6 +1923,10 @@ GlobalRouteManagerImpl::SPFCalculate(Ipv4Address root)
 
     // Second stage of SPF calculation procedure
     SPFProcessStubs(m_spfroot);
+    if (m_dependencies)
+    {
+        m_dependencies->externals = true;
+    }
     for (uint32_t i = 0; i < m_lsdb->GetNumExtLSAs(); i++)
     {
         m_spfroot->ClearVertexProcessed();
@@ -1486,14 +1936,29 @@ GlobalRouteManagerImpl::SPFCalculate(Ipv4Address root)
     }
 
     //
-    // We're all done setting the routing information for the node at the root of
-    // the SPF tree.  Delete all of the vertices and corresponding resources.  Go
-    // possibly do it again for the next router.
+    // We're all done computing the routing information for the node at the root
+    // of the SPF tree.  Delete all of the vertices and corresponding resources;
+    // the caller installs the routes and possibly does it again for the next
+    // router.
     //
-    delete m_spfroot;
+    m_vertices.Clear();
     m_spfroot = nullptr;
 }
 
+void
+GlobalRouteManagerImpl::SPFInstallRoutes()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_spfrootNode && m_spfrootNode->router)
+    {
+        NS_LOG_LOGIC("Installing " << m_stagedRoutes.GetNRoutes() << " routes on node "
+                                   << m_spfrootNode->nodeId);
+        m_spfrootNode->router->GetRoutingProtocol()->SwapRoutes(m_stagedRoutes);
+    }
+    // m_stagedRoutes now holds the previous routes of the node (if any)
+    m_stagedRoutes.Clear();
+}
+
 void
 GlobalRouteManagerImpl::ProcessASExternals(SPFVertex* v, GlobalRoutingLSA* extlsa)
 {
@@ -1543,108 +2008,52 @@ GlobalRouteManagerImpl::SPFAddASExternal(GlobalRoutingLSA* extlsa, SPFVertex* v)
     }
     NS_LOG_LOGIC("External is on remote host: " << extlsa->GetAdvertisingRouter()
                                                 << "; installing");
-
-    Ipv4Address routerId = m_spfroot->GetVertexId();
-
-    NS_LOG_LOGIC("Vertex ID = " << routerId);
     //
-    // We need to walk the list of nodes looking for the one that has the router
-    // ID corresponding to the root vertex.  This is the one we're going to write
-    // the routing information to.
+    // The routes are written to the node at the root of the SPF tree, whose
+    // data was gathered before the calculation.  If it is not known there is
+    // nothing to write the routes to.
     //
-    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
+    if (!m_spfrootNode || !m_spfrootNode->router)
     {
-        Ptr<Node> node = *i;
-        //
-        // The router ID is accessible through the GlobalRouter interface, so we need
-        // to QI for that interface.  If there's no GlobalRouter interface, the node
-        // in question cannot be the router we want, so we continue.
-        //
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
+        NS_LOG_LOGIC("Can't find root node " << m_spfroot->GetVertexId());
+        return;
+    }
+    uint32_t nodeId = m_spfrootNode->nodeId;
+    NS_LOG_LOGIC("Setting routes for node " << nodeId);
+    NS_ASSERT_MSG(v->GetLSA(),
+                  "GlobalRouteManagerImpl::SPFAddASExternal (): "
+                  "Expected valid LSA in SPFVertex* v");
+    Ipv4Mask tempmask = extlsa->GetNetworkLSANetworkMask();
+    Ipv4Address tempip = extlsa->GetLinkStateId();
+    tempip = tempip.CombineMask(tempmask);
 
-        if (!rtr)
+    //
+    // The vertex <v> has the next hops and outbound interfaces precalculated
+    // for us that the root node should use to send packets to the advertising
+    // router, and so to the external network.
+    //
+    // walk through all next-hop-IPs and out-going-interfaces for reaching
+    // the stub network gateway 'v' from the root node
+    for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
+    {
+        SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
+        Ipv4Address nextHop = exit.first;
+        int32_t outIf = exit.second;
+        if (outIf >= 0)
         {
-            NS_LOG_LOGIC("No GlobalRouter interface on node " << node->GetId());
-            continue;
+            m_stagedRoutes.AddASExternalRouteTo(tempip, tempmask, nextHop, outIf);
+            NS_LOG_LOGIC("(Route " << i << ") Node " << nodeId << " add external network route to "
+                                   << tempip << " using next hop " << nextHop << " via interface "
+                                   << outIf);
         }
-        //
-        // If the router ID of the current node is equal to the router ID of the
-        // root of the SPF tree, then this node is the one for which we need to
-        // write the routing tables.
-        //
-        NS_LOG_LOGIC("Considering router " << rtr->GetRouterId());
-
-        if (rtr->GetRouterId() == routerId)
+        else
         {
-            NS_LOG_LOGIC("Setting routes for node " << node->GetId());
-            //
-            // Routing information is updated using the Ipv4 interface.  We need to QI
-            // for that interface.  If the node is acting as an IP version 4 router, it
-            // should absolutely have an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "QI for <Ipv4> interface failed");
-            //
-            // Get the Global Router Link State Advertisement from the vertex we're
-            // adding the routes to.  The LSA will have a number of attached Global Router
-            // Link Records corresponding to links off of that vertex / node.  We're going
-            // to be interested in the records corresponding to point-to-point links.
-            //
-            NS_ASSERT_MSG(v->GetLSA(),
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "Expected valid LSA in SPFVertex* v");
-            Ipv4Mask tempmask = extlsa->GetNetworkLSANetworkMask();
-            Ipv4Address tempip = extlsa->GetLinkStateId();
-            tempip = tempip.CombineMask(tempmask);
-
-            //
-            // Here's why we did all of that work.  We're going to add a host route to the
-            // host address found in the m_linkData field of the point-to-point link
-            // record.  In the case of a point-to-point link, this is the local IP address
-            // of the node connected to the link.  Each of these point-to-point links
-            // will correspond to a local interface that has an IP address to which
-            // the node at the root of the SPF tree can send packets.  The vertex <v>
-            // (corresponding to the node that has these links and interfaces) has
-            // an m_nextHop address precalculated for us that is the address to which the
-            // root node should send packets to be forwarded to these IP addresses.
-            // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
-            // which the packets should be send for forwarding.
-            //
-            Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
-            if (!router)
-            {
-                continue;
-            }
-            Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-            NS_ASSERT(gr);
-            // walk through all next-hop-IPs and out-going-interfaces for reaching
-            // the stub network gateway 'v' from the root node
-            for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
-            {
-                SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
-                Ipv4Address nextHop = exit.first;
-                int32_t outIf = exit.second;
-                if (outIf >= 0)
-                {
-                    gr->AddASExternalRouteTo(tempip, tempmask, nextHop, outIf);
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " add external network route to " << tempip
-                                           << " using next hop " << nextHop << " via interface "
-                                           << outIf);
-                }
-                else
-                {
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " NOT able to add network route to " << tempip
-                                           << " using next hop " << nextHop
-                                           << " since outgoing interface id is negative");
-                }
-            }
-            return;
-        } // if
-    }     // for
+            NS_LOG_LOGIC("(Route " << i << ") Node " << nodeId
+                                   << " NOT able to add network route to " << tempip
+                                   << " using next hop " << nextHop
+                                   << " since outgoing interface id is negative");
+        }
+    }
 }
 
 // Processing logic from RFC 2328, page 166 and quagga ospf_spf_process_stubs ()
@@ -1703,118 +2112,66 @@ GlobalRouteManagerImpl::SPFIntraAddStub(GlobalRoutingLinkRecord* l, SPFVertex* v
     NS_LOG_LOGIC("Stub is on remote host: " << v->GetVertexId() << "; installing");
     //
     // The root of the Shortest Path First tree is the router to which we are
-    // going to write the actual routing table entries.  The vertex corresponding
-    // to this router has a vertex ID which is the router ID of that node.  We're
-    // going to use this ID to discover which node it is that we're actually going
-    // to update.
+    // going to write the actual routing table entries.  Its data was gathered
+    // before the calculation started; if it is not known there is nothing to
+    // write the routes to.
     //
-    Ipv4Address routerId = m_spfroot->GetVertexId();
-
-    NS_LOG_LOGIC("Vertex ID = " << routerId);
+    if (!m_spfrootNode || !m_spfrootNode->router)
+    {
+        NS_LOG_LOGIC("Can't find root node " << m_spfroot->GetVertexId());
+        return;
+    }
+    uint32_t nodeId = m_spfrootNode->nodeId;
+    NS_LOG_LOGIC("Setting routes for node " << nodeId);
     //
-    // We need to walk the list of nodes looking for the one that has the router
-    // ID corresponding to the root vertex.  This is the one we're going to write
-    // the routing information to.
+    // Get the Global Router Link State Advertisement from the vertex we're
+    // adding the routes to.  The LSA will have a number of attached Global Router
+    // Link Records corresponding to links off of that vertex / node.  We're going
+    // to be interested in the records corresponding to point-to-point links.
     //
-    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
+    NS_ASSERT_MSG(v->GetLSA(),
+                  "GlobalRouteManagerImpl::SPFIntraAddStub (): "
+                  "Expected valid LSA in SPFVertex* v");
+    Ipv4Mask tempmask(l->GetLinkData().Get());
+    Ipv4Address tempip = l->GetLinkId();
+    tempip = tempip.CombineMask(tempmask);
+    //
+    // Here's why we did all of that work.  We're going to add a network route
+    // to the stub network found in the link record.  The vertex <v> (corresponding
+    // to the node that has the stub network) has an m_nextHop address
+    // precalculated for us that is the address to which the root node should
+    // send packets to be forwarded to this network.  Similarly, the vertex <v>
+    // has an m_rootOif (outbound interface index) to which the packets should
+    // be send for forwarding.
+    //
+    // walk through all next-hop-IPs and out-going-interfaces for reaching
+    // the stub network gateway 'v' from the root node
+    for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
     {
-        Ptr<Node> node = *i;
-        //
-        // The router ID is accessible through the GlobalRouter interface, so we need
-        // to QI for that interface.  If there's no GlobalRouter interface, the node
-        // in question cannot be the router we want, so we continue.
-        //
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
-
-        if (!rtr)
+        SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
+        Ipv4Address nextHop = exit.first;
+        int32_t outIf = exit.second;
+        if (outIf >= 0)
         {
-            NS_LOG_LOGIC("No GlobalRouter interface on node " << node->GetId());
-            continue;
+            m_stagedRoutes.AddNetworkRouteTo(tempip, tempmask, nextHop, outIf);
+            NS_LOG_LOGIC("(Route " << i << ") Node " << nodeId << " add network route to " << tempip
+                                   << " using next hop " << nextHop << " via interface "
+                                   << outIf);
         }
-        //
-        // If the router ID of the current node is equal to the router ID of the
-        // root of the SPF tree, then this node is the one for which we need to
-        // write the routing tables.
-        //
-        NS_LOG_LOGIC("Considering router " << rtr->GetRouterId());
-
-        if (rtr->GetRouterId() == routerId)
+        else
         {
-            NS_LOG_LOGIC("Setting routes for node " << node->GetId());
-            //
-            // Routing information is updated using the Ipv4 interface.  We need to QI
-            // for that interface.  If the node is acting as an IP version 4 router, it
-            // should absolutely have an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "QI for <Ipv4> interface failed");
-            //
-            // Get the Global Router Link State Advertisement from the vertex we're
-            // adding the routes to.  The LSA will have a number of attached Global Router
-            // Link Records corresponding to links off of that vertex / node.  We're going
-            // to be interested in the records corresponding to point-to-point links.
-            //
-            NS_ASSERT_MSG(v->GetLSA(),
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "Expected valid LSA in SPFVertex* v");
-            Ipv4Mask tempmask(l->GetLinkData().Get());
-            Ipv4Address tempip = l->GetLinkId();
-            tempip = tempip.CombineMask(tempmask);
-            //
-            // Here's why we did all of that work.  We're going to add a host route to the
-            // host address found in the m_linkData field of the point-to-point link
-            // record.  In the case of a point-to-point link, this is the local IP address
-            // of the node connected to the link.  Each of these point-to-point links
-            // will correspond to a local interface that has an IP address to which
-            // the node at the root of the SPF tree can send packets.  The vertex <v>
-            // (corresponding to the node that has these links and interfaces) has
-            // an m_nextHop address precalculated for us that is the address to which the
-            // root node should send packets to be forwarded to these IP addresses.
-            // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
-            // which the packets should be send for forwarding.
-            //
-
-            Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
-            if (!router)
-            {
-                continue;
-            }
-            Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-            NS_ASSERT(gr);
-            // walk through all next-hop-IPs and out-going-interfaces for reaching
-            // the stub network gateway 'v' from the root node
-            for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
-            {
-                SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
-                Ipv4Address nextHop = exit.first;
-                int32_t outIf = exit.second;
-                if (outIf >= 0)
-                {
-                    gr->AddNetworkRouteTo(tempip, tempmask, nextHop, outIf);
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " add network route to " << tempip
-                                           << " using next hop " << nextHop << " via interface "
-                                           << outIf);
-                }
-                else
-                {
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " NOT able to add network route to " << tempip
-                                           << " using next hop " << nextHop
-                                           << " since outgoing interface id is negative");
-                }
-            }
-            return;
-        } // if
-    }     // for
+            NS_LOG_LOGIC("(Route " << i << ") Node " << nodeId
+                                   << " NOT able to add network route to " << tempip
+                                   << " using next hop " << nextHop
+                                   << " since outgoing interface id is negative");
+        }
+    }
 }
 
 //
 // Return the interface number corresponding to a given IP address and mask
-// This is a wrapper around GetInterfaceForPrefix(), but we first
-// have to find the right node pointer to pass to that function.
+// This has the semantics of GetInterfaceForPrefix(), applied to the addresses
+// of the root node gathered before the calculation.
 // If no such interface is found, return -1 (note:  unit test framework
 // for routing assumes -1 to be a legal return value)
 //
@@ -1823,66 +2180,23 @@ GlobalRouteManagerImpl::FindOutgoingInterfaceId(Ipv4Address a, Ipv4Mask amask)
 {
     NS_LOG_FUNCTION(this << a << amask);
     //
-    // We have an IP address <a> and a vertex ID of the root of the SPF tree.
-    // The question is what interface index does this address correspond to.
-    // The answer is a little complicated since we have to find a pointer to
-    // the node corresponding to the vertex ID, find the Ipv4 interface on that
-    // node in order to iterate the interfaces and find the one corresponding to
-    // the address in question.
-    //
-    Ipv4Address routerId = m_spfroot->GetVertexId();
+    // We have an IP address <a> and the addresses of the interfaces of the
+    // node at the root of the SPF tree, in interface order.  Return the index
+    // of the first interface that has an address on the prefix, or -1 if
+    // there is none.
     //
-    // Walk the list of nodes in the system looking for the one corresponding to
-    // the node at the root of the SPF tree.  This is the node for which we are
-    // building the routing table.
-    //
-    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
+    if (!m_spfrootNode)
     {
-        Ptr<Node> node = *i;
-
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
-        //
-        // If the node doesn't have a GlobalRouter interface it can't be the one
-        // we're interested in.
-        //
-        if (!rtr)
-        {
-            continue;
-        }
-
-        if (rtr->GetRouterId() == routerId)
+        NS_LOG_LOGIC("FindOutgoingInterfaceId():Can't find root node");
+        return -1;
+    }
+    for (const auto& address : m_spfrootNode->addresses)
+    {
+        if (address.second.CombineMask(amask) == a.CombineMask(amask))
         {
-            //
-            // This is the node we're building the routing table for.  We're going to need
-            // the Ipv4 interface to look for the ipv4 interface index.  Since this node
-            // is participating in routing IP version 4 packets, it certainly must have
-            // an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::FindOutgoingInterfaceId (): "
-                          "GetObject for <Ipv4> interface failed");
-            //
-            // Look through the interfaces on this node for one that has the IP address
-            // we're looking for.  If we find one, return the corresponding interface
-            // index, or -1 if not found.
-            //
-            int32_t interface = ipv4->GetInterfaceForPrefix(a, amask);
-
-#if 0
-          if (interface < 0)
-            {
-              NS_FATAL_ERROR ("GlobalRouteManagerImpl::FindOutgoingInterfaceId(): "
-                              "Expected an interface associated with address a:" << a);
-            }
-#endif
-            return interface;
+            return address.first;
         }
     }
-    //
-    // Couldn't find it.
-    //
-    NS_LOG_LOGIC("FindOutgoingInterfaceId():Can't find root node " << routerId);
     return -1;
 }
 
@@ -1910,137 +2224,85 @@ GlobalRouteManagerImpl::SPFIntraAddRouter(SPFVertex* v)
     NS_ASSERT_MSG(m_spfroot, "GlobalRouteManagerImpl::SPFIntraAddRouter (): Root pointer not set");
     //
     // The root of the Shortest Path First tree is the router to which we are
-    // going to write the actual routing table entries.  The vertex corresponding
-    // to this router has a vertex ID which is the router ID of that node.  We're
-    // going to use this ID to discover which node it is that we're actually going
-    // to update.
+    // going to write the actual routing table entries.  Its data was gathered
+    // before the calculation started; if it is not known there is nothing to
+    // write the routes to.
+    //
+    if (!m_spfrootNode || !m_spfrootNode->router)
+    {
+        NS_LOG_LOGIC("Can't find root node " << m_spfroot->GetVertexId());
+        return;
+    }
+    uint32_t nodeId = m_spfrootNode->nodeId;
+    NS_LOG_LOGIC("Setting routes for node " << nodeId);
+    //
+    // Get the Global Router Link State Advertisement from the vertex we're
+    // adding the routes to.  The LSA will have a number of attached Global Router
+    // Link Records corresponding to links off of that vertex / node.  We're going
+    // to be interested in the records corresponding to point-to-point links.
     //
-    Ipv4Address routerId = m_spfroot->GetVertexId();
+    GlobalRoutingLSA* lsa = v->GetLSA();
+    NS_ASSERT_MSG(lsa,
+                  "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
+                  "Expected valid LSA in SPFVertex* v");
 
-    NS_LOG_LOGIC("Vertex ID = " << routerId);
+    uint32_t nLinkRecords = lsa->GetNLinkRecords();
     //
-    // We need to walk the list of nodes looking for the one that has the router
-    // ID corresponding to the root vertex.  This is the one we're going to write
-    // the routing information to.
+    // Iterate through the link records on the vertex to which we're going to add
+    // routes.  To make sure we're being clear, we're going to add routing table
+    // entries to the tables on the node corresping to the root of the SPF tree.
+    // These entries will have routes to the IP addresses we find from looking at
+    // the local side of the point-to-point links found on the node described by
+    // the vertex <v>.
     //
-    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
+    NS_LOG_LOGIC(" Node " << nodeId << " found " << nLinkRecords << " link records in LSA "
+                          << lsa << "with LinkStateId " << lsa->GetLinkStateId());
+    for (uint32_t j = 0; j < nLinkRecords; ++j)
     {
-        Ptr<Node> node = *i;
         //
-        // The router ID is accessible through the GlobalRouter interface, so we need
-        // to GetObject for that interface.  If there's no GlobalRouter interface,
-        // the node in question cannot be the router we want, so we continue.
+        // We are only concerned about point-to-point links
         //
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
-
-        if (!rtr)
+        GlobalRoutingLinkRecord* lr = lsa->GetLinkRecord(j);
+        if (lr->GetLinkType() != GlobalRoutingLinkRecord::PointToPoint)
         {
-            NS_LOG_LOGIC("No GlobalRouter interface on node " << node->GetId());
             continue;
         }
         //
-        // If the router ID of the current node is equal to the router ID of the
-        // root of the SPF tree, then this node is the one for which we need to
-        // write the routing tables.
+        // Here's why we did all of that work.  We're going to add a host route to the
+        // host address found in the m_linkData field of the point-to-point link
+        // record.  In the case of a point-to-point link, this is the local IP address
+        // of the node connected to the link.  Each of these point-to-point links
+        // will correspond to a local interface that has an IP address to which
+        // the node at the root of the SPF tree can send packets.  The vertex <v>
+        // (corresponding to the node that has these links and interfaces) has
+        // an m_nextHop address precalculated for us that is the address to which the
+        // root node should send packets to be forwarded to these IP addresses.
+        // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
+        // which the packets should be send for forwarding.
         //
-        NS_LOG_LOGIC("Considering router " << rtr->GetRouterId());
-
-        if (rtr->GetRouterId() == routerId)
+        // walk through all available exit directions due to ECMP,
+        // and add host route for each of the exit direction toward
+        // the vertex 'v'
+        for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
         {
-            NS_LOG_LOGIC("Setting routes for node " << node->GetId());
-            //
-            // Routing information is updated using the Ipv4 interface.  We need to
-            // GetObject for that interface.  If the node is acting as an IP version 4
-            // router, it should absolutely have an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "GetObject for <Ipv4> interface failed");
-            //
-            // Get the Global Router Link State Advertisement from the vertex we're
-            // adding the routes to.  The LSA will have a number of attached Global Router
-            // Link Records corresponding to links off of that vertex / node.  We're going
-            // to be interested in the records corresponding to point-to-point links.
-            //
-            GlobalRoutingLSA* lsa = v->GetLSA();
-            NS_ASSERT_MSG(lsa,
-                          "GlobalRouteManagerImpl::SPFIntraAddRouter (): "
-                          "Expected valid LSA in SPFVertex* v");
-
-            uint32_t nLinkRecords = lsa->GetNLinkRecords();
-            //
-            // Iterate through the link records on the vertex to which we're going to add
-            // routes.  To make sure we're being clear, we're going to add routing table
-            // entries to the tables on the node corresping to the root of the SPF tree.
-            // These entries will have routes to the IP addresses we find from looking at
-            // the local side of the point-to-point links found on the node described by
-            // the vertex <v>.
-            //
-            NS_LOG_LOGIC(" Node " << node->GetId() << " found " << nLinkRecords
-                                  << " link records in LSA " << lsa << "with LinkStateId "
-                                  << lsa->GetLinkStateId());
-            for (uint32_t j = 0; j < nLinkRecords; ++j)
+            SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
+            Ipv4Address nextHop = exit.first;
+            int32_t outIf = exit.second;
+            if (outIf >= 0)
             {
-                //
-                // We are only concerned about point-to-point links
-                //
-                GlobalRoutingLinkRecord* lr = lsa->GetLinkRecord(j);
-                if (lr->GetLinkType() != GlobalRoutingLinkRecord::PointToPoint)
-                {
-                    continue;
-                }
-                //
-                // Here's why we did all of that work.  We're going to add a host route to the
-                // host address found in the m_linkData field of the point-to-point link
-                // record.  In the case of a point-to-point link, this is the local IP address
-                // of the node connected to the link.  Each of these point-to-point links
-                // will correspond to a local interface that has an IP address to which
-                // the node at the root of the SPF tree can send packets.  The vertex <v>
-                // (corresponding to the node that has these links and interfaces) has
-                // an m_nextHop address precalculated for us that is the address to which the
-                // root node should send packets to be forwarded to these IP addresses.
-                // Similarly, the vertex <v> has an m_rootOif (outbound interface index) to
-                // which the packets should be send for forwarding.
-                //
-                Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
-                if (!router)
-                {
-                    continue;
-                }
-                Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-                NS_ASSERT(gr);
-                // walk through all available exit directions due to ECMP,
-                // and add host route for each of the exit direction toward
-                // the vertex 'v'
-                for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
-                {
-                    SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
-                    Ipv4Address nextHop = exit.first;
-                    int32_t outIf = exit.second;
-                    if (outIf >= 0)
-                    {
-                        gr->AddHostRouteTo(lr->GetLinkData(), nextHop, outIf);
-                        NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                               << " adding host route to " << lr->GetLinkData()
-                                               << " using next hop " << nextHop
-                                               << " and outgoing interface " << outIf);
-                    }
-                    else
-                    {
-                        NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                               << " NOT able to add host route to "
-                                               << lr->GetLinkData() << " using next hop " << nextHop
-                                               << " since outgoing interface id is negative "
-                                               << outIf);
-                    }
-                } // for all routes from the root the vertex 'v'
+                m_stagedRoutes.AddHostRouteTo(lr->GetLinkData(), nextHop, outIf);
+                NS_LOG_LOGIC("(Route " << i << ") Node " << nodeId << " adding host route to "
+                                       << lr->GetLinkData() << " using next hop " << nextHop
+                                       << " and outgoing interface " << outIf);
             }
-            //
-            // Done adding the routes for the selected node.
-            //
-            return;
-        }
+            else
+            {
+                NS_LOG_LOGIC("(Route " << i << ") Node " << nodeId
+                                       << " NOT able to add host route to " << lr->GetLinkData()
+                                       << " using next hop " << nextHop
+                                       << " since outgoing interface id is negative " << outIf);
+            }
+        } // for all routes from the root the vertex 'v'
     }
 }
 
@@ -2052,98 +2314,51 @@ GlobalRouteManagerImpl::SPFIntraAddTransit(SPFVertex* v)
     NS_ASSERT_MSG(m_spfroot, "GlobalRouteManagerImpl::SPFIntraAddTransit (): Root pointer not set");
     //
     // The root of the Shortest Path First tree is the router to which we are
-    // going to write the actual routing table entries.  The vertex corresponding
-    // to this router has a vertex ID which is the router ID of that node.  We're
-    // going to use this ID to discover which node it is that we're actually going
-    // to update.
+    // going to write the actual routing table entries.  Its data was gathered
+    // before the calculation started; if it is not known there is nothing to
+    // write the routes to.
     //
-    Ipv4Address routerId = m_spfroot->GetVertexId();
-
-    NS_LOG_LOGIC("Vertex ID = " << routerId);
+    if (!m_spfrootNode || !m_spfrootNode->router)
+    {
+        NS_LOG_LOGIC("Can't find root node " << m_spfroot->GetVertexId());
+        return;
+    }
+    uint32_t nodeId = m_spfrootNode->nodeId;
+    NS_LOG_LOGIC("setting routes for node " << nodeId);
     //
-    // We need to walk the list of nodes looking for the one that has the router
-    // ID corresponding to the root vertex.  This is the one we're going to write
-    // the routing information to.
+    // Get the Global Router Link State Advertisement from the vertex we're
+    // adding the routes to.  The LSA of a transit network vertex describes the
+    // network, to which we add a network route.
     //
-    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
+    GlobalRoutingLSA* lsa = v->GetLSA();
+    NS_ASSERT_MSG(lsa,
+                  "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
+                  "Expected valid LSA in SPFVertex* v");
+    Ipv4Mask tempmask = lsa->GetNetworkLSANetworkMask();
+    Ipv4Address tempip = lsa->GetLinkStateId();
+    tempip = tempip.CombineMask(tempmask);
+    // walk through all available exit directions due to ECMP,
+    // and add host route for each of the exit direction toward
+    // the vertex 'v'
+    for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
     {
-        Ptr<Node> node = *i;
-        //
-        // The router ID is accessible through the GlobalRouter interface, so we need
-        // to GetObject for that interface.  If there's no GlobalRouter interface,
-        // the node in question cannot be the router we want, so we continue.
-        //
-        Ptr<GlobalRouter> rtr = node->GetObject<GlobalRouter>();
+        SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
+        Ipv4Address nextHop = exit.first;
+        int32_t outIf = exit.second;
 
-        if (!rtr)
+        if (outIf >= 0)
         {
-            NS_LOG_LOGIC("No GlobalRouter interface on node " << node->GetId());
-            continue;
+            m_stagedRoutes.AddNetworkRouteTo(tempip, tempmask, nextHop, outIf);
+            NS_LOG_LOGIC("(Route " << i << ") Node " << nodeId << " add network route to " << tempip
+                                   << " using next hop " << nextHop << " via interface "
+                                   << outIf);
         }
-        //
-        // If the router ID of the current node is equal to the router ID of the
-        // root of the SPF tree, then this node is the one for which we need to
-        // write the routing tables.
-        //
-        NS_LOG_LOGIC("Considering router " << rtr->GetRouterId());
-
-        if (rtr->GetRouterId() == routerId)
+        else
         {
-            NS_LOG_LOGIC("setting routes for node " << node->GetId());
-            //
-            // Routing information is updated using the Ipv4 interface.  We need to
-            // GetObject for that interface.  If the node is acting as an IP version 4
-            // router, it should absolutely have an Ipv4 interface.
-            //
-            Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
-            NS_ASSERT_MSG(ipv4,
-                          "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
-                          "GetObject for <Ipv4> interface failed");
-            //
-            // Get the Global Router Link State Advertisement from the vertex we're
-            // adding the routes to.  The LSA will have a number of attached Global Router
-            // Link Records corresponding to links off of that vertex / node.  We're going
-            // to be interested in the records corresponding to point-to-point links.
-            //
-            GlobalRoutingLSA* lsa = v->GetLSA();
-            NS_ASSERT_MSG(lsa,
-                          "GlobalRouteManagerImpl::SPFIntraAddTransit (): "
-                          "Expected valid LSA in SPFVertex* v");
-            Ipv4Mask tempmask = lsa->GetNetworkLSANetworkMask();
-            Ipv4Address tempip = lsa->GetLinkStateId();
-            tempip = tempip.CombineMask(tempmask);
-            Ptr<GlobalRouter> router = node->GetObject<GlobalRouter>();
-            if (!router)
-            {
-                continue;
-            }
-            Ptr<Ipv4GlobalRouting> gr = router->GetRoutingProtocol();
-            NS_ASSERT(gr);
-            // walk through all available exit directions due to ECMP,
-            // and add host route for each of the exit direction toward
-            // the vertex 'v'
-            for (uint32_t i = 0; i < v->GetNRootExitDirections(); i++)
-            {
-                SPFVertex::NodeExit_t exit = v->GetRootExitDirection(i);
-                Ipv4Address nextHop = exit.first;
-                int32_t outIf = exit.second;
-
-                if (outIf >= 0)
-                {
-                    gr->AddNetworkRouteTo(tempip, tempmask, nextHop, outIf);
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " add network route to " << tempip
-                                           << " using next hop " << nextHop << " via interface "
-                                           << outIf);
-                }
-                else
-                {
-                    NS_LOG_LOGIC("(Route " << i << ") Node " << node->GetId()
-                                           << " NOT able to add network route to " << tempip
-                                           << " using next hop " << nextHop
-                                           << " since outgoing interface id is negative " << outIf);
-                }
-            }
+            NS_LOG_LOGIC("(Route " << i << ") Node " << nodeId
+                                   << " NOT able to add network route to " << tempip
+                                   << " using next hop " << nextHop
+                                   << " since outgoing interface id is negative " << outIf);
         }
     }
 }
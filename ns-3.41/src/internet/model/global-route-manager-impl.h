@@ -22,6 +22,7 @@
 #define GLOBAL_ROUTE_MANAGER_IMPL_H
 
 #include "global-router-interface.h"
+#include "ipv4-routing-table.h"
 
 #include "ns3/ipv4-address.h"
 #include "ns3/object.h"
@@ -31,6 +32,7 @@
 #include <map>
 #include <queue>
 #include <stdint.h>
+#include <unordered_map>
 #include <vector>
 
 namespace ns3
@@ -547,6 +549,10 @@ class SPFVertex
     ListOfSPFVertex_t m_children;                    //!< Children list
     bool m_vertexProcessed; //!< Flag to note whether vertex has been processed in stage two of SPF
                             //!< computation
+    uint32_t m_candidatePosition; //!< Position in the heap of the CandidateQueue holding the vertex
+
+    friend class CandidateQueue;
+    friend class GlobalRouteManagerImpl;
 
     /**
      * \brief Stream insertion operator.
@@ -679,6 +685,8 @@ class GlobalRouteManagerLSDB
         LSDBPair_t; //!< pair of IPv4 addresses / Link State Advertisements
 
     LSDBMap_t m_database; //!< database of IPv4 addresses / Link State Advertisements
+    /// LSAs by the link data of their transit network link records
+    std::unordered_map<Ipv4Address, GlobalRoutingLSA*, Ipv4AddressHash> m_linkDataIndex;
     std::vector<GlobalRoutingLSA*>
         m_extdatabase; //!< database of External Link State Advertisements
 };
@@ -725,6 +733,21 @@ class GlobalRouteManagerImpl
      */
     virtual void InitializeRoutes();
 
+    /**
+     * @brief Rebuild the routing database and recompute the routes of the
+     * routers whose last SPF computation depends on something that changed.
+     *
+     * The SPF computation of each router records the LSAs it looked up.  The
+     * new database is compared with the previous one, and only the routers
+     * that looked up a changed LSA, processed changed external LSAs or had
+     * the addresses of their interfaces changed are computed again; the
+     * routes of the other routers are left in place.  When there is no
+     * previous computation to compare with, or the set of routers changed,
+     * this falls back to DeleteGlobalRoutes (), BuildGlobalRoutingDatabase ()
+     * and InitializeRoutes ().
+     */
+    virtual void UpdateRoutes();
+
     /**
      * @brief Debugging routine; allow client code to supply a pre-built LSDB
      * @param lsdb the pre-built LSDB
@@ -738,8 +761,181 @@ class GlobalRouteManagerImpl
     void DebugSPFCalculate(Ipv4Address root);
 
   private:
+    /// Local addresses of a node, with the index of their interface, in interface order
+    typedef std::vector<std::pair<int32_t, Ipv4Address>> InterfaceAddresses_t;
+
+    /**
+     * \brief Data of the node at the root of an SPF calculation.
+     *
+     * It is gathered before the calculation starts, so that the calculation
+     * does not need to search the node list or to query the node objects
+     * (which allows it to run outside of the main thread).
+     */
+    struct SPFRoot
+    {
+        Ipv4Address routerId;           //!< router ID of the root
+        uint32_t nodeId;                //!< node ID of the root
+        Ptr<GlobalRouter> router;       //!< GlobalRouter of the root, null if not found
+        InterfaceAddresses_t addresses; //!< local addresses of the root
+    };
+
+    /**
+     * \brief What the SPF calculation of a root depends on.
+     */
+    struct SPFDependencies
+    {
+        std::vector<bool> lsas;         //!< link state IDs looked up, by key index
+        std::vector<bool> linkData;     //!< link data looked up, by key index
+        bool externals{false};          //!< whether the external LSAs were processed
+        InterfaceAddresses_t addresses; //!< local addresses of the root
+    };
+
+    /**
+     * \brief Dense indexes of the addresses used to look LSAs up.
+     *
+     * The keys are kept across database rebuilds, so that the dependencies
+     * recorded against a database can be checked against the next one.
+     */
+    struct LSAKeys
+    {
+        std::unordered_map<Ipv4Address, uint32_t, Ipv4AddressHash> lsas; //!< link state IDs
+        std::unordered_map<Ipv4Address, uint32_t, Ipv4AddressHash>
+            linkData; //!< link data of transit network link records
+    };
+
+    /**
+     * \brief Create a worker sharing the LSDB of another instance.
+     *
+     * Workers run SPF calculations in their own thread; they do not own the
+     * LSDB nor install any route.
+     *
+     * \param lsdb the LSDB
+     * \param keys the lookup keys of the LSDB
+     */
+    GlobalRouteManagerImpl(GlobalRouteManagerLSDB* lsdb, const LSAKeys* keys);
+
+    /**
+     * \brief Storage of the vertices of SPF trees.
+     *
+     * The vertices are constructed in chunks of memory that are kept from one
+     * SPF calculation to the next, and they are all released at once when the
+     * tree is no longer needed, rather than one by one by deleting the root.
+     */
+    class SPFVertexArena
+    {
+      public:
+        SPFVertexArena();
+        ~SPFVertexArena();
+
+        // Delete copy constructor and assignment operator to avoid misuse
+        SPFVertexArena(const SPFVertexArena&) = delete;
+        SPFVertexArena& operator=(const SPFVertexArena&) = delete;
+
+        /**
+         * \brief Create a vertex.
+         * \param lsa the LSA of the vertex
+         * \returns the vertex, valid until the next Clear ()
+         */
+        SPFVertex* Create(GlobalRoutingLSA* lsa);
+
+        /**
+         * \brief Release all the vertices created.
+         */
+        void Clear();
+
+      private:
+        static const std::size_t CHUNK_SIZE = 256; //!< number of vertices per chunk
+        std::vector<SPFVertex*> m_chunks;          //!< storage of the vertices
+        std::size_t m_size;                        //!< number of vertices created
+    };
+
     SPFVertex* m_spfroot;           //!< the root node
+    SPFVertexArena m_vertices;      //!< vertices of the SPF tree
     GlobalRouteManagerLSDB* m_lsdb; //!< the Link State DataBase (LSDB) of the Global Route Manager
+    bool m_ownsLsdb;                //!< whether m_lsdb is deleted with this instance
+    Ipv4RoutingTable m_stagedRoutes; //!< routes computed for the current SPF root
+    const SPFRoot* m_spfrootNode;    //!< node data of the current SPF root, null if unknown
+    /// SPF status of the LSAs in the current calculation, absent if not explored
+    std::unordered_map<const GlobalRoutingLSA*, GlobalRoutingLSA::SPFStatus> m_lsaStatus;
+    LSAKeys m_lsaKeys;               //!< lookup keys of the LSDB
+    const LSAKeys* m_keys;           //!< lookup keys used to record the dependencies
+    bool m_keysComplete;             //!< whether every LSA of m_lsdb has its keys in m_lsaKeys
+    SPFDependencies* m_dependencies; //!< dependencies of the current calculation, if recorded
+    /// Dependencies of the last SPF calculation of each root, by router ID
+    std::unordered_map<Ipv4Address, SPFDependencies, Ipv4AddressHash> m_rootDependencies;
+
+    /**
+     * \brief Remove the routes installed by global routing on every node.
+     */
+    void ClearRoutes();
+
+    /**
+     * \brief Get the routers to run an SPF calculation for.
+     * \returns the routers of this system that advertise LSAs, in node order
+     */
+    std::vector<SPFRoot> GetSPFRoots() const;
+
+    /**
+     * \brief Gather the data of a node needed by an SPF calculation rooted at it.
+     * \param node the node
+     * \param router the GlobalRouter of the node
+     * \returns the root data
+     */
+    SPFRoot GetSPFRoot(Ptr<Node> node, Ptr<GlobalRouter> router) const;
+
+    /**
+     * \brief Run the SPF calculation of each root and install the routes.
+     *
+     * The calculations run in a pool of threads sized by the
+     * GlobalRoutingThreads global value; the routes are installed from the
+     * calling thread.
+     *
+     * \param roots the roots to compute the routes of
+     */
+    void ComputeRoutes(const std::vector<SPFRoot>& roots);
+
+    /**
+     * \brief Register the lookup keys of an LSA.
+     * \param lsa the LSA
+     */
+    void AddLSAKeys(const GlobalRoutingLSA* lsa);
+
+    /**
+     * \brief Look an LSA up by link state ID, recording the dependency.
+     * \param id the link state ID
+     * \returns the LSA, or null if there is none
+     */
+    GlobalRoutingLSA* LookupLSA(Ipv4Address id);
+
+    /**
+     * \brief Look an LSA up by the link data of a transit network link record,
+     * recording the dependency.
+     * \param linkData the link data
+     * \returns the LSA, or null if there is none
+     */
+    GlobalRoutingLSA* LookupLSAByLinkData(Ipv4Address linkData);
+
+    /**
+     * \brief Get the SPF status of an LSA in the current calculation.
+     * \param lsa the LSA
+     * \returns the status
+     */
+    GlobalRoutingLSA::SPFStatus GetLSAStatus(const GlobalRoutingLSA* lsa) const;
+
+    /**
+     * \brief Set the SPF status of an LSA in the current calculation.
+     * \param lsa the LSA
+     * \param status the status
+     */
+    void SetLSAStatus(const GlobalRoutingLSA* lsa, GlobalRoutingLSA::SPFStatus status);
+
+    /**
+     * \brief Compare the contents of two LSAs.
+     * \param a the first LSA, may be null
+     * \param b the second LSA, may be null
+     * \returns true if both are null, or both have the same contents
+     */
+    static bool IsSameLSA(const GlobalRoutingLSA* a, const GlobalRoutingLSA* b);
 
     /**
      * \brief Test if a node is a stub, from an OSPF sense.
@@ -756,7 +952,8 @@ class GlobalRouteManagerImpl
     /**
      * \brief Calculate the shortest path first (SPF) tree
      *
-     * Equivalent to quagga ospf_spf_calculate
+     * Equivalent to quagga ospf_spf_calculate.  The routes are accumulated in
+     * m_stagedRoutes; installing them is left to the caller.
      * \param root the root node
      */
     void SPFCalculate(Ipv4Address root);
@@ -907,11 +1104,20 @@ class GlobalRouteManagerImpl
      */
     void SPFAddASExternal(GlobalRoutingLSA* extlsa, SPFVertex* v);
 
+    /**
+     * \brief Install the routes computed for a root in its routing table
+     *
+     * The routes accumulated in m_stagedRoutes during the SPF calculation
+     * replace the routing table of the node in a single swap, and the old
+     * routes are released.
+     */
+    void SPFInstallRoutes();
+
     /**
      * \brief Return the interface number corresponding to a given IP address and mask
      *
-     * This is a wrapper around GetInterfaceForPrefix(), but we first
-     * have to find the right node pointer to pass to that function.
+     * This has the semantics of GetInterfaceForPrefix() on the node at the
+     * root of the SPF tree, using the addresses gathered in m_spfrootNode.
      * If no such interface is found, return -1 (note:  unit test framework
      * for routing assumes -1 to be a legal return value)
      *
@@ -70,6 +70,14 @@ class GlobalRouteManager
      * per-node forwarding tables
      */
     static void InitializeRoutes();
+
+    /**
+     * @brief Rebuild the routing database and recompute the routes of the
+     * routers affected by the changes since the last computation.
+     *
+     * @see GlobalRouteManagerImpl::UpdateRoutes
+     */
+    static void UpdateRoutes();
 };
 
 } // namespace ns3
@@ -34,6 +34,7 @@
 
 #include <list>
 #include <stdint.h>
+#include <vector>
 
 namespace ns3
 {
@@ -530,15 +531,16 @@ class GlobalRoutingLSA
     /**
      * A convenience typedef to avoid too much writers cramp.
      */
-    typedef std::list<GlobalRoutingLinkRecord*> ListOfLinkRecords_t;
+    typedef std::vector<GlobalRoutingLinkRecord*> ListOfLinkRecords_t;
 
     /**
      * Each Link State Advertisement contains a number of Link Records that
      * describe the kinds of links that are attached to a given node.  We
      * consider PointToPoint and StubNetwork links.
      *
-     * m_linkRecords is an STL list container to hold the Link Records that have
-     * been discovered and prepared for the advertisement.
+     * m_linkRecords is an STL vector container to hold the Link Records that have
+     * been discovered and prepared for the advertisement.  The SPF calculation
+     * walks them by index.
      *
      * @see GlobalRouting::DiscoverLSAs ()
      */
@@ -552,12 +554,12 @@ class GlobalRoutingLSA
     /**
      * A convenience typedef to avoid too much writers cramp.
      */
-    typedef std::list<Ipv4Address> ListOfAttachedRouters_t;
+    typedef std::vector<Ipv4Address> ListOfAttachedRouters_t;
 
     /**
      * Each Network LSA contains a list of attached routers
      *
-     * m_attachedRouters is an STL list container to hold the addresses that have
+     * m_attachedRouters is an STL vector container to hold the addresses that have
      * been discovered and prepared for the advertisement.
      *
      * @see GlobalRouting::DiscoverLSAs ()
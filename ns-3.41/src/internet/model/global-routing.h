@@ -54,8 +54,10 @@
  * ns3::GlobalRouteManager::PopulateRoutingTables (), prior to the
  * ns3::Simulator::Run() call.
  *
- * There are two attributes of Ipv4GlobalRouting that govern behavior.
+ * These attributes of Ipv4GlobalRouting govern behavior.
  * - Ipv4GlobalRouting::RandomEcmpRouting
+ * - Ipv4GlobalRouting::FlowEcmpRouting, with Ipv4GlobalRouting::EcmpHashSeed
+ *   and Ipv4GlobalRouting::EcmpBuckets
  * - Ipv4GlobalRouting::RespondToInterfaceEvents
  *
  * \section impl Implementation
@@ -20,8 +20,13 @@
 #include "global-route-manager.h"
 #include "ipv4-route.h"
 #include "ipv4-routing-table-entry.h"
+#include "ipv4-routing-table.h"
+#include "tcp-header.h"
+#include "udp-header.h"
 
+#include "ns3/abort.h"
 #include "ns3/boolean.h"
+#include "ns3/hash.h"
 #include "ns3/log.h"
 #include "ns3/names.h"
 #include "ns3/net-device.h"
@@ -29,7 +34,9 @@
 #include "ns3/object.h"
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
+#include "ns3/uinteger.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <vector>
 
@@ -58,13 +65,36 @@ Ipv4GlobalRouting::GetTypeId()
                           "Interface notification events (up/down, or add/remove address)",
                           BooleanValue(false),
                           MakeBooleanAccessor(&Ipv4GlobalRouting::m_respondToInterfaceEvents),
-                          MakeBooleanChecker());
+                          MakeBooleanChecker())
+            .AddAttribute("FlowEcmpRouting",
+                          "Set to true if packets are routed among ECMP by the hash of their "
+                          "5-tuple, so that the packets of a flow follow the same route; takes "
+                          "precedence over RandomEcmpRouting",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&Ipv4GlobalRouting::m_flowEcmpRouting),
+                          MakeBooleanChecker())
+            .AddAttribute("EcmpHashSeed",
+                          "The seed of the ECMP flow hash; routers with different seeds spread "
+                          "the flows independently",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&Ipv4GlobalRouting::m_ecmpHashSeed),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("EcmpBuckets",
+                          "The number of hash buckets shared by the next hops of a destination",
+                          UintegerValue(64),
+                          MakeUintegerAccessor(&Ipv4GlobalRouting::m_ecmpBuckets),
+                          MakeUintegerChecker<uint16_t>(1));
     return tid;
 }
 
 Ipv4GlobalRouting::Ipv4GlobalRouting()
     : m_randomEcmpRouting(false),
-      m_respondToInterfaceEvents(false)
+      m_respondToInterfaceEvents(false),
+      m_flowEcmpRouting(false),
+      m_ecmpHashSeed(0),
+      m_ecmpBuckets(64),
+      m_networkRoutesOrder(0),
+      m_nextHopGroupsDirty(true)
 {
     NS_LOG_FUNCTION(this);
 
@@ -83,6 +113,8 @@ Ipv4GlobalRouting::AddHostRouteTo(Ipv4Address dest, Ipv4Address nextHop, uint32_
     auto route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateHostRouteTo(dest, nextHop, interface);
     m_hostRoutes.push_back(route);
+    m_hostRoutesIndex.Insert(route->GetDest(), Ipv4Mask::GetOnes(), route);
+    m_nextHopGroupsDirty = true;
 }
 
 void
@@ -92,6 +124,8 @@ Ipv4GlobalRouting::AddHostRouteTo(Ipv4Address dest, uint32_t interface)
     auto route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateHostRouteTo(dest, interface);
     m_hostRoutes.push_back(route);
+    m_hostRoutesIndex.Insert(route->GetDest(), Ipv4Mask::GetOnes(), route);
+    m_nextHopGroupsDirty = true;
 }
 
 void
@@ -104,6 +138,8 @@ Ipv4GlobalRouting::AddNetworkRouteTo(Ipv4Address network,
     auto route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, nextHop, interface);
     m_networkRoutes.push_back(route);
+    IndexNetworkRoute(route);
+    m_nextHopGroupsDirty = true;
 }
 
 void
@@ -113,6 +149,8 @@ Ipv4GlobalRouting::AddNetworkRouteTo(Ipv4Address network, Ipv4Mask networkMask,
     auto route = new Ipv4RoutingTableEntry();
     *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, interface);
     m_networkRoutes.push_back(route);
+    IndexNetworkRoute(route);
+    m_nextHopGroupsDirty = true;
 }
 
 void
@@ -128,21 +166,29 @@ Ipv4GlobalRouting::AddASExternalRouteTo(Ipv4Address network,
 }
 
 Ptr<Ipv4Route>
-Ipv4GlobalRouting::LookupGlobal(Ipv4Address dest, Ptr<NetDevice> oif)
+Ipv4GlobalRouting::LookupGlobal(Ipv4Address dest, Ptr<NetDevice> oif, uint32_t flowHash)
 {
-    NS_LOG_FUNCTION(this << dest << oif);
+    NS_LOG_FUNCTION(this << dest << oif << flowHash);
     NS_LOG_LOGIC("Looking for route for destination " << dest);
-    Ptr<Ipv4Route> rtentry = nullptr;
+    if (m_flowEcmpRouting && !oif)
+    {
+        Ptr<Ipv4Route> rtentry = LookupNextHopGroup(dest, flowHash);
+        if (rtentry)
+        {
+            return rtentry;
+        }
+    }
     // store all available routes that bring packets to their destination
     typedef std::vector<Ipv4RoutingTableEntry*> RouteVec_t;
     RouteVec_t allRoutes;
 
     NS_LOG_LOGIC("Number of m_hostRoutes = " << m_hostRoutes.size());
-    for (auto i = m_hostRoutes.begin(); i != m_hostRoutes.end(); i++)
+    const auto* hostRoutes = m_hostRoutesIndex.Find(dest, Ipv4Mask::GetOnes());
+    if (hostRoutes)
     {
-        NS_ASSERT((*i)->IsHost());
-        if ((*i)->GetDest() == dest)
+        for (auto i = hostRoutes->begin(); i != hostRoutes->end(); i++)
         {
+            NS_ASSERT((*i)->IsHost());
             if (oif)
             {
                 if (oif != m_ipv4->GetNetDevice((*i)->GetInterface()))
@@ -158,23 +204,60 @@ Ipv4GlobalRouting::LookupGlobal(Ipv4Address dest, Ptr<NetDevice> oif)
     if (allRoutes.empty()) // if no host route is found
     {
         NS_LOG_LOGIC("Number of m_networkRoutes" << m_networkRoutes.size());
-        for (auto j = m_networkRoutes.begin(); j != m_networkRoutes.end(); j++)
-        {
-            Ipv4Mask mask = (*j)->GetDestNetworkMask();
-            Ipv4Address entry = (*j)->GetDestNetwork();
-            if (mask.IsMatch(dest, entry))
-            {
-                if (oif)
+        // Every matching network is a candidate, whatever its prefix length,
+        // and candidates are considered in the order the routes were added.
+        // Each index bucket keeps its routes in that order, so the candidate
+        // following a given position is the smallest first eligible route
+        // at or after that position across the matching buckets.
+        auto nextCandidate = [&](uint64_t from, uint32_t* nCandidates) {
+            const NetworkRouteRef* next = nullptr;
+            m_networkRoutesIndex.Lookup(dest, [&](uint16_t, const auto& bucket) {
+                for (const auto& ref : bucket)
                 {
-                    if (oif != m_ipv4->GetNetDevice((*j)->GetInterface()))
+                    if (ref.order < from)
                     {
-                        NS_LOG_LOGIC("Not on requested interface, skipping");
                         continue;
                     }
+                    if (oif)
+                    {
+                        if (oif != m_ipv4->GetNetDevice(ref.route->GetInterface()))
+                        {
+                            NS_LOG_LOGIC("Not on requested interface, skipping");
+                            continue;
+                        }
+                    }
+                    if (!next || ref.order < next->order)
+                    {
+                        next = &ref;
+                    }
+                    if (!nCandidates)
+                    {
+                        break;
+                    }
+                    (*nCandidates)++;
                 }
-                allRoutes.push_back(*j);
-                NS_LOG_LOGIC(allRoutes.size() << "Found global network route" << *j);
+                return false;
+            });
+            return next;
+        };
+        // Candidates only need counting to draw one at random
+        uint32_t nCandidates = 0;
+        const NetworkRouteRef* candidate =
+            nextCandidate(0, m_randomEcmpRouting ? &nCandidates : nullptr);
+        if (candidate)
+        {
+            uint32_t selectIndex = 0;
+            if (m_randomEcmpRouting)
+            {
+                NS_LOG_LOGIC(nCandidates << " global network routes found");
+                selectIndex = m_rand->GetInteger(0, nCandidates - 1);
+            }
+            for (uint32_t i = 0; i < selectIndex; i++)
+            {
+                candidate = nextCandidate(candidate->order + 1, nullptr);
             }
+            NS_LOG_LOGIC("Selected global network route " << candidate->route);
+            return CreateRoute(candidate->route);
         }
     }
     if (allRoutes.empty()) // consider external if no host/network found
@@ -213,21 +296,279 @@ Ipv4GlobalRouting::LookupGlobal(Ipv4Address dest, Ptr<NetDevice> oif)
         {
             selectIndex = 0;
         }
-        Ipv4RoutingTableEntry* route = allRoutes.at(selectIndex);
-        // create a Ipv4Route object from the selected routing table entry
-        rtentry = Create<Ipv4Route>();
-        rtentry->SetDestination(route->GetDest());
-        /// \todo handle multi-address case
-        rtentry->SetSource(m_ipv4->GetAddress(route->GetInterface(), 0).GetLocal());
-        rtentry->SetGateway(route->GetGateway());
-        uint32_t interfaceIdx = route->GetInterface();
-        rtentry->SetOutputDevice(m_ipv4->GetNetDevice(interfaceIdx));
-        return rtentry;
+        return CreateRoute(allRoutes.at(selectIndex));
+    }
+    else
+    {
+        return nullptr;
+    }
+}
+
+Ptr<Ipv4Route>
+Ipv4GlobalRouting::LookupNextHopGroup(Ipv4Address dest, uint32_t flowHash)
+{
+    NS_LOG_FUNCTION(this << dest << flowHash);
+    if (m_nextHopGroupsDirty)
+    {
+        UpdateNextHopGroups();
+    }
+
+    // Host routes come first, then every matching network is a candidate.
+    // Unless several networks match, the group of the destination holds
+    // the candidates.
+    std::vector<Ipv4RoutingTableEntry*> routes;
+    uint32_t nNetworks = 0;
+    const auto* hostRoutes = m_hostRoutesIndex.Find(dest, Ipv4Mask::GetOnes());
+    if (hostRoutes)
+    {
+        routes.push_back(hostRoutes->front());
+        nNetworks = 1;
     }
     else
+    {
+        m_networkRoutesIndex.Lookup(dest, [&](uint16_t, const auto& bucket) {
+            for (const auto& ref : bucket)
+            {
+                routes.push_back(ref.route);
+            }
+            nNetworks++;
+            return false;
+        });
+    }
+    if (routes.empty())
     {
         return nullptr;
     }
+
+    Ptr<NextHopGroup> group;
+    if (nNetworks == 1)
+    {
+        Ipv4Mask mask = routes.front()->GetDestNetworkMask();
+        uint64_t key = (uint64_t(routes.front()->GetDestNetwork().CombineMask(mask).Get()) << 32) |
+                       mask.Get();
+        auto it = m_destinationGroups.find(key);
+        NS_ASSERT_MSG(it != m_destinationGroups.end(), "No next-hop group for " << dest);
+        group = it->second;
+    }
+    else
+    {
+        std::vector<NextHop> nextHops;
+        for (const auto& route : routes)
+        {
+            nextHops.emplace_back(route->GetGateway(), route->GetInterface());
+        }
+        std::sort(nextHops.begin(), nextHops.end());
+        nextHops.erase(std::unique(nextHops.begin(), nextHops.end()), nextHops.end());
+        group = CreateNextHopGroup(nextHops, nullptr);
+    }
+
+    const NextHop& nextHop = group->nextHops[group->buckets[flowHash % group->buckets.size()]];
+    NS_LOG_LOGIC("Selected next hop " << nextHop.first << " on interface " << nextHop.second
+                                      << " among " << group->nextHops.size());
+    // The destination of the route is the network of its first matching entry
+    Ipv4Address network = routes.front()->GetDest();
+    for (const auto& route : routes)
+    {
+        if (route->GetGateway() == nextHop.first && route->GetInterface() == nextHop.second)
+        {
+            network = route->GetDest();
+            break;
+        }
+    }
+    return CreateRoute(network, nextHop);
+}
+
+uint32_t
+Ipv4GlobalRouting::GetFlowHash(const Ipv4Header& header, Ptr<const Packet> p) const
+{
+    NS_LOG_FUNCTION(this << header << p);
+
+    uint8_t prot = header.GetProtocol();
+    uint16_t srcPort = 0;
+    uint16_t destPort = 0;
+    if (p && header.GetFragmentOffset() == 0)
+    {
+        if (prot == 6) // TCP
+        {
+            TcpHeader tcpHdr;
+            p->PeekHeader(tcpHdr);
+            srcPort = tcpHdr.GetSourcePort();
+            destPort = tcpHdr.GetDestinationPort();
+        }
+        else if (prot == 17) // UDP
+        {
+            UdpHeader udpHdr;
+            p->PeekHeader(udpHdr);
+            srcPort = udpHdr.GetSourcePort();
+            destPort = udpHdr.GetDestinationPort();
+        }
+    }
+
+    /* serialize the 5-tuple and the seed in buf */
+    uint8_t buf[17];
+    header.GetSource().Serialize(buf);
+    header.GetDestination().Serialize(buf + 4);
+    buf[8] = prot;
+    buf[9] = (srcPort >> 8) & 0xff;
+    buf[10] = srcPort & 0xff;
+    buf[11] = (destPort >> 8) & 0xff;
+    buf[12] = destPort & 0xff;
+    buf[13] = (m_ecmpHashSeed >> 24) & 0xff;
+    buf[14] = (m_ecmpHashSeed >> 16) & 0xff;
+    buf[15] = (m_ecmpHashSeed >> 8) & 0xff;
+    buf[16] = m_ecmpHashSeed & 0xff;
+    return Hash32((char*)buf, 17);
+}
+
+void
+Ipv4GlobalRouting::UpdateNextHopGroups()
+{
+    NS_LOG_FUNCTION(this);
+
+    // Gather the next hops of each destination
+    std::unordered_map<uint64_t, std::vector<NextHop>> destinations;
+    for (const auto& route : m_hostRoutes)
+    {
+        uint64_t key = (uint64_t(route->GetDest().Get()) << 32) | Ipv4Mask::GetOnes().Get();
+        destinations[key].emplace_back(route->GetGateway(), route->GetInterface());
+    }
+    for (const auto& route : m_networkRoutes)
+    {
+        Ipv4Mask mask = route->GetDestNetworkMask();
+        uint64_t key =
+            (uint64_t(route->GetDestNetwork().CombineMask(mask).Get()) << 32) | mask.Get();
+        destinations[key].emplace_back(route->GetGateway(), route->GetInterface());
+    }
+
+    // Destinations with the same next hops share a group, built from the
+    // former group of the first of them
+    std::unordered_map<uint64_t, Ptr<NextHopGroup>> destinationGroups;
+    std::map<std::vector<NextHop>, Ptr<NextHopGroup>> nextHopGroups;
+    for (auto& [key, nextHops] : destinations)
+    {
+        std::sort(nextHops.begin(), nextHops.end());
+        nextHops.erase(std::unique(nextHops.begin(), nextHops.end()), nextHops.end());
+        Ptr<NextHopGroup>& group = nextHopGroups[nextHops];
+        if (!group)
+        {
+            auto previous = m_destinationGroups.find(key);
+            group = CreateNextHopGroup(
+                nextHops,
+                previous != m_destinationGroups.end() ? previous->second : nullptr);
+        }
+        destinationGroups[key] = group;
+    }
+    NS_LOG_LOGIC(destinationGroups.size() << " destinations share " << nextHopGroups.size()
+                                          << " next-hop groups");
+    m_destinationGroups.swap(destinationGroups);
+    m_nextHopGroups.swap(nextHopGroups);
+    m_nextHopGroupsDirty = false;
+}
+
+Ptr<Ipv4GlobalRouting::NextHopGroup>
+Ipv4GlobalRouting::CreateNextHopGroup(const std::vector<NextHop>& nextHops,
+                                      Ptr<const NextHopGroup> previous) const
+{
+    NS_LOG_FUNCTION(this << nextHops.size() << previous);
+
+    Ptr<NextHopGroup> group = Create<NextHopGroup>();
+    group->nextHops = nextHops;
+    uint32_t nBuckets = std::max<uint32_t>(m_ecmpBuckets, nextHops.size());
+
+    // Share the buckets in proportion to the weights, the remainder going
+    // to the first next hops
+    uint64_t totalWeight = 0;
+    for (const auto& nextHop : nextHops)
+    {
+        totalWeight += GetInterfaceWeight(nextHop.second);
+    }
+    std::vector<uint32_t> shares;
+    uint32_t nShared = 0;
+    for (const auto& nextHop : nextHops)
+    {
+        shares.push_back(nBuckets * GetInterfaceWeight(nextHop.second) / totalWeight);
+        nShared += shares.back();
+    }
+    for (uint32_t i = 0; nShared < nBuckets; i = (i + 1) % shares.size(), nShared++)
+    {
+        shares[i]++;
+    }
+
+    // The buckets of the former group keep their next hop if it remains,
+    // up to its share, the other buckets go to the next hops short of
+    // their share
+    group->buckets.assign(nBuckets, UINT16_MAX);
+    if (previous && previous->buckets.size() == nBuckets)
+    {
+        for (uint32_t i = 0; i < nBuckets; i++)
+        {
+            const NextHop& nextHop = previous->nextHops[previous->buckets[i]];
+            auto it = std::lower_bound(nextHops.begin(), nextHops.end(), nextHop);
+            if (it != nextHops.end() && *it == nextHop && shares[it - nextHops.begin()] > 0)
+            {
+                group->buckets[i] = it - nextHops.begin();
+                shares[it - nextHops.begin()]--;
+            }
+        }
+    }
+    uint16_t index = 0;
+    for (auto& bucket : group->buckets)
+    {
+        if (bucket == UINT16_MAX)
+        {
+            while (shares[index] == 0)
+            {
+                index++;
+            }
+            bucket = index;
+            shares[index]--;
+        }
+    }
+    return group;
+}
+
+void
+Ipv4GlobalRouting::SetInterfaceWeight(uint32_t interface, uint16_t weight)
+{
+    NS_LOG_FUNCTION(this << interface << weight);
+    NS_ABORT_MSG_IF(weight == 0, "The weight of an interface must be at least 1");
+    if (interface >= m_interfaceWeights.size())
+    {
+        m_interfaceWeights.resize(interface + 1, 1);
+    }
+    m_interfaceWeights[interface] = weight;
+    m_nextHopGroupsDirty = true;
+}
+
+uint16_t
+Ipv4GlobalRouting::GetInterfaceWeight(uint32_t interface) const
+{
+    return interface < m_interfaceWeights.size() ? m_interfaceWeights[interface] : 1;
+}
+
+uint32_t
+Ipv4GlobalRouting::GetNNextHopGroups() const
+{
+    return m_nextHopGroups.size();
+}
+
+Ptr<Ipv4Route>
+Ipv4GlobalRouting::CreateRoute(Ipv4Address dest, const NextHop& nextHop) const
+{
+    Ptr<Ipv4Route> rtentry = Create<Ipv4Route>();
+    rtentry->SetDestination(dest);
+    /// \todo handle multi-address case
+    rtentry->SetSource(m_ipv4->GetAddress(nextHop.second, 0).GetLocal());
+    rtentry->SetGateway(nextHop.first);
+    rtentry->SetOutputDevice(m_ipv4->GetNetDevice(nextHop.second));
+    return rtentry;
+}
+
+Ptr<Ipv4Route>
+Ipv4GlobalRouting::CreateRoute(Ipv4RoutingTableEntry* route) const
+{
+    // create a Ipv4Route object from the selected routing table entry
+    return CreateRoute(route->GetDest(), NextHop(route->GetGateway(), route->GetInterface()));
 }
 
 uint32_t
@@ -297,6 +638,8 @@ Ipv4GlobalRouting::RemoveRoute(uint32_t index)
             if (tmp == index)
             {
                 NS_LOG_LOGIC("Removing route " << index << "; size = " << m_hostRoutes.size());
+                m_hostRoutesIndex.Remove((*i)->GetDest(), Ipv4Mask::GetOnes(), *i);
+                m_nextHopGroupsDirty = true;
                 delete *i;
                 m_hostRoutes.erase(i);
                 NS_LOG_LOGIC("Done removing host route "
@@ -313,6 +656,10 @@ Ipv4GlobalRouting::RemoveRoute(uint32_t index)
         if (tmp == index)
         {
             NS_LOG_LOGIC("Removing route " << index << "; size = " << m_networkRoutes.size());
+            m_networkRoutesIndex.Remove((*j)->GetDestNetwork(),
+                                        (*j)->GetDestNetworkMask(),
+                                        NetworkRouteRef{*j, 0});
+            m_nextHopGroupsDirty = true;
             delete *j;
             m_networkRoutes.erase(j);
             NS_LOG_LOGIC("Done removing network route "
@@ -339,6 +686,41 @@ Ipv4GlobalRouting::RemoveRoute(uint32_t index)
     NS_ASSERT(false);
 }
 
+void
+Ipv4GlobalRouting::SwapRoutes(Ipv4RoutingTable& table)
+{
+    NS_LOG_FUNCTION(this << &table);
+    NS_LOG_LOGIC("Installing " << table.GetNRoutes() << " routes, replacing " << GetNRoutes());
+    table.Swap(m_hostRoutes, m_networkRoutes, m_ASexternalRoutes);
+    RebuildRoutesIndex();
+}
+
+void
+Ipv4GlobalRouting::IndexNetworkRoute(Ipv4RoutingTableEntry* route)
+{
+    m_networkRoutesIndex.Insert(route->GetDestNetwork(),
+                                route->GetDestNetworkMask(),
+                                NetworkRouteRef{route, m_networkRoutesOrder++});
+}
+
+void
+Ipv4GlobalRouting::RebuildRoutesIndex()
+{
+    NS_LOG_FUNCTION(this);
+    m_hostRoutesIndex.Clear();
+    m_networkRoutesIndex.Clear();
+    m_networkRoutesOrder = 0;
+    m_nextHopGroupsDirty = true;
+    for (auto i = m_hostRoutes.begin(); i != m_hostRoutes.end(); i++)
+    {
+        m_hostRoutesIndex.Insert((*i)->GetDest(), Ipv4Mask::GetOnes(), *i);
+    }
+    for (auto j = m_networkRoutes.begin(); j != m_networkRoutes.end(); j++)
+    {
+        IndexNetworkRoute(*j);
+    }
+}
+
 int64_t
 Ipv4GlobalRouting::AssignStreams(int64_t stream)
 {
@@ -364,6 +746,10 @@ Ipv4GlobalRouting::DoDispose()
     {
         delete (*l);
     }
+    m_hostRoutesIndex.Clear();
+    m_networkRoutesIndex.Clear();
+    m_destinationGroups.clear();
+    m_nextHopGroups.clear();
 
     Ipv4RoutingProtocol::DoDispose();
 }
@@ -456,7 +842,11 @@ Ipv4GlobalRouting::RouteOutput(Ptr<Packet> p,
     // See if this is a unicast packet we have a route for.
     //
     NS_LOG_LOGIC("Unicast destination- looking up");
-    Ptr<Ipv4Route> rtentry = LookupGlobal(header.GetDestination(), oif);
+    // Locally generated packets do not carry their transport header yet
+    Ptr<Ipv4Route> rtentry =
+        LookupGlobal(header.GetDestination(),
+                     oif,
+                     m_flowEcmpRouting ? GetFlowHash(header, nullptr) : 0);
     if (rtentry)
     {
         sockerr = Socket::ERROR_NOTERROR;
@@ -511,7 +901,8 @@ Ipv4GlobalRouting::RouteInput(Ptr<const Packet> p,
     }
     // Next, try to find a route
     NS_LOG_LOGIC("Unicast destination- looking up global route");
-    Ptr<Ipv4Route> rtentry = LookupGlobal(header.GetDestination());
+    Ptr<Ipv4Route> rtentry =
+        LookupGlobal(header.GetDestination(), nullptr, m_flowEcmpRouting ? GetFlowHash(header, p) : 0);
     if (rtentry)
     {
         NS_LOG_LOGIC("Found unicast destination- calling unicast callback");
@@ -532,9 +923,7 @@ Ipv4GlobalRouting::NotifyInterfaceUp(uint32_t i)
     NS_LOG_FUNCTION(this << i);
     if (m_respondToInterfaceEvents && Simulator::Now().GetSeconds() > 0) // avoid startup events
     {
-        GlobalRouteManager::DeleteGlobalRoutes();
-        GlobalRouteManager::BuildGlobalRoutingDatabase();
-        GlobalRouteManager::InitializeRoutes();
+        GlobalRouteManager::UpdateRoutes();
     }
 }
 
@@ -544,9 +933,7 @@ Ipv4GlobalRouting::NotifyInterfaceDown(uint32_t i)
     NS_LOG_FUNCTION(this << i);
     if (m_respondToInterfaceEvents && Simulator::Now().GetSeconds() > 0) // avoid startup events
     {
-        GlobalRouteManager::DeleteGlobalRoutes();
-        GlobalRouteManager::BuildGlobalRoutingDatabase();
-        GlobalRouteManager::InitializeRoutes();
+        GlobalRouteManager::UpdateRoutes();
     }
 }
 
@@ -556,9 +943,7 @@ Ipv4GlobalRouting::NotifyAddAddress(uint32_t interface, Ipv4InterfaceAddress add
     NS_LOG_FUNCTION(this << interface << address);
     if (m_respondToInterfaceEvents && Simulator::Now().GetSeconds() > 0) // avoid startup events
     {
-        GlobalRouteManager::DeleteGlobalRoutes();
-        GlobalRouteManager::BuildGlobalRoutingDatabase();
-        GlobalRouteManager::InitializeRoutes();
+        GlobalRouteManager::UpdateRoutes();
     }
 }
 
@@ -568,9 +953,7 @@ Ipv4GlobalRouting::NotifyRemoveAddress(uint32_t interface, Ipv4InterfaceAddress
     NS_LOG_FUNCTION(this << interface << address);
     if (m_respondToInterfaceEvents && Simulator::Now().GetSeconds() > 0) // avoid startup events
     {
-        GlobalRouteManager::DeleteGlobalRoutes();
-        GlobalRouteManager::BuildGlobalRoutingDatabase();
-        GlobalRouteManager::InitializeRoutes();
+        GlobalRouteManager::UpdateRoutes();
     }
 }
 
@@ -20,15 +20,20 @@
 #define IPV4_GLOBAL_ROUTING_H
 
 #include "ipv4-header.h"
+#include "ipv4-routing-prefix-index.h"
 #include "ipv4-routing-protocol.h"
 #include "ipv4.h"
 
 #include "ns3/ipv4-address.h"
 #include "ns3/ptr.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/simple-ref-count.h"
 
 #include <list>
+#include <map>
 #include <stdint.h>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
@@ -38,6 +43,7 @@ class NetDevice;
 class Ipv4Interface;
 class Ipv4Address;
 class Ipv4Header;
+class Ipv4RoutingTable;
 class Ipv4RoutingTableEntry;
 class Ipv4MulticastRoutingTableEntry;
 class Node;
@@ -66,6 +72,17 @@ class Node;
  *
  * This class deals with Ipv4 unicast routes only.
  *
+ * When several equal-cost routes lead to a destination, the first one is
+ * used, unless RandomEcmpRouting picks one at random for each packet, or
+ * FlowEcmpRouting picks one by hashing the 5-tuple of each packet, so that
+ * the packets of a flow follow the same path.  Flow hashing stores the next
+ * hops of each destination once per router as a next-hop group, shared by
+ * all the destinations reached through the same next hops.  Each group maps
+ * a fixed number of hash buckets to its next hops, in proportion to the
+ * weights of their interfaces (see SetInterfaceWeight), and keeps this
+ * mapping as far as possible when the routes change (resilient hashing):
+ * when a next hop disappears, only the flows it carried move.
+ *
  * \see Ipv4RoutingProtocol
  * \see GlobalRouteManager
  */
@@ -222,6 +239,49 @@ class Ipv4GlobalRouting : public Ipv4RoutingProtocol
      */
     void RemoveRoute(uint32_t i);
 
+    /**
+     * \brief Replace the whole unicast routing table in a single step.
+     *
+     * The routes held by \p table become the routes of this protocol, and
+     * \p table receives the routes that were previously installed.  No
+     * routing table entry is copied, so installing the result of an SPF run
+     * costs the same whatever the size of the table.  The caller is
+     * responsible for clearing \p table to release the old routes.
+     *
+     * \param table the new set of routes
+     *
+     * \see Ipv4RoutingTable
+     */
+    void SwapRoutes(Ipv4RoutingTable& table);
+
+    /**
+     * \brief Set the weight of the next hops reached through an interface.
+     *
+     * With FlowEcmpRouting, the equal-cost routes to a destination share
+     * its flows in proportion to the weights of their interfaces
+     * (weighted-cost multipath).  All the interfaces weigh 1 by default.
+     *
+     * \param interface the interface index
+     * \param weight the weight, at least 1
+     */
+    void SetInterfaceWeight(uint32_t interface, uint16_t weight);
+
+    /**
+     * \brief Get the weight of the next hops reached through an interface.
+     * \param interface the interface index
+     * \return the weight
+     */
+    uint16_t GetInterfaceWeight(uint32_t interface) const;
+
+    /**
+     * \brief Get the number of next-hop groups used by FlowEcmpRouting.
+     *
+     * The groups are built on the first lookup after a change of the routes.
+     *
+     * \return the number of distinct sets of next hops
+     */
+    uint32_t GetNNextHopGroups() const;
+
     /**
      * Assign a fixed random variable stream number to the random variables
      * used by this model.  Return the number of streams (possibly zero) that
@@ -244,6 +304,12 @@ class Ipv4GlobalRouting : public Ipv4RoutingProtocol
     bool m_respondToInterfaceEvents;
     /// A uniform random number generator for randomly routing packets among ECMP
     Ptr<UniformRandomVariable> m_rand;
+    /// Set to true if packets are routed among ECMP by the hash of their 5-tuple
+    bool m_flowEcmpRouting;
+    /// Seed of the ECMP hash, different seeds spread the flows differently
+    uint32_t m_ecmpHashSeed;
+    /// Number of hash buckets of a next-hop group
+    uint16_t m_ecmpBuckets;
 
     /// container of Ipv4RoutingTableEntry (routes to hosts)
     typedef std::list<Ipv4RoutingTableEntry*> HostRoutes;
@@ -266,18 +332,128 @@ class Ipv4GlobalRouting : public Ipv4RoutingProtocol
     /// iterator of container of Ipv4RoutingTableEntry (routes to external AS)
     typedef std::list<Ipv4RoutingTableEntry*>::iterator ASExternalRoutesI;
 
+    /**
+     * \brief Network route stored in the prefix index, with its position in
+     * m_networkRoutes so that matches can be returned in list order.
+     */
+    struct NetworkRouteRef
+    {
+        Ipv4RoutingTableEntry* route; //!< the route
+        uint64_t order;               //!< insertion order of the route
+
+        /**
+         * \param other the reference to compare with
+         * \return true if both reference the same route
+         */
+        bool operator==(const NetworkRouteRef& other) const
+        {
+            return route == other.route;
+        }
+    };
+
+    /// A next hop: gateway and output interface
+    typedef std::pair<Ipv4Address, uint32_t> NextHop;
+
+    /**
+     * \brief Next hops shared by the destinations routed through them.
+     *
+     * A flow is mapped to a bucket by its hash, and each bucket to a next
+     * hop.  Each next hop holds a share of the buckets proportional to the
+     * weight of its interface.
+     */
+    struct NextHopGroup : public SimpleRefCount<NextHopGroup>
+    {
+        std::vector<NextHop> nextHops; //!< the next hops, sorted
+        std::vector<uint16_t> buckets; //!< index in nextHops of the next hop of each bucket
+    };
+
     /**
      * \brief Lookup in the forwarding table for destination.
      * \param dest destination address
      * \param oif output interface if any (put 0 otherwise)
+     * \param flowHash hash of the packet, used by FlowEcmpRouting
      * \return Ipv4Route to route the packet to reach dest address
      */
-    Ptr<Ipv4Route> LookupGlobal(Ipv4Address dest, Ptr<NetDevice> oif = nullptr);
+    Ptr<Ipv4Route> LookupGlobal(Ipv4Address dest,
+                                Ptr<NetDevice> oif = nullptr,
+                                uint32_t flowHash = 0);
+
+    /**
+     * \brief Lookup the next-hop group of a destination, for FlowEcmpRouting.
+     * \param dest destination address
+     * \param flowHash hash of the packet
+     * \return Ipv4Route to route the packet to reach dest address, or null
+     * if there is no host or network route to dest
+     */
+    Ptr<Ipv4Route> LookupNextHopGroup(Ipv4Address dest, uint32_t flowHash);
+
+    /**
+     * \brief Hash the 5-tuple of a packet.
+     * \param header the IPv4 header of the packet
+     * \param p the packet, starting with its transport header, or null if
+     * the packet does not carry its transport header yet
+     * \return the hash of the packet
+     */
+    uint32_t GetFlowHash(const Ipv4Header& header, Ptr<const Packet> p) const;
+
+    /**
+     * \brief Build the next-hop groups of the destinations from the routes.
+     *
+     * A destination keeps the buckets of its former group that still lead
+     * to one of its next hops, as far as the weights allow.
+     */
+    void UpdateNextHopGroups();
+
+    /**
+     * \brief Create a next-hop group.
+     * \param nextHops the next hops, sorted
+     * \param previous the former group of the destination, if any
+     * \return the group
+     */
+    Ptr<NextHopGroup> CreateNextHopGroup(const std::vector<NextHop>& nextHops,
+                                         Ptr<const NextHopGroup> previous) const;
+
+    /**
+     * \brief Create the Ipv4Route to a next hop.
+     * \param dest the destination of the route
+     * \param nextHop the next hop
+     * \return the Ipv4Route
+     */
+    Ptr<Ipv4Route> CreateRoute(Ipv4Address dest, const NextHop& nextHop) const;
+
+    /**
+     * \brief Create the Ipv4Route for a routing table entry.
+     * \param route the selected routing table entry
+     * \return the Ipv4Route
+     */
+    Ptr<Ipv4Route> CreateRoute(Ipv4RoutingTableEntry* route) const;
+
+    /**
+     * \brief Add a network route to the prefix index.
+     * \param route the route, already appended to m_networkRoutes
+     */
+    void IndexNetworkRoute(Ipv4RoutingTableEntry* route);
+
+    /**
+     * \brief Rebuild the prefix indexes from the route lists.
+     */
+    void RebuildRoutesIndex();
 
     HostRoutes m_hostRoutes;             //!< Routes to hosts
     NetworkRoutes m_networkRoutes;       //!< Routes to networks
     ASExternalRoutes m_ASexternalRoutes; //!< External routes imported
 
+    Ipv4RoutingPrefixIndex<HostRoutes::value_type> m_hostRoutesIndex; //!< Index of m_hostRoutes
+    Ipv4RoutingPrefixIndex<NetworkRouteRef> m_networkRoutesIndex; //!< Index of m_networkRoutes
+    uint64_t m_networkRoutesOrder; //!< insertion order of the next network route
+
+    /// Next-hop groups by destination network (high 32 bits) and mask
+    std::unordered_map<uint64_t, Ptr<NextHopGroup>> m_destinationGroups;
+    /// Next-hop groups by next hops
+    std::map<std::vector<NextHop>, Ptr<NextHopGroup>> m_nextHopGroups;
+    bool m_nextHopGroupsDirty;                //!< whether the routes changed since the groups were built
+    std::vector<uint16_t> m_interfaceWeights; //!< weight of each interface
+
     Ptr<Ipv4> m_ipv4; //!< associated IPv4 instance
 };
 
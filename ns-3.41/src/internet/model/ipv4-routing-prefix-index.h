@@ -0,0 +1,233 @@
+/*
+ * Copyright (c) 2024 Liverpool Hope University, UK
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef IPV4_ROUTING_PREFIX_INDEX_H
+#define IPV4_ROUTING_PREFIX_INDEX_H
+
+#include "ns3/ipv4-address.h"
+
+#include <algorithm>
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup ipv4Routing
+ *
+ * \brief Longest-prefix-match index over a routing table.
+ *
+ * The index does not own the routes: it stores a value per route (usually
+ * a pointer to the Ipv4RoutingTableEntry, possibly with some extra
+ * information) and is kept in sync by the routing protocol whenever a
+ * route is added to or removed from its lists.
+ *
+ * Routes are grouped by network mask, and within a mask by masked network
+ * address in a hash table.  A lookup probes one hash bucket per distinct
+ * mask, from the most to the least specific, so its cost depends on the
+ * number of distinct prefix lengths (at most 33 for contiguous masks)
+ * rather than on the number of routes.
+ *
+ * Values sharing the same network and mask are kept in insertion order, so
+ * that a routing protocol can reproduce the tie-breaking of a sequential
+ * scan of its route list.
+ *
+ * \tparam T the type of the values stored for each route
+ */
+template <typename T>
+class Ipv4RoutingPrefixIndex
+{
+  public:
+    /// Values sharing the same network and mask, in insertion order
+    typedef std::vector<T> Bucket;
+
+    Ipv4RoutingPrefixIndex();
+
+    /**
+     * \brief Add a route to the index.
+     * \param network the destination network (host bits are ignored)
+     * \param mask the network mask
+     * \param value the value stored for the route
+     */
+    void Insert(Ipv4Address network, Ipv4Mask mask, const T& value);
+
+    /**
+     * \brief Remove a route from the index.
+     * \param network the destination network (host bits are ignored)
+     * \param mask the network mask
+     * \param value the value stored for the route
+     * \return true if the route was found
+     */
+    bool Remove(Ipv4Address network, Ipv4Mask mask, const T& value);
+
+    /**
+     * \brief Remove every route from the index.
+     */
+    void Clear();
+
+    /**
+     * \return the number of routes in the index
+     */
+    uint32_t GetSize() const;
+
+    /**
+     * \brief Get the routes to exactly one network.
+     * \param network the destination network (host bits are ignored)
+     * \param mask the network mask
+     * \return the routes, or nullptr if there are none
+     */
+    const Bucket* Find(Ipv4Address network, Ipv4Mask mask) const;
+
+    /**
+     * \brief Visit the routes matching a destination.
+     *
+     * The visitor is invoked as `bool visitor(uint16_t prefixLength, const
+     * Bucket& bucket)` once per network containing \p dest, from the longest
+     * to the shortest prefix.  Returning true stops the walk.
+     *
+     * \param dest the destination address
+     * \param visitor the visitor
+     */
+    template <typename Visitor>
+    void Lookup(Ipv4Address dest, Visitor visitor) const;
+
+  private:
+    /// Routes sharing the same network mask
+    struct MaskTable
+    {
+        uint32_t mask;                                 //!< the network mask
+        uint16_t prefixLength;                         //!< the prefix length of the mask
+        std::unordered_map<uint32_t, Bucket> buckets; //!< routes by masked network
+    };
+
+    std::vector<MaskTable> m_tables; //!< tables sorted by decreasing prefix length
+    uint32_t m_size;                 //!< number of routes
+};
+
+template <typename T>
+Ipv4RoutingPrefixIndex<T>::Ipv4RoutingPrefixIndex()
+    : m_size(0)
+{
+}
+
+template <typename T>
+void
+Ipv4RoutingPrefixIndex<T>::Insert(Ipv4Address network, Ipv4Mask mask, const T& value)
+{
+    auto table = std::find_if(m_tables.begin(), m_tables.end(), [&mask](const MaskTable& t) {
+        return t.mask == mask.Get();
+    });
+    if (table == m_tables.end())
+    {
+        MaskTable newTable;
+        newTable.mask = mask.Get();
+        newTable.prefixLength = mask.GetPrefixLength();
+        auto position =
+            std::find_if(m_tables.begin(), m_tables.end(), [&newTable](const MaskTable& t) {
+                return t.prefixLength < newTable.prefixLength;
+            });
+        table = m_tables.insert(position, std::move(newTable));
+    }
+    table->buckets[network.Get() & table->mask].push_back(value);
+    m_size++;
+}
+
+template <typename T>
+bool
+Ipv4RoutingPrefixIndex<T>::Remove(Ipv4Address network, Ipv4Mask mask, const T& value)
+{
+    for (auto table = m_tables.begin(); table != m_tables.end(); table++)
+    {
+        if (table->mask != mask.Get())
+        {
+            continue;
+        }
+        auto bucket = table->buckets.find(network.Get() & table->mask);
+        if (bucket == table->buckets.end())
+        {
+            return false;
+        }
+        auto it = std::find(bucket->second.begin(), bucket->second.end(), value);
+        if (it == bucket->second.end())
+        {
+            return false;
+        }
+        bucket->second.erase(it);
+        m_size--;
+        if (bucket->second.empty())
+        {
+            table->buckets.erase(bucket);
+            if (table->buckets.empty())
+            {
+                m_tables.erase(table);
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+template <typename T>
+void
+Ipv4RoutingPrefixIndex<T>::Clear()
+{
+    m_tables.clear();
+    m_size = 0;
+}
+
+template <typename T>
+uint32_t
+Ipv4RoutingPrefixIndex<T>::GetSize() const
+{
+    return m_size;
+}
+
+template <typename T>
+const typename Ipv4RoutingPrefixIndex<T>::Bucket*
+Ipv4RoutingPrefixIndex<T>::Find(Ipv4Address network, Ipv4Mask mask) const
+{
+    for (const auto& table : m_tables)
+    {
+        if (table.mask == mask.Get())
+        {
+            auto bucket = table.buckets.find(network.Get() & table.mask);
+            return bucket == table.buckets.end() ? nullptr : &bucket->second;
+        }
+    }
+    return nullptr;
+}
+
+template <typename T>
+template <typename Visitor>
+void
+Ipv4RoutingPrefixIndex<T>::Lookup(Ipv4Address dest, Visitor visitor) const
+{
+    for (const auto& table : m_tables)
+    {
+        auto bucket = table.buckets.find(dest.Get() & table.mask);
+        if (bucket != table.buckets.end() && visitor(table.prefixLength, bucket->second))
+        {
+            return;
+        }
+    }
+}
+
+} // namespace ns3
+
+#endif /* IPV4_ROUTING_PREFIX_INDEX_H */
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2024 Liverpool Hope University, UK
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ipv4-routing-table.h"
+
+#include "ns3/log.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("Ipv4RoutingTable");
+
+Ipv4RoutingTable::Ipv4RoutingTable()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+Ipv4RoutingTable::~Ipv4RoutingTable()
+{
+    NS_LOG_FUNCTION(this);
+    Clear();
+}
+
+void
+Ipv4RoutingTable::AddHostRouteTo(Ipv4Address dest, Ipv4Address nextHop, uint32_t interface)
+{
+    NS_LOG_FUNCTION(this << dest << nextHop << interface);
+    m_hostRoutes.push_back(
+        new Ipv4RoutingTableEntry(Ipv4RoutingTableEntry::CreateHostRouteTo(dest, nextHop, interface)));
+}
+
+void
+Ipv4RoutingTable::AddHostRouteTo(Ipv4Address dest, uint32_t interface)
+{
+    NS_LOG_FUNCTION(this << dest << interface);
+    m_hostRoutes.push_back(
+        new Ipv4RoutingTableEntry(Ipv4RoutingTableEntry::CreateHostRouteTo(dest, interface)));
+}
+
+void
+Ipv4RoutingTable::AddNetworkRouteTo(Ipv4Address network,
+                                    Ipv4Mask networkMask,
+                                    Ipv4Address nextHop,
+                                    uint32_t interface)
+{
+    NS_LOG_FUNCTION(this << network << networkMask << nextHop << interface);
+    m_networkRoutes.push_back(new Ipv4RoutingTableEntry(
+        Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, nextHop, interface)));
+}
+
+void
+Ipv4RoutingTable::AddNetworkRouteTo(Ipv4Address network, Ipv4Mask networkMask, uint32_t interface)
+{
+    NS_LOG_FUNCTION(this << network << networkMask << interface);
+    m_networkRoutes.push_back(new Ipv4RoutingTableEntry(
+        Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, interface)));
+}
+
+void
+Ipv4RoutingTable::AddASExternalRouteTo(Ipv4Address network,
+                                       Ipv4Mask networkMask,
+                                       Ipv4Address nextHop,
+                                       uint32_t interface)
+{
+    NS_LOG_FUNCTION(this << network << networkMask << nextHop << interface);
+    m_ASexternalRoutes.push_back(new Ipv4RoutingTableEntry(
+        Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, nextHop, interface)));
+}
+
+uint32_t
+Ipv4RoutingTable::GetNRoutes() const
+{
+    return m_hostRoutes.size() + m_networkRoutes.size() + m_ASexternalRoutes.size();
+}
+
+void
+Ipv4RoutingTable::Clear()
+{
+    NS_LOG_FUNCTION(this);
+    for (auto i = m_hostRoutes.begin(); i != m_hostRoutes.end(); i = m_hostRoutes.erase(i))
+    {
+        delete (*i);
+    }
+    for (auto j = m_networkRoutes.begin(); j != m_networkRoutes.end(); j = m_networkRoutes.erase(j))
+    {
+        delete (*j);
+    }
+    for (auto k = m_ASexternalRoutes.begin(); k != m_ASexternalRoutes.end();
+         k = m_ASexternalRoutes.erase(k))
+    {
+        delete (*k);
+    }
+}
+
+void
+Ipv4RoutingTable::Swap(Ipv4RoutingTable& other)
+{
+    NS_LOG_FUNCTION(this << &other);
+    Swap(other.m_hostRoutes, other.m_networkRoutes, other.m_ASexternalRoutes);
+}
+
+void
+Ipv4RoutingTable::Swap(Routes& hostRoutes, Routes& networkRoutes, Routes& externalRoutes)
+{
+    NS_LOG_FUNCTION(this);
+    m_hostRoutes.swap(hostRoutes);
+    m_networkRoutes.swap(networkRoutes);
+    m_ASexternalRoutes.swap(externalRoutes);
+}
+
+const Ipv4RoutingTable::Routes&
+Ipv4RoutingTable::GetHostRoutes() const
+{
+    return m_hostRoutes;
+}
+
+const Ipv4RoutingTable::Routes&
+Ipv4RoutingTable::GetNetworkRoutes() const
+{
+    return m_networkRoutes;
+}
+
+const Ipv4RoutingTable::Routes&
+Ipv4RoutingTable::GetASExternalRoutes() const
+{
+    return m_ASexternalRoutes;
+}
+
+} // namespace ns3
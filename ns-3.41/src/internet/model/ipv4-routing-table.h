@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2024 Liverpool Hope University, UK
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef IPV4_ROUTING_TABLE_H
+#define IPV4_ROUTING_TABLE_H
+
+#include "ipv4-routing-table-entry.h"
+
+#include "ns3/ipv4-address.h"
+
+#include <list>
+#include <stdint.h>
+
+namespace ns3
+{
+
+/**
+ * \ingroup ipv4Routing
+ *
+ * \brief A staging area for a complete set of unicast routes.
+ *
+ * Link-state protocols recompute their whole forwarding table after every
+ * SPF run.  Rather than removing and re-adding routes one at a time on the
+ * live routing protocol, the new routes are accumulated in an
+ * Ipv4RoutingTable built off to the side, and the result is installed in a
+ * single step by swapping containers (see Ipv4GlobalRouting::SwapRoutes).
+ * After the swap the table holds the previous routes, which are released
+ * by Clear () or by the destructor.
+ *
+ * The table owns the Ipv4RoutingTableEntry objects it stores.
+ */
+class Ipv4RoutingTable
+{
+  public:
+    /// Container of routing table entries, owned by the table
+    typedef std::list<Ipv4RoutingTableEntry*> Routes;
+
+    Ipv4RoutingTable();
+    ~Ipv4RoutingTable();
+
+    // Delete copy constructor and assignment operator to avoid double deletion
+    Ipv4RoutingTable(const Ipv4RoutingTable&) = delete;
+    Ipv4RoutingTable& operator=(const Ipv4RoutingTable&) = delete;
+
+    /**
+     * \brief Add a host route to the table.
+     * \param dest The Ipv4Address destination for this route.
+     * \param nextHop The Ipv4Address of the next hop in the route.
+     * \param interface The network interface index used to reach the destination.
+     */
+    void AddHostRouteTo(Ipv4Address dest, Ipv4Address nextHop, uint32_t interface);
+
+    /**
+     * \brief Add a host route to the table.
+     * \param dest The Ipv4Address destination for this route.
+     * \param interface The network interface index used to reach the destination.
+     */
+    void AddHostRouteTo(Ipv4Address dest, uint32_t interface);
+
+    /**
+     * \brief Add a network route to the table.
+     * \param network The Ipv4Address network for this route.
+     * \param networkMask The Ipv4Mask to extract the network.
+     * \param nextHop The next hop in the route to the destination network.
+     * \param interface The network interface index used to reach the destination.
+     */
+    void AddNetworkRouteTo(Ipv4Address network,
+                           Ipv4Mask networkMask,
+                           Ipv4Address nextHop,
+                           uint32_t interface);
+
+    /**
+     * \brief Add a network route to the table.
+     * \param network The Ipv4Address network for this route.
+     * \param networkMask The Ipv4Mask to extract the network.
+     * \param interface The network interface index used to reach the destination.
+     */
+    void AddNetworkRouteTo(Ipv4Address network, Ipv4Mask networkMask, uint32_t interface);
+
+    /**
+     * \brief Add an external route to the table.
+     * \param network The Ipv4Address network for this route.
+     * \param networkMask The Ipv4Mask to extract the network.
+     * \param nextHop The next hop Ipv4Address
+     * \param interface The network interface index used to reach the destination.
+     */
+    void AddASExternalRouteTo(Ipv4Address network,
+                              Ipv4Mask networkMask,
+                              Ipv4Address nextHop,
+                              uint32_t interface);
+
+    /**
+     * \brief Get the total number of routes in the table.
+     * \returns the number of host, network and external routes
+     */
+    uint32_t GetNRoutes() const;
+
+    /**
+     * \brief Delete every route held by the table.
+     */
+    void Clear();
+
+    /**
+     * \brief Exchange the contents of two tables in constant time.
+     * \param other the table to swap with
+     */
+    void Swap(Ipv4RoutingTable& other);
+
+    /**
+     * \brief Exchange the contents of the table with externally owned containers.
+     *
+     * This is the hook used by routing protocols that keep their routes in
+     * their own lists: no entry is copied or reallocated.
+     *
+     * \param hostRoutes host routes container
+     * \param networkRoutes network routes container
+     * \param externalRoutes external routes container
+     */
+    void Swap(Routes& hostRoutes, Routes& networkRoutes, Routes& externalRoutes);
+
+    /**
+     * \returns the host routes
+     */
+    const Routes& GetHostRoutes() const;
+
+    /**
+     * \returns the network routes
+     */
+    const Routes& GetNetworkRoutes() const;
+
+    /**
+     * \returns the external routes
+     */
+    const Routes& GetASExternalRoutes() const;
+
+  private:
+    Routes m_hostRoutes;       //!< Routes to hosts
+    Routes m_networkRoutes;    //!< Routes to networks
+    Routes m_ASexternalRoutes; //!< External routes imported
+};
+
+} // namespace ns3
+
+#endif /* IPV4_ROUTING_TABLE_H */
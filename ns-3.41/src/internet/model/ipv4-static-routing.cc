@@ -80,6 +80,7 @@ Ipv4StaticRouting::AddNetworkRouteTo(Ipv4Address network,
     {
         auto routePtr = new Ipv4RoutingTableEntry(route);
         m_networkRoutes.emplace_back(routePtr, metric);
+        m_networkRoutesIndex.Insert(network, networkMask, m_networkRoutes.back());
     }
 }
 
@@ -96,8 +97,8 @@ Ipv4StaticRouting::AddNetworkRouteTo(Ipv4Address network,
     if (!LookupRoute(route, metric))
     {
         auto routePtr = new Ipv4RoutingTableEntry(route);
-
         m_networkRoutes.emplace_back(routePtr, metric);
+        m_networkRoutesIndex.Insert(network, networkMask, m_networkRoutes.back());
     }
 }
 
@@ -153,6 +154,7 @@ Ipv4StaticRouting::SetDefaultMulticastRoute(uint32_t outputInterface)
     Ipv4Mask networkMask("240.0.0.0");
     *route = Ipv4RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, outputInterface);
     m_networkRoutes.emplace_back(route, 0);
+    m_networkRoutesIndex.Insert(network, networkMask, m_networkRoutes.back());
 }
 
 uint32_t
@@ -224,14 +226,19 @@ Ipv4StaticRouting::RemoveMulticastRoute(uint32_t index)
 bool
 Ipv4StaticRouting::LookupRoute(const Ipv4RoutingTableEntry& route, uint32_t metric)
 {
-    for (auto j = m_networkRoutes.begin(); j != m_networkRoutes.end(); j++)
+    const auto* bucket = m_networkRoutesIndex.Find(route.GetDest(), route.GetDestNetworkMask());
+    if (!bucket)
     {
-        Ipv4RoutingTableEntry* rtentry = j->first;
+        return false;
+    }
+    for (const auto& j : *bucket)
+    {
+        Ipv4RoutingTableEntry* rtentry = j.first;
 
         if (rtentry->GetDest() == route.GetDest() &&
             rtentry->GetDestNetworkMask() == route.GetDestNetworkMask() &&
             rtentry->GetGateway() == route.GetGateway() &&
-            rtentry->GetInterface() == route.GetInterface() && j->second == metric)
+            rtentry->GetInterface() == route.GetInterface() && j.second == metric)
         {
             return true;
         }
@@ -244,8 +251,6 @@ Ipv4StaticRouting::LookupStatic(Ipv4Address dest, Ptr<NetDevice> oif)
 {
     NS_LOG_FUNCTION(this << dest << " " << oif);
     Ptr<Ipv4Route> rtentry = nullptr;
-    uint16_t longest_mask = 0;
-    uint32_t shortest_metric = 0xffffffff;
     /* when sending on local multicast, there have to be interface specified */
     if (dest.IsLocalMulticast())
     {
@@ -261,16 +266,14 @@ Ipv4StaticRouting::LookupStatic(Ipv4Address dest, Ptr<NetDevice> oif)
         return rtentry;
     }
 
-    for (auto i = m_networkRoutes.begin(); i != m_networkRoutes.end(); i++)
-    {
-        Ipv4RoutingTableEntry* j = i->first;
-        uint32_t metric = i->second;
-        Ipv4Mask mask = (j)->GetDestNetworkMask();
-        uint16_t masklen = mask.GetPrefixLength();
-        Ipv4Address entry = (j)->GetDestNetwork();
-        NS_LOG_LOGIC("Searching for route to " << dest << ", checking against route to " << entry
-                                               << "/" << masklen);
-        if (mask.IsMatch(dest, entry))
+    // Walk the networks containing dest from the longest prefix down.  Within
+    // the longest prefix, the route with the lowest metric wins; on equal
+    // metrics the route added last wins, except for host routes where the
+    // first one is used.
+    Ipv4RoutingTableEntry* route = nullptr;
+    m_networkRoutesIndex.Lookup(dest, [&](uint16_t masklen, const auto& bucket) {
+        uint32_t shortest_metric = 0xffffffff;
+        for (const auto& [j, metric] : bucket)
         {
             NS_LOG_LOGIC("Found global network route " << j << ", mask length " << masklen
                                                        << ", metric " << metric);
@@ -282,34 +285,28 @@ Ipv4StaticRouting::LookupStatic(Ipv4Address dest, Ptr<NetDevice> oif)
                     continue;
                 }
             }
-            if (masklen < longest_mask) // Not interested if got shorter mask
-            {
-                NS_LOG_LOGIC("Previous match longer, skipping");
-                continue;
-            }
-            if (masklen > longest_mask) // Reset metric if longer masklen
-            {
-                shortest_metric = 0xffffffff;
-            }
-            longest_mask = masklen;
             if (metric > shortest_metric)
             {
                 NS_LOG_LOGIC("Equal mask length, but previous metric shorter, skipping");
                 continue;
             }
             shortest_metric = metric;
-            Ipv4RoutingTableEntry* route = (j);
-            uint32_t interfaceIdx = route->GetInterface();
-            rtentry = Create<Ipv4Route>();
-            rtentry->SetDestination(route->GetDest());
-            rtentry->SetSource(m_ipv4->SourceAddressSelection(interfaceIdx, route->GetDest()));
-            rtentry->SetGateway(route->GetGateway());
-            rtentry->SetOutputDevice(m_ipv4->GetNetDevice(interfaceIdx));
+            route = j;
             if (masklen == 32)
             {
                 break;
             }
         }
+        return route != nullptr;
+    });
+    if (route)
+    {
+        uint32_t interfaceIdx = route->GetInterface();
+        rtentry = Create<Ipv4Route>();
+        rtentry->SetDestination(route->GetDest());
+        rtentry->SetSource(m_ipv4->SourceAddressSelection(interfaceIdx, route->GetDest()));
+        rtentry->SetGateway(route->GetGateway());
+        rtentry->SetOutputDevice(m_ipv4->GetNetDevice(interfaceIdx));
     }
     if (rtentry)
     {
@@ -457,6 +454,7 @@ Ipv4StaticRouting::RemoveRoute(uint32_t index)
     {
         if (tmp == index)
         {
+            m_networkRoutesIndex.Remove(j->first->GetDest(), j->first->GetDestNetworkMask(), *j);
             delete j->first;
             m_networkRoutes.erase(j);
             return;
@@ -592,6 +590,7 @@ Ipv4StaticRouting::DoDispose()
     {
         delete (j->first);
     }
+    m_networkRoutesIndex.Clear();
     for (auto i = m_multicastRoutes.begin(); i != m_multicastRoutes.end();
          i = m_multicastRoutes.erase(i))
     {
@@ -631,6 +630,9 @@ Ipv4StaticRouting::NotifyInterfaceDown(uint32_t i)
     {
         if (it->first->GetInterface() == i)
         {
+            m_networkRoutesIndex.Remove(it->first->GetDest(),
+                                        it->first->GetDestNetworkMask(),
+                                        *it);
             delete it->first;
             it = m_networkRoutes.erase(it);
         }
@@ -676,6 +678,9 @@ Ipv4StaticRouting::NotifyRemoveAddress(uint32_t interface, Ipv4InterfaceAddress
             it->first->GetDestNetwork() == networkAddress &&
             it->first->GetDestNetworkMask() == networkMask)
         {
+            m_networkRoutesIndex.Remove(it->first->GetDest(),
+                                        it->first->GetDestNetworkMask(),
+                                        *it);
             delete it->first;
             it = m_networkRoutes.erase(it);
         }
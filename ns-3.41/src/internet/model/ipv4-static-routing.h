@@ -22,6 +22,7 @@
 #define IPV4_STATIC_ROUTING_H
 
 #include "ipv4-header.h"
+#include "ipv4-routing-prefix-index.h"
 #include "ipv4-routing-protocol.h"
 #include "ipv4.h"
 
@@ -411,6 +412,11 @@ class Ipv4StaticRouting : public Ipv4RoutingProtocol
      */
     NetworkRoutes m_networkRoutes;
 
+    /**
+     * \brief longest-prefix-match index of m_networkRoutes.
+     */
+    Ipv4RoutingPrefixIndex<NetworkRoutes::value_type> m_networkRoutesIndex;
+
     /**
      * \brief the forwarding table for multicast.
      */
@@ -0,0 +1,264 @@
+/*
+ * Copyright (c) 2024 Liverpool Hope University, UK
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef IPV6_ROUTING_PREFIX_INDEX_H
+#define IPV6_ROUTING_PREFIX_INDEX_H
+
+#include "ns3/ipv6-address.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup ipv6Routing
+ *
+ * \brief Longest-prefix-match index over a routing table.
+ *
+ * The index does not own the routes: it stores a value per route (usually
+ * a pointer to the Ipv6RoutingTableEntry, possibly with some extra
+ * information) and is kept in sync by the routing protocol whenever a
+ * route is added to or removed from its lists.
+ *
+ * This is the IPv6 counterpart of Ipv4RoutingPrefixIndex.  Routes are
+ * grouped by prefix, and within a prefix by masked network address in a
+ * hash table.  A lookup probes one hash bucket per distinct prefix, from the
+ * most to the least specific, so its cost depends on the number of distinct
+ * prefix lengths in use (a handful in practice, at most 129) rather than on
+ * the number of routes.
+ *
+ * Values sharing the same network and prefix are kept in insertion order, so
+ * that a routing protocol can reproduce the tie-breaking of a sequential
+ * scan of its route list.
+ *
+ * \tparam T the type of the values stored for each route
+ */
+template <typename T>
+class Ipv6RoutingPrefixIndex
+{
+  public:
+    /// Values sharing the same network and prefix, in insertion order
+    typedef std::vector<T> Bucket;
+
+    Ipv6RoutingPrefixIndex();
+
+    /**
+     * \brief Add a route to the index.
+     * \param network the destination network (host bits are ignored)
+     * \param prefix the network prefix
+     * \param value the value stored for the route
+     */
+    void Insert(Ipv6Address network, Ipv6Prefix prefix, const T& value);
+
+    /**
+     * \brief Remove a route from the index.
+     * \param network the destination network (host bits are ignored)
+     * \param prefix the network prefix
+     * \param value the value stored for the route
+     * \return true if the route was found
+     */
+    bool Remove(Ipv6Address network, Ipv6Prefix prefix, const T& value);
+
+    /**
+     * \brief Remove every route from the index.
+     */
+    void Clear();
+
+    /**
+     * \return the number of routes in the index
+     */
+    uint32_t GetSize() const;
+
+    /**
+     * \brief Get the routes to exactly one network.
+     * \param network the destination network (host bits are ignored)
+     * \param prefix the network prefix
+     * \return the routes, or nullptr if there are none
+     */
+    const Bucket* Find(Ipv6Address network, Ipv6Prefix prefix) const;
+
+    /**
+     * \brief Visit the routes matching a destination.
+     *
+     * The visitor is invoked as `bool visitor(uint16_t prefixLength, const
+     * Bucket& bucket)` once per network containing \p dest, from the longest
+     * to the shortest prefix.  Returning true stops the walk.
+     *
+     * \param dest the destination address
+     * \param visitor the visitor
+     */
+    template <typename Visitor>
+    void Lookup(Ipv6Address dest, Visitor visitor) const;
+
+  private:
+    /// Routes sharing the same network prefix
+    struct PrefixTable
+    {
+        uint8_t prefix[16];    //!< the network prefix
+        uint8_t prefixLength;  //!< the prefix length
+        std::unordered_map<Ipv6Address, Bucket, Ipv6AddressHash> buckets; //!< routes by network
+
+        /**
+         * \param address an address
+         * \return the address masked by the prefix
+         */
+        Ipv6Address Combine(Ipv6Address address) const
+        {
+            uint8_t buf[16];
+            address.GetBytes(buf);
+            for (uint32_t i = 0; i < 16; i++)
+            {
+                buf[i] &= prefix[i];
+            }
+            return Ipv6Address(buf);
+        }
+    };
+
+    /**
+     * \param prefix a network prefix
+     * \return the position of the table of the prefix in m_tables, or the
+     * size of m_tables if there is none
+     */
+    std::size_t FindTable(Ipv6Prefix prefix) const;
+
+    std::vector<PrefixTable> m_tables; //!< tables sorted by decreasing prefix length
+    uint32_t m_size;                 //!< number of routes
+};
+
+template <typename T>
+Ipv6RoutingPrefixIndex<T>::Ipv6RoutingPrefixIndex()
+    : m_size(0)
+{
+}
+
+template <typename T>
+std::size_t
+Ipv6RoutingPrefixIndex<T>::FindTable(Ipv6Prefix prefix) const
+{
+    uint8_t bytes[16];
+    prefix.GetBytes(bytes);
+    std::size_t i = 0;
+    while (i < m_tables.size() && std::memcmp(m_tables[i].prefix, bytes, 16) != 0)
+    {
+        i++;
+    }
+    return i;
+}
+
+template <typename T>
+void
+Ipv6RoutingPrefixIndex<T>::Insert(Ipv6Address network, Ipv6Prefix prefix, const T& value)
+{
+    auto table = m_tables.begin() + FindTable(prefix);
+    if (table == m_tables.end())
+    {
+        PrefixTable newTable;
+        prefix.GetBytes(newTable.prefix);
+        newTable.prefixLength = prefix.GetPrefixLength();
+        auto position =
+            std::find_if(m_tables.begin(), m_tables.end(), [&newTable](const PrefixTable& t) {
+                return t.prefixLength < newTable.prefixLength;
+            });
+        table = m_tables.insert(position, std::move(newTable));
+    }
+    table->buckets[table->Combine(network)].push_back(value);
+    m_size++;
+}
+
+template <typename T>
+bool
+Ipv6RoutingPrefixIndex<T>::Remove(Ipv6Address network, Ipv6Prefix prefix, const T& value)
+{
+    auto table = m_tables.begin() + FindTable(prefix);
+    if (table == m_tables.end())
+    {
+        return false;
+    }
+    auto bucket = table->buckets.find(table->Combine(network));
+    if (bucket == table->buckets.end())
+    {
+        return false;
+    }
+    auto it = std::find(bucket->second.begin(), bucket->second.end(), value);
+    if (it == bucket->second.end())
+    {
+        return false;
+    }
+    bucket->second.erase(it);
+    m_size--;
+    if (bucket->second.empty())
+    {
+        table->buckets.erase(bucket);
+        if (table->buckets.empty())
+        {
+            m_tables.erase(table);
+        }
+    }
+    return true;
+}
+
+template <typename T>
+void
+Ipv6RoutingPrefixIndex<T>::Clear()
+{
+    m_tables.clear();
+    m_size = 0;
+}
+
+template <typename T>
+uint32_t
+Ipv6RoutingPrefixIndex<T>::GetSize() const
+{
+    return m_size;
+}
+
+template <typename T>
+const typename Ipv6RoutingPrefixIndex<T>::Bucket*
+Ipv6RoutingPrefixIndex<T>::Find(Ipv6Address network, Ipv6Prefix prefix) const
+{
+    auto table = m_tables.begin() + FindTable(prefix);
+    if (table == m_tables.end())
+    {
+        return nullptr;
+    }
+    auto bucket = table->buckets.find(table->Combine(network));
+    return bucket == table->buckets.end() ? nullptr : &bucket->second;
+}
+
+template <typename T>
+template <typename Visitor>
+void
+Ipv6RoutingPrefixIndex<T>::Lookup(Ipv6Address dest, Visitor visitor) const
+{
+    for (const auto& table : m_tables)
+    {
+        auto bucket = table.buckets.find(table.Combine(dest));
+        if (bucket != table.buckets.end() && visitor(table.prefixLength, bucket->second))
+        {
+            return;
+        }
+    }
+}
+
+} // namespace ns3
+
+#endif /* IPV6_ROUTING_PREFIX_INDEX_H */
@@ -29,6 +29,7 @@
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 
+#include <algorithm>
 #include <iomanip>
 
 namespace ns3
@@ -183,6 +184,7 @@ Ipv6StaticRouting::AddNetworkRouteTo(Ipv6Address network,
     {
         auto routePtr = new Ipv6RoutingTableEntry(route);
         m_networkRoutes.emplace_back(routePtr, metric);
+        m_networkRoutesIndex.Insert(network, networkPrefix, m_networkRoutes.back());
     }
 }
 
@@ -210,6 +212,7 @@ Ipv6StaticRouting::AddNetworkRouteTo(Ipv6Address network,
     {
         auto routePtr = new Ipv6RoutingTableEntry(route);
         m_networkRoutes.emplace_back(routePtr, metric);
+        m_networkRoutesIndex.Insert(network, networkPrefix, m_networkRoutes.back());
     }
 }
 
@@ -227,6 +230,7 @@ Ipv6StaticRouting::AddNetworkRouteTo(Ipv6Address network,
     {
         auto routePtr = new Ipv6RoutingTableEntry(route);
         m_networkRoutes.emplace_back(routePtr, metric);
+        m_networkRoutesIndex.Insert(network, networkPrefix, m_networkRoutes.back());
     }
 }
 
@@ -258,6 +262,7 @@ Ipv6StaticRouting::AddMulticastRoute(Ipv6Address origin,
                                                                   inputInterface,
                                                                   outputInterfaces);
     m_multicastRoutes.push_back(route);
+    m_multicastRoutesIndex[group].push_back(route);
 }
 
 void
@@ -269,6 +274,7 @@ Ipv6StaticRouting::SetDefaultMulticastRoute(uint32_t outputInterface)
     Ipv6Prefix networkMask = Ipv6Prefix(8);
     *route = Ipv6RoutingTableEntry::CreateNetworkRouteTo(network, networkMask, outputInterface);
     m_networkRoutes.emplace_back(route, 0);
+    m_networkRoutesIndex.Insert(network, networkMask, m_networkRoutes.back());
 }
 
 uint32_t
@@ -312,6 +318,7 @@ Ipv6StaticRouting::RemoveMulticastRoute(Ipv6Address origin,
         if (origin == route->GetOrigin() && group == route->GetGroup() &&
             inputInterface == route->GetInputInterface())
         {
+            RemoveMulticastRouteIndex(route);
             delete *i;
             m_multicastRoutes.erase(i);
             return true;
@@ -330,6 +337,7 @@ Ipv6StaticRouting::RemoveMulticastRoute(uint32_t index)
     {
         if (tmp == index)
         {
+            RemoveMulticastRouteIndex(*i);
             delete *i;
             m_multicastRoutes.erase(i);
             return;
@@ -344,34 +352,41 @@ Ipv6StaticRouting::HasNetworkDest(Ipv6Address network, uint32_t interfaceIndex)
     NS_LOG_FUNCTION(this << network << interfaceIndex);
 
     /* in the network table */
-    for (auto j = m_networkRoutes.begin(); j != m_networkRoutes.end(); j++)
-    {
-        Ipv6RoutingTableEntry* rtentry = j->first;
-        Ipv6Prefix prefix = rtentry->GetDestNetworkPrefix();
-        Ipv6Address entry = rtentry->GetDestNetwork();
-
-        if (prefix.IsMatch(network, entry) && rtentry->GetInterface() == interfaceIndex)
+    bool found = false;
+    m_networkRoutesIndex.Lookup(network, [&](uint16_t, const auto& bucket) {
+        for (const auto& j : bucket)
         {
-            return true;
+            if (j.first->GetInterface() == interfaceIndex)
+            {
+                found = true;
+                break;
+            }
         }
-    }
+        return found;
+    });
 
     /* beuh!!! not route at all */
-    return false;
+    return found;
 }
 
 bool
 Ipv6StaticRouting::LookupRoute(const Ipv6RoutingTableEntry& route, uint32_t metric)
 {
-    for (auto j = m_networkRoutes.begin(); j != m_networkRoutes.end(); j++)
+    const auto* bucket =
+        m_networkRoutesIndex.Find(route.GetDest(), route.GetDestNetworkPrefix());
+    if (!bucket)
     {
-        Ipv6RoutingTableEntry* rtentry = j->first;
+        return false;
+    }
+    for (const auto& j : *bucket)
+    {
+        Ipv6RoutingTableEntry* rtentry = j.first;
 
         if (rtentry->GetDest() == route.GetDest() &&
             rtentry->GetDestNetworkPrefix() == route.GetDestNetworkPrefix() &&
             rtentry->GetGateway() == route.GetGateway() &&
             rtentry->GetInterface() == route.GetInterface() &&
-            rtentry->GetPrefixToUse() == route.GetPrefixToUse() && j->second == metric)
+            rtentry->GetPrefixToUse() == route.GetPrefixToUse() && j.second == metric)
         {
             return true;
         }
@@ -384,8 +399,6 @@ Ipv6StaticRouting::LookupStatic(Ipv6Address dst, Ptr<NetDevice> interface)
 {
     NS_LOG_FUNCTION(this << dst << interface);
     Ptr<Ipv6Route> rtentry = nullptr;
-    uint16_t longestMask = 0;
-    uint32_t shortestMetric = 0xffffffff;
 
     /* when sending on link-local multicast, there have to be interface specified */
     if (dst.IsLinkLocalMulticast())
@@ -402,18 +415,14 @@ Ipv6StaticRouting::LookupStatic(Ipv6Address dst, Ptr<NetDevice> interface)
         return rtentry;
     }
 
-    for (auto it = m_networkRoutes.begin(); it != m_networkRoutes.end(); it++)
-    {
-        Ipv6RoutingTableEntry* j = it->first;
-        uint32_t metric = it->second;
-        Ipv6Prefix mask = j->GetDestNetworkPrefix();
-        uint16_t maskLen = mask.GetPrefixLength();
-        Ipv6Address entry = j->GetDestNetwork();
-
-        NS_LOG_LOGIC("Searching for route to " << dst << ", mask length " << maskLen << ", metric "
-                                               << metric);
-
-        if (mask.IsMatch(dst, entry))
+    // Walk the networks containing dst from the longest prefix down.  Within
+    // the longest prefix, the route with the lowest metric wins; on equal
+    // metrics the route added last wins, except for host routes where the
+    // first one is used.
+    Ipv6RoutingTableEntry* route = nullptr;
+    m_networkRoutesIndex.Lookup(dst, [&](uint16_t maskLen, const auto& bucket) {
+        uint32_t shortestMetric = 0xffffffff;
+        for (const auto& [j, metric] : bucket)
         {
             NS_LOG_LOGIC("Found global network route " << *j << ", mask length " << maskLen
                                                        << ", metric " << metric);
@@ -421,18 +430,6 @@ Ipv6StaticRouting::LookupStatic(Ipv6Address dst, Ptr<NetDevice> interface)
             /* if interface is given, check the route will output on this interface */
             if (!interface || interface == m_ipv6->GetNetDevice(j->GetInterface()))
             {
-                if (maskLen < longestMask)
-                {
-                    NS_LOG_LOGIC("Previous match longer, skipping");
-                    continue;
-                }
-
-                if (maskLen > longestMask)
-                {
-                    shortestMetric = 0xffffffff;
-                }
-
-                longestMask = maskLen;
                 if (metric > shortestMetric)
                 {
                     NS_LOG_LOGIC("Equal mask length, but previous metric shorter, skipping");
@@ -440,36 +437,39 @@ Ipv6StaticRouting::LookupStatic(Ipv6Address dst, Ptr<NetDevice> interface)
                 }
 
                 shortestMetric = metric;
-                Ipv6RoutingTableEntry* route = j;
-                uint32_t interfaceIdx = route->GetInterface();
-                rtentry = Create<Ipv6Route>();
-
-                if (route->GetGateway().IsAny())
-                {
-                    rtentry->SetSource(
-                        m_ipv6->SourceAddressSelection(interfaceIdx, route->GetDest()));
-                }
-                else if (route->GetDest().IsAny()) /* default route */
-                {
-                    rtentry->SetSource(m_ipv6->SourceAddressSelection(
-                        interfaceIdx,
-                        route->GetPrefixToUse().IsAny() ? dst : route->GetPrefixToUse()));
-                }
-                else
-                {
-                    rtentry->SetSource(
-                        m_ipv6->SourceAddressSelection(interfaceIdx, route->GetDest()));
-                }
-
-                rtentry->SetDestination(route->GetDest());
-                rtentry->SetGateway(route->GetGateway());
-                rtentry->SetOutputDevice(m_ipv6->GetNetDevice(interfaceIdx));
+                route = j;
                 if (maskLen == 128)
                 {
                     break;
                 }
             }
         }
+        return route != nullptr;
+    });
+
+    if (route)
+    {
+        uint32_t interfaceIdx = route->GetInterface();
+        rtentry = Create<Ipv6Route>();
+
+        if (route->GetGateway().IsAny())
+        {
+            rtentry->SetSource(m_ipv6->SourceAddressSelection(interfaceIdx, route->GetDest()));
+        }
+        else if (route->GetDest().IsAny()) /* default route */
+        {
+            rtentry->SetSource(m_ipv6->SourceAddressSelection(
+                interfaceIdx,
+                route->GetPrefixToUse().IsAny() ? dst : route->GetPrefixToUse()));
+        }
+        else
+        {
+            rtentry->SetSource(m_ipv6->SourceAddressSelection(interfaceIdx, route->GetDest()));
+        }
+
+        rtentry->SetDestination(route->GetDest());
+        rtentry->SetGateway(route->GetGateway());
+        rtentry->SetOutputDevice(m_ipv6->GetNetDevice(interfaceIdx));
     }
 
     if (rtentry)
@@ -490,6 +490,7 @@ Ipv6StaticRouting::DoDispose()
         delete j->first;
     }
     m_networkRoutes.clear();
+    m_networkRoutesIndex.Clear();
 
     for (auto i = m_multicastRoutes.begin(); i != m_multicastRoutes.end();
          i = m_multicastRoutes.erase(i))
@@ -497,6 +498,7 @@ Ipv6StaticRouting::DoDispose()
         delete (*i);
     }
     m_multicastRoutes.clear();
+    m_multicastRoutesIndex.clear();
 
     m_ipv6 = nullptr;
     Ipv6RoutingProtocol::DoDispose();
@@ -508,7 +510,12 @@ Ipv6StaticRouting::LookupStatic(Ipv6Address origin, Ipv6Address group, uint32_t
     NS_LOG_FUNCTION(this << origin << group << interface);
     Ptr<Ipv6MulticastRoute> mrtentry = nullptr;
 
-    for (auto i = m_multicastRoutes.begin(); i != m_multicastRoutes.end(); i++)
+    auto routes = m_multicastRoutesIndex.find(group);
+    if (routes == m_multicastRoutesIndex.end())
+    {
+        return mrtentry;
+    }
+    for (auto i = routes->second.begin(); i != routes->second.end(); i++)
     {
         Ipv6MulticastRoutingTableEntry* route = *i;
 
@@ -522,7 +529,7 @@ Ipv6StaticRouting::LookupStatic(Ipv6Address origin, Ipv6Address group, uint32_t
            the local node (in which case the ifIndex is a wildcard).
            */
 
-        if (origin == route->GetOrigin() && group == route->GetGroup())
+        if (origin == route->GetOrigin())
         {
             /* skipping SSM case */
             NS_LOG_LOGIC("Find source specific multicast route" << *i);
@@ -647,6 +654,7 @@ Ipv6StaticRouting::RemoveRoute(uint32_t index)
     {
         if (tmp == index)
         {
+            RemoveNetworkRouteIndex(*it);
             delete it->first;
             m_networkRoutes.erase(it);
             return;
@@ -670,6 +678,7 @@ Ipv6StaticRouting::RemoveRoute(Ipv6Address network,
         if (network == rtentry->GetDest() && rtentry->GetInterface() == ifIndex &&
             rtentry->GetPrefixToUse() == prefixToUse)
         {
+            RemoveNetworkRouteIndex(*it);
             delete it->first;
             m_networkRoutes.erase(it);
             return;
@@ -677,6 +686,26 @@ Ipv6StaticRouting::RemoveRoute(Ipv6Address network,
     }
 }
 
+void
+Ipv6StaticRouting::RemoveNetworkRouteIndex(const NetworkRoutes::value_type& route)
+{
+    m_networkRoutesIndex.Remove(route.first->GetDest(),
+                                route.first->GetDestNetworkPrefix(),
+                                route);
+}
+
+void
+Ipv6StaticRouting::RemoveMulticastRouteIndex(Ipv6MulticastRoutingTableEntry* route)
+{
+    auto routes = m_multicastRoutesIndex.find(route->GetGroup());
+    NS_ASSERT(routes != m_multicastRoutesIndex.end());
+    routes->second.erase(std::find(routes->second.begin(), routes->second.end(), route));
+    if (routes->second.empty())
+    {
+        m_multicastRoutesIndex.erase(routes);
+    }
+}
+
 Ptr<Ipv6Route>
 Ipv6StaticRouting::RouteOutput(Ptr<Packet> p,
                                const Ipv6Header& header,
@@ -812,6 +841,7 @@ Ipv6StaticRouting::NotifyInterfaceDown(uint32_t i)
     {
         if (it->first->GetInterface() == i)
         {
+            RemoveNetworkRouteIndex(*it);
             delete it->first;
             it = m_networkRoutes.erase(it);
         }
@@ -850,6 +880,7 @@ Ipv6StaticRouting::NotifyRemoveAddress(uint32_t interface, Ipv6InterfaceAddress
             it->first->GetDestNetwork() == networkAddress &&
             it->first->GetDestNetworkPrefix() == networkMask)
         {
+            RemoveNetworkRouteIndex(*it);
             delete it->first;
             it = m_networkRoutes.erase(it);
         }
@@ -908,6 +939,7 @@ Ipv6StaticRouting::NotifyRemoveRoute(Ipv6Address dst,
 
             if (dst == entry && prefix == mask && rtentry->GetInterface() == interface)
             {
+                RemoveNetworkRouteIndex(*j);
                 delete j->first;
                 j = m_networkRoutes.erase(j);
             }
@@ -21,6 +21,7 @@
 #define IPV6_STATIC_ROUTING_H
 
 #include "ipv6-header.h"
+#include "ipv6-routing-prefix-index.h"
 #include "ipv6-routing-protocol.h"
 #include "ipv6.h"
 
@@ -29,6 +30,8 @@
 
 #include <list>
 #include <stdint.h>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
@@ -331,16 +334,42 @@ class Ipv6StaticRouting : public Ipv6RoutingProtocol
      */
     Ptr<Ipv6MulticastRoute> LookupStatic(Ipv6Address origin, Ipv6Address group, uint32_t ifIndex);
 
+    /**
+     * \brief Remove a network route from m_networkRoutesIndex.
+     * \param route the route, still in m_networkRoutes
+     */
+    void RemoveNetworkRouteIndex(const NetworkRoutes::value_type& route);
+
+    /**
+     * \brief Remove a multicast route from m_multicastRoutesIndex.
+     * \param route the route, still in m_multicastRoutes
+     */
+    void RemoveMulticastRouteIndex(Ipv6MulticastRoutingTableEntry* route);
+
     /**
      * \brief the forwarding table for network.
      */
     NetworkRoutes m_networkRoutes;
 
+    /**
+     * \brief longest-prefix-match index of m_networkRoutes.
+     */
+    Ipv6RoutingPrefixIndex<NetworkRoutes::value_type> m_networkRoutesIndex;
+
     /**
      * \brief the forwarding table for multicast.
      */
     MulticastRoutes m_multicastRoutes;
 
+    /**
+     * \brief m_multicastRoutes by group, each in insertion order.
+     *
+     * Multicast lookups match on the group and input interface only (source
+     * specific routes are not supported), so the origin is not part of the key.
+     */
+    std::unordered_map<Ipv6Address, std::vector<Ipv6MulticastRoutingTableEntry*>, Ipv6AddressHash>
+        m_multicastRoutesIndex;
+
     /**
      * \brief Ipv6 reference.
      */
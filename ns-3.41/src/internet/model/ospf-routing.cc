@@ -2,15 +2,56 @@
 #include "ospf-l4-protocol.h"
 #include "ospf-header.h"
 
+#include "ipv4-route.h"
+
 #include "ns3/log.h"
+#include "ns3/names.h"
 #include "ns3/simulator.h"
 #include "ns3/node.h"
 
+#include <algorithm>
+#include <iomanip>
+
 #define OSPF_ALL_NODE "224.0.0.5"
 
 namespace ns3
 {
-OspfRouting::OspfRouting() : m_ipv4(nullptr){
+
+NS_LOG_COMPONENT_DEFINE("OspfRouting");
+
+NS_OBJECT_ENSURE_REGISTERED(OspfRouting);
+
+TypeId OspfRouting::GetTypeId() {
+    static TypeId tid =
+        TypeId("ns3::OspfRouting")
+            .SetParent<Ipv4RoutingProtocol>()
+            .SetGroupName("Internet")
+            .AddConstructor<OspfRouting>()
+            .AddAttribute("SpfInitialWait",
+                          "Delay between the first topology change after a quiet period "
+                          "and the SPF calculation.",
+                          TimeValue(MilliSeconds(50)),
+                          MakeTimeAccessor(&OspfRouting::m_spfInitialWait),
+                          MakeTimeChecker())
+            .AddAttribute("SpfHoldTime",
+                          "Initial minimum interval between two consecutive SPF calculations. "
+                          "It doubles on every back-to-back calculation up to SpfMaxWait.",
+                          TimeValue(MilliSeconds(200)),
+                          MakeTimeAccessor(&OspfRouting::m_spfHoldTime),
+                          MakeTimeChecker())
+            .AddAttribute("SpfMaxWait",
+                          "Maximum interval between two consecutive SPF calculations.",
+                          TimeValue(Seconds(5)),
+                          MakeTimeAccessor(&OspfRouting::m_spfMaxWait),
+                          MakeTimeChecker())
+            .AddTraceSource("SpfCalculation",
+                            "An SPF calculation installed a new routing table.",
+                            MakeTraceSourceAccessor(&OspfRouting::m_spfTrace),
+                            "ns3::OspfRouting::SpfTracedCallback");
+    return tid;
+}
+
+OspfRouting::OspfRouting() : m_ipv4(nullptr), m_initialized(false), m_spfRan(false){
     m_ospf_protocol = CreateObject<OspfL4Protocol>();
 }
 OspfRouting::~OspfRouting() {
@@ -20,6 +61,7 @@ OspfRouting::~OspfRouting() {
 void OspfRouting::DoInitialize() {
     //NS_LOG_FUNCTION(this);
     m_down_timer = Time(10);
+    m_spfCurrentHold = m_spfHoldTime;
 
     for (uint32_t i = 0; i < m_ipv4->GetNInterfaces(); i++) {
         Ptr<LoopbackNetDevice> check = DynamicCast<LoopbackNetDevice>(m_ipv4->GetNetDevice(i));
@@ -44,6 +86,9 @@ void OspfRouting::DoInitialize() {
         }
     }
 
+    m_initialized = true;
+    ScheduleSpfCalculation();
+
     Ipv4RoutingProtocol::DoInitialize();
 }
 
@@ -53,6 +98,10 @@ void OspfRouting::SetInterfaceExclusions(std::set<uint32_t> exceptions){
 }
 
 void OspfRouting::DoDispose(){
+    m_spfEvent.Cancel();
+    m_routes.Clear();
+    m_ospf_protocol = nullptr;
+    m_ipv4 = nullptr;
     Ipv4RoutingProtocol::DoDispose();
 }
 
@@ -76,4 +125,244 @@ void SendDownUpdate(){
 
 }
 
-}
\ No newline at end of file
+/******************************************************************************
+ *
+ * SPF scheduling
+ *
+ ******************************************************************************/
+
+void OspfRouting::ScheduleSpfCalculation() {
+    NS_LOG_FUNCTION(this);
+
+    if (!m_initialized) {
+        // DoInitialize requests the first calculation
+        return;
+    }
+    if (m_spfEvent.IsRunning()) {
+        NS_LOG_LOGIC("SPF calculation already scheduled, merging request");
+        return;
+    }
+
+    Time sinceLast = Simulator::Now() - m_lastSpf;
+    Time delay;
+    if (!m_spfRan || sinceLast >= m_spfCurrentHold * 2) {
+        // Quiet period: react quickly and restart the backoff
+        m_spfCurrentHold = m_spfHoldTime;
+        delay = m_spfInitialWait;
+    } else {
+        // Back-to-back changes: honour the hold time, then back off
+        delay = std::max(m_spfInitialWait, m_spfCurrentHold - sinceLast);
+        m_spfCurrentHold = std::min(m_spfCurrentHold * 2, m_spfMaxWait);
+    }
+
+    NS_LOG_LOGIC("SPF calculation in " << delay.As(Time::MS) << ", next hold "
+                                        << m_spfCurrentHold.As(Time::MS));
+    m_spfEvent = Simulator::Schedule(delay, &OspfRouting::SpfCalculate, this);
+}
+
+void OspfRouting::SpfCalculate() {
+    NS_LOG_FUNCTION(this);
+
+    Ipv4RoutingTable table;
+    BuildRoutes(table);
+
+    // Install the new table in one step; `table` now holds the old routes
+    // and releases them when it goes out of scope.
+    m_routes.Swap(table);
+    m_lastSpf = Simulator::Now();
+    m_spfRan = true;
+
+    NS_LOG_LOGIC("SPF calculation installed " << m_routes.GetNRoutes() << " routes");
+    m_spfTrace(m_routes.GetNRoutes(), m_spfCurrentHold);
+}
+
+void OspfRouting::BuildRoutes(Ipv4RoutingTable& table) const {
+    NS_LOG_FUNCTION(this << &table);
+
+    for (uint32_t i = 0; i < m_ipv4->GetNInterfaces(); i++) {
+        if (!m_ipv4->IsUp(i) || m_interfaceExclusions.find(i) != m_interfaceExclusions.end()) {
+            continue;
+        }
+        if (DynamicCast<LoopbackNetDevice>(m_ipv4->GetNetDevice(i))) {
+            continue;
+        }
+        for (uint32_t j = 0; j < m_ipv4->GetNAddresses(i); j++) {
+            Ipv4InterfaceAddress address = m_ipv4->GetAddress(i, j);
+            if (address.GetScope() == Ipv4InterfaceAddress::HOST) {
+                continue;
+            }
+            Ipv4Mask mask = address.GetMask();
+            table.AddNetworkRouteTo(address.GetLocal().CombineMask(mask), mask, i);
+        }
+    }
+}
+
+uint32_t OspfRouting::GetNRoutes() const {
+    return m_routes.GetNRoutes();
+}
+
+Time OspfRouting::GetSpfHoldTime() const {
+    return m_spfCurrentHold;
+}
+
+/******************************************************************************
+ *
+ * Ipv4RoutingProtocol
+ *
+ ******************************************************************************/
+
+Ptr<Ipv4Route> OspfRouting::LookupOspf(Ipv4Address dest, Ptr<NetDevice> oif) const {
+    NS_LOG_FUNCTION(this << dest << oif);
+
+    Ipv4RoutingTableEntry* best = nullptr;
+    for (Ipv4RoutingTableEntry* route : m_routes.GetHostRoutes()) {
+        if (route->GetDest() == dest &&
+            (!oif || oif == m_ipv4->GetNetDevice(route->GetInterface()))) {
+            best = route;
+            break;
+        }
+    }
+    if (!best) {
+        uint16_t longestMask = 0;
+        for (Ipv4RoutingTableEntry* route : m_routes.GetNetworkRoutes()) {
+            Ipv4Mask mask = route->GetDestNetworkMask();
+            if (!mask.IsMatch(dest, route->GetDestNetwork())) {
+                continue;
+            }
+            if (oif && oif != m_ipv4->GetNetDevice(route->GetInterface())) {
+                continue;
+            }
+            if (!best || mask.GetPrefixLength() > longestMask) {
+                best = route;
+                longestMask = mask.GetPrefixLength();
+            }
+        }
+    }
+    if (!best) {
+        return nullptr;
+    }
+
+    uint32_t interfaceIdx = best->GetInterface();
+    Ptr<Ipv4Route> rtentry = Create<Ipv4Route>();
+    rtentry->SetDestination(dest);
+    rtentry->SetSource(m_ipv4->SourceAddressSelection(interfaceIdx, dest));
+    rtentry->SetGateway(best->GetGateway());
+    rtentry->SetOutputDevice(m_ipv4->GetNetDevice(interfaceIdx));
+    return rtentry;
+}
+
+Ptr<Ipv4Route> OspfRouting::RouteOutput(Ptr<Packet> p,
+                                        const Ipv4Header& header,
+                                        Ptr<NetDevice> oif,
+                                        Socket::SocketErrno& sockerr) {
+    NS_LOG_FUNCTION(this << header << oif);
+
+    if (header.GetDestination().IsMulticast()) {
+        // Let other routing protocols try to handle this
+        return nullptr;
+    }
+    Ptr<Ipv4Route> rtentry = LookupOspf(header.GetDestination(), oif);
+    sockerr = rtentry ? Socket::ERROR_NOTERROR : Socket::ERROR_NOROUTETOHOST;
+    return rtentry;
+}
+
+bool OspfRouting::RouteInput(Ptr<const Packet> p,
+                             const Ipv4Header& header,
+                             Ptr<const NetDevice> idev,
+                             const UnicastForwardCallback& ucb,
+                             const MulticastForwardCallback& mcb,
+                             const LocalDeliverCallback& lcb,
+                             const ErrorCallback& ecb) {
+    NS_LOG_FUNCTION(this << p << header << idev);
+
+    NS_ASSERT(m_ipv4->GetInterfaceForDevice(idev) >= 0);
+    uint32_t iif = m_ipv4->GetInterfaceForDevice(idev);
+
+    if (m_ipv4->IsDestinationAddress(header.GetDestination(), iif)) {
+        if (!lcb.IsNull()) {
+            lcb(p, header, iif);
+            return true;
+        }
+        // Multicast or broadcast, let another protocol handle it
+        return false;
+    }
+    if (header.GetDestination().IsMulticast()) {
+        return false;
+    }
+    if (!m_ipv4->IsForwarding(iif)) {
+        ecb(p, header, Socket::ERROR_NOROUTETOHOST);
+        return true;
+    }
+
+    Ptr<Ipv4Route> rtentry = LookupOspf(header.GetDestination());
+    if (rtentry) {
+        ucb(rtentry, p, header);
+        return true;
+    }
+    return false;
+}
+
+void OspfRouting::NotifyInterfaceUp(uint32_t interface) {
+    NS_LOG_FUNCTION(this << interface);
+    ScheduleSpfCalculation();
+}
+
+void OspfRouting::NotifyInterfaceDown(uint32_t interface) {
+    NS_LOG_FUNCTION(this << interface);
+    ScheduleSpfCalculation();
+}
+
+void OspfRouting::NotifyAddAddress(uint32_t interface, Ipv4InterfaceAddress address) {
+    NS_LOG_FUNCTION(this << interface << address);
+    ScheduleSpfCalculation();
+}
+
+void OspfRouting::NotifyRemoveAddress(uint32_t interface, Ipv4InterfaceAddress address) {
+    NS_LOG_FUNCTION(this << interface << address);
+    ScheduleSpfCalculation();
+}
+
+void OspfRouting::PrintRoutingTable(Ptr<OutputStreamWrapper> stream, Time::Unit unit) const {
+    std::ostream* os = stream->GetStream();
+    // Copy the current ostream state
+    std::ios oldState(nullptr);
+    oldState.copyfmt(*os);
+
+    *os << std::resetiosflags(std::ios::adjustfield) << std::setiosflags(std::ios::left);
+
+    *os << "Node: " << m_ipv4->GetObject<Node>()->GetId() << ", Time: " << Now().As(unit)
+        << ", Local time: " << m_ipv4->GetObject<Node>()->GetLocalTime().As(unit)
+        << ", OSPF table" << std::endl;
+
+    if (m_routes.GetNRoutes() > 0) {
+        *os << "Destination     Gateway         Genmask         Flags Iface" << std::endl;
+        auto printRoutes = [this, os](const Ipv4RoutingTable::Routes& routes) {
+            for (Ipv4RoutingTableEntry* route : routes) {
+                std::ostringstream dest;
+                std::ostringstream gw;
+                std::ostringstream mask;
+                dest << route->GetDest();
+                gw << route->GetGateway();
+                mask << route->GetDestNetworkMask();
+                *os << std::setw(16) << dest.str() << std::setw(16) << gw.str() << std::setw(16)
+                    << mask.str();
+                *os << std::setw(6) << (route->IsHost() ? "UH" : (route->IsGateway() ? "UG" : "U"));
+                Ptr<NetDevice> device = m_ipv4->GetNetDevice(route->GetInterface());
+                if (!Names::FindName(device).empty()) {
+                    *os << Names::FindName(device);
+                } else {
+                    *os << route->GetInterface();
+                }
+                *os << std::endl;
+            }
+        };
+        printRoutes(m_routes.GetHostRoutes());
+        printRoutes(m_routes.GetNetworkRoutes());
+        printRoutes(m_routes.GetASExternalRoutes());
+    }
+    *os << std::endl;
+    // Restore the previous ostream state
+    (*os).copyfmt(oldState);
+}
+
+}
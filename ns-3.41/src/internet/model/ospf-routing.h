@@ -1,23 +1,132 @@
+/*
+ *  Copyright (c) 2024 Liverpool Hope University, UK
+ *  Authors:
+ *      Mark Greenwood
+ *      Nathan Nunes
+ *
+ *  File: ospf-routing.h
+ *
+ *  Declares OspfRouting, the Ipv4RoutingProtocol side of OSPF.
+ *
+ *  SPF runs are throttled with an exponential backoff (initial wait, hold
+ *  time doubling up to a maximum wait) so that a burst of LSAs results in a
+ *  single route recalculation.  Each run builds a complete Ipv4RoutingTable
+ *  off to the side and installs it with one swap.
+ *
+ */
+
+#ifndef OSPF_ROUTING_H
+#define OSPF_ROUTING_H
+
 #include "ipv4-routing-protocol.h"
+#include "ipv4-routing-table.h"
 #include "ospf-l4-protocol.h"
 
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/traced-callback.h"
+
+#include <set>
+
 namespace ns3
 {
 class OspfRouting : public Ipv4RoutingProtocol{
 public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
     OspfRouting();
     ~OspfRouting() override;
     OspfRouting(const OspfRouting&) = delete;
     OspfRouting& operator=(const OspfRouting&) = delete;
+
+    // From Ipv4RoutingProtocol
+    Ptr<Ipv4Route> RouteOutput(Ptr<Packet> p,
+                               const Ipv4Header& header,
+                               Ptr<NetDevice> oif,
+                               Socket::SocketErrno& sockerr) override;
+    bool RouteInput(Ptr<const Packet> p,
+                    const Ipv4Header& header,
+                    Ptr<const NetDevice> idev,
+                    const UnicastForwardCallback& ucb,
+                    const MulticastForwardCallback& mcb,
+                    const LocalDeliverCallback& lcb,
+                    const ErrorCallback& ecb) override;
+    void NotifyInterfaceUp(uint32_t interface) override;
+    void NotifyInterfaceDown(uint32_t interface) override;
+    void NotifyAddAddress(uint32_t interface, Ipv4InterfaceAddress address) override;
+    void NotifyRemoveAddress(uint32_t interface, Ipv4InterfaceAddress address) override;
     void SetIpv4(Ptr<Ipv4> ipv4) override;
+    void PrintRoutingTable(Ptr<OutputStreamWrapper> stream,
+                           Time::Unit unit = Time::S) const override;
+
     void SetInterfaceExclusions(std::set<uint32_t> exceptions);
 
+    /**
+     * \brief Request a new SPF calculation.
+     *
+     * Called whenever the link-state database changes (LSA received, local
+     * interface event).  Requests arriving while a calculation is already
+     * scheduled are merged into it.  The first request after a quiet period
+     * waits SpfInitialWait; requests arriving within the current hold time
+     * of the previous run wait until the hold time has elapsed, and the hold
+     * time doubles on each such run up to SpfMaxWait.
+     */
+    void ScheduleSpfCalculation();
+
+    /**
+     * \brief Get the number of routes currently installed.
+     * \return the number of routes
+     */
+    uint32_t GetNRoutes() const;
+
+    /**
+     * \brief Get the hold time applied to the next back-to-back SPF request.
+     * \return the current SPF hold time
+     */
+    Time GetSpfHoldTime() const;
+
+    /**
+     * TracedCallback signature for SPF calculations.
+     *
+     * \param [in] nRoutes number of routes installed by the calculation
+     * \param [in] holdTime hold time in force after the calculation
+     */
+    typedef void (*SpfTracedCallback)(uint32_t nRoutes, Time holdTime);
+
 protected:
     void DoInitialize() override;
     void DoDispose() override;
 private:
     void SendDownUpdate();
 
+    /**
+     * \brief Run the SPF calculation and install its result.
+     */
+    void SpfCalculate();
+
+    /**
+     * \brief Compute the full set of routes from the link-state database.
+     *
+     * Until LSA flooding is in place the database only contains the router's
+     * own links, so the shortest-path tree reduces to the directly attached
+     * networks of the active interfaces.
+     *
+     * \param table the table to fill
+     */
+    void BuildRoutes(Ipv4RoutingTable& table) const;
+
+    /**
+     * \brief Longest-prefix match lookup in the installed routes.
+     * \param dest destination address
+     * \param oif output interface if any (put 0 otherwise)
+     * \return Ipv4Route to route the packet to reach dest address
+     */
+    Ptr<Ipv4Route> LookupOspf(Ipv4Address dest, Ptr<NetDevice> oif = nullptr) const;
+
     Ptr<OspfL4Protocol> m_ospf_protocol;
     std::set<uint32_t> m_interfaceExclusions;   //interface
     Ptr<Ipv4> m_ipv4;                           //reference for an ipv4 address
@@ -26,5 +135,20 @@ private:
 
     Time m_down_timer;
     Time m_next_down_timer;
+
+    bool m_initialized;       //!< true once DoInitialize has run
+    Ipv4RoutingTable m_routes; //!< routes installed by the last SPF calculation
+
+    Time m_spfInitialWait;    //!< delay before the first SPF after a quiet period
+    Time m_spfHoldTime;       //!< initial hold time between consecutive SPF runs
+    Time m_spfMaxWait;        //!< upper bound of the hold time
+    Time m_spfCurrentHold;    //!< hold time in force for the next back-to-back request
+    Time m_lastSpf;           //!< time of the last SPF calculation
+    bool m_spfRan;            //!< true once at least one SPF calculation ran
+    EventId m_spfEvent;       //!< pending SPF calculation
+
+    TracedCallback<uint32_t, Time> m_spfTrace; //!< fired after each SPF calculation
 };
-}
\ No newline at end of file
+}
+
+#endif // OSPF_ROUTING_H
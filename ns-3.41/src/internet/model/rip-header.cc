@@ -255,8 +255,8 @@ RipHeader::Deserialize(Buffer::Iterator start)
         return 0;
     }
 
-    uint8_t rteNumber = i.GetRemainingSize() / 20;
-    for (uint8_t n = 0; n < rteNumber; n++)
+    uint32_t rteNumber = i.GetRemainingSize() / 20;
+    for (uint32_t n = 0; n < rteNumber; n++)
     {
         RipRte rte;
         i.Next(rte.Deserialize(i));
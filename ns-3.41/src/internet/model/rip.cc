@@ -34,6 +34,7 @@
 #include "ns3/random-variable-stream.h"
 #include "ns3/uinteger.h"
 
+#include <algorithm>
 #include <iomanip>
 
 #define RIP_ALL_NODE "224.0.0.9"
@@ -48,6 +49,8 @@ NS_OBJECT_ENSURE_REGISTERED(Rip);
 
 Rip::Rip()
     : m_ipv4(nullptr),
+      m_frontOrder(0),
+      m_backOrder(0),
       m_splitHorizonStrategy(Rip::POISON_REVERSE),
       m_initialized(false)
 {
@@ -408,9 +411,9 @@ Rip::NotifyInterfaceDown(uint32_t interface)
     /* remove all routes that are going through this interface */
     for (auto it = m_routes.begin(); it != m_routes.end(); it++)
     {
-        if (it->first->GetInterface() == interface)
+        if (it->route->GetInterface() == interface)
         {
-            InvalidateRoute(it->first);
+            InvalidateRoute(it);
         }
     }
 
@@ -478,13 +481,16 @@ Rip::NotifyRemoveAddress(uint32_t interface, Ipv4InterfaceAddress address)
 
     // Remove all routes that are going through this interface
     // which reference this network
-    for (auto it = m_routes.begin(); it != m_routes.end(); it++)
+    if (const auto* bucket = m_routesIndex.Find(networkAddress, networkMask))
     {
-        if (it->first->GetInterface() == interface && it->first->IsNetwork() &&
-            it->first->GetDestNetwork() == networkAddress &&
-            it->first->GetDestNetworkMask() == networkMask)
+        for (RoutesI it : *bucket)
         {
-            InvalidateRoute(it->first);
+            if (it->route->GetInterface() == interface && it->route->IsNetwork() &&
+                it->route->GetDestNetwork() == networkAddress &&
+                it->route->GetDestNetworkMask() == networkMask)
+            {
+                InvalidateRoute(it);
+            }
         }
     }
 
@@ -538,7 +544,7 @@ Rip::PrintRoutingTable(Ptr<OutputStreamWrapper> stream, Time::Unit unit) const
             << std::endl;
         for (auto it = m_routes.begin(); it != m_routes.end(); it++)
         {
-            RipRoutingTableEntry* route = it->first;
+            RipRoutingTableEntry* route = it->route;
             RipRoutingTableEntry::Status_e status = route->GetRouteStatus();
 
             if (status == RipRoutingTableEntry::RIP_VALID)
@@ -594,9 +600,12 @@ Rip::DoDispose()
 
     for (auto j = m_routes.begin(); j != m_routes.end(); j = m_routes.erase(j))
     {
-        delete j->first;
+        delete j->route;
     }
     m_routes.clear();
+    m_routesIndex.Clear();
+    m_expirations.clear();
+    m_expirationEvent.Cancel();
 
     m_nextTriggeredUpdate.Cancel();
     m_nextUnsolicitedUpdate.Cancel();
@@ -623,7 +632,6 @@ Rip::Lookup(Ipv4Address dst, bool setSource, Ptr<NetDevice> interface)
     NS_LOG_FUNCTION(this << dst << interface);
 
     Ptr<Ipv4Route> rtentry = nullptr;
-    uint16_t longestMask = 0;
 
     /* when sending on local multicast, there have to be interface specified */
     if (dst.IsLocalMulticast())
@@ -639,57 +647,57 @@ Rip::Lookup(Ipv4Address dst, bool setSource, Ptr<NetDevice> interface)
         return rtentry;
     }
 
-    for (auto it = m_routes.begin(); it != m_routes.end(); it++)
-    {
-        RipRoutingTableEntry* j = it->first;
-
-        if (j->GetRouteStatus() == RipRoutingTableEntry::RIP_VALID)
+    // Walk the networks containing dst from the longest prefix down.  On equal
+    // prefixes, the route closest to the back of the table wins.
+    RoutesI best;
+    bool found = false;
+    m_routesIndex.Lookup(dst, [&](uint16_t maskLen, const auto& bucket) {
+        NS_LOG_LOGIC("Searching for route to " << dst << ", mask length " << maskLen);
+        for (RoutesI it : bucket)
         {
-            Ipv4Mask mask = j->GetDestNetworkMask();
-            uint16_t maskLen = mask.GetPrefixLength();
-            Ipv4Address entry = j->GetDestNetwork();
-
-            NS_LOG_LOGIC("Searching for route to " << dst << ", mask length " << maskLen);
-
-            if (mask.IsMatch(dst, entry))
+            RipRoutingTableEntry* j = it->route;
+            if (j->GetRouteStatus() != RipRoutingTableEntry::RIP_VALID)
             {
-                NS_LOG_LOGIC("Found global network route " << j << ", mask length " << maskLen);
-
-                /* if interface is given, check the route will output on this interface */
-                if (!interface || interface == m_ipv4->GetNetDevice(j->GetInterface()))
-                {
-                    if (maskLen < longestMask)
-                    {
-                        NS_LOG_LOGIC("Previous match longer, skipping");
-                        continue;
-                    }
-
-                    longestMask = maskLen;
+                continue;
+            }
+            NS_LOG_LOGIC("Found global network route " << j << ", mask length " << maskLen);
 
-                    Ipv4RoutingTableEntry* route = j;
-                    uint32_t interfaceIdx = route->GetInterface();
-                    rtentry = Create<Ipv4Route>();
+            /* if interface is given, check the route will output on this interface */
+            if (interface && interface != m_ipv4->GetNetDevice(j->GetInterface()))
+            {
+                continue;
+            }
+            if (!found || it->order > best->order)
+            {
+                best = it;
+                found = true;
+            }
+        }
+        return found;
+    });
 
-                    if (setSource)
-                    {
-                        if (route->GetDest().IsAny()) /* default route */
-                        {
-                            rtentry->SetSource(
-                                m_ipv4->SourceAddressSelection(interfaceIdx, route->GetGateway()));
-                        }
-                        else
-                        {
-                            rtentry->SetSource(
-                                m_ipv4->SourceAddressSelection(interfaceIdx, route->GetDest()));
-                        }
-                    }
+    if (found)
+    {
+        Ipv4RoutingTableEntry* route = best->route;
+        uint32_t interfaceIdx = route->GetInterface();
+        rtentry = Create<Ipv4Route>();
 
-                    rtentry->SetDestination(route->GetDest());
-                    rtentry->SetGateway(route->GetGateway());
-                    rtentry->SetOutputDevice(m_ipv4->GetNetDevice(interfaceIdx));
-                }
+        if (setSource)
+        {
+            if (route->GetDest().IsAny()) /* default route */
+            {
+                rtentry->SetSource(
+                    m_ipv4->SourceAddressSelection(interfaceIdx, route->GetGateway()));
+            }
+            else
+            {
+                rtentry->SetSource(m_ipv4->SourceAddressSelection(interfaceIdx, route->GetDest()));
             }
         }
+
+        rtentry->SetDestination(route->GetDest());
+        rtentry->SetGateway(route->GetGateway());
+        rtentry->SetOutputDevice(m_ipv4->GetNetDevice(interfaceIdx));
     }
 
     if (rtentry)
@@ -713,7 +721,7 @@ Rip::AddNetworkRouteTo(Ipv4Address network,
     route->SetRouteStatus(RipRoutingTableEntry::RIP_VALID);
     route->SetRouteChanged(true);
 
-    m_routes.emplace_back(route, EventId());
+    InsertRoute(route, false);
 }
 
 void
@@ -726,48 +734,110 @@ Rip::AddNetworkRouteTo(Ipv4Address network, Ipv4Mask networkPrefix, uint32_t int
     route->SetRouteStatus(RipRoutingTableEntry::RIP_VALID);
     route->SetRouteChanged(true);
 
-    m_routes.emplace_back(route, EventId());
+    InsertRoute(route, false);
+}
+
+Rip::RoutesI
+Rip::InsertRoute(RipRoutingTableEntry* route, bool front)
+{
+    NS_LOG_FUNCTION(this << *route << front);
+
+    RouteSlot slot = {route, Time::Max(), front ? --m_frontOrder : m_backOrder++, false};
+    auto it = m_routes.insert(front ? m_routes.begin() : m_routes.end(), slot);
+    m_routesIndex.Insert(route->GetDestNetwork(), route->GetDestNetworkMask(), it);
+    return it;
 }
 
 void
-Rip::InvalidateRoute(RipRoutingTableEntry* route)
+Rip::SetRouteTimer(RoutesI it, Time delay, bool deletion)
 {
-    NS_LOG_FUNCTION(this << *route);
+    if (it->expiration != Time::Max())
+    {
+        m_expirations.erase({it->expiration, it});
+    }
+    it->expiration = Simulator::Now() + delay;
+    it->deletion = deletion;
+    m_expirations.emplace(it->expiration, it);
+    ScheduleExpiration();
+}
 
-    for (auto it = m_routes.begin(); it != m_routes.end(); it++)
+void
+Rip::ClearRouteTimer(RoutesI it)
+{
+    if (it->expiration != Time::Max())
     {
-        if (it->first == route)
-        {
-            route->SetRouteStatus(RipRoutingTableEntry::RIP_INVALID);
-            route->SetRouteMetric(m_linkDown);
-            route->SetRouteChanged(true);
-            if (it->second.IsRunning())
-            {
-                it->second.Cancel();
-            }
-            it->second =
-                Simulator::Schedule(m_garbageCollectionDelay, &Rip::DeleteRoute, this, route);
-            return;
-        }
+        m_expirations.erase({it->expiration, it});
+        it->expiration = Time::Max();
+        ScheduleExpiration();
     }
-    NS_ABORT_MSG("RIP::InvalidateRoute - cannot find the route to update");
 }
 
 void
-Rip::DeleteRoute(RipRoutingTableEntry* route)
+Rip::ScheduleExpiration()
 {
-    NS_LOG_FUNCTION(this << *route);
+    // A single event tracks the earliest timer of the table
+    if (m_expirations.empty())
+    {
+        m_expirationEvent.Cancel();
+        return;
+    }
+    Time next = m_expirations.begin()->first;
+    if (!m_expirationEvent.IsRunning() ||
+        m_expirationEvent.GetTs() != static_cast<uint64_t>(next.GetTimeStep()))
+    {
+        m_expirationEvent.Cancel();
+        m_expirationEvent = Simulator::Schedule(next - Simulator::Now(), &Rip::ExpireRoutes, this);
+    }
+}
 
-    for (auto it = m_routes.begin(); it != m_routes.end(); it++)
+Time
+Rip::GetRouteTimerLeft(RoutesCI it) const
+{
+    return it->expiration == Time::Max() ? Time() : it->expiration - Simulator::Now();
+}
+
+void
+Rip::ExpireRoutes()
+{
+    NS_LOG_FUNCTION(this);
+
+    while (!m_expirations.empty() && m_expirations.begin()->first <= Simulator::Now())
     {
-        if (it->first == route)
+        RoutesI it = m_expirations.begin()->second;
+        if (it->deletion)
         {
-            delete route;
-            m_routes.erase(it);
-            return;
+            DeleteRoute(it);
+        }
+        else
+        {
+            InvalidateRoute(it);
         }
     }
-    NS_ABORT_MSG("RIP::DeleteRoute - cannot find the route to delete");
+}
+
+void
+Rip::InvalidateRoute(RoutesI it)
+{
+    NS_LOG_FUNCTION(this << *it->route);
+
+    it->route->SetRouteStatus(RipRoutingTableEntry::RIP_INVALID);
+    it->route->SetRouteMetric(m_linkDown);
+    it->route->SetRouteChanged(true);
+    SetRouteTimer(it, m_garbageCollectionDelay, true);
+}
+
+void
+Rip::DeleteRoute(RoutesI it)
+{
+    NS_LOG_FUNCTION(this << *it->route);
+
+    ClearRouteTimer(it);
+    bool removed = m_routesIndex.Remove(it->route->GetDestNetwork(),
+                                        it->route->GetDestNetworkMask(),
+                                        it);
+    NS_ABORT_MSG_UNLESS(removed, "RIP::DeleteRoute - cannot find the route to delete");
+    delete it->route;
+    m_routes.erase(it);
 }
 
 void
@@ -879,75 +949,10 @@ Rip::HandleRequests(RipHeader requestHdr,
                 NS_ASSERT_MSG(sendingSocket,
                               "HandleRequest - Impossible to find a socket to send the reply");
 
-                uint16_t mtu = m_ipv4->GetMtu(incomingInterface);
-                uint16_t maxRte =
-                    (mtu - Ipv4Header().GetSerializedSize() - UdpHeader().GetSerializedSize() -
-                     RipHeader().GetSerializedSize()) /
-                    RipRte().GetSerializedSize();
-
-                Ptr<Packet> p = Create<Packet>();
-                SocketIpTtlTag tag;
-                p->RemovePacketTag(tag);
-                if (senderAddress == Ipv4Address(RIP_ALL_NODE))
-                {
-                    tag.SetTtl(1);
-                }
-                else
-                {
-                    tag.SetTtl(255);
-                }
-                p->AddPacketTag(tag);
-
-                RipHeader hdr;
-                hdr.SetCommand(RipHeader::RESPONSE);
-
-                for (auto rtIter = m_routes.begin(); rtIter != m_routes.end(); rtIter++)
+                uint8_t ttl = senderAddress == Ipv4Address(RIP_ALL_NODE) ? 1 : 255;
+                std::vector<AdvertisedRoute> rtes = CollectRtes(true, false);
+                for (const auto& p : PackRtes(rtes, incomingInterface, false, ttl))
                 {
-                    bool splitHorizoning = (rtIter->first->GetInterface() == incomingInterface);
-
-                    Ipv4InterfaceAddress rtDestAddr =
-                        Ipv4InterfaceAddress(rtIter->first->GetDestNetwork(),
-                                             rtIter->first->GetDestNetworkMask());
-
-                    bool isGlobal = (rtDestAddr.GetScope() == Ipv4InterfaceAddress::GLOBAL);
-                    bool isDefaultRoute =
-                        ((rtIter->first->GetDestNetwork() == Ipv4Address::GetAny()) &&
-                         (rtIter->first->GetDestNetworkMask() == Ipv4Mask::GetZero()) &&
-                         (rtIter->first->GetInterface() != incomingInterface));
-
-                    if ((isGlobal || isDefaultRoute) &&
-                        (rtIter->first->GetRouteStatus() == RipRoutingTableEntry::RIP_VALID))
-                    {
-                        RipRte rte;
-                        rte.SetPrefix(rtIter->first->GetDestNetwork());
-                        rte.SetSubnetMask(rtIter->first->GetDestNetworkMask());
-                        if (m_splitHorizonStrategy == POISON_REVERSE && splitHorizoning)
-                        {
-                            rte.SetRouteMetric(m_linkDown);
-                        }
-                        else
-                        {
-                            rte.SetRouteMetric(rtIter->first->GetRouteMetric());
-                        }
-                        rte.SetRouteTag(rtIter->first->GetRouteTag());
-                        if ((m_splitHorizonStrategy != SPLIT_HORIZON) ||
-                            (m_splitHorizonStrategy == SPLIT_HORIZON && !splitHorizoning))
-                        {
-                            hdr.AddRte(rte);
-                        }
-                    }
-                    if (hdr.GetRteNumber() == maxRte)
-                    {
-                        p->AddHeader(hdr);
-                        NS_LOG_DEBUG("SendTo: " << *p);
-                        sendingSocket->SendTo(p, 0, InetSocketAddress(senderAddress, RIP_PORT));
-                        p->RemoveHeader(hdr);
-                        hdr.ClearRtes();
-                    }
-                }
-                if (hdr.GetRteNumber() > 0)
-                {
-                    p->AddHeader(hdr);
                     NS_LOG_DEBUG("SendTo: " << *p);
                     sendingSocket->SendTo(p, 0, InetSocketAddress(senderAddress, RIP_PORT));
                 }
@@ -980,20 +985,20 @@ Rip::HandleRequests(RipHeader requestHdr,
             for (auto rtIter = m_routes.begin(); rtIter != m_routes.end(); rtIter++)
             {
                 Ipv4InterfaceAddress rtDestAddr =
-                    Ipv4InterfaceAddress(rtIter->first->GetDestNetwork(),
-                                         rtIter->first->GetDestNetworkMask());
+                    Ipv4InterfaceAddress(rtIter->route->GetDestNetwork(),
+                                         rtIter->route->GetDestNetworkMask());
                 if ((rtDestAddr.GetScope() == Ipv4InterfaceAddress::GLOBAL) &&
-                    (rtIter->first->GetRouteStatus() == RipRoutingTableEntry::RIP_VALID))
+                    (rtIter->route->GetRouteStatus() == RipRoutingTableEntry::RIP_VALID))
                 {
                     Ipv4Address requestedAddress = iter->GetPrefix();
                     requestedAddress.CombineMask(iter->GetSubnetMask());
-                    Ipv4Address rtAddress = rtIter->first->GetDestNetwork();
-                    rtAddress.CombineMask(rtIter->first->GetDestNetworkMask());
+                    Ipv4Address rtAddress = rtIter->route->GetDestNetwork();
+                    rtAddress.CombineMask(rtIter->route->GetDestNetworkMask());
 
                     if (requestedAddress == rtAddress)
                     {
-                        iter->SetRouteMetric(rtIter->first->GetRouteMetric());
-                        iter->SetRouteTag(rtIter->first->GetRouteTag());
+                        iter->SetRouteMetric(rtIter->route->GetRouteMetric());
+                        iter->SetRouteTag(rtIter->route->GetRouteTag());
                         hdr.AddRte(*iter);
                         found = true;
                         break;
@@ -1067,89 +1072,84 @@ Rip::HandleResponses(RipHeader hdr,
             rteMetric = m_linkDown;
         }
 
-        RoutesI it;
-        bool found = false;
-        for (it = m_routes.begin(); it != m_routes.end(); it++)
+        // The routes to the network, in the order of the table
+        std::vector<RoutesI> routes;
+        if (const auto* bucket = m_routesIndex.Find(rteAddr, rtePrefixMask))
         {
-            if (it->first->GetDestNetwork() == rteAddr &&
-                it->first->GetDestNetworkMask() == rtePrefixMask)
+            for (RoutesI it : *bucket)
             {
-                found = true;
-                if (rteMetric < it->first->GetRouteMetric())
+                if (it->route->GetDestNetwork() == rteAddr &&
+                    it->route->GetDestNetworkMask() == rtePrefixMask)
                 {
-                    if (senderAddress != it->first->GetGateway())
+                    routes.push_back(it);
+                }
+            }
+            std::sort(routes.begin(), routes.end(), [](RoutesI a, RoutesI b) {
+                return a->order < b->order;
+            });
+        }
+        bool found = !routes.empty();
+        for (RoutesI it : routes)
+        {
+            if (rteMetric < it->route->GetRouteMetric())
+            {
+                if (senderAddress != it->route->GetGateway())
+                {
+                    auto route = new RipRoutingTableEntry(rteAddr,
+                                                          rtePrefixMask,
+                                                          senderAddress,
+                                                          incomingInterface);
+                    delete it->route;
+                    it->route = route;
+                }
+                it->route->SetRouteMetric(rteMetric);
+                it->route->SetRouteStatus(RipRoutingTableEntry::RIP_VALID);
+                it->route->SetRouteTag(iter->GetRouteTag());
+                it->route->SetRouteChanged(true);
+                SetRouteTimer(it, m_timeoutDelay);
+                changed = true;
+            }
+            else if (rteMetric == it->route->GetRouteMetric())
+            {
+                if (senderAddress == it->route->GetGateway())
+                {
+                    SetRouteTimer(it, m_timeoutDelay);
+                }
+                else
+                {
+                    if (GetRouteTimerLeft(it) < m_timeoutDelay / 2)
                     {
                         auto route = new RipRoutingTableEntry(rteAddr,
                                                               rtePrefixMask,
                                                               senderAddress,
                                                               incomingInterface);
-                        delete it->first;
-                        it->first = route;
+                        route->SetRouteMetric(rteMetric);
+                        route->SetRouteStatus(RipRoutingTableEntry::RIP_VALID);
+                        route->SetRouteTag(iter->GetRouteTag());
+                        route->SetRouteChanged(true);
+                        delete it->route;
+                        it->route = route;
+                        SetRouteTimer(it, m_timeoutDelay);
+                        changed = true;
                     }
-                    it->first->SetRouteMetric(rteMetric);
-                    it->first->SetRouteStatus(RipRoutingTableEntry::RIP_VALID);
-                    it->first->SetRouteTag(iter->GetRouteTag());
-                    it->first->SetRouteChanged(true);
-                    it->second.Cancel();
-                    it->second =
-                        Simulator::Schedule(m_timeoutDelay, &Rip::InvalidateRoute, this, it->first);
-                    changed = true;
                 }
-                else if (rteMetric == it->first->GetRouteMetric())
+            }
+            else if (rteMetric > it->route->GetRouteMetric() &&
+                     senderAddress == it->route->GetGateway())
+            {
+                if (rteMetric < m_linkDown)
                 {
-                    if (senderAddress == it->first->GetGateway())
-                    {
-                        it->second.Cancel();
-                        it->second = Simulator::Schedule(m_timeoutDelay,
-                                                         &Rip::InvalidateRoute,
-                                                         this,
-                                                         it->first);
-                    }
-                    else
-                    {
-                        if (Simulator::GetDelayLeft(it->second) < m_timeoutDelay / 2)
-                        {
-                            auto route = new RipRoutingTableEntry(rteAddr,
-                                                                  rtePrefixMask,
-                                                                  senderAddress,
-                                                                  incomingInterface);
-                            route->SetRouteMetric(rteMetric);
-                            route->SetRouteStatus(RipRoutingTableEntry::RIP_VALID);
-                            route->SetRouteTag(iter->GetRouteTag());
-                            route->SetRouteChanged(true);
-                            delete it->first;
-                            it->first = route;
-                            it->second.Cancel();
-                            it->second = Simulator::Schedule(m_timeoutDelay,
-                                                             &Rip::InvalidateRoute,
-                                                             this,
-                                                             route);
-                            changed = true;
-                        }
-                    }
+                    it->route->SetRouteMetric(rteMetric);
+                    it->route->SetRouteStatus(RipRoutingTableEntry::RIP_VALID);
+                    it->route->SetRouteTag(iter->GetRouteTag());
+                    it->route->SetRouteChanged(true);
+                    SetRouteTimer(it, m_timeoutDelay);
                 }
-                else if (rteMetric > it->first->GetRouteMetric() &&
-                         senderAddress == it->first->GetGateway())
+                else
                 {
-                    it->second.Cancel();
-                    if (rteMetric < m_linkDown)
-                    {
-                        it->first->SetRouteMetric(rteMetric);
-                        it->first->SetRouteStatus(RipRoutingTableEntry::RIP_VALID);
-                        it->first->SetRouteTag(iter->GetRouteTag());
-                        it->first->SetRouteChanged(true);
-                        it->second.Cancel();
-                        it->second = Simulator::Schedule(m_timeoutDelay,
-                                                         &Rip::InvalidateRoute,
-                                                         this,
-                                                         it->first);
-                    }
-                    else
-                    {
-                        InvalidateRoute(it->first);
-                    }
-                    changed = true;
+                    InvalidateRoute(it);
                 }
+                changed = true;
             }
         }
         if (!found && rteMetric != m_linkDown)
@@ -1161,10 +1161,7 @@ Rip::HandleResponses(RipHeader hdr,
             route->SetRouteMetric(rteMetric);
             route->SetRouteStatus(RipRoutingTableEntry::RIP_VALID);
             route->SetRouteChanged(true);
-            m_routes.emplace_front(route, EventId());
-            EventId invalidateEvent =
-                Simulator::Schedule(m_timeoutDelay, &Rip::InvalidateRoute, this, route);
-            (m_routes.begin())->second = invalidateEvent;
+            SetRouteTimer(InsertRoute(route, true), m_timeoutDelay);
             changed = true;
         }
     }
@@ -1175,101 +1172,142 @@ Rip::HandleResponses(RipHeader hdr,
     }
 }
 
-void
-Rip::DoSendRouteUpdate(bool periodic)
+std::vector<Rip::AdvertisedRoute>
+Rip::CollectRtes(bool validOnly, bool changedOnly) const
 {
-    NS_LOG_FUNCTION(this << (periodic ? " periodic" : " triggered"));
+    NS_LOG_FUNCTION(this << validOnly << changedOnly);
 
-    for (auto iter = m_unicastSocketList.begin(); iter != m_unicastSocketList.end(); iter++)
+    std::vector<AdvertisedRoute> rtes;
+    for (const auto& slot : m_routes)
     {
-        uint32_t interface = iter->second;
+        const RipRoutingTableEntry* route = slot.route;
+        Ipv4InterfaceAddress rtDestAddr =
+            Ipv4InterfaceAddress(route->GetDestNetwork(), route->GetDestNetworkMask());
 
-        if (m_interfaceExclusions.find(interface) == m_interfaceExclusions.end())
+        NS_LOG_DEBUG("Processing RT " << rtDestAddr << " " << int(route->IsRouteChanged()));
+
+        // The default route is global, hence advertised as well
+        if (rtDestAddr.GetScope() != Ipv4InterfaceAddress::GLOBAL ||
+            (validOnly && route->GetRouteStatus() != RipRoutingTableEntry::RIP_VALID) ||
+            (changedOnly && !route->IsRouteChanged()))
         {
-            uint16_t mtu = m_ipv4->GetMtu(interface);
-            uint16_t maxRte = (mtu - Ipv4Header().GetSerializedSize() -
-                               UdpHeader().GetSerializedSize() - RipHeader().GetSerializedSize()) /
-                              RipRte().GetSerializedSize();
+            continue;
+        }
+        AdvertisedRoute advertised;
+        advertised.rte.SetPrefix(route->GetDestNetwork());
+        advertised.rte.SetSubnetMask(route->GetDestNetworkMask());
+        advertised.rte.SetRouteMetric(route->GetRouteMetric());
+        advertised.rte.SetRouteTag(route->GetRouteTag());
+        advertised.interface = route->GetInterface();
+        rtes.push_back(advertised);
+    }
+    return rtes;
+}
 
-            Ptr<Packet> p = Create<Packet>();
-            SocketIpTtlTag tag;
-            tag.SetTtl(1);
-            p->AddPacketTag(tag);
+std::vector<Ptr<Packet>>
+Rip::PackRtes(const std::vector<AdvertisedRoute>& rtes,
+              uint32_t interface,
+              bool skipOwnNetworks,
+              uint8_t ttl) const
+{
+    NS_LOG_FUNCTION(this << rtes.size() << interface << skipOwnNetworks << int(ttl));
 
-            RipHeader hdr;
-            hdr.SetCommand(RipHeader::RESPONSE);
+    uint16_t mtu = m_ipv4->GetMtu(interface);
+    uint16_t maxRte = (mtu - Ipv4Header().GetSerializedSize() - UdpHeader().GetSerializedSize() -
+                       RipHeader().GetSerializedSize()) /
+                      RipRte().GetSerializedSize();
 
-            for (auto rtIter = m_routes.begin(); rtIter != m_routes.end(); rtIter++)
-            {
-                bool splitHorizoning = (rtIter->first->GetInterface() == interface);
-                Ipv4InterfaceAddress rtDestAddr =
-                    Ipv4InterfaceAddress(rtIter->first->GetDestNetwork(),
-                                         rtIter->first->GetDestNetworkMask());
+    // Sorted, as stub interfaces may have many networks
+    std::vector<Ipv4Address> ownNetworks;
+    if (skipOwnNetworks)
+    {
+        for (uint32_t index = 0; index < m_ipv4->GetNAddresses(interface); index++)
+        {
+            Ipv4InterfaceAddress addr = m_ipv4->GetAddress(interface, index);
+            ownNetworks.push_back(addr.GetLocal().CombineMask(addr.GetMask()));
+        }
+        std::sort(ownNetworks.begin(), ownNetworks.end());
+    }
 
-                NS_LOG_DEBUG("Processing RT " << rtDestAddr << " "
-                                              << int(rtIter->first->IsRouteChanged()));
+    std::vector<Ptr<Packet>> responses;
+    RipHeader hdr;
+    hdr.SetCommand(RipHeader::RESPONSE);
+    auto pack = [&]() {
+        Ptr<Packet> p = Create<Packet>();
+        SocketIpTtlTag tag;
+        tag.SetTtl(ttl);
+        p->AddPacketTag(tag);
+        p->AddHeader(hdr);
+        responses.push_back(p);
+        hdr.ClearRtes();
+    };
 
-                bool isGlobal = (rtDestAddr.GetScope() == Ipv4InterfaceAddress::GLOBAL);
-                bool isDefaultRoute =
-                    ((rtIter->first->GetDestNetwork() == Ipv4Address::GetAny()) &&
-                     (rtIter->first->GetDestNetworkMask() == Ipv4Mask::GetZero()) &&
-                     (rtIter->first->GetInterface() != interface));
+    for (const auto& advertised : rtes)
+    {
+        if (std::binary_search(ownNetworks.begin(), ownNetworks.end(), advertised.rte.GetPrefix()))
+        {
+            continue;
+        }
+        bool splitHorizoning = (advertised.interface == interface);
+        if (m_splitHorizonStrategy == SPLIT_HORIZON && splitHorizoning)
+        {
+            continue;
+        }
+        if (m_splitHorizonStrategy == POISON_REVERSE && splitHorizoning)
+        {
+            RipRte rte = advertised.rte;
+            rte.SetRouteMetric(m_linkDown);
+            hdr.AddRte(rte);
+        }
+        else
+        {
+            hdr.AddRte(advertised.rte);
+        }
+        if (hdr.GetRteNumber() == maxRte)
+        {
+            pack();
+        }
+    }
+    if (hdr.GetRteNumber() > 0)
+    {
+        pack();
+    }
+    return responses;
+}
 
-                bool sameNetwork = false;
-                for (uint32_t index = 0; index < m_ipv4->GetNAddresses(interface); index++)
-                {
-                    Ipv4InterfaceAddress addr = m_ipv4->GetAddress(interface, index);
-                    if (addr.GetLocal().CombineMask(addr.GetMask()) ==
-                        rtIter->first->GetDestNetwork())
-                    {
-                        sameNetwork = true;
-                    }
-                }
+void
+Rip::DoSendRouteUpdate(bool periodic)
+{
+    NS_LOG_FUNCTION(this << (periodic ? " periodic" : " triggered"));
 
-                if ((isGlobal || isDefaultRoute) && (periodic || rtIter->first->IsRouteChanged()) &&
-                    !sameNetwork)
+    // The RTEs are collected once, and packed once per interface with its own
+    // split horizon, whatever the number of sockets on the interface
+    std::vector<AdvertisedRoute> rtes = CollectRtes(false, !periodic);
+    if (!rtes.empty())
+    {
+        std::map<uint32_t, std::vector<Ptr<Packet>>> responses;
+        for (auto iter = m_unicastSocketList.begin(); iter != m_unicastSocketList.end(); iter++)
+        {
+            uint32_t interface = iter->second;
+
+            if (m_interfaceExclusions.find(interface) == m_interfaceExclusions.end())
+            {
+                auto packed = responses.find(interface);
+                if (packed == responses.end())
                 {
-                    RipRte rte;
-                    rte.SetPrefix(rtIter->first->GetDestNetwork());
-                    rte.SetSubnetMask(rtIter->first->GetDestNetworkMask());
-                    if (m_splitHorizonStrategy == POISON_REVERSE && splitHorizoning)
-                    {
-                        rte.SetRouteMetric(m_linkDown);
-                    }
-                    else
-                    {
-                        rte.SetRouteMetric(rtIter->first->GetRouteMetric());
-                    }
-                    rte.SetRouteTag(rtIter->first->GetRouteTag());
-                    if (m_splitHorizonStrategy == SPLIT_HORIZON && !splitHorizoning)
-                    {
-                        hdr.AddRte(rte);
-                    }
-                    else if (m_splitHorizonStrategy != SPLIT_HORIZON)
-                    {
-                        hdr.AddRte(rte);
-                    }
+                    packed = responses.emplace(interface, PackRtes(rtes, interface, true, 1)).first;
                 }
-                if (hdr.GetRteNumber() == maxRte)
+                for (const auto& p : packed->second)
                 {
-                    p->AddHeader(hdr);
                     NS_LOG_DEBUG("SendTo: " << *p);
-                    iter->first->SendTo(p, 0, InetSocketAddress(RIP_ALL_NODE, RIP_PORT));
-                    p->RemoveHeader(hdr);
-                    hdr.ClearRtes();
+                    iter->first->SendTo(p->Copy(), 0, InetSocketAddress(RIP_ALL_NODE, RIP_PORT));
                 }
             }
-            if (hdr.GetRteNumber() > 0)
-            {
-                p->AddHeader(hdr);
-                NS_LOG_DEBUG("SendTo: " << *p);
-                iter->first->SendTo(p, 0, InetSocketAddress(RIP_ALL_NODE, RIP_PORT));
-            }
         }
     }
     for (auto rtIter = m_routes.begin(); rtIter != m_routes.end(); rtIter++)
     {
-        rtIter->first->SetRouteChanged(false);
+        rtIter->route->SetRouteChanged(false);
     }
 }
 
@@ -1302,6 +1340,13 @@ Rip::SendTriggeredRouteUpdate()
 
     Time delay = Seconds(m_rng->GetValue(m_minTriggeredUpdateDelay.GetSeconds(),
                                          m_maxTriggeredUpdateDelay.GetSeconds()));
+    // The changes are batched in the unsolicited update if it is due first
+    if (m_nextUnsolicitedUpdate.IsRunning() &&
+        Simulator::GetDelayLeft(m_nextUnsolicitedUpdate) <= delay)
+    {
+        NS_LOG_LOGIC("Suppressing Triggered Update, an Unsolicited Update is due first");
+        return;
+    }
     m_nextTriggeredUpdate = Simulator::Schedule(delay, &Rip::DoSendRouteUpdate, this, false);
 }
 
@@ -22,6 +22,7 @@
 
 #include "ipv4-interface.h"
 #include "ipv4-l3-protocol.h"
+#include "ipv4-routing-prefix-index.h"
 #include "ipv4-routing-protocol.h"
 #include "ipv4-routing-table-entry.h"
 #include "rip-header.h"
@@ -30,6 +31,8 @@
 #include "ns3/random-variable-stream.h"
 
 #include <list>
+#include <set>
+#include <vector>
 
 namespace ns3
 {
@@ -274,14 +277,49 @@ class Rip : public Ipv4RoutingProtocol
     void DoInitialize() override;
 
   private:
-    /// Container for the network routes - pair RipRoutingTableEntry *, EventId (update event)
-    typedef std::list<std::pair<RipRoutingTableEntry*, EventId>> Routes;
+    /**
+     * A network route and its timer.  A valid route times out when its timer
+     * expires, an invalid route is then deleted.
+     */
+    struct RouteSlot
+    {
+        RipRoutingTableEntry* route; //!< the route
+        Time expiration;             //!< when the timer of the route expires, Time::Max if none
+        int64_t order;               //!< rank of the route in the forwarding table
+        bool deletion;               //!< true if the timer deletes the route, else invalidates it
+    };
+
+    /// Container for the network routes
+    typedef std::list<RouteSlot> Routes;
 
     /// Const Iterator for container for the network routes
-    typedef std::list<std::pair<RipRoutingTableEntry*, EventId>>::const_iterator RoutesCI;
+    typedef std::list<RouteSlot>::const_iterator RoutesCI;
 
     /// Iterator for container for the network routes
-    typedef std::list<std::pair<RipRoutingTableEntry*, EventId>>::iterator RoutesI;
+    typedef std::list<RouteSlot>::iterator RoutesI;
+
+    /// Order of the route timers: by expiration, then by rank of the route
+    struct ExpirationCompare
+    {
+        /**
+         * \param a a timer
+         * \param b another timer
+         * 
+eturn true if \p a expires before \p b
+         */
+        bool operator()(const std::pair<Time, RoutesI>& a,
+                        const std::pair<Time, RoutesI>& b) const
+        {
+            return a.first < b.first || (a.first == b.first && a.second->order < b.second->order);
+        }
+    };
+
+    /// A route to advertise, with the interface it goes through
+    struct AdvertisedRoute
+    {
+        RipRte rte;         //!< the RTE, with the metric of the route
+        uint32_t interface; //!< the interface of the route
+    };
 
     /**
      * \brief Receive RIP packets.
@@ -358,6 +396,68 @@ class Rip : public Ipv4RoutingProtocol
      */
     void AddNetworkRouteTo(Ipv4Address network, Ipv4Mask networkPrefix, uint32_t interface);
 
+    /**
+     * \brief Add a route to the forwarding table.
+     * \param route the route
+     * \param front true to put the route at the front of the table, else at the back
+     * \return the route slot
+     */
+    RoutesI InsertRoute(RipRoutingTableEntry* route, bool front);
+
+    /**
+     * \brief Set the timer of a route, replacing the previous one.
+     * \param it the route slot
+     * \param delay delay before the timer expires
+     * \param deletion true if the timer deletes the route, else it invalidates it
+     */
+    void SetRouteTimer(RoutesI it, Time delay, bool deletion = false);
+
+    /**
+     * \brief Clear the timer of a route.
+     * \param it the route slot
+     */
+    void ClearRouteTimer(RoutesI it);
+
+    /**
+     * \brief Schedule the expiration of the earliest route timer.
+     */
+    void ScheduleExpiration();
+
+    /**
+     * \brief Get the time left before the timer of a route expires.
+     * \param it the route slot
+     * \return the time left, zero if the route has no timer
+     */
+    Time GetRouteTimerLeft(RoutesCI it) const;
+
+    /**
+     * \brief Invalidate the routes whose timeout expired, and delete the
+     * invalid routes whose garbage collection delay expired.
+     */
+    void ExpireRoutes();
+
+    /**
+     * \brief Collect the RTEs to advertise, once for all the interfaces.
+     * \param validOnly true to skip the invalid routes
+     * \param changedOnly true to skip the routes that did not change
+     * \return the RTEs, in the order of the forwarding table
+     */
+    std::vector<AdvertisedRoute> CollectRtes(bool validOnly, bool changedOnly) const;
+
+    /**
+     * \brief Pack RTEs for an interface in as few responses as the MTU allows,
+     * after applying the split horizon strategy.
+     * \param rtes the RTEs
+     * \param interface the interface
+     * \param skipOwnNetworks true to skip the networks of the interface
+     * \param ttl the TTL of the responses
+     * \return the responses
+     */
+    std::vector<Ptr<Packet>> PackRtes(const std::vector<AdvertisedRoute>& rtes,
+                                      uint32_t interface,
+                                      bool skipOwnNetworks,
+                                      uint8_t ttl) const;
+
     /**
      * \brief Send Routing Updates on all interfaces.
      * \param periodic true for periodic update, else triggered.
@@ -381,15 +481,15 @@ class Rip : public Ipv4RoutingProtocol
 
     /**
      * \brief Invalidate a route.
-     * \param route the route to be removed
+     * \param it the slot of the route to be invalidated
      */
-    void InvalidateRoute(RipRoutingTableEntry* route);
+    void InvalidateRoute(RoutesI it);
 
     /**
      * \brief Delete a route.
-     * \param route the route to be removed
+     * \param it the slot of the route to be removed
      */
-    void DeleteRoute(RipRoutingTableEntry* route);
+    void DeleteRoute(RoutesI it);
 
     Routes m_routes;                //!<  the forwarding table for network.
     Ptr<Ipv4> m_ipv4;               //!< IPv4 reference
@@ -400,6 +500,13 @@ class Rip : public Ipv4RoutingProtocol
     Time m_timeoutDelay;            //!< Delay before invalidating a route
     Time m_garbageCollectionDelay;  //!< Delay before deleting an INVALID route
 
+    Ipv4RoutingPrefixIndex<RoutesI> m_routesIndex; //!< the routes by destination network
+    /// The route timers
+    std::set<std::pair<Time, RoutesI>, ExpirationCompare> m_expirations;
+    EventId m_expirationEvent; //!< expiration of the earliest route timer
+    int64_t m_frontOrder;      //!< rank of the route at the front of the table
+    int64_t m_backOrder;       //!< rank of the route at the back of the table
+
     // note: we can not trust the result of socket->GetBoundNetDevice ()->GetIfIndex ();
     // it is dependent on the interface initialization (i.e., if the loopback is already up).
     /// Socket list type
@@ -61,13 +61,29 @@ GlobalRouteManagerImplTestCase::DoRun()
     for (int i = 0; i < 100; ++i)
     {
         auto v = new SPFVertex;
+        v->SetVertexId(Ipv4Address(i + 1));
         v->SetDistanceFromRoot(std::rand() % 100);
         candidate.Push(v);
     }
 
+    // Move some vertices closer to the root
+    for (uint32_t i = 0; i < 100; i += 7)
+    {
+        SPFVertex* v = candidate.Find(Ipv4Address(i + 1));
+        NS_TEST_ASSERT_MSG_NE(v, nullptr, "Vertex not found");
+        v->SetDistanceFromRoot(v->GetDistanceFromRoot() / 2);
+        candidate.DecreaseKey(v);
+    }
+    NS_TEST_ASSERT_MSG_EQ(candidate.Size(), 100, "Wrong number of candidates");
+
+    uint32_t distance = 0;
     for (int i = 0; i < 100; ++i)
     {
         SPFVertex* v = candidate.Pop();
+        NS_TEST_ASSERT_MSG_GT_OR_EQ(v->GetDistanceFromRoot(),
+                                    distance,
+                                    "Candidates not popped in order of distance");
+        distance = v->GetDistanceFromRoot();
         delete v;
         v = nullptr;
     }
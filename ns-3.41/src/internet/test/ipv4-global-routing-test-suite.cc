@@ -21,16 +21,20 @@
 #include "ns3/ipv4-address-helper.h"
 #include "ns3/ipv4-global-routing-helper.h"
 #include "ns3/ipv4-global-routing.h"
+#include "ns3/ipv4-header.h"
 #include "ns3/ipv4-l3-protocol.h"
 #include "ns3/ipv4-packet-info-tag.h"
+#include "ns3/ipv4-route.h"
 #include "ns3/ipv4-routing-protocol.h"
 #include "ns3/ipv4-routing-table-entry.h"
+#include "ns3/ipv4-routing-table.h"
 #include "ns3/ipv4-static-routing-helper.h"
 #include "ns3/log.h"
 #include "ns3/node-container.h"
 #include "ns3/node.h"
 #include "ns3/packet.h"
 #include "ns3/pointer.h"
+#include "ns3/random-variable-stream.h"
 #include "ns3/simple-channel.h"
 #include "ns3/simple-net-device-helper.h"
 #include "ns3/simple-net-device.h"
@@ -38,9 +42,12 @@
 #include "ns3/socket-factory.h"
 #include "ns3/string.h"
 #include "ns3/test.h"
+#include "ns3/udp-header.h"
 #include "ns3/udp-socket-factory.h"
 #include "ns3/uinteger.h"
 
+#include <algorithm>
+#include <sstream>
 #include <vector>
 
 using namespace ns3;
@@ -1311,6 +1318,514 @@ Ipv4GlobalRoutingSlash32TestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup internet-test
+ *
+ * \brief IPv4 GlobalRouting bulk route table swap test
+ */
+class Ipv4GlobalRoutingSwapRoutesTestCase : public TestCase
+{
+  public:
+    Ipv4GlobalRoutingSwapRoutesTestCase();
+    void DoRun() override;
+};
+
+Ipv4GlobalRoutingSwapRoutesTestCase::Ipv4GlobalRoutingSwapRoutesTestCase()
+    : TestCase("Replace the global routing table with a staged table")
+{
+}
+
+void
+Ipv4GlobalRoutingSwapRoutesTestCase::DoRun()
+{
+    Ptr<Ipv4GlobalRouting> globalRouting = CreateObject<Ipv4GlobalRouting>();
+    globalRouting->AddHostRouteTo(Ipv4Address("10.0.0.1"), Ipv4Address("10.0.1.1"), 1);
+    globalRouting->AddNetworkRouteTo(Ipv4Address("10.2.0.0"), Ipv4Mask("255.255.0.0"), 1);
+
+    Ipv4RoutingTable table;
+    table.AddHostRouteTo(Ipv4Address("10.0.0.2"), 2);
+    table.AddNetworkRouteTo(Ipv4Address("10.3.0.0"),
+                            Ipv4Mask("255.255.0.0"),
+                            Ipv4Address("10.0.2.1"),
+                            2);
+    table.AddASExternalRouteTo(Ipv4Address("192.168.0.0"),
+                               Ipv4Mask("255.255.0.0"),
+                               Ipv4Address("10.0.2.1"),
+                               2);
+    Ipv4RoutingTableEntry* staged = table.GetHostRoutes().front();
+
+    globalRouting->SwapRoutes(table);
+
+    NS_TEST_ASSERT_MSG_EQ(globalRouting->GetNRoutes(), 3, "Staged routes not installed");
+    NS_TEST_EXPECT_MSG_EQ(globalRouting->GetRoute(0), staged, "Route entry was copied");
+    NS_TEST_EXPECT_MSG_EQ(globalRouting->GetRoute(1)->GetDestNetwork(),
+                          Ipv4Address("10.3.0.0"),
+                          "Wrong network route");
+    NS_TEST_EXPECT_MSG_EQ(globalRouting->GetRoute(2)->GetDestNetwork(),
+                          Ipv4Address("192.168.0.0"),
+                          "Wrong external route");
+    NS_TEST_EXPECT_MSG_EQ(table.GetNRoutes(), 2, "Previous routes not handed back");
+    NS_TEST_EXPECT_MSG_EQ(table.GetHostRoutes().front()->GetDest(),
+                          Ipv4Address("10.0.0.1"),
+                          "Wrong previous host route");
+
+    table.Clear();
+    NS_TEST_EXPECT_MSG_EQ(table.GetNRoutes(), 0, "Table not cleared");
+    globalRouting->Dispose();
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief IPv4 GlobalRouting route selection Test
+ *
+ * Checks that the indexed lookups select the same routes, in the same
+ * order for ECMP, as a scan of the route lists in insertion order, and that
+ * the index follows the removal and replacement of routes.
+ */
+class Ipv4GlobalRoutingLookupTestCase : public TestCase
+{
+  public:
+    Ipv4GlobalRoutingLookupTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Look up a route.
+     * \param dest destination address
+     * \param oif requested output interface, 0 for any
+     * \return the output interface of the route, or 0 if there is none
+     */
+    uint32_t Lookup(std::string dest, uint32_t oif = 0);
+
+    Ptr<Ipv4> m_ipv4;                 //!< IPv4 of the node
+    Ptr<Ipv4GlobalRouting> m_routing; //!< routing protocol under test
+};
+
+Ipv4GlobalRoutingLookupTestCase::Ipv4GlobalRoutingLookupTestCase()
+    : TestCase("Global routing route selection")
+{
+}
+
+uint32_t
+Ipv4GlobalRoutingLookupTestCase::Lookup(std::string dest, uint32_t oif)
+{
+    Ipv4Header header;
+    header.SetDestination(Ipv4Address(dest.c_str()));
+    Socket::SocketErrno sockerr;
+    Ptr<NetDevice> device = oif ? m_ipv4->GetNetDevice(oif) : nullptr;
+    Ptr<Ipv4Route> route = m_routing->RouteOutput(nullptr, header, device, sockerr);
+    return route ? m_ipv4->GetInterfaceForDevice(route->GetOutputDevice()) : 0;
+}
+
+void
+Ipv4GlobalRoutingLookupTestCase::DoRun()
+{
+    Ptr<Node> node = CreateObject<Node>();
+    InternetStackHelper internet;
+    internet.Install(node);
+    m_ipv4 = node->GetObject<Ipv4>();
+    for (uint32_t i = 1; i <= 3; i++)
+    {
+        Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice>();
+        device->SetAddress(Mac48Address::Allocate());
+        node->AddDevice(device);
+        uint32_t interface = m_ipv4->AddInterface(device);
+        m_ipv4->AddAddress(interface,
+                           Ipv4InterfaceAddress(Ipv4Address(0x0a000001 + (i << 8)),
+                                                Ipv4Mask("255.255.255.0")));
+        m_ipv4->SetUp(interface);
+    }
+    m_routing = CreateObject<Ipv4GlobalRouting>();
+    m_routing->SetIpv4(m_ipv4);
+
+    // Every matching network is a candidate and the first one added is used,
+    // whatever its prefix length
+    m_routing->AddNetworkRouteTo(Ipv4Address("172.16.0.0"),
+                                 Ipv4Mask("255.255.0.0"),
+                                 Ipv4Address("10.0.1.2"),
+                                 1);
+    m_routing->AddNetworkRouteTo(Ipv4Address("172.16.1.0"),
+                                 Ipv4Mask("255.255.255.0"),
+                                 Ipv4Address("10.0.2.2"),
+                                 2);
+    m_routing->AddNetworkRouteTo(Ipv4Address("172.16.1.0"),
+                                 Ipv4Mask("255.255.255.0"),
+                                 Ipv4Address("10.0.3.2"),
+                                 3);
+    m_routing->AddNetworkRouteTo(Ipv4Address("192.168.0.0"),
+                                 Ipv4Mask("255.255.255.0"),
+                                 Ipv4Address("10.0.3.2"),
+                                 3);
+    NS_TEST_EXPECT_MSG_EQ(Lookup("172.16.1.5"), 1, "First network route not selected");
+    NS_TEST_EXPECT_MSG_EQ(Lookup("172.16.2.5"), 1, "Wrong network route");
+    NS_TEST_EXPECT_MSG_EQ(Lookup("192.168.0.5"), 3, "Wrong network route");
+    NS_TEST_EXPECT_MSG_EQ(Lookup("192.168.1.5"), 0, "Unexpected route");
+    NS_TEST_EXPECT_MSG_EQ(Lookup("172.16.1.5", 3), 3, "Output interface ignored");
+    NS_TEST_EXPECT_MSG_EQ(Lookup("172.16.2.5", 3), 0, "Route on the wrong interface");
+
+    // Random ECMP draws among the candidates in insertion order
+    const int64_t stream = 42;
+    m_routing->SetAttribute("RandomEcmpRouting", BooleanValue(true));
+    m_routing->AssignStreams(stream);
+    Ptr<UniformRandomVariable> reference = CreateObject<UniformRandomVariable>();
+    reference->SetStream(stream);
+    const uint32_t candidates[] = {1, 2, 3};
+    for (uint32_t i = 0; i < 20; i++)
+    {
+        uint32_t expected = candidates[reference->GetInteger(0, 2)];
+        NS_TEST_EXPECT_MSG_EQ(Lookup("172.16.1.5"), expected, "Wrong ECMP candidate order");
+    }
+    m_routing->SetAttribute("RandomEcmpRouting", BooleanValue(false));
+
+    // Host routes come first
+    m_routing->AddHostRouteTo(Ipv4Address("172.16.1.5"), Ipv4Address("10.0.2.2"), 2);
+    m_routing->AddHostRouteTo(Ipv4Address("172.16.1.5"), Ipv4Address("10.0.3.2"), 3);
+    NS_TEST_EXPECT_MSG_EQ(Lookup("172.16.1.5"), 2, "Host route not selected");
+    NS_TEST_EXPECT_MSG_EQ(Lookup("172.16.1.5", 3), 3, "Output interface ignored");
+    NS_TEST_EXPECT_MSG_EQ(Lookup("172.16.1.5", 1), 1, "No fallback to network routes");
+
+    // Removed routes are no longer returned
+    m_routing->RemoveRoute(0);
+    m_routing->RemoveRoute(0);
+    NS_TEST_EXPECT_MSG_EQ(Lookup("172.16.1.5"), 1, "Removed host route still selected");
+    m_routing->RemoveRoute(0);
+    NS_TEST_EXPECT_MSG_EQ(Lookup("172.16.1.5"), 2, "Removed network route still selected");
+    NS_TEST_EXPECT_MSG_EQ(Lookup("172.16.2.5"), 0, "Removed network route still selected");
+
+    // Routes swapped out are no longer returned, swapped in ones are
+    Ipv4RoutingTable table;
+    table.AddNetworkRouteTo(Ipv4Address("172.16.0.0"),
+                            Ipv4Mask("255.255.0.0"),
+                            Ipv4Address("10.0.3.2"),
+                            3);
+    table.AddHostRouteTo(Ipv4Address("192.168.0.5"), Ipv4Address("10.0.1.2"), 1);
+    m_routing->SwapRoutes(table);
+    NS_TEST_EXPECT_MSG_EQ(Lookup("172.16.1.5"), 3, "Swapped out route still selected");
+    NS_TEST_EXPECT_MSG_EQ(Lookup("192.168.0.5"), 1, "Swapped in host route not selected");
+    NS_TEST_EXPECT_MSG_EQ(Lookup("192.168.0.6"), 0, "Swapped out route still selected");
+
+    m_routing->Dispose();
+    m_routing = nullptr;
+    m_ipv4 = nullptr;
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief IPv4 GlobalRouting incremental and parallel route computation Test
+ *
+ * Checks that updating the routes after a change of the topology, and
+ * computing them in several threads, gives the same routes as computing all
+ * of them again in one thread.
+ */
+class Ipv4GlobalRoutingUpdateTestCase : public TestCase
+{
+  public:
+    Ipv4GlobalRoutingUpdateTestCase();
+    void DoSetup() override;
+    void DoRun() override;
+
+  private:
+    /**
+     * \brief Print the global routes of every node.
+     * \return the routes
+     */
+    std::string GetRoutes() const;
+
+    NodeContainer m_nodes; //!< Nodes used in the test.
+};
+
+Ipv4GlobalRoutingUpdateTestCase::Ipv4GlobalRoutingUpdateTestCase()
+    : TestCase("Global routing incremental and parallel route computation")
+{
+}
+
+void
+Ipv4GlobalRoutingUpdateTestCase::DoSetup()
+{
+    // A ring of five routers, a host on router 2 and a LAN between router 0
+    // and two hosts.  The ring has an odd length so that there is a single
+    // shortest path to the LAN from every router.
+    m_nodes.Create(8);
+    InternetStackHelper internet;
+    Ipv4GlobalRoutingHelper ipv4RoutingHelper;
+    internet.SetRoutingHelper(ipv4RoutingHelper);
+    internet.Install(m_nodes);
+
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.1.0.0", "255.255.255.252");
+    SimpleNetDeviceHelper simpleHelper;
+    simpleHelper.SetNetDevicePointToPointMode(true);
+    std::vector<std::pair<uint32_t, uint32_t>> links{{0, 1},
+                                                      {1, 2},
+                                                      {2, 3},
+                                                      {3, 4},
+                                                      {4, 0},
+                                                      {2, 7}};
+    for (const auto& link : links)
+    {
+        NodeContainer nodes(m_nodes.Get(link.first), m_nodes.Get(link.second));
+        ipv4.Assign(simpleHelper.Install(nodes, CreateObject<SimpleChannel>()));
+        ipv4.NewNetwork();
+    }
+
+    SimpleNetDeviceHelper lanHelper;
+    NodeContainer lan(m_nodes.Get(0), m_nodes.Get(5), m_nodes.Get(6));
+    ipv4.SetBase("10.2.0.0", "255.255.255.0");
+    ipv4.Assign(lanHelper.Install(lan, CreateObject<SimpleChannel>()));
+}
+
+std::string
+Ipv4GlobalRoutingUpdateTestCase::GetRoutes() const
+{
+    std::ostringstream routes;
+    for (uint32_t i = 0; i < m_nodes.GetN(); i++)
+    {
+        Ptr<Ipv4GlobalRouting> globalRouting = m_nodes.Get(i)
+                                                   ->GetObject<Ipv4L3Protocol>()
+                                                   ->GetRoutingProtocol()
+                                                   ->GetObject<Ipv4GlobalRouting>();
+        routes << "node " << i << "\n";
+        for (uint32_t j = 0; j < globalRouting->GetNRoutes(); j++)
+        {
+            routes << *globalRouting->GetRoute(j) << "\n";
+        }
+    }
+    return routes.str();
+}
+
+void
+Ipv4GlobalRoutingUpdateTestCase::DoRun()
+{
+    Ipv4GlobalRoutingHelper::PopulateRoutingTables();
+    std::string initial = GetRoutes();
+
+    Ipv4GlobalRoutingHelper::UpdateRoutingTables();
+    NS_TEST_EXPECT_MSG_EQ(GetRoutes(), initial, "Routes changed without a topology change");
+
+    // Take the link between routers 1 and 2 down
+    Ptr<Ipv4> ipv4 = m_nodes.Get(1)->GetObject<Ipv4>();
+    ipv4->SetDown(2);
+    Ipv4GlobalRoutingHelper::UpdateRoutingTables();
+    std::string updated = GetRoutes();
+    NS_TEST_EXPECT_MSG_NE(updated, initial, "Routes not updated");
+    Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+    NS_TEST_EXPECT_MSG_EQ(GetRoutes(), updated, "Updated routes differ from recomputed routes");
+
+    // Compute them in several threads
+    Config::SetGlobal("GlobalRoutingThreads", UintegerValue(4));
+    Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+    NS_TEST_EXPECT_MSG_EQ(GetRoutes(), updated, "Routes computed in parallel differ");
+
+    // Bring the link back up, and take a LAN interface down
+    ipv4->SetUp(2);
+    Ipv4GlobalRoutingHelper::UpdateRoutingTables();
+    NS_TEST_EXPECT_MSG_EQ(GetRoutes(), initial, "Routes not restored");
+    m_nodes.Get(6)->GetObject<Ipv4>()->SetDown(1);
+    Ipv4GlobalRoutingHelper::UpdateRoutingTables();
+    updated = GetRoutes();
+    Config::SetGlobal("GlobalRoutingThreads", UintegerValue(1));
+    Ipv4GlobalRoutingHelper::RecomputeRoutingTables();
+    NS_TEST_EXPECT_MSG_EQ(GetRoutes(), updated, "Updated routes differ from recomputed routes");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief IPv4 GlobalRouting flow hash ECMP Test
+ *
+ * Checks that FlowEcmpRouting keeps the packets of a flow on one next hop,
+ * spreads the flows in proportion to the interface weights, shares the
+ * next-hop groups between destinations, and only moves the flows of a
+ * removed next hop.
+ */
+class Ipv4GlobalRoutingFlowEcmpTestCase : public TestCase
+{
+  public:
+    Ipv4GlobalRoutingFlowEcmpTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Route the flows of a source range to a destination.
+     * \param dest destination address
+     * \param nFlows number of flows, each from its own source address
+     * \return the output interface of each flow
+     */
+    std::vector<uint32_t> RouteFlows(std::string dest, uint32_t nFlows);
+
+    /**
+     * \brief Forward a UDP packet.
+     * \param dest destination address
+     * \param sourcePort UDP source port
+     * \return the output interface of the packet, or 0 if it is not forwarded
+     */
+    uint32_t Forward(std::string dest, uint16_t sourcePort);
+
+    Ptr<Ipv4> m_ipv4;                 //!< IPv4 of the node
+    Ptr<Ipv4GlobalRouting> m_routing; //!< routing protocol under test
+};
+
+Ipv4GlobalRoutingFlowEcmpTestCase::Ipv4GlobalRoutingFlowEcmpTestCase()
+    : TestCase("Global routing flow hash ECMP")
+{
+}
+
+std::vector<uint32_t>
+Ipv4GlobalRoutingFlowEcmpTestCase::RouteFlows(std::string dest, uint32_t nFlows)
+{
+    std::vector<uint32_t> interfaces;
+    for (uint32_t i = 0; i < nFlows; i++)
+    {
+        Ipv4Header header;
+        header.SetSource(Ipv4Address(0xc0a80000 + i));
+        header.SetDestination(Ipv4Address(dest.c_str()));
+        header.SetProtocol(17);
+        Socket::SocketErrno sockerr;
+        Ptr<Ipv4Route> route = m_routing->RouteOutput(nullptr, header, nullptr, sockerr);
+        interfaces.push_back(route ? m_ipv4->GetInterfaceForDevice(route->GetOutputDevice()) : 0);
+    }
+    return interfaces;
+}
+
+uint32_t
+Ipv4GlobalRoutingFlowEcmpTestCase::Forward(std::string dest, uint16_t sourcePort)
+{
+    UdpHeader udpHeader;
+    udpHeader.SetSourcePort(sourcePort);
+    udpHeader.SetDestinationPort(9);
+    Ptr<Packet> p = Create<Packet>(100);
+    p->AddHeader(udpHeader);
+    Ipv4Header header;
+    header.SetSource(Ipv4Address("192.168.0.1"));
+    header.SetDestination(Ipv4Address(dest.c_str()));
+    header.SetProtocol(17);
+    uint32_t output = 0;
+    Ipv4RoutingProtocol::UnicastForwardCallback ucb(
+        [this, &output](Ptr<Ipv4Route> route, Ptr<const Packet>, const Ipv4Header&) {
+            output = m_ipv4->GetInterfaceForDevice(route->GetOutputDevice());
+        });
+    m_routing->RouteInput(p,
+                          header,
+                          m_ipv4->GetNetDevice(1),
+                          ucb,
+                          Ipv4RoutingProtocol::MulticastForwardCallback(),
+                          Ipv4RoutingProtocol::LocalDeliverCallback(),
+                          Ipv4RoutingProtocol::ErrorCallback());
+    return output;
+}
+
+void
+Ipv4GlobalRoutingFlowEcmpTestCase::DoRun()
+{
+    Ptr<Node> node = CreateObject<Node>();
+    InternetStackHelper internet;
+    internet.SetIpv6StackInstall(false);
+    internet.Install(node);
+    m_ipv4 = node->GetObject<Ipv4>();
+    for (uint32_t i = 1; i <= 4; i++)
+    {
+        Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice>();
+        device->SetAddress(Mac48Address::Allocate());
+        node->AddDevice(device);
+        uint32_t interface = m_ipv4->AddInterface(device);
+        m_ipv4->AddAddress(interface,
+                           Ipv4InterfaceAddress(Ipv4Address(0x0a000001 + (i << 8)),
+                                                Ipv4Mask("255.255.255.0")));
+        m_ipv4->SetUp(interface);
+    }
+    m_routing = CreateObject<Ipv4GlobalRouting>();
+    m_routing->SetIpv4(m_ipv4);
+    m_routing->SetAttribute("FlowEcmpRouting", BooleanValue(true));
+
+    // Two destinations reached through the same four next hops
+    for (std::string network : {"172.16.1.0", "172.16.2.0"})
+    {
+        for (uint32_t i = 1; i <= 4; i++)
+        {
+            m_routing->AddNetworkRouteTo(Ipv4Address(network.c_str()),
+                                         Ipv4Mask("255.255.255.0"),
+                                         Ipv4Address(0x0a000002 + (i << 8)),
+                                         i);
+        }
+    }
+
+    // The flows are spread evenly, and always take the same next hop
+    const uint32_t nFlows = 1000;
+    std::vector<uint32_t> flows = RouteFlows("172.16.1.5", nFlows);
+    NS_TEST_EXPECT_MSG_EQ((flows == RouteFlows("172.16.1.5", nFlows)), true, "Flows moved");
+    NS_TEST_EXPECT_MSG_EQ(m_routing->GetNNextHopGroups(), 1, "Next-hop group not shared");
+    for (uint32_t i = 1; i <= 4; i++)
+    {
+        auto n = std::count(flows.begin(), flows.end(), i);
+        NS_TEST_EXPECT_MSG_GT(n, nFlows / 8, "Too few flows on interface " << i);
+        NS_TEST_EXPECT_MSG_LT(n, nFlows * 3 / 8, "Too many flows on interface " << i);
+    }
+
+    // Forwarded packets hash their ports as well
+    std::vector<uint32_t> counts(5);
+    for (uint16_t port = 1000; port < 1200; port++)
+    {
+        uint32_t interface = Forward("172.16.1.5", port);
+        NS_TEST_EXPECT_MSG_EQ(Forward("172.16.1.5", port), interface, "Flow moved");
+        counts[interface]++;
+    }
+    NS_TEST_EXPECT_MSG_EQ(counts[0], 0, "Packet not forwarded");
+    for (uint32_t i = 1; i <= 4; i++)
+    {
+        NS_TEST_EXPECT_MSG_GT(counts[i], 0, "No flow forwarded on interface " << i);
+    }
+
+    // Another seed spreads the flows differently
+    m_routing->SetAttribute("EcmpHashSeed", UintegerValue(1));
+    std::vector<uint32_t> seeded = RouteFlows("172.16.1.5", nFlows);
+    NS_TEST_EXPECT_MSG_EQ((seeded != flows), true, "Seed ignored");
+    m_routing->SetAttribute("EcmpHashSeed", UintegerValue(0));
+
+    // Removing a next hop only moves its flows, and the destinations no
+    // longer share their group
+    std::vector<uint32_t> otherFlows = RouteFlows("172.16.2.5", nFlows);
+    for (uint32_t i = 0; i < m_routing->GetNRoutes(); i++)
+    {
+        if (m_routing->GetRoute(i)->GetInterface() == 4)
+        {
+            m_routing->RemoveRoute(i);
+            break;
+        }
+    }
+    std::vector<uint32_t> remaining = RouteFlows("172.16.1.5", nFlows);
+    for (uint32_t i = 0; i < nFlows; i++)
+    {
+        if (flows[i] != 4)
+        {
+            NS_TEST_EXPECT_MSG_EQ(remaining[i], flows[i], "Flow " << i << " moved");
+        }
+        NS_TEST_EXPECT_MSG_NE(remaining[i], 4, "Flow " << i << " on a removed next hop");
+    }
+    NS_TEST_EXPECT_MSG_EQ((RouteFlows("172.16.2.5", nFlows) == otherFlows),
+                          true,
+                          "Flows of another destination moved");
+    NS_TEST_EXPECT_MSG_EQ(m_routing->GetNNextHopGroups(), 2, "Wrong number of next-hop groups");
+
+    // The weights of the interfaces share the flows
+    m_routing->SetInterfaceWeight(1, 3);
+    flows = RouteFlows("172.16.2.5", nFlows);
+    auto n = std::count(flows.begin(), flows.end(), 1);
+    NS_TEST_EXPECT_MSG_GT(n, nFlows * 4 / 10, "Too few flows on the heavy interface");
+    NS_TEST_EXPECT_MSG_LT(n, nFlows * 6 / 10, "Too many flows on the heavy interface");
+
+    m_routing->Dispose();
+    m_routing = nullptr;
+    m_ipv4 = nullptr;
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup internet-test
  *
@@ -1333,6 +1848,10 @@ Ipv4GlobalRoutingTestSuite::Ipv4GlobalRoutingTestSuite()
     AddTestCase(new TwoBridgeTest, TestCase::QUICK);
     AddTestCase(new Ipv4DynamicGlobalRoutingTestCase, TestCase::QUICK);
     AddTestCase(new Ipv4GlobalRoutingSlash32TestCase, TestCase::QUICK);
+    AddTestCase(new Ipv4GlobalRoutingSwapRoutesTestCase, TestCase::QUICK);
+    AddTestCase(new Ipv4GlobalRoutingLookupTestCase, TestCase::QUICK);
+    AddTestCase(new Ipv4GlobalRoutingUpdateTestCase, TestCase::QUICK);
+    AddTestCase(new Ipv4GlobalRoutingFlowEcmpTestCase, TestCase::QUICK);
 }
 
 static Ipv4GlobalRoutingTestSuite
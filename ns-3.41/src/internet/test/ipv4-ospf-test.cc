@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2024 Liverpool Hope University, UK
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/node-container.h"
+#include "ns3/ospf-helper.h"
+#include "ns3/ospf-routing.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief OSPF SPF throttling test.
+ *
+ * A burst of interface events must be merged into a single SPF calculation,
+ * and back-to-back bursts must be spaced by an exponentially growing hold
+ * time.
+ */
+class Ipv4OspfSpfThrottleTest : public TestCase
+{
+  public:
+    Ipv4OspfSpfThrottleTest();
+    void DoRun() override;
+
+  private:
+    /**
+     * \brief Record an SPF calculation.
+     * \param nRoutes number of routes installed
+     * \param holdTime hold time after the calculation
+     */
+    void SpfCalculation(uint32_t nRoutes, Time holdTime);
+
+    std::vector<Time> m_spfTimes;      //!< times of the SPF calculations
+    std::vector<uint32_t> m_spfRoutes; //!< routes installed by each calculation
+};
+
+Ipv4OspfSpfThrottleTest::Ipv4OspfSpfThrottleTest()
+    : TestCase("OSPF SPF throttling")
+{
+}
+
+void
+Ipv4OspfSpfThrottleTest::SpfCalculation(uint32_t nRoutes, Time holdTime)
+{
+    m_spfTimes.push_back(Simulator::Now());
+    m_spfRoutes.push_back(nRoutes);
+}
+
+void
+Ipv4OspfSpfThrottleTest::DoRun()
+{
+    NodeContainer nodes;
+    nodes.Create(2);
+
+    Ptr<SimpleChannel> channel = CreateObject<SimpleChannel>();
+    SimpleNetDeviceHelper simpleHelper;
+    simpleHelper.SetNetDevicePointToPointMode(true);
+    NetDeviceContainer net = simpleHelper.Install(nodes, channel);
+
+    OspfHelper ospf;
+    ospf.Set("SpfInitialWait", TimeValue(MilliSeconds(50)));
+    ospf.Set("SpfHoldTime", TimeValue(MilliSeconds(200)));
+    ospf.Set("SpfMaxWait", TimeValue(MilliSeconds(600)));
+    InternetStackHelper internet;
+    internet.SetRoutingHelper(ospf);
+    internet.Install(nodes);
+
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase("10.1.1.0", "255.255.255.252");
+    ipv4.Assign(net);
+
+    Ptr<Ipv4L3Protocol> ip0 = nodes.Get(0)->GetObject<Ipv4L3Protocol>();
+    Ptr<OspfRouting> ospf0 = DynamicCast<OspfRouting>(ip0->GetRoutingProtocol());
+    NS_TEST_ASSERT_MSG_NE(ospf0, nullptr, "Error-- no OspfRouting object");
+    ospf0->TraceConnectWithoutContext(
+        "SpfCalculation",
+        MakeCallback(&Ipv4OspfSpfThrottleTest::SpfCalculation, this));
+
+    // A burst of three events, merged into one calculation after the initial wait
+    Simulator::Schedule(Seconds(1), &Ipv4L3Protocol::SetDown, ip0, 1);
+    Simulator::Schedule(Seconds(1.01), &Ipv4L3Protocol::SetUp, ip0, 1);
+    Simulator::Schedule(Seconds(1.02), &Ipv4L3Protocol::SetDown, ip0, 1);
+    // Back-to-back events, delayed by the hold time which then doubles
+    Simulator::Schedule(Seconds(1.1), &Ipv4L3Protocol::SetUp, ip0, 1);
+    Simulator::Schedule(Seconds(1.3), &Ipv4L3Protocol::SetDown, ip0, 1);
+    Simulator::Schedule(Seconds(1.7), &Ipv4L3Protocol::SetUp, ip0, 1);
+
+    Simulator::Stop(Seconds(5));
+    Simulator::Run();
+
+    std::vector<Time> expectedTimes = {MilliSeconds(50),
+                                       MilliSeconds(1050),
+                                       MilliSeconds(1250),
+                                       MilliSeconds(1650),
+                                       MilliSeconds(2250)};
+    std::vector<uint32_t> expectedRoutes = {1, 0, 1, 0, 1};
+    NS_TEST_ASSERT_MSG_EQ(m_spfTimes.size(), expectedTimes.size(), "Wrong number of SPF runs");
+    for (std::size_t i = 0; i < expectedTimes.size(); i++)
+    {
+        NS_TEST_EXPECT_MSG_EQ(m_spfTimes[i], expectedTimes[i], "Wrong time for SPF run " << i);
+        NS_TEST_EXPECT_MSG_EQ(m_spfRoutes[i], expectedRoutes[i], "Wrong routes for SPF run " << i);
+    }
+    NS_TEST_EXPECT_MSG_EQ(ospf0->GetSpfHoldTime(),
+                          MilliSeconds(600),
+                          "Hold time not capped by SpfMaxWait");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief IPv4 OSPF TestSuite
+ */
+class Ipv4OspfTestSuite : public TestSuite
+{
+  public:
+    Ipv4OspfTestSuite()
+        : TestSuite("ipv4-ospf", UNIT)
+    {
+        AddTestCase(new Ipv4OspfSpfThrottleTest(), TestCase::QUICK);
+    }
+};
+
+static Ipv4OspfTestSuite g_ipv4OspfTestSuite; //!< Static variable for test initialization
@@ -23,6 +23,7 @@
 #include "ns3/inet-socket-address.h"
 #include "ns3/internet-stack-helper.h"
 #include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-header.h"
 #include "ns3/ipv4-l3-protocol.h"
 #include "ns3/ipv4-static-routing.h"
 #include "ns3/log.h"
@@ -694,6 +695,139 @@ Ipv4RipSplitHorizonStrategyTest::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup internet-test
+ *
+ * \brief IPv4 RIP test with many routes, more than 255 in a response
+ */
+class Ipv4RipManyRoutesTest : public TestCase
+{
+    /**
+     * \brief Count the stub networks a router has a route to.
+     * \param router The router.
+     * \param nNetworks The number of stub networks.
+     * \return the number of stub networks reached.
+     */
+    uint32_t CountRoutes(Ptr<Node> router, uint32_t nNetworks);
+
+    /**
+     * \brief Check the number of stub networks a router has a route to.
+     * \param router The router.
+     * \param nNetworks The number of stub networks.
+     * \param expected The expected number of stub networks reached.
+     */
+    void CheckRoutes(Ptr<Node> router, uint32_t nNetworks, uint32_t expected);
+
+  public:
+    void DoRun() override;
+    Ipv4RipManyRoutesTest();
+};
+
+Ipv4RipManyRoutesTest::Ipv4RipManyRoutesTest()
+    : TestCase("RIP with many routes")
+{
+}
+
+uint32_t
+Ipv4RipManyRoutesTest::CountRoutes(Ptr<Node> router, uint32_t nNetworks)
+{
+    Ptr<Ipv4RoutingProtocol> routing = router->GetObject<Ipv4>()->GetRoutingProtocol();
+    uint32_t nRoutes = 0;
+    for (uint32_t i = 0; i < nNetworks; i++)
+    {
+        Ipv4Header header;
+        header.SetDestination(Ipv4Address(0xac100001 + (i << 8)));
+        Socket::SocketErrno sockerr;
+        if (routing->RouteOutput(nullptr, header, nullptr, sockerr))
+        {
+            nRoutes++;
+        }
+    }
+    return nRoutes;
+}
+
+void
+Ipv4RipManyRoutesTest::CheckRoutes(Ptr<Node> router, uint32_t nNetworks, uint32_t expected)
+{
+    NS_TEST_EXPECT_MSG_EQ(CountRoutes(router, nNetworks),
+                          expected,
+                          "Wrong number of routes at " << Simulator::Now().As(Time::S));
+}
+
+void
+Ipv4RipManyRoutesTest::DoRun()
+{
+    // Routers A, B and C in a line; C has a stub interface with many networks
+    NodeContainer routers;
+    routers.Create(3);
+    RipHelper ripRouting;
+    InternetStackHelper internetRouters;
+    internetRouters.SetRoutingHelper(ripRouting);
+    internetRouters.SetIpv6StackInstall(false);
+    internetRouters.Install(routers);
+
+    Ipv4AddressHelper ipv4;
+    ipv4.SetBase(Ipv4Address("192.168.0.0"), Ipv4Mask("255.255.255.0"));
+    for (uint32_t i = 0; i < 2; i++)
+    {
+        Ptr<SimpleChannel> channel = CreateObject<SimpleChannel>();
+        NetDeviceContainer net;
+        for (uint32_t j = i; j < i + 2; j++)
+        {
+            Ptr<SimpleNetDevice> dev = CreateObject<SimpleNetDevice>();
+            dev->SetAddress(Mac48Address::Allocate());
+            dev->SetChannel(channel);
+            routers.Get(j)->AddDevice(dev);
+            net.Add(dev);
+        }
+        ipv4.Assign(net);
+        ipv4.NewNetwork();
+    }
+    Ptr<SimpleNetDevice> stubDev = CreateObject<SimpleNetDevice>();
+    stubDev->SetAddress(Mac48Address::Allocate());
+    stubDev->SetChannel(CreateObject<SimpleChannel>());
+    routers.Get(2)->AddDevice(stubDev);
+    ipv4.SetBase(Ipv4Address("172.16.0.0"), Ipv4Mask("255.255.255.0"));
+    ipv4.Assign(NetDeviceContainer(stubDev));
+
+    // The 64 KB MTU of the devices lets a single response advertise all the
+    // stub networks
+    const uint32_t nNetworks = 300;
+    Ptr<Ipv4> ipv4C = routers.Get(2)->GetObject<Ipv4>();
+    uint32_t stubInterface = ipv4C->GetInterfaceForDevice(stubDev);
+    for (uint32_t i = 1; i < nNetworks; i++)
+    {
+        ipv4C->AddAddress(stubInterface,
+                          Ipv4InterfaceAddress(Ipv4Address(0xac100001 + (i << 8)),
+                                               Ipv4Mask("255.255.255.0")));
+    }
+
+    // The stub networks are learned, then invalidated once the stub interface
+    // goes down
+    Simulator::Schedule(Seconds(60),
+                        &Ipv4RipManyRoutesTest::CheckRoutes,
+                        this,
+                        routers.Get(0),
+                        nNetworks,
+                        nNetworks);
+    Simulator::Schedule(Seconds(60),
+                        &Ipv4RipManyRoutesTest::CheckRoutes,
+                        this,
+                        routers.Get(1),
+                        nNetworks,
+                        nNetworks);
+    Simulator::Schedule(Seconds(61), &Ipv4::SetDown, ipv4C, stubInterface);
+    Simulator::Schedule(Seconds(90),
+                        &Ipv4RipManyRoutesTest::CheckRoutes,
+                        this,
+                        routers.Get(0),
+                        nNetworks,
+                        0);
+    Simulator::Stop(Seconds(91));
+    Simulator::Run();
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup internet-test
  *
@@ -710,6 +844,7 @@ class Ipv4RipTestSuite : public TestSuite
         AddTestCase(new Ipv4RipSplitHorizonStrategyTest(Rip::POISON_REVERSE), TestCase::QUICK);
         AddTestCase(new Ipv4RipSplitHorizonStrategyTest(Rip::SPLIT_HORIZON), TestCase::QUICK);
         AddTestCase(new Ipv4RipSplitHorizonStrategyTest(Rip::NO_SPLIT_HORIZON), TestCase::QUICK);
+        AddTestCase(new Ipv4RipManyRoutesTest, TestCase::QUICK);
     }
 };
 
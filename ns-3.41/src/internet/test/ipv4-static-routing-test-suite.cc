@@ -20,7 +20,11 @@
 #include "ns3/inet-socket-address.h"
 #include "ns3/internet-stack-helper.h"
 #include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/ipv4-routing-table-entry.h"
 #include "ns3/ipv4-static-routing-helper.h"
+#include "ns3/ipv4-static-routing.h"
 #include "ns3/node-container.h"
 #include "ns3/node.h"
 #include "ns3/packet.h"
@@ -207,6 +211,142 @@ Ipv4StaticRoutingSlash32TestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup internet-test
+ *
+ * \brief IPv4 StaticRouting longest prefix match Test
+ *
+ * Checks the route selection rules of the indexed lookups, and that the
+ * index follows the removal of routes.
+ */
+class Ipv4StaticRoutingLookupTestCase : public TestCase
+{
+  public:
+    Ipv4StaticRoutingLookupTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Look up a route.
+     * \param dest destination address
+     * \param oif requested output interface, 0 for any
+     * \return the output interface of the route, or 0 if there is none
+     */
+    uint32_t Lookup(std::string dest, uint32_t oif = 0);
+
+    Ptr<Ipv4> m_ipv4;                   //!< IPv4 of the node
+    Ptr<Ipv4StaticRouting> m_routing;   //!< routing protocol under test
+};
+
+Ipv4StaticRoutingLookupTestCase::Ipv4StaticRoutingLookupTestCase()
+    : TestCase("Static routing longest prefix match")
+{
+}
+
+uint32_t
+Ipv4StaticRoutingLookupTestCase::Lookup(std::string dest, uint32_t oif)
+{
+    Ipv4Header header;
+    header.SetDestination(Ipv4Address(dest.c_str()));
+    Socket::SocketErrno sockerr;
+    Ptr<NetDevice> device = oif ? m_ipv4->GetNetDevice(oif) : nullptr;
+    Ptr<Ipv4Route> route = m_routing->RouteOutput(nullptr, header, device, sockerr);
+    return route ? m_ipv4->GetInterfaceForDevice(route->GetOutputDevice()) : 0;
+}
+
+void
+Ipv4StaticRoutingLookupTestCase::DoRun()
+{
+    Ptr<Node> node = CreateObject<Node>();
+    InternetStackHelper internet;
+    internet.Install(node);
+    m_ipv4 = node->GetObject<Ipv4>();
+    for (uint32_t i = 1; i <= 3; i++)
+    {
+        Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice>();
+        device->SetAddress(Mac48Address::Allocate());
+        node->AddDevice(device);
+        uint32_t interface = m_ipv4->AddInterface(device);
+        m_ipv4->AddAddress(interface,
+                           Ipv4InterfaceAddress(Ipv4Address(0x0a000001 + (i << 8)),
+                                                Ipv4Mask("255.255.255.0")));
+        m_ipv4->SetUp(interface);
+    }
+    m_routing = CreateObject<Ipv4StaticRouting>();
+    m_routing->SetIpv4(m_ipv4);
+
+    // The longest prefix wins, even over a shorter prefix added later
+    m_routing->AddNetworkRouteTo(Ipv4Address("172.16.1.0"),
+                                 Ipv4Mask("255.255.255.0"),
+                                 Ipv4Address("10.0.1.2"),
+                                 1);
+    m_routing->AddNetworkRouteTo(Ipv4Address("172.16.0.0"),
+                                 Ipv4Mask("255.255.0.0"),
+                                 Ipv4Address("10.0.2.2"),
+                                 2);
+    NS_TEST_EXPECT_MSG_EQ(Lookup("172.16.1.5"), 1, "Longest prefix not selected");
+    NS_TEST_EXPECT_MSG_EQ(Lookup("172.16.2.5"), 2, "Shorter prefix not selected");
+    NS_TEST_EXPECT_MSG_EQ(Lookup("172.17.1.5"), 0, "Unexpected route");
+
+    // The output interface filter falls back to a shorter prefix
+    NS_TEST_EXPECT_MSG_EQ(Lookup("172.16.1.5", 2), 2, "No fallback to the shorter prefix");
+    NS_TEST_EXPECT_MSG_EQ(Lookup("172.16.1.5", 3), 0, "Route on the wrong interface");
+
+    // Within a prefix the lowest metric wins, then the last route added
+    m_routing->AddNetworkRouteTo(Ipv4Address("192.168.0.0"),
+                                 Ipv4Mask("255.255.255.0"),
+                                 Ipv4Address("10.0.1.2"),
+                                 1,
+                                 10);
+    m_routing->AddNetworkRouteTo(Ipv4Address("192.168.0.0"),
+                                 Ipv4Mask("255.255.255.0"),
+                                 Ipv4Address("10.0.2.2"),
+                                 2,
+                                 5);
+    m_routing->AddNetworkRouteTo(Ipv4Address("192.168.0.0"),
+                                 Ipv4Mask("255.255.255.0"),
+                                 Ipv4Address("10.0.3.2"),
+                                 3,
+                                 5);
+    NS_TEST_EXPECT_MSG_EQ(Lookup("192.168.0.7"), 3, "Wrong route among equal metrics");
+    NS_TEST_EXPECT_MSG_EQ(Lookup("192.168.0.7", 1), 1, "Output interface ignored");
+
+    // Except for host routes, where the first route added wins
+    m_routing->AddHostRouteTo(Ipv4Address("192.168.5.5"), Ipv4Address("10.0.1.2"), 1);
+    m_routing->AddHostRouteTo(Ipv4Address("192.168.5.5"), Ipv4Address("10.0.2.2"), 2);
+    NS_TEST_EXPECT_MSG_EQ(Lookup("192.168.5.5"), 1, "Wrong host route");
+
+    // Removed routes are no longer returned
+    for (uint32_t i = 0; i < m_routing->GetNRoutes(); i++)
+    {
+        Ipv4RoutingTableEntry route = m_routing->GetRoute(i);
+        if (route.GetDestNetwork() == Ipv4Address("172.16.1.0"))
+        {
+            m_routing->RemoveRoute(i);
+            break;
+        }
+    }
+    NS_TEST_EXPECT_MSG_EQ(Lookup("172.16.1.5"), 2, "Removed route still selected");
+    m_routing->RemoveRoute(m_routing->GetNRoutes() - 2);
+    NS_TEST_EXPECT_MSG_EQ(Lookup("192.168.5.5"), 2, "Removed host route still selected");
+
+    m_routing->NotifyInterfaceDown(3);
+    NS_TEST_EXPECT_MSG_EQ(Lookup("192.168.0.7"), 2, "Route on a down interface selected");
+    NS_TEST_EXPECT_MSG_EQ(Lookup("10.0.3.7"), 0, "Connected route on a down interface");
+
+    NS_TEST_EXPECT_MSG_EQ(Lookup("10.0.2.7"), 2, "No connected route");
+    m_routing->NotifyRemoveAddress(2,
+                                   Ipv4InterfaceAddress(Ipv4Address("10.0.2.1"),
+                                                        Ipv4Mask("255.255.255.0")));
+    NS_TEST_EXPECT_MSG_EQ(Lookup("10.0.2.7"), 0, "Route to a removed address selected");
+
+    m_routing->Dispose();
+    m_routing = nullptr;
+    m_ipv4 = nullptr;
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup internet-test
  *
@@ -222,6 +362,7 @@ Ipv4StaticRoutingTestSuite::Ipv4StaticRoutingTestSuite()
     : TestSuite("ipv4-static-routing", UNIT)
 {
     AddTestCase(new Ipv4StaticRoutingSlash32TestCase, TestCase::QUICK);
+    AddTestCase(new Ipv4StaticRoutingLookupTestCase, TestCase::QUICK);
 }
 
 static Ipv4StaticRoutingTestSuite
@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2024 Liverpool Hope University, UK
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv6-header.h"
+#include "ns3/ipv6-route.h"
+#include "ns3/ipv6-routing-table-entry.h"
+#include "ns3/ipv6-static-routing.h"
+#include "ns3/ipv6.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief IPv6 StaticRouting route lookup Test
+ *
+ * Checks the route selection rules of the indexed unicast and multicast
+ * lookups, and that the indexes follow the removal of routes.
+ */
+class Ipv6StaticRoutingLookupTestCase : public TestCase
+{
+  public:
+    Ipv6StaticRoutingLookupTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Look up a unicast route.
+     * \param dest destination address
+     * \param oif requested output interface, 0 for any
+     * \return the output interface of the route, or 0 if there is none
+     */
+    uint32_t Lookup(std::string dest, uint32_t oif = 0);
+
+    /**
+     * \brief Look up a multicast route.
+     * \param group multicast group
+     * \param iif input interface
+     * \return the first output interface of the route, or 0 if there is none
+     */
+    uint32_t LookupMulticast(std::string group, uint32_t iif);
+
+    Ptr<Ipv6> m_ipv6;                 //!< IPv6 of the node
+    Ptr<Ipv6StaticRouting> m_routing; //!< routing protocol under test
+};
+
+Ipv6StaticRoutingLookupTestCase::Ipv6StaticRoutingLookupTestCase()
+    : TestCase("Static routing longest prefix match and multicast lookups")
+{
+}
+
+uint32_t
+Ipv6StaticRoutingLookupTestCase::Lookup(std::string dest, uint32_t oif)
+{
+    Ipv6Header header;
+    header.SetDestination(Ipv6Address(dest.c_str()));
+    Socket::SocketErrno sockerr;
+    Ptr<NetDevice> device = oif ? m_ipv6->GetNetDevice(oif) : nullptr;
+    Ptr<Ipv6Route> route = m_routing->RouteOutput(nullptr, header, device, sockerr);
+    return route ? m_ipv6->GetInterfaceForDevice(route->GetOutputDevice()) : 0;
+}
+
+uint32_t
+Ipv6StaticRoutingLookupTestCase::LookupMulticast(std::string group, uint32_t iif)
+{
+    Ipv6Header header;
+    header.SetSource(Ipv6Address("2001:db8:ffff::1"));
+    header.SetDestination(Ipv6Address(group.c_str()));
+    uint32_t output = 0;
+    Ipv6RoutingProtocol::MulticastForwardCallback mcb(
+        [&output](Ptr<const NetDevice>,
+                  Ptr<Ipv6MulticastRoute> route,
+                  Ptr<const Packet>,
+                  const Ipv6Header&) { output = route->GetOutputTtlMap().begin()->first; });
+    m_routing->RouteInput(Create<Packet>(),
+                          header,
+                          m_ipv6->GetNetDevice(iif),
+                          Ipv6RoutingProtocol::UnicastForwardCallback(),
+                          mcb,
+                          Ipv6RoutingProtocol::LocalDeliverCallback(),
+                          Ipv6RoutingProtocol::ErrorCallback());
+    return output;
+}
+
+void
+Ipv6StaticRoutingLookupTestCase::DoRun()
+{
+    Ptr<Node> node = CreateObject<Node>();
+    InternetStackHelper internet;
+    internet.SetIpv4StackInstall(false);
+    internet.Install(node);
+    m_ipv6 = node->GetObject<Ipv6>();
+    for (uint8_t i = 1; i <= 3; i++)
+    {
+        Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice>();
+        device->SetAddress(Mac48Address::Allocate());
+        node->AddDevice(device);
+        uint32_t interface = m_ipv6->AddInterface(device);
+        uint8_t address[16] = {0x20, 0x01, 0x0d, 0xb8, 0, i};
+        address[15] = 1;
+        m_ipv6->AddAddress(interface,
+                           Ipv6InterfaceAddress(Ipv6Address(address), Ipv6Prefix(64)));
+        m_ipv6->SetUp(interface);
+    }
+    m_routing = CreateObject<Ipv6StaticRouting>();
+    m_routing->SetIpv6(m_ipv6);
+
+    // The longest prefix wins, even over a shorter prefix added later
+    m_routing->AddNetworkRouteTo(Ipv6Address("2001:1:1::"),
+                                 Ipv6Prefix(48),
+                                 Ipv6Address("fe80::1"),
+                                 1);
+    m_routing->AddNetworkRouteTo(Ipv6Address("2001:1::"),
+                                 Ipv6Prefix(32),
+                                 Ipv6Address("fe80::2"),
+                                 2);
+    NS_TEST_EXPECT_MSG_EQ(Lookup("2001:1:1::5"), 1, "Longest prefix not selected");
+    NS_TEST_EXPECT_MSG_EQ(Lookup("2001:1:2::5"), 2, "Shorter prefix not selected");
+    NS_TEST_EXPECT_MSG_EQ(Lookup("2001:2::5"), 0, "Unexpected route");
+
+    // The output interface filter falls back to a shorter prefix
+    NS_TEST_EXPECT_MSG_EQ(Lookup("2001:1:1::5", 2), 2, "No fallback to the shorter prefix");
+    NS_TEST_EXPECT_MSG_EQ(Lookup("2001:1:1::5", 3), 0, "Route on the wrong interface");
+
+    // Within a prefix the lowest metric wins, then the last route added
+    m_routing->AddNetworkRouteTo(Ipv6Address("2001:3::"),
+                                 Ipv6Prefix(32),
+                                 Ipv6Address("fe80::1"),
+                                 1,
+                                 10);
+    m_routing->AddNetworkRouteTo(Ipv6Address("2001:3::"),
+                                 Ipv6Prefix(32),
+                                 Ipv6Address("fe80::2"),
+                                 2,
+                                 5);
+    m_routing->AddNetworkRouteTo(Ipv6Address("2001:3::"),
+                                 Ipv6Prefix(32),
+                                 Ipv6Address("fe80::3"),
+                                 3,
+                                 5);
+    NS_TEST_EXPECT_MSG_EQ(Lookup("2001:3::7"), 3, "Wrong route among equal metrics");
+    NS_TEST_EXPECT_MSG_EQ(Lookup("2001:3::7", 1), 1, "Output interface ignored");
+
+    // Except for host routes, where the first route added wins
+    m_routing->AddHostRouteTo(Ipv6Address("2001:5::5"),
+                              Ipv6Address("fe80::1"),
+                              1,
+                              Ipv6Address::GetZero());
+    m_routing->AddHostRouteTo(Ipv6Address("2001:5::5"),
+                              Ipv6Address("fe80::2"),
+                              2,
+                              Ipv6Address::GetZero());
+    NS_TEST_EXPECT_MSG_EQ(Lookup("2001:5::5"), 1, "Wrong host route");
+
+    // Removed routes are no longer returned
+    for (uint32_t i = 0; i < m_routing->GetNRoutes(); i++)
+    {
+        if (m_routing->GetRoute(i).GetDestNetwork() == Ipv6Address("2001:1:1::"))
+        {
+            m_routing->RemoveRoute(i);
+            break;
+        }
+    }
+    NS_TEST_EXPECT_MSG_EQ(Lookup("2001:1:1::5"), 2, "Removed route still selected");
+    m_routing->RemoveRoute(m_routing->GetNRoutes() - 2);
+    NS_TEST_EXPECT_MSG_EQ(Lookup("2001:5::5"), 2, "Removed host route still selected");
+
+    m_routing->NotifyInterfaceDown(3);
+    NS_TEST_EXPECT_MSG_EQ(Lookup("2001:3::7"), 2, "Route on a down interface selected");
+    NS_TEST_EXPECT_MSG_EQ(Lookup("2001:db8:3::7"), 0, "Connected route on a down interface");
+
+    NS_TEST_EXPECT_MSG_EQ(Lookup("2001:db8:2::7"), 2, "No connected route");
+    m_routing->NotifyRemoveAddress(
+        2,
+        Ipv6InterfaceAddress(Ipv6Address("2001:db8:2::1"), Ipv6Prefix(64)));
+    NS_TEST_EXPECT_MSG_EQ(Lookup("2001:db8:2::7"), 0, "Route to a removed address selected");
+
+    // Multicast routes match on the group and the input interface, the
+    // first route added wins
+    m_routing->AddMulticastRoute(Ipv6Address::GetAny(), Ipv6Address("ff0e::1"), 1, {2});
+    m_routing->AddMulticastRoute(Ipv6Address::GetAny(), Ipv6Address("ff0e::1"), 2, {1});
+    m_routing->AddMulticastRoute(Ipv6Address("2001:db8::1"), Ipv6Address("ff0e::1"), 1, {3});
+    m_routing->AddMulticastRoute(Ipv6Address::GetAny(), Ipv6Address("ff0e::2"), 1, {3});
+    NS_TEST_EXPECT_MSG_EQ(LookupMulticast("ff0e::1", 1), 2, "Wrong multicast route");
+    NS_TEST_EXPECT_MSG_EQ(LookupMulticast("ff0e::1", 2), 1, "Wrong multicast route");
+    NS_TEST_EXPECT_MSG_EQ(LookupMulticast("ff0e::2", 1), 3, "Wrong multicast route");
+    NS_TEST_EXPECT_MSG_EQ(LookupMulticast("ff0e::2", 2), 0, "Route on the wrong interface");
+    NS_TEST_EXPECT_MSG_EQ(LookupMulticast("ff0e::3", 1), 0, "Unexpected multicast route");
+
+    NS_TEST_EXPECT_MSG_EQ(m_routing->RemoveMulticastRoute(Ipv6Address::GetAny(),
+                                                          Ipv6Address("ff0e::1"),
+                                                          2),
+                          true,
+                          "Multicast route not removed");
+    NS_TEST_EXPECT_MSG_EQ(LookupMulticast("ff0e::1", 2), 0, "Removed multicast route selected");
+    m_routing->RemoveMulticastRoute(2);
+    NS_TEST_EXPECT_MSG_EQ(LookupMulticast("ff0e::2", 1), 0, "Removed multicast route selected");
+    m_routing->RemoveMulticastRoute(uint32_t(0));
+    NS_TEST_EXPECT_MSG_EQ(LookupMulticast("ff0e::1", 1), 3, "Second multicast route not used");
+    NS_TEST_EXPECT_MSG_EQ(m_routing->GetNMulticastRoutes(), 1, "Wrong number of multicast routes");
+
+    m_routing->Dispose();
+    m_routing = nullptr;
+    m_ipv6 = nullptr;
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief IPv6 StaticRouting TestSuite
+ */
+class Ipv6StaticRoutingTestSuite : public TestSuite
+{
+  public:
+    Ipv6StaticRoutingTestSuite();
+};
+
+Ipv6StaticRoutingTestSuite::Ipv6StaticRoutingTestSuite()
+    : TestSuite("ipv6-static-routing", UNIT)
+{
+    AddTestCase(new Ipv6StaticRoutingLookupTestCase, TestCase::QUICK);
+}
+
+static Ipv6StaticRoutingTestSuite
+    ipv6StaticRoutingTestSuite; //!< Static variable for test initialization
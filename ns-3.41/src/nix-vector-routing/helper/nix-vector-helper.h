@@ -95,6 +95,15 @@ class NixVectorHelper : public std::enable_if_t<std::is_same_v<Ipv4RoutingHelper
      */
     Ptr<IpRoutingProtocol> Create(Ptr<Node> node) const override;
 
+    /**
+     * \param name the name of the attribute to set
+     * \param value the value of the attribute to set.
+     *
+     * This method controls the attributes of ns3::Ipv4NixVectorRouting
+     * or ns3::Ipv6NixVectorRouting
+     */
+    void Set(std::string name, const AttributeValue& value);
+
     /**
      * \brief prints the routing path for a source and destination at a particular time.
      * If the routing path does not exist, it prints that the path does not exist between
@@ -25,13 +25,20 @@
 #include "nix-vector-routing.h"
 
 #include "ns3/abort.h"
+#include "ns3/boolean.h"
 #include "ns3/ipv4-list-routing.h"
 #include "ns3/log.h"
 #include "ns3/loopback-net-device.h"
 #include "ns3/names.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
 
+#include <algorithm>
+#include <atomic>
 #include <iomanip>
 #include <queue>
+#include <set>
+#include <thread>
 
 namespace ns3
 {
@@ -48,6 +55,24 @@ bool NixVectorRouting<T>::g_isCacheDirty = false;
 template <typename T>
 uint32_t NixVectorRouting<T>::g_epoch = 1;
 
+template <typename T>
+std::vector<typename NixVectorRouting<T>::TopologyChange> NixVectorRouting<T>::g_topologyChanges;
+
+template <typename T>
+std::vector<typename NixVectorRouting<T>::NixCacheKeys_t> NixVectorRouting<T>::g_nixCacheUsers;
+
+template <typename T>
+uint64_t NixVectorRouting<T>::g_nCachedNixVectors = 0;
+
+template <typename T>
+typename NixVectorRouting<T>::CacheStatistics NixVectorRouting<T>::g_statistics;
+
+template <typename T>
+typename NixVectorRouting<T>::NixTable NixVectorRouting<T>::g_nixTable;
+
+template <typename T>
+bool NixVectorRouting<T>::g_nixTablePending = false;
+
 template <typename T>
 typename NixVectorRouting<T>::IpAddressToNodeMap NixVectorRouting<T>::g_ipAddressToNodeMap;
 
@@ -71,13 +96,28 @@ NixVectorRouting<T>::GetTypeId()
     static TypeId tid = TypeId("ns3::" + name + "NixVectorRouting")
                             .SetParent<T>()
                             .SetGroupName("NixVectorRouting")
-                            .template AddConstructor<NixVectorRouting<T>>();
+                            .template AddConstructor<NixVectorRouting<T>>()
+                            .AddAttribute("Precompute",
+                                          "Precompute the nix-vectors from this node to all "
+                                          "the nodes when the simulation starts.",
+                                          BooleanValue(false),
+                                          MakeBooleanAccessor(&NixVectorRouting<T>::m_precompute),
+                                          MakeBooleanChecker())
+                            .AddAttribute("PrecomputeThreads",
+                                          "Number of threads precomputing the nix-vectors, "
+                                          "0 for the number of hardware threads.",
+                                          UintegerValue(0),
+                                          MakeUintegerAccessor(
+                                              &NixVectorRouting<T>::m_precomputeThreads),
+                                          MakeUintegerChecker<uint32_t>());
     return tid;
 }
 
 template <typename T>
 NixVectorRouting<T>::NixVectorRouting()
-    : m_totalNeighbors(0)
+    : m_totalNeighbors(0),
+      m_precompute(false),
+      m_precomputeThreads(0)
 {
     NS_LOG_FUNCTION_NOARGS();
 }
@@ -121,6 +161,14 @@ NixVectorRouting<T>::DoInitialize()
         m_ip->SetForwarding(i, true);
     }
 
+    // The first node precomputing nix-vectors builds the table for all of
+    // them, once the other nodes are initialized
+    if (m_precompute && !g_nixTablePending)
+    {
+        g_nixTablePending = true;
+        Simulator::ScheduleNow(&NixVectorRouting<T>::BuildNixTable, this);
+    }
+
     T::DoInitialize();
 }
 
@@ -132,6 +180,10 @@ NixVectorRouting<T>::DoDispose()
 
     m_node = nullptr;
     m_ip = nullptr;
+    // The cache indexes refer to the nodes, start over
+    g_isCacheDirty = true;
+    g_nixTable = NixTable();
+    g_nixTablePending = false;
 
     T::DoDispose();
 }
@@ -164,18 +216,67 @@ NixVectorRouting<T>::FlushGlobalNixRoutingCache() const
         rp->FlushIpRouteCache();
         rp->m_totalNeighbors = 0;
     }
+    g_nixCacheUsers.clear();
+    g_nCachedNixVectors = 0;
+    g_topologyChanges.clear();
 
     // IP address to node mapping is potentially invalid so clear it.
     // Will be repopulated in lazy evaluation when mapping is needed.
     g_ipAddressToNodeMap.clear();
 }
 
+template <typename T>
+typename NixVectorRouting<T>::CacheStatistics
+NixVectorRouting<T>::GetCacheStatistics()
+{
+    return g_statistics;
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::ResetCacheStatistics()
+{
+    g_statistics = CacheStatistics();
+}
+
+template <typename T>
+typename NixVectorRouting<T>::NixTableSize
+NixVectorRouting<T>::GetNixTableSize()
+{
+    NixTableSize size;
+    if (g_nixTable.epoch == g_epoch)
+    {
+        size.pairs = g_nixTable.rowStarts.size() * static_cast<uint64_t>(g_nixTable.nNodes);
+        size.bytes = g_nixTable.rows.size() * sizeof(uint32_t) +
+                     g_nixTable.rowStarts.size() * sizeof(uint64_t) +
+                     g_nixTable.offsets.size() * sizeof(uint32_t) +
+                     g_nixTable.bits.size() * sizeof(uint32_t);
+    }
+    return size;
+}
+
 template <typename T>
 void
 NixVectorRouting<T>::FlushNixCache() const
 {
     NS_LOG_FUNCTION_NOARGS();
+    g_nCachedNixVectors -= std::min<uint64_t>(g_nCachedNixVectors, m_nixCache.size());
     m_nixCache.clear();
+    m_nixCachePaths.clear();
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::InvalidateNixCacheEntry(const IpAddress& dest) const
+{
+    NS_LOG_FUNCTION(this << dest);
+    if (m_nixCache.erase(dest))
+    {
+        g_nCachedNixVectors--;
+        g_statistics.invalidated++;
+    }
+    m_nixCachePaths.erase(dest);
+    m_ipRouteCache.erase(dest);
 }
 
 template <typename T>
@@ -188,7 +289,10 @@ NixVectorRouting<T>::FlushIpRouteCache() const
 
 template <typename T>
 Ptr<NixVector>
-NixVectorRouting<T>::GetNixVector(Ptr<Node> source, IpAddress dest, Ptr<NetDevice> oif) const
+NixVectorRouting<T>::GetNixVector(Ptr<Node> source,
+                                  IpAddress dest,
+                                  Ptr<NetDevice> oif,
+                                  std::vector<uint32_t>* path) const
 {
     NS_LOG_FUNCTION(this << source << dest << oif);
 
@@ -223,6 +327,17 @@ NixVectorRouting<T>::GetNixVector(Ptr<Node> source, IpAddress dest, Ptr<NetDevic
         {
             if (BuildNixVector(parentVector, source->GetId(), destNode->GetId(), nixVector))
             {
+                if (path)
+                {
+                    path->clear();
+                    for (Ptr<Node> node = destNode; node != source;
+                         node = parentVector[node->GetId()])
+                    {
+                        path->push_back(node->GetId());
+                    }
+                    path->push_back(source->GetId());
+                    std::reverse(path->begin(), path->end());
+                }
                 return nixVector;
             }
             else
@@ -260,6 +375,230 @@ NixVectorRouting<T>::GetNixVectorInCache(const IpAddress& address, bool& foundIn
     return nullptr;
 }
 
+template <typename T>
+Ptr<NixVector>
+NixVectorRouting<T>::GetNixVectorInTable(Ptr<Node> source,
+                                         const IpAddress& dest,
+                                         bool& foundInTable) const
+{
+    NS_LOG_FUNCTION(this << source << dest);
+
+    foundInTable = false;
+    uint32_t sourceId = source->GetId();
+    if (g_nixTable.epoch != g_epoch || sourceId >= g_nixTable.rows.size() ||
+        g_nixTable.rows[sourceId] == UINT32_MAX)
+    {
+        return nullptr;
+    }
+    foundInTable = true;
+
+    Ptr<Node> destNode = GetNodeByIp(dest);
+    if (!destNode || destNode == source || destNode->GetId() >= g_nixTable.nNodes)
+    {
+        NS_LOG_DEBUG("No routing path exists");
+        return nullptr;
+    }
+
+    uint32_t row = g_nixTable.rows[sourceId];
+    const uint32_t* offsets = &g_nixTable.offsets[row * (g_nixTable.nNodes + uint64_t(1))];
+    uint32_t begin = offsets[destNode->GetId()];
+    uint32_t end = offsets[destNode->GetId() + 1];
+    if (begin == end)
+    {
+        NS_LOG_DEBUG("No routing path exists");
+        return nullptr;
+    }
+
+    // The bits of the nix-vector are laid out as in NixVector, copy them
+    // by chunks of up to 32 bits
+    const uint32_t* words = &g_nixTable.bits[g_nixTable.rowStarts[row]];
+    Ptr<NixVector> nixVector = Create<NixVector>();
+    for (uint32_t bit = begin; bit < end;)
+    {
+        uint32_t numberOfBits = std::min<uint32_t>(32, end - bit);
+        uint32_t shift = bit % 32;
+        uint32_t value = words[bit / 32] >> shift;
+        if (shift && shift + numberOfBits > 32)
+        {
+            value |= words[bit / 32 + 1] << (32 - shift);
+        }
+        if (numberOfBits < 32)
+        {
+            value &= (1U << numberOfBits) - 1;
+        }
+        nixVector->AddNeighborIndex(value, numberOfBits);
+        bit += numberOfBits;
+    }
+    nixVector->SetEpoch(g_epoch);
+    return nixVector;
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::BuildNixTable()
+{
+    NS_LOG_FUNCTION(this);
+
+    g_nixTablePending = false;
+    CheckCacheStateAndFlush();
+    // GetAdjacentNodes looks up the interfaces of the devices
+    BuildIpAddressToNodeMap();
+
+    //
+    // Copy the topology into plain vectors: the worker threads must not
+    // touch the nodes, whose reference counts are not atomic.  The nodes
+    // are explored in the order of BFS, so that the table holds the same
+    // nix-vectors as the ones built on demand.
+    //
+    uint32_t nNodes = NodeList::GetNNodes();
+    std::vector<std::vector<uint32_t>> adjacency(nNodes);
+    // Nix index of each neighbor, sorted by neighbor
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> nixIndexes(nNodes);
+    std::vector<uint32_t> nixBits(nNodes);
+    std::vector<uint32_t> rows(nNodes, UINT32_MAX);
+    std::vector<uint32_t> sources;
+    std::vector<Ptr<Node>> neighbors;
+    std::vector<uint32_t> nixNeighbors;
+    NixVector nixVector;
+    for (uint32_t id = 0; id < nNodes; id++)
+    {
+        Ptr<Node> node = NodeList::GetNode(id);
+        Ptr<NixVectorRouting<T>> rp = node->GetObject<NixVectorRouting>();
+        if (rp && rp->m_precompute)
+        {
+            rows[id] = sources.size();
+            sources.push_back(id);
+        }
+        neighbors.clear();
+        GetAdjacentNodes(node, neighbors);
+        for (const auto& neighbor : neighbors)
+        {
+            adjacency[id].push_back(neighbor->GetId());
+        }
+        GetNixNeighbors(node, nixNeighbors);
+        nixBits[id] = nixVector.BitCount(nixNeighbors.size());
+        for (uint32_t index = 0; index < nixNeighbors.size(); index++)
+        {
+            nixIndexes[id].emplace_back(nixNeighbors[index], index);
+        }
+        // Keep the last index of a neighbor reached through several channels
+        std::stable_sort(nixIndexes[id].begin(),
+                         nixIndexes[id].end(),
+                         [](const auto& a, const auto& b) { return a.first < b.first; });
+    }
+
+    //
+    // Run a BFS from each source, then walk back from each node to write
+    // the nix-vector of the path, last hop first.
+    //
+    std::vector<std::vector<uint32_t>> rowOffsets(sources.size());
+    std::vector<std::vector<uint32_t>> rowBits(sources.size());
+    std::atomic<std::size_t> nextRow{0};
+    auto buildRows = [&]() {
+        std::vector<uint32_t> parents;
+        std::vector<uint32_t> greyNodeList;
+        for (std::size_t row = nextRow++; row < sources.size(); row = nextRow++)
+        {
+            uint32_t source = sources[row];
+            parents.assign(nNodes, UINT32_MAX);
+            parents[source] = source;
+            greyNodeList.assign(1, source);
+            for (std::size_t head = 0; head < greyNodeList.size(); head++)
+            {
+                for (uint32_t neighbor : adjacency[greyNodeList[head]])
+                {
+                    if (parents[neighbor] == UINT32_MAX)
+                    {
+                        parents[neighbor] = greyNodeList[head];
+                        greyNodeList.push_back(neighbor);
+                    }
+                }
+            }
+
+            std::vector<uint32_t>& offsets = rowOffsets[row];
+            std::vector<uint32_t>& bits = rowBits[row];
+            offsets.resize(nNodes + 1);
+            uint32_t nBits = 0;
+            for (uint32_t dest = 0; dest < nNodes; dest++)
+            {
+                offsets[dest] = nBits;
+                if (dest == source || parents[dest] == UINT32_MAX)
+                {
+                    continue;
+                }
+                for (uint32_t node = dest; node != source; node = parents[node])
+                {
+                    uint32_t parent = parents[node];
+                    const auto& indexes = nixIndexes[parent];
+                    auto it = std::upper_bound(
+                        indexes.begin(),
+                        indexes.end(),
+                        node,
+                        [](uint32_t id, const auto& entry) { return id < entry.first; });
+                    uint32_t index = 0;
+                    if (it != indexes.begin() && (it - 1)->first == node)
+                    {
+                        index = (it - 1)->second;
+                    }
+                    // Same layout as NixVector::AddNeighborIndex
+                    uint32_t used = nBits % 32;
+                    if (used == 0)
+                    {
+                        bits.push_back(0);
+                    }
+                    bits.back() |= index << used;
+                    if (used + nixBits[parent] > 32)
+                    {
+                        bits.push_back(index >> (32 - used));
+                    }
+                    nBits += nixBits[parent];
+                }
+            }
+            offsets[nNodes] = nBits;
+        }
+    };
+
+    uint32_t nThreads = m_precomputeThreads;
+    if (nThreads == 0)
+    {
+        nThreads = std::max(1U, std::thread::hardware_concurrency());
+    }
+    nThreads = std::min<std::size_t>(nThreads, std::max<std::size_t>(1, sources.size()));
+    std::vector<std::thread> threads;
+    for (uint32_t i = 1; i < nThreads; i++)
+    {
+        threads.emplace_back(buildRows);
+    }
+    buildRows();
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    g_nixTable = NixTable();
+    g_nixTable.epoch = g_epoch;
+    g_nixTable.nNodes = nNodes;
+    g_nixTable.rows = std::move(rows);
+    g_nixTable.offsets.reserve(sources.size() * (nNodes + uint64_t(1)));
+    for (std::size_t row = 0; row < sources.size(); row++)
+    {
+        g_nixTable.rowStarts.push_back(g_nixTable.bits.size());
+        g_nixTable.offsets.insert(g_nixTable.offsets.end(),
+                                  rowOffsets[row].begin(),
+                                  rowOffsets[row].end());
+        g_nixTable.bits.insert(g_nixTable.bits.end(), rowBits[row].begin(), rowBits[row].end());
+        std::vector<uint32_t>().swap(rowOffsets[row]);
+        std::vector<uint32_t>().swap(rowBits[row]);
+    }
+
+    NixTableSize size = GetNixTableSize();
+    NS_LOG_INFO("Precomputed the nix-vectors of " << size.pairs << " node pairs in "
+                                                  << size.bytes << " bytes ("
+                                                  << (size.pairs ? size.bytes / double(size.pairs)
+                                                                 : 0)
+                                                  << " bytes per pair)");
+}
+
 template <typename T>
 Ptr<typename NixVectorRouting<T>::IpRoute>
 NixVectorRouting<T>::GetIpRouteInCache(IpAddress address)
@@ -300,18 +639,44 @@ NixVectorRouting<T>::BuildNixVector(const std::vector<Ptr<Node>>& parentVector,
 
     Ptr<Node> parentNode = parentVector.at(dest);
 
-    uint32_t numberOfDevices = parentNode->GetNDevices();
+    // If we find the node that matches "dest" among the neighbors
+    // then we can add its index to the nix vector.
+    std::vector<uint32_t> neighbors;
+    GetNixNeighbors(parentNode, neighbors);
     uint32_t destId = 0;
-    uint32_t totalNeighbors = 0;
+    uint32_t totalNeighbors = neighbors.size();
+    for (uint32_t i = 0; i < totalNeighbors; i++)
+    {
+        if (neighbors[i] == dest)
+        {
+            destId = i;
+        }
+    }
+    NS_LOG_LOGIC("Adding Nix: " << destId << " with " << nixVector->BitCount(totalNeighbors)
+                                << " bits, for node " << parentNode->GetId());
+    nixVector->AddNeighborIndex(destId, nixVector->BitCount(totalNeighbors));
 
+    // recurse through T vector, grabbing the path
+    // and building the nix vector
+    BuildNixVector(parentVector, source, (parentVector.at(dest))->GetId(), nixVector);
+    return true;
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::GetNixNeighbors(Ptr<Node> node, std::vector<uint32_t>& neighbors) const
+{
+    NS_LOG_FUNCTION(this << node);
+
+    neighbors.clear();
     // scan through the net devices on the T node
     // and then look at the nodes adjacent to them
-    for (uint32_t i = 0; i < numberOfDevices; i++)
+    for (uint32_t i = 0; i < node->GetNDevices(); i++)
     {
         // Get a net device from the node
         // as well as the channel, and figure
         // out the adjacent net devices
-        Ptr<NetDevice> localNetDevice = parentNode->GetDevice(i);
+        Ptr<NetDevice> localNetDevice = node->GetDevice(i);
         if (localNetDevice->IsBridge())
         {
             continue;
@@ -327,33 +692,12 @@ NixVectorRouting<T>::BuildNixVector(const std::vector<Ptr<Node>>& parentVector,
         NetDeviceContainer netDeviceContainer;
         GetAdjacentNetDevices(localNetDevice, channel, netDeviceContainer);
 
-        // Finally we can get the adjacent nodes
-        // and scan through them.  If we find the
-        // node that matches "dest" then we can add
-        // the index  to the nix vector.
-        // the index corresponds to the neighbor index
-        uint32_t offset = 0;
+        // the index of a neighbor is its position in the list
         for (auto iter = netDeviceContainer.Begin(); iter != netDeviceContainer.End(); iter++)
         {
-            Ptr<Node> remoteNode = (*iter)->GetNode();
-
-            if (remoteNode->GetId() == dest)
-            {
-                destId = totalNeighbors + offset;
-            }
-            offset += 1;
+            neighbors.push_back((*iter)->GetNode()->GetId());
         }
-
-        totalNeighbors += netDeviceContainer.GetN();
     }
-    NS_LOG_LOGIC("Adding Nix: " << destId << " with " << nixVector->BitCount(totalNeighbors)
-                                << " bits, for node " << parentNode->GetId());
-    nixVector->AddNeighborIndex(destId, nixVector->BitCount(totalNeighbors));
-
-    // recurse through T vector, grabbing the path
-    // and building the nix vector
-    BuildNixVector(parentVector, source, (parentVector.at(dest))->GetId(), nixVector);
-    return true;
 }
 
 template <typename T>
@@ -567,6 +911,253 @@ NixVectorRouting<T>::GetInterfaceByNetDevice(Ptr<NetDevice> netDevice) const
     return ipInterface;
 }
 
+template <typename T>
+void
+NixVectorRouting<T>::GetAdjacentNodes(Ptr<Node> node, std::vector<Ptr<Node>>& neighbors) const
+{
+    NS_LOG_FUNCTION(this << node);
+
+    Ptr<IpL3Protocol> ip = node->GetObject<IpL3Protocol>();
+    for (uint32_t i = 0; i < (node->GetNDevices()); i++)
+    {
+        // Get a net device from the node
+        // as well as the channel, and figure
+        // out the adjacent net device
+        Ptr<NetDevice> localNetDevice = node->GetDevice(i);
+
+        // make sure that we can go this way
+        if (ip)
+        {
+            uint32_t interfaceIndex = (ip)->GetInterfaceForDevice(node->GetDevice(i));
+            if (!(ip->IsUp(interfaceIndex)))
+            {
+                NS_LOG_LOGIC("IpInterface is down");
+                continue;
+            }
+        }
+        if (!(localNetDevice->IsLinkUp()))
+        {
+            NS_LOG_LOGIC("Link is down.");
+            continue;
+        }
+        Ptr<Channel> channel = localNetDevice->GetChannel();
+        if (!channel)
+        {
+            continue;
+        }
+
+        // this function takes in the local net dev, and channel, and
+        // writes to the netDeviceContainer the adjacent net devs
+        NetDeviceContainer netDeviceContainer;
+        GetAdjacentNetDevices(localNetDevice, channel, netDeviceContainer);
+
+        for (auto iter = netDeviceContainer.Begin(); iter != netDeviceContainer.End(); iter++)
+        {
+            Ptr<IpInterface> remoteIpInterface = GetInterfaceByNetDevice(*iter);
+            if (!remoteIpInterface || !(remoteIpInterface->IsUp()))
+            {
+                NS_LOG_LOGIC("IpInterface either doesn't exist or is down");
+                continue;
+            }
+            neighbors.push_back((*iter)->GetNode());
+        }
+    }
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::GetDistances(Ptr<Node> source, std::vector<uint32_t>& distances) const
+{
+    NS_LOG_FUNCTION(this << source);
+
+    distances.assign(NodeList::GetNNodes(), UINT32_MAX);
+    std::queue<Ptr<Node>> greyNodeList;
+    greyNodeList.push(source);
+    distances[source->GetId()] = 0;
+    std::vector<Ptr<Node>> neighbors;
+    while (!greyNodeList.empty())
+    {
+        Ptr<Node> currNode = greyNodeList.front();
+        greyNodeList.pop();
+        neighbors.clear();
+        GetAdjacentNodes(currNode, neighbors);
+        for (const auto& remoteNode : neighbors)
+        {
+            if (distances[remoteNode->GetId()] == UINT32_MAX)
+            {
+                distances[remoteNode->GetId()] = distances[currNode->GetId()] + 1;
+                greyNodeList.push(remoteNode);
+            }
+        }
+    }
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::GetChannelNodes(Ptr<NetDevice> netDevice,
+                                     std::unordered_set<uint32_t>& nodes) const
+{
+    NS_LOG_FUNCTION(this << netDevice);
+
+    nodes.insert(netDevice->GetNode()->GetId());
+    Ptr<Channel> channel = netDevice->GetChannel();
+    if (!channel)
+    {
+        return;
+    }
+    // Walk the channels bridged to this one, the nodes attached to them
+    // are neighbors of the node of netDevice
+    std::vector<Ptr<Channel>> channels{channel};
+    std::set<Ptr<Channel>> visited{channel};
+    while (!channels.empty())
+    {
+        channel = channels.back();
+        channels.pop_back();
+        for (std::size_t i = 0; i < channel->GetNDevices(); i++)
+        {
+            Ptr<NetDevice> device = channel->GetDevice(i);
+            nodes.insert(device->GetNode()->GetId());
+            Ptr<BridgeNetDevice> bd = NetDeviceIsBridged(device);
+            if (!bd)
+            {
+                continue;
+            }
+            for (uint32_t j = 0; j < bd->GetNBridgePorts(); ++j)
+            {
+                Ptr<Channel> chBridged = bd->GetBridgePort(j)->GetChannel();
+                if (chBridged && visited.insert(chBridged).second)
+                {
+                    channels.push_back(chBridged);
+                }
+            }
+        }
+    }
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::RecordTopologyChange(uint32_t interface, bool up)
+{
+    NS_LOG_FUNCTION(this << interface << up);
+
+    if (g_isCacheDirty || !m_ip)
+    {
+        g_isCacheDirty = true;
+        return;
+    }
+    g_topologyChanges.push_back({m_ip->GetNetDevice(interface), up});
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::ApplyTopologyChanges() const
+{
+    NS_LOG_FUNCTION_NOARGS();
+
+    std::vector<TopologyChange> changes;
+    changes.swap(g_topologyChanges);
+
+    // IP address to node mapping is potentially invalid so clear it.
+    // Will be repopulated in lazy evaluation when mapping is needed.
+    g_ipAddressToNodeMap.clear();
+
+    //
+    // The neighbor indexes of the nodes sharing a channel with a changed
+    // interface are renumbered: drop their IpRoutes and the nix-vectors
+    // traversing them.
+    //
+    std::unordered_set<uint32_t> affected;
+    std::vector<Ptr<Node>> upNodes;
+    for (const auto& change : changes)
+    {
+        Ptr<Node> node = change.device->GetNode();
+        if (!node)
+        {
+            continue;
+        }
+        GetChannelNodes(change.device, affected);
+        if (change.up && std::find(upNodes.begin(), upNodes.end(), node) == upNodes.end())
+        {
+            upNodes.push_back(node);
+        }
+    }
+    for (uint32_t nodeId : affected)
+    {
+        Ptr<NixVectorRouting<T>> rp = NodeList::GetNode(nodeId)->GetObject<NixVectorRouting>();
+        if (rp)
+        {
+            rp->FlushIpRouteCache();
+            rp->m_totalNeighbors = 0;
+        }
+        if (nodeId >= g_nixCacheUsers.size())
+        {
+            continue;
+        }
+        for (const auto& key : g_nixCacheUsers[nodeId])
+        {
+            Ptr<Node> userNode = NodeList::GetNode(key.first);
+            Ptr<NixVectorRouting<T>> user = userNode->GetObject<NixVectorRouting>();
+            auto path = user->m_nixCachePaths.find(key.second);
+            // Skip the nix-vectors already dropped, or rebuilt elsewhere
+            if (path != user->m_nixCachePaths.end() &&
+                std::find(path->second.begin(), path->second.end(), nodeId) != path->second.end())
+            {
+                NS_LOG_LOGIC("Dropping nix-vector of node " << key.first << " to " << key.second);
+                user->InvalidateNixCacheEntry(key.second);
+            }
+        }
+        g_nixCacheUsers[nodeId].clear();
+    }
+
+    //
+    // A new link can only shorten the paths going through its end nodes.
+    // Unless there are fewer nix-vectors left than such nodes, drop the
+    // nix-vectors longer than the path through one of them.
+    //
+    if (upNodes.empty() || g_nCachedNixVectors == 0)
+    {
+        return;
+    }
+    if (upNodes.size() >= g_nCachedNixVectors)
+    {
+        g_statistics.invalidated += g_nCachedNixVectors;
+        FlushGlobalNixRoutingCache();
+        return;
+    }
+    std::vector<std::vector<uint32_t>> distances(upNodes.size());
+    for (std::size_t i = 0; i < upNodes.size(); i++)
+    {
+        GetDistances(upNodes[i], distances[i]);
+    }
+    for (auto i = NodeList::Begin(); i != NodeList::End(); i++)
+    {
+        Ptr<NixVectorRouting<T>> rp = (*i)->GetObject<NixVectorRouting>();
+        if (!rp)
+        {
+            continue;
+        }
+        std::vector<IpAddress> longer;
+        for (const auto& [dest, path] : rp->m_nixCachePaths)
+        {
+            uint64_t hops = path.size() - 1;
+            for (const auto& d : distances)
+            {
+                if (static_cast<uint64_t>(d[path.front()]) + d[path.back()] < hops)
+                {
+                    longer.push_back(dest);
+                    break;
+                }
+            }
+        }
+        for (const auto& dest : longer)
+        {
+            NS_LOG_LOGIC("Dropping nix-vector of node " << (*i)->GetId() << " to " << dest
+                                                        << ", a shorter path exists");
+            rp->InvalidateNixCacheEntry(dest);
+        }
+    }
+}
+
 template <typename T>
 uint32_t
 NixVectorRouting<T>::FindTotalNeighbors(Ptr<Node> node) const
@@ -747,23 +1338,52 @@ NixVectorRouting<T>::RouteOutput(Ptr<Packet> p,
             return rtentry;
         }
     }
-    // Check the Nix cache
+    // Check the precomputed nix-vectors, then the Nix cache
+    bool foundInTable = false;
     bool foundInCache = false;
-    nixVectorInCache = GetNixVectorInCache(destAddress, foundInCache);
+    if (!oif)
+    {
+        nixVectorInCache = GetNixVectorInTable(m_node, destAddress, foundInTable);
+    }
+    if (!foundInTable)
+    {
+        nixVectorInCache = GetNixVectorInCache(destAddress, foundInCache);
+    }
 
+    if (foundInTable)
+    {
+        g_statistics.precomputed++;
+    }
     // not in cache
-    if (!foundInCache)
+    else if (!foundInCache)
     {
+        g_statistics.misses++;
         NS_LOG_LOGIC("Nix-vector not in cache, build: ");
         // Build the nix-vector, given this node and the
         // dest IP address
-        nixVectorInCache = GetNixVector(m_node, destAddress, oif);
+        std::vector<uint32_t> path;
+        nixVectorInCache = GetNixVector(m_node, destAddress, oif, &path);
         if (nixVectorInCache)
         {
-            // cache it
+            // cache it, and index it by the nodes it traverses so that
+            // a topology change only drops the nix-vectors it affects
             m_nixCache.insert(typename NixMap_t::value_type(destAddress, nixVectorInCache));
+            g_nCachedNixVectors++;
+            if (g_nixCacheUsers.size() < NodeList::GetNNodes())
+            {
+                g_nixCacheUsers.resize(NodeList::GetNNodes());
+            }
+            for (uint32_t nodeId : path)
+            {
+                g_nixCacheUsers[nodeId].emplace(m_node->GetId(), destAddress);
+            }
+            m_nixCachePaths[destAddress] = std::move(path);
         }
     }
+    else
+    {
+        g_statistics.hits++;
+    }
 
     // path exists
     if (nixVectorInCache)
@@ -1018,7 +1638,9 @@ NixVectorRouting<T>::PrintRoutingTable(Ptr<OutputStreamWrapper> stream, Time::Un
     {
         *os << std::setw(30) << "Destination";
         *os << "NixVector" << std::endl;
-        for (auto it = m_nixCache.begin(); it != m_nixCache.end(); it++)
+        // Sort the destinations for a stable output
+        std::map<IpAddress, Ptr<NixVector>> nixCache(m_nixCache.begin(), m_nixCache.end());
+        for (auto it = nixCache.begin(); it != nixCache.end(); it++)
         {
             std::ostringstream dest;
             dest << it->first;
@@ -1041,7 +1663,9 @@ NixVectorRouting<T>::PrintRoutingTable(Ptr<OutputStreamWrapper> stream, Time::Un
         *os << std::setw(30) << "Gateway";
         *os << std::setw(30) << "Source";
         *os << "OutputDevice" << std::endl;
-        for (auto it = m_ipRouteCache.begin(); it != m_ipRouteCache.end(); it++)
+        std::map<IpAddress, Ptr<IpRoute>> ipRouteCache(m_ipRouteCache.begin(),
+                                                       m_ipRouteCache.end());
+        for (auto it = ipRouteCache.begin(); it != ipRouteCache.end(); it++)
         {
             std::ostringstream dest;
             std::ostringstream gw;
@@ -1074,28 +1698,28 @@ template <typename T>
 void
 NixVectorRouting<T>::NotifyInterfaceUp(uint32_t i)
 {
-    g_isCacheDirty = true;
+    RecordTopologyChange(i, true);
 }
 
 template <typename T>
 void
 NixVectorRouting<T>::NotifyInterfaceDown(uint32_t i)
 {
-    g_isCacheDirty = true;
+    RecordTopologyChange(i, false);
 }
 
 template <typename T>
 void
 NixVectorRouting<T>::NotifyAddAddress(uint32_t interface, IpInterfaceAddress address)
 {
-    g_isCacheDirty = true;
+    RecordTopologyChange(interface, true);
 }
 
 template <typename T>
 void
 NixVectorRouting<T>::NotifyRemoveAddress(uint32_t interface, IpInterfaceAddress address)
 {
-    g_isCacheDirty = true;
+    RecordTopologyChange(interface, false);
 }
 
 template <typename T>
@@ -1106,7 +1730,7 @@ NixVectorRouting<T>::NotifyAddRoute(IpAddress dst,
                                     uint32_t interface,
                                     IpAddress prefixToUse)
 {
-    g_isCacheDirty = true;
+    // Nix-vectors only depend on the interfaces and their addresses
 }
 
 template <typename T>
@@ -1117,7 +1741,7 @@ NixVectorRouting<T>::NotifyRemoveRoute(IpAddress dst,
                                        uint32_t interface,
                                        IpAddress prefixToUse)
 {
-    g_isCacheDirty = true;
+    // Nix-vectors only depend on the interfaces and their addresses
 }
 
 template <typename T>
@@ -1131,6 +1755,7 @@ NixVectorRouting<T>::BFS(uint32_t numberOfNodes,
     NS_LOG_FUNCTION(this << numberOfNodes << source << dest << parentVector << oif);
 
     NS_LOG_LOGIC("Going from Node " << source->GetId() << " to Node " << dest->GetId());
+    g_statistics.bfs++;
     std::queue<Ptr<Node>> greyNodeList; // discovered nodes with unexplored children
 
     // reset the parent vector
@@ -1212,63 +1837,18 @@ NixVectorRouting<T>::BFS(uint32_t numberOfNodes,
         {
             // Iterate over the current node's adjacent vertices
             // and push them into the queue
-            for (uint32_t i = 0; i < (currNode->GetNDevices()); i++)
+            std::vector<Ptr<Node>> neighbors;
+            GetAdjacentNodes(currNode, neighbors);
+            for (const auto& remoteNode : neighbors)
             {
-                // Get a net device from the node
-                // as well as the channel, and figure
-                // out the adjacent net device
-                Ptr<NetDevice> localNetDevice = currNode->GetDevice(i);
-
-                // make sure that we can go this way
-                if (ip)
-                {
-                    uint32_t interfaceIndex = (ip)->GetInterfaceForDevice(currNode->GetDevice(i));
-                    if (!(ip->IsUp(interfaceIndex)))
-                    {
-                        NS_LOG_LOGIC("IpInterface is down");
-                        continue;
-                    }
-                }
-                if (!(localNetDevice->IsLinkUp()))
-                {
-                    NS_LOG_LOGIC("Link is down.");
-                    continue;
-                }
-                Ptr<Channel> channel = localNetDevice->GetChannel();
-                if (!channel)
-                {
-                    continue;
-                }
-
-                // this function takes in the local net dev, and channel, and
-                // writes to the netDeviceContainer the adjacent net devs
-                NetDeviceContainer netDeviceContainer;
-                GetAdjacentNetDevices(localNetDevice, channel, netDeviceContainer);
-
-                // Finally we can get the adjacent nodes
-                // and scan through them.  We push them
-                // to the greyNode queue, if they aren't
-                // already there.
-                for (auto iter = netDeviceContainer.Begin(); iter != netDeviceContainer.End();
-                     iter++)
+                // check to see if this node has been pushed before
+                // by checking to see if it has a parent
+                // if it doesn't (null or 0), then set its parent and
+                // push to the queue
+                if (!parentVector.at(remoteNode->GetId()))
                 {
-                    Ptr<Node> remoteNode = (*iter)->GetNode();
-                    Ptr<IpInterface> remoteIpInterface = GetInterfaceByNetDevice(*iter);
-                    if (!remoteIpInterface || !(remoteIpInterface->IsUp()))
-                    {
-                        NS_LOG_LOGIC("IpInterface either doesn't exist or is down");
-                        continue;
-                    }
-
-                    // check to see if this node has been pushed before
-                    // by checking to see if it has a parent
-                    // if it doesn't (null or 0), then set its parent and
-                    // push to the queue
-                    if (!parentVector.at(remoteNode->GetId()))
-                    {
-                        parentVector.at(remoteNode->GetId()) = currNode;
-                        greyNodeList.push(remoteNode);
-                    }
+                    parentVector.at(remoteNode->GetId()) = currNode;
+                    greyNodeList.push(remoteNode);
                 }
             }
         }
@@ -1427,6 +2007,17 @@ NixVectorRouting<T>::CheckCacheStateAndFlush() const
         g_epoch++;
         g_isCacheDirty = false;
     }
+    else if (!g_topologyChanges.empty())
+    {
+        // Nix-vectors in flight may traverse the changed nodes
+        ApplyTopologyChanges();
+        g_epoch++;
+    }
+    if (g_nixTable.epoch != g_epoch && !g_nixTable.rows.empty())
+    {
+        // The precomputed nix-vectors are stale, build them on demand
+        g_nixTable = NixTable();
+    }
 }
 
 /* Public template function declarations */
@@ -1434,6 +2025,16 @@ template void NixVectorRouting<Ipv4RoutingProtocol>::SetNode(Ptr<Node> node);
 template void NixVectorRouting<Ipv6RoutingProtocol>::SetNode(Ptr<Node> node);
 template void NixVectorRouting<Ipv4RoutingProtocol>::FlushGlobalNixRoutingCache() const;
 template void NixVectorRouting<Ipv6RoutingProtocol>::FlushGlobalNixRoutingCache() const;
+template NixVectorRouting<Ipv4RoutingProtocol>::CacheStatistics
+NixVectorRouting<Ipv4RoutingProtocol>::GetCacheStatistics();
+template NixVectorRouting<Ipv6RoutingProtocol>::CacheStatistics
+NixVectorRouting<Ipv6RoutingProtocol>::GetCacheStatistics();
+template void NixVectorRouting<Ipv4RoutingProtocol>::ResetCacheStatistics();
+template void NixVectorRouting<Ipv6RoutingProtocol>::ResetCacheStatistics();
+template NixVectorRouting<Ipv4RoutingProtocol>::NixTableSize
+NixVectorRouting<Ipv4RoutingProtocol>::GetNixTableSize();
+template NixVectorRouting<Ipv6RoutingProtocol>::NixTableSize
+NixVectorRouting<Ipv6RoutingProtocol>::GetNixTableSize();
 template void NixVectorRouting<Ipv4RoutingProtocol>::PrintRoutingPath(
     Ptr<Node> source,
     IpAddress dest,
@@ -43,6 +43,8 @@
 
 #include <map>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 // NOLINTBEGIN(modernize-use-override)
 
@@ -99,6 +101,27 @@ class NixVectorRouting : public std::enable_if_t<std::is_same_v<Ipv4RoutingProto
     using IpL3Protocol = typename std::conditional_t<IsIpv4, Ipv4L3Protocol, Ipv6L3Protocol>;
 
   public:
+    /**
+     * Counters of the nix-vector caches, summed over all the nodes.
+     */
+    struct CacheStatistics
+    {
+        uint64_t hits{0};        //!< nix-vectors found in the cache by RouteOutput
+        uint64_t misses{0};      //!< nix-vectors not found in the cache by RouteOutput
+        uint64_t bfs{0};         //!< breadth first searches run to build nix-vectors
+        uint64_t invalidated{0}; //!< cached nix-vectors dropped by topology changes
+        uint64_t precomputed{0}; //!< nix-vectors taken from the precomputed table
+    };
+
+    /**
+     * Size of the table of precomputed nix-vectors.
+     */
+    struct NixTableSize
+    {
+        uint64_t pairs{0}; //!< number of (source, destination) node pairs
+        uint64_t bytes{0}; //!< memory used by the table
+    };
+
     NixVectorRouting();
     ~NixVectorRouting();
     /**
@@ -127,6 +150,23 @@ class NixVectorRouting : public std::enable_if_t<std::is_same_v<Ipv4RoutingProto
      */
     void FlushGlobalNixRoutingCache() const;
 
+    /**
+     * @brief Get the counters of the nix-vector caches
+     * @return the counters since the last reset
+     */
+    static CacheStatistics GetCacheStatistics();
+
+    /**
+     * @brief Reset the counters of the nix-vector caches
+     */
+    static void ResetCacheStatistics();
+
+    /**
+     * @brief Get the size of the table of precomputed nix-vectors
+     * @return the size of the table, empty if it is not built or stale
+     */
+    static NixTableSize GetNixTableSize();
+
     /**
      * @brief Print the Routing Path according to Nix Routing
      * \param source Source node
@@ -162,6 +202,35 @@ class NixVectorRouting : public std::enable_if_t<std::is_same_v<Ipv4RoutingProto
      */
     void ResetTotalNeighbors();
 
+    /**
+     * Drops the cached nix-vector and IpRoute of a destination
+     * \param dest destination IP
+     */
+    void InvalidateNixCacheEntry(const IpAddress& dest) const;
+
+    /**
+     * Records a change of an interface of the node, to be applied
+     * to the caches before they are used again
+     * \param interface the interface index
+     * \param up whether the change may create new paths
+     */
+    void RecordTopologyChange(uint32_t interface, bool up);
+
+    /**
+     * Applies the recorded topology changes to the caches of all the
+     * nodes.  The nix-vectors traversing a node whose neighbors changed
+     * are dropped, as are those that a new link would shorten.
+     */
+    void ApplyTopologyChanges() const;
+
+    /**
+     * Finds the nodes attached to the channel of a net-device, across
+     * bridges.  Their neighbor indexes depend on the net-device.
+     * \param [in] netDevice the NetDevice
+     * \param [out] nodes the IDs of the nodes, including the node of netDevice
+     */
+    void GetChannelNodes(Ptr<NetDevice> netDevice, std::unordered_set<uint32_t>& nodes) const;
+
     /**
      * Takes in the source node and dest IP and calls GetNodeByIp,
      * BFS, accounting for any output interface specified, and finally
@@ -170,9 +239,13 @@ class NixVectorRouting : public std::enable_if_t<std::is_same_v<Ipv4RoutingProto
      * \param source Source node
      * \param dest Destination node address
      * \param oif Preferred output interface
+     * \param path if not null, set to the IDs of the nodes on the path, from source to dest
      * \returns The NixVector to be used in routing.
      */
-    Ptr<NixVector> GetNixVector(Ptr<Node> source, IpAddress dest, Ptr<NetDevice> oif) const;
+    Ptr<NixVector> GetNixVector(Ptr<Node> source,
+                                IpAddress dest,
+                                Ptr<NetDevice> oif,
+                                std::vector<uint32_t>* path = nullptr) const;
 
     /**
      * Checks the cache based on dest IP for the nix-vector
@@ -182,6 +255,24 @@ class NixVectorRouting : public std::enable_if_t<std::is_same_v<Ipv4RoutingProto
      */
     Ptr<NixVector> GetNixVectorInCache(const IpAddress& address, bool& foundInCache) const;
 
+    /**
+     * Looks up the nix-vector in the table of precomputed nix-vectors
+     * \param source Source node
+     * \param dest Destination node address
+     * \param foundInTable whether the table holds the nix-vectors of source
+     * \returns The NixVector to be used in routing, null if there is no path.
+     */
+    Ptr<NixVector> GetNixVectorInTable(Ptr<Node> source,
+                                       const IpAddress& dest,
+                                       bool& foundInTable) const;
+
+    /**
+     * Builds the table of the nix-vectors from the nodes with the
+     * Precompute attribute set to all the nodes.  The breadth first
+     * searches run in parallel on a copy of the topology.
+     */
+    void BuildNixTable();
+
     /**
      * Checks the cache based on dest IP for the IpRoute
      * \param address Address to check
@@ -229,6 +320,31 @@ class NixVectorRouting : public std::enable_if_t<std::is_same_v<Ipv4RoutingProto
                         uint32_t dest,
                         Ptr<NixVector> nixVector) const;
 
+    /**
+     * Finds the neighbors of a node through its up interfaces,
+     * in the order of the nix indexes.
+     * \param [in] node node pointer
+     * \param [out] neighbors the neighbors of the node
+     */
+    void GetAdjacentNodes(Ptr<Node> node, std::vector<Ptr<Node>>& neighbors) const;
+
+    /**
+     * Computes the number of hops from a node to all the others.
+     * \param [in] source the node
+     * \param [out] distances number of hops indexed by node ID,
+     *              UINT32_MAX for unreachable nodes
+     */
+    void GetDistances(Ptr<Node> source, std::vector<uint32_t>& distances) const;
+
+    /**
+     * Finds the neighbors of a node, the nix index of a neighbor
+     * being its position in the list.  A neighbor appears several
+     * times if several channels lead to it.
+     * \param [in] node node pointer
+     * \param [out] neighbors the IDs of the neighbors of the node
+     */
+    void GetNixNeighbors(Ptr<Node> node, std::vector<uint32_t>& neighbors) const;
+
     /**
      * Simply iterates through the nodes net-devices and determines
      * how many neighbors the node has.
@@ -284,9 +400,52 @@ class NixVectorRouting : public std::enable_if_t<std::is_same_v<Ipv4RoutingProto
     void DoDispose();
 
     /// Map of IpAddress to NixVector
-    typedef std::map<IpAddress, Ptr<NixVector>> NixMap_t;
+    typedef std::unordered_map<IpAddress, Ptr<NixVector>, IpAddressHash> NixMap_t;
     /// Map of IpAddress to IpRoute
-    typedef std::map<IpAddress, Ptr<IpRoute>> IpRouteMap_t;
+    typedef std::unordered_map<IpAddress, Ptr<IpRoute>, IpAddressHash> IpRouteMap_t;
+    /// Map of IpAddress to the IDs of the nodes traversed by the nix-vector
+    typedef std::unordered_map<IpAddress, std::vector<uint32_t>, IpAddressHash> NixPathMap_t;
+
+    /// A cached nix-vector: the ID of the node caching it and its destination
+    typedef std::pair<uint32_t, IpAddress> NixCacheKey;
+
+    /// Hash function of NixCacheKey
+    struct NixCacheKeyHash
+    {
+        /**
+         * \param key the key
+         * \return the hash of the key
+         */
+        std::size_t operator()(const NixCacheKey& key) const
+        {
+            return IpAddressHash()(key.second) ^ (key.first * 0x9e3779b9U);
+        }
+    };
+
+    /// Set of cached nix-vectors
+    typedef std::unordered_set<NixCacheKey, NixCacheKeyHash> NixCacheKeys_t;
+
+    /**
+     * Nix-vectors from a set of source nodes to all the nodes, bit-packed
+     * as in NixVector.
+     */
+    struct NixTable
+    {
+        uint32_t epoch{0};               //!< epoch the table was built in
+        uint32_t nNodes{0};              //!< number of nodes when the table was built
+        std::vector<uint32_t> rows;      //!< row of each source node, UINT32_MAX for others
+        std::vector<uint64_t> rowStarts; //!< first word of each row in bits
+        /// Bit offset of the nix-vector to each node in its row, nNodes + 1 per row
+        std::vector<uint32_t> offsets;
+        std::vector<uint32_t> bits; //!< the nix-vectors
+    };
+
+    /// A change of an interface waiting to be applied to the caches
+    struct TopologyChange
+    {
+        Ptr<NetDevice> device; //!< the net-device of the interface
+        bool up;               //!< whether the change may create new paths
+    };
 
     /// Callback for IPv4 unicast packets to be forwarded
     typedef Callback<void, Ptr<IpRoute>, Ptr<const Packet>, const IpHeader&>
@@ -486,6 +645,31 @@ class NixVectorRouting : public std::enable_if_t<std::is_same_v<Ipv4RoutingProto
      */
     static bool g_isCacheDirty;
 
+    /**
+     * Topology changes not yet applied to the caches.  They are applied
+     * lazily, when the caches are used.
+     */
+    static std::vector<TopologyChange> g_topologyChanges;
+
+    /**
+     * Cached nix-vectors traversing each node, indexed by node ID.  The
+     * entries of nix-vectors dropped for other reasons are left in place
+     * and skipped when the node changes.
+     */
+    static std::vector<NixCacheKeys_t> g_nixCacheUsers;
+
+    /// Number of nix-vectors cached by all the nodes
+    static uint64_t g_nCachedNixVectors;
+
+    /// Counters of the nix-vector caches
+    static CacheStatistics g_statistics;
+
+    /// Table of precomputed nix-vectors, valid in its epoch only
+    static NixTable g_nixTable;
+
+    /// Whether a node scheduled the build of the table
+    static bool g_nixTablePending;
+
     /**
      * Nix Epoch, incremented each time a flush is performed.
      */
@@ -494,6 +678,9 @@ class NixVectorRouting : public std::enable_if_t<std::is_same_v<Ipv4RoutingProto
     /** Cache stores nix-vectors based on destination ip */
     mutable NixMap_t m_nixCache;
 
+    /** Nodes traversed by the nix-vectors of m_nixCache */
+    mutable NixPathMap_t m_nixCachePaths;
+
     /** Cache stores IpRoutes based on destination ip */
     mutable IpRouteMap_t m_ipRouteCache;
 
@@ -503,6 +690,9 @@ class NixVectorRouting : public std::enable_if_t<std::is_same_v<Ipv4RoutingProto
     /** Total neighbors used for nix-vector to determine number of bits */
     uint32_t m_totalNeighbors;
 
+    bool m_precompute;            //!< whether to precompute the nix-vectors from this node
+    uint32_t m_precomputeThreads; //!< number of threads precomputing the nix-vectors
+
     /**
      * Mapping of IP address to ns-3 node.
      *
@@ -17,14 +17,17 @@
  * Author: Ameya Deshpande <ameyanrd@outlook.com>
  */
 
+#include "ns3/boolean.h"
 #include "ns3/icmpv4-l4-protocol.h"
 #include "ns3/icmpv6-l4-protocol.h"
 #include "ns3/internet-stack-helper.h"
 #include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-header.h"
 #include "ns3/ipv4-l3-protocol.h"
 #include "ns3/ipv6-address-helper.h"
 #include "ns3/ipv6-l3-protocol.h"
 #include "ns3/nix-vector-helper.h"
+#include "ns3/nix-vector-routing.h"
 #include "ns3/simple-net-device-helper.h"
 #include "ns3/simulator.h"
 #include "ns3/socket-factory.h"
@@ -32,6 +35,7 @@
 #include "ns3/test.h"
 #include "ns3/udp-l4-protocol.h"
 #include "ns3/udp-socket-factory.h"
+#include "ns3/uinteger.h"
 
 using namespace ns3;
 
@@ -393,6 +397,265 @@ NixVectorRoutingTest::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup nix-vector-routing-test
+ * \ingroup tests
+ *
+ * The topology is of the form:
+ * \verbatim
+    n0 -- n1 -- n2 -- n3 -- n4
+     \                      /
+      n5 ------------- n6
+   \endverbatim
+ *
+ * The interface of n5 on the n5-n6 channel starts down.  Following are
+ * the tests in this test case:
+ * - Cached nix-vectors are reused.
+ * (Set up the interface of n5 on the n5-n6 channel.)
+ * - The nix-vector from n0 to n4 is dropped as the new link shortens it,
+ *   the one from n0 to n1 is kept.
+ * (Set down the interface of n2 on the n2-n3 channel.)
+ * - No cached nix-vector traverses n2 or n3, none is dropped.
+ * (Set down the interface of n5 on the n5-n6 channel.)
+ * - The nix-vector from n0 to n4 is dropped, and there is no path left.
+ *
+ * \brief IPv4 Nix-Vector Routing cache invalidation Test
+ */
+class NixVectorRoutingCacheTest : public TestCase
+{
+  public:
+    NixVectorRoutingCacheTest();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Look up a route from n0.
+     * \param dest destination address
+     * \return the route, or null if there is none
+     */
+    Ptr<Ipv4Route> RouteOutput(Ipv4Address dest);
+
+    Ptr<Ipv4RoutingProtocol> m_routing; //!< nix-vector routing of n0
+};
+
+NixVectorRoutingCacheTest::NixVectorRoutingCacheTest()
+    : TestCase("nix-vector cache invalidation scoped to topology changes")
+{
+}
+
+Ptr<Ipv4Route>
+NixVectorRoutingCacheTest::RouteOutput(Ipv4Address dest)
+{
+    Ipv4Header header;
+    header.SetDestination(dest);
+    Socket::SocketErrno sockerr;
+    return m_routing->RouteOutput(nullptr, header, nullptr, sockerr);
+}
+
+void
+NixVectorRoutingCacheTest::DoRun()
+{
+    NodeContainer nodes;
+    nodes.Create(7);
+
+    Ipv4NixVectorHelper nixRouting;
+    InternetStackHelper stack;
+    stack.SetRoutingHelper(nixRouting);
+    stack.SetIpv6StackInstall(false);
+    stack.Install(nodes);
+
+    SimpleNetDeviceHelper devHelper;
+    devHelper.SetNetDevicePointToPointMode(true);
+    Ipv4AddressHelper address("10.1.0.0", "255.255.255.0");
+    std::vector<Ipv4InterfaceContainer> links;
+    for (auto [a, b] : std::vector<std::pair<uint32_t, uint32_t>>{{0, 1},
+                                                                   {1, 2},
+                                                                   {2, 3},
+                                                                   {3, 4},
+                                                                   {0, 5},
+                                                                   {5, 6},
+                                                                   {6, 4}})
+    {
+        links.push_back(address.Assign(devHelper.Install(NodeContainer(nodes.Get(a), nodes.Get(b)))));
+        address.NewNetwork();
+    }
+    Ipv4Address n1 = links[0].GetAddress(1);
+    Ipv4Address n4 = links[3].GetAddress(1);
+    links[5].Get(0).first->SetDown(links[5].Get(0).second);
+
+    m_routing = nodes.Get(0)->GetObject<Ipv4>()->GetRoutingProtocol();
+    Ipv4NixVectorRouting::ResetCacheStatistics();
+
+    // Cached nix-vectors are reused
+    NS_TEST_ASSERT_MSG_NE(RouteOutput(n4), nullptr, "No route to n4");
+    NS_TEST_ASSERT_MSG_NE(RouteOutput(n1), nullptr, "No route to n1");
+    NS_TEST_EXPECT_MSG_EQ(RouteOutput(n4)->GetGateway(), n1, "Wrong path to n4");
+    RouteOutput(n1);
+    auto stats = Ipv4NixVectorRouting::GetCacheStatistics();
+    NS_TEST_EXPECT_MSG_EQ(stats.misses, 2, "Wrong number of cache misses");
+    NS_TEST_EXPECT_MSG_EQ(stats.hits, 2, "Wrong number of cache hits");
+    NS_TEST_EXPECT_MSG_EQ(stats.bfs, 2, "Wrong number of BFS");
+
+    // The new link only shortens the path to n4
+    links[5].Get(0).first->SetUp(links[5].Get(0).second);
+    NS_TEST_EXPECT_MSG_EQ(RouteOutput(n4)->GetGateway(),
+                          links[4].GetAddress(1),
+                          "Shorter path to n4 not used");
+    NS_TEST_EXPECT_MSG_NE(RouteOutput(n1), nullptr, "No route to n1");
+    stats = Ipv4NixVectorRouting::GetCacheStatistics();
+    NS_TEST_EXPECT_MSG_EQ(stats.invalidated, 1, "Wrong number of dropped nix-vectors");
+    NS_TEST_EXPECT_MSG_EQ(stats.bfs, 3, "Wrong number of BFS");
+
+    // No cached nix-vector goes through n2 or n3
+    links[2].Get(0).first->SetDown(links[2].Get(0).second);
+    NS_TEST_EXPECT_MSG_NE(RouteOutput(n4), nullptr, "No route to n4");
+    NS_TEST_EXPECT_MSG_NE(RouteOutput(n1), nullptr, "No route to n1");
+    stats = Ipv4NixVectorRouting::GetCacheStatistics();
+    NS_TEST_EXPECT_MSG_EQ(stats.invalidated, 1, "Unaffected nix-vector dropped");
+    NS_TEST_EXPECT_MSG_EQ(stats.bfs, 3, "Wrong number of BFS");
+
+    // The path to n4 is cut
+    links[5].Get(0).first->SetDown(links[5].Get(0).second);
+    NS_TEST_EXPECT_MSG_EQ(RouteOutput(n4), nullptr, "Unexpected route to n4");
+    NS_TEST_EXPECT_MSG_NE(RouteOutput(n1), nullptr, "No route to n1");
+    stats = Ipv4NixVectorRouting::GetCacheStatistics();
+    NS_TEST_EXPECT_MSG_EQ(stats.invalidated, 2, "Wrong number of dropped nix-vectors");
+    NS_TEST_EXPECT_MSG_EQ(stats.hits, 6, "Wrong number of cache hits");
+
+    m_routing = nullptr;
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup nix-vector-routing-test
+ * \ingroup tests
+ *
+ * \brief Precomputed nix-vectors test
+ *
+ * Checks that the table of precomputed nix-vectors holds the nix-vectors
+ * built on demand, on a topology with parallel links, a shared channel and
+ * unreachable nodes, and that a topology change drops the table.
+ */
+class NixVectorRoutingPrecomputeTest : public TestCase
+{
+  public:
+    NixVectorRoutingPrecomputeTest();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Look up the routes between all the nodes.
+     * \param nodes the nodes
+     * \return the nix-vectors of the packets, "none" where there is no route
+     */
+    std::vector<std::string> RouteAll(const NodeContainer& nodes);
+};
+
+NixVectorRoutingPrecomputeTest::NixVectorRoutingPrecomputeTest()
+    : TestCase("precomputed nix-vectors")
+{
+}
+
+std::vector<std::string>
+NixVectorRoutingPrecomputeTest::RouteAll(const NodeContainer& nodes)
+{
+    std::vector<std::string> nixVectors;
+    for (uint32_t i = 0; i < nodes.GetN(); i++)
+    {
+        Ptr<Ipv4RoutingProtocol> routing = nodes.Get(i)->GetObject<Ipv4>()->GetRoutingProtocol();
+        for (uint32_t j = 0; j < nodes.GetN(); j++)
+        {
+            Ipv4Header header;
+            header.SetDestination(nodes.Get(j)->GetObject<Ipv4>()->GetAddress(1, 0).GetLocal());
+            Socket::SocketErrno sockerr;
+            Ptr<Packet> p = Create<Packet>();
+            std::ostringstream oss;
+            if (i != j && routing->RouteOutput(p, header, nullptr, sockerr))
+            {
+                oss << *p->GetNixVector();
+            }
+            else
+            {
+                oss << "none";
+            }
+            nixVectors.push_back(oss.str());
+        }
+    }
+    return nixVectors;
+}
+
+void
+NixVectorRoutingPrecomputeTest::DoRun()
+{
+    NodeContainer nodes;
+    nodes.Create(8);
+
+    Ipv4NixVectorHelper nixRouting;
+    nixRouting.Set("Precompute", BooleanValue(true));
+    nixRouting.Set("PrecomputeThreads", UintegerValue(2));
+    InternetStackHelper stack;
+    stack.SetRoutingHelper(nixRouting);
+    stack.SetIpv6StackInstall(false);
+    stack.Install(nodes);
+
+    // Two parallel links between n0 and n1, a channel shared by n1, n3 and
+    // n4, and n6 and n7 apart
+    SimpleNetDeviceHelper devHelper;
+    devHelper.SetNetDevicePointToPointMode(true);
+    Ipv4AddressHelper address("10.1.0.0", "255.255.255.0");
+    std::vector<Ipv4InterfaceContainer> links;
+    for (auto [a, b] : std::vector<std::pair<uint32_t, uint32_t>>{{0, 1},
+                                                                   {0, 1},
+                                                                   {1, 2},
+                                                                   {2, 3},
+                                                                   {4, 5},
+                                                                   {6, 7}})
+    {
+        links.push_back(address.Assign(devHelper.Install(NodeContainer(nodes.Get(a), nodes.Get(b)))));
+        address.NewNetwork();
+    }
+    devHelper.SetNetDevicePointToPointMode(false);
+    address.Assign(devHelper.Install(NodeContainer(nodes.Get(1), nodes.Get(3), nodes.Get(4))));
+
+    // The table is built when the simulation starts
+    Simulator::Stop(NanoSeconds(1));
+    Simulator::Run();
+    NS_TEST_EXPECT_MSG_EQ(Ipv4NixVectorRouting::GetNixTableSize().pairs,
+                          64,
+                          "Wrong number of precomputed node pairs");
+
+    Ipv4NixVectorRouting::ResetCacheStatistics();
+    std::vector<std::string> precomputed = RouteAll(nodes);
+    auto stats = Ipv4NixVectorRouting::GetCacheStatistics();
+    NS_TEST_EXPECT_MSG_EQ(stats.precomputed, 56, "Nix-vectors not taken from the table");
+    NS_TEST_EXPECT_MSG_EQ(stats.bfs, 0, "Unexpected BFS");
+
+    // A topology change drops the table, the nix-vectors are built on demand
+    links[5].Get(0).first->SetDown(links[5].Get(0).second);
+    links[5].Get(0).first->SetUp(links[5].Get(0).second);
+    std::vector<std::string> onDemand = RouteAll(nodes);
+    NS_TEST_EXPECT_MSG_EQ(Ipv4NixVectorRouting::GetNixTableSize().pairs,
+                          0,
+                          "Stale table not dropped");
+    stats = Ipv4NixVectorRouting::GetCacheStatistics();
+    NS_TEST_EXPECT_MSG_EQ(stats.precomputed, 56, "Nix-vectors taken from a stale table");
+    NS_TEST_EXPECT_MSG_GT(stats.bfs, 0, "Nix-vectors not built on demand");
+
+    NS_TEST_ASSERT_MSG_EQ(precomputed.size(), onDemand.size(), "Wrong number of routes");
+    for (std::size_t i = 0; i < precomputed.size(); i++)
+    {
+        NS_TEST_EXPECT_MSG_EQ(precomputed[i],
+                              onDemand[i],
+                              "Different nix-vectors from n" << i / 8 << " to n" << i % 8);
+    }
+    NS_TEST_EXPECT_MSG_NE(precomputed[0 * 8 + 5], std::string("none"), "No route from n0 to n5");
+    NS_TEST_EXPECT_MSG_EQ(precomputed[0 * 8 + 6], std::string("none"), "Unexpected route from n0 to n6");
+
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup nix-vector-routing-test
  * \ingroup tests
@@ -406,6 +669,8 @@ class NixVectorRoutingTestSuite : public TestSuite
         : TestSuite("nix-vector-routing", UNIT)
     {
         AddTestCase(new NixVectorRoutingTest(), TestCase::QUICK);
+        AddTestCase(new NixVectorRoutingCacheTest(), TestCase::QUICK);
+        AddTestCase(new NixVectorRoutingPrecomputeTest(), TestCase::QUICK);
     }
 };
 
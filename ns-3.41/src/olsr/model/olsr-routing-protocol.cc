@@ -52,8 +52,11 @@
 #include "ns3/udp-socket-factory.h"
 #include "ns3/uinteger.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <iostream>
+#include <unordered_map>
+#include <unordered_set>
 
 /********** Useful macros **********/
 
@@ -237,6 +240,12 @@ RoutingProtocol::GetTypeId()
                                           "high",
                                           Willingness::ALWAYS,
                                           "always"))
+            .AddAttribute("IncrementalComputation",
+                          "Recompute the MPR set and the routing table only when the "
+                          "neighborhood or the topology changed.",
+                          BooleanValue(true),
+                          MakeBooleanAccessor(&RoutingProtocol::m_incrementalComputation),
+                          MakeBooleanChecker())
             .AddTraceSource("Rx",
                             "Receive OLSR packet.",
                             MakeTraceSourceAccessor(&RoutingProtocol::m_rxPacketTrace),
@@ -254,11 +263,17 @@ RoutingProtocol::GetTypeId()
 
 RoutingProtocol::RoutingProtocol()
     : m_routingTableAssociation(nullptr),
+      m_mprNeighborhoodVersion(0),
+      m_routesNeighborhoodVersion(0),
+      m_routesTopologyVersion(0),
+      m_routesAssociationVersion(0),
+      m_routesLinkExpiry(Time::Max()),
       m_ipv4(nullptr),
       m_helloTimer(Timer::CANCEL_ON_DESTROY),
       m_tcTimer(Timer::CANCEL_ON_DESTROY),
       m_midTimer(Timer::CANCEL_ON_DESTROY),
       m_hnaTimer(Timer::CANCEL_ON_DESTROY),
+      m_duplicateTimer(Timer::CANCEL_ON_DESTROY),
       m_queuedMessagesTimer(Timer::CANCEL_ON_DESTROY)
 {
     m_uniformRandomVariable = CreateObject<UniformRandomVariable>();
@@ -280,6 +295,7 @@ RoutingProtocol::SetIpv4(Ptr<Ipv4> ipv4)
     m_tcTimer.SetFunction(&RoutingProtocol::TcTimerExpire, this);
     m_midTimer.SetFunction(&RoutingProtocol::MidTimerExpire, this);
     m_hnaTimer.SetFunction(&RoutingProtocol::HnaTimerExpire, this);
+    m_duplicateTimer.SetFunction(&RoutingProtocol::DupTupleTimerExpire, this);
     m_queuedMessagesTimer.SetFunction(&RoutingProtocol::SendQueuedMessages, this);
 
     m_packetSequenceNumber = OLSR_MAX_SEQ_NUM;
@@ -717,6 +733,15 @@ RoutingProtocol::MprComputation()
 {
     NS_LOG_FUNCTION(this);
 
+    // The MPR set only depends on the neighbor and 2-hop neighbor sets
+    if (m_incrementalComputation &&
+        m_state.GetNeighborhoodVersion() == m_mprNeighborhoodVersion)
+    {
+        NS_LOG_DEBUG("Neighborhood unchanged, keeping the MPR set");
+        return;
+    }
+    m_mprNeighborhoodVersion = m_state.GetNeighborhoodVersion();
+
     // MPR computation should be done for each interface. See section 8.3.1
     // (RFC 3626) for details.
     MprSet mprSet;
@@ -1014,69 +1039,114 @@ RoutingProtocol::RoutingTableComputation()
     NS_LOG_DEBUG(Simulator::Now().As(Time::S)
                  << " : Node " << m_mainAddress << ": RoutingTableComputation begin...");
 
+    // The routes depend on the neighborhood, on the topology and on the
+    // links not expired yet; the HNA routes also depend on the associations
+    bool routesChanged = !m_incrementalComputation ||
+                         m_state.GetNeighborhoodVersion() != m_routesNeighborhoodVersion ||
+                         m_state.GetTopologyVersion() != m_routesTopologyVersion ||
+                         Simulator::Now() > m_routesLinkExpiry;
+    bool hnaRoutesChanged =
+        routesChanged || m_state.GetAssociationVersion() != m_routesAssociationVersion;
+    if (!hnaRoutesChanged)
+    {
+        NS_LOG_DEBUG("Node " << m_mainAddress << ": routing state unchanged, keeping the table.");
+        return;
+    }
+
+    if (routesChanged)
+    {
+        ComputeRoutes();
+        m_routesNeighborhoodVersion = m_state.GetNeighborhoodVersion();
+        m_routesTopologyVersion = m_state.GetTopologyVersion();
+    }
+    ComputeHnaRoutes();
+    m_routesAssociationVersion = m_state.GetAssociationVersion();
+
+    NS_LOG_DEBUG("Node " << m_mainAddress << ": RoutingTableComputation end.");
+    m_routingTableChanged(GetSize());
+}
+
+void
+RoutingProtocol::ComputeRoutes()
+{
+    Time now = Simulator::Now();
+
     // 1. All the entries from the routing table are removed.
     Clear();
 
+    // The links not expired yet, indexed by the main address of their
+    // neighbor.  The routes must be recomputed when the first one expires.
+    std::unordered_map<Ipv4Address, std::vector<const LinkTuple*>, Ipv4AddressHash> neighborLinks;
+    m_routesLinkExpiry = Time::Max();
+    for (const auto& link_tuple : m_state.GetLinks())
+    {
+        if (link_tuple.time >= now)
+        {
+            neighborLinks[GetMainAddress(link_tuple.neighborIfaceAddr)].push_back(&link_tuple);
+            m_routesLinkExpiry = std::min(m_routesLinkExpiry, link_tuple.time);
+        }
+        else
+        {
+            NS_LOG_LOGIC("Link tuple " << link_tuple << " expired => IGNORE");
+        }
+    }
+
     // 2. The new routing entries are added starting with the
     // symmetric neighbors (h=1) as the destination nodes.
     const NeighborSet& neighborSet = m_state.GetNeighbors();
-    for (auto it = neighborSet.begin(); it != neighborSet.end(); it++)
+    std::unordered_set<Ipv4Address, Ipv4AddressHash> symNeighbors;
+    std::unordered_set<Ipv4Address, Ipv4AddressHash> willingNeighbors;
+    for (const auto& nb_tuple : neighborSet)
     {
-        const NeighborTuple& nb_tuple = *it;
         NS_LOG_DEBUG("Looking at neighbor tuple: " << nb_tuple);
-        if (nb_tuple.status == NeighborTuple::STATUS_SYM)
+        if (nb_tuple.willingness != Willingness::NEVER)
         {
-            bool nb_main_addr = false;
-            const LinkTuple* lt = nullptr;
-            const LinkSet& linkSet = m_state.GetLinks();
-            for (auto it2 = linkSet.begin(); it2 != linkSet.end(); it2++)
-            {
-                const LinkTuple& link_tuple = *it2;
-                NS_LOG_DEBUG("Looking at link tuple: "
-                             << link_tuple
-                             << (link_tuple.time >= Simulator::Now() ? "" : " (expired)"));
-                if ((GetMainAddress(link_tuple.neighborIfaceAddr) == nb_tuple.neighborMainAddr) &&
-                    link_tuple.time >= Simulator::Now())
-                {
-                    NS_LOG_LOGIC("Link tuple matches neighbor "
-                                 << nb_tuple.neighborMainAddr
-                                 << " => adding routing table entry to neighbor");
-                    lt = &link_tuple;
-                    AddEntry(link_tuple.neighborIfaceAddr,
-                             link_tuple.neighborIfaceAddr,
-                             link_tuple.localIfaceAddr,
-                             1);
-                    if (link_tuple.neighborIfaceAddr == nb_tuple.neighborMainAddr)
-                    {
-                        nb_main_addr = true;
-                    }
-                }
-                else
-                {
-                    NS_LOG_LOGIC("Link tuple: linkMainAddress= "
-                                 << GetMainAddress(link_tuple.neighborIfaceAddr)
-                                 << "; neighborMainAddr =  " << nb_tuple.neighborMainAddr
-                                 << "; expired=" << int(link_tuple.time < Simulator::Now())
-                                 << " => IGNORE");
-                }
-            }
+            willingNeighbors.insert(nb_tuple.neighborMainAddr);
+        }
+        if (nb_tuple.status != NeighborTuple::STATUS_SYM)
+        {
+            continue;
+        }
+        symNeighbors.insert(nb_tuple.neighborMainAddr);
 
-            // If, in the above, no R_dest_addr is equal to the main
-            // address of the neighbor, then another new routing entry
-            // with MUST be added, with:
-            //      R_dest_addr  = main address of the neighbor;
-            //      R_next_addr  = L_neighbor_iface_addr of one of the
-            //                     associated link tuple with L_time >= current time;
-            //      R_dist       = 1;
-            //      R_iface_addr = L_local_iface_addr of the
-            //                     associated link tuple.
-            if (!nb_main_addr && lt != nullptr)
+        auto links = neighborLinks.find(nb_tuple.neighborMainAddr);
+        if (links == neighborLinks.end())
+        {
+            continue;
+        }
+        bool nb_main_addr = false;
+        const LinkTuple* lt = nullptr;
+        for (const LinkTuple* link_tuple : links->second)
+        {
+            NS_LOG_LOGIC("Link tuple " << *link_tuple << " matches neighbor "
+                                       << nb_tuple.neighborMainAddr
+                                       << " => adding routing table entry to neighbor");
+            lt = link_tuple;
+            AddEntry(link_tuple->neighborIfaceAddr,
+                     link_tuple->neighborIfaceAddr,
+                     link_tuple->localIfaceAddr,
+                     1);
+            if (link_tuple->neighborIfaceAddr == nb_tuple.neighborMainAddr)
             {
-                NS_LOG_LOGIC("no R_dest_addr is equal to the main address of the neighbor "
-                             "=> adding additional routing entry");
-                AddEntry(nb_tuple.neighborMainAddr, lt->neighborIfaceAddr, lt->localIfaceAddr, 1);
+                nb_main_addr = true;
             }
         }
+
+        // If, in the above, no R_dest_addr is equal to the main
+        // address of the neighbor, then another new routing entry
+        // with MUST be added, with:
+        //      R_dest_addr  = main address of the neighbor;
+        //      R_next_addr  = L_neighbor_iface_addr of one of the
+        //                     associated link tuple with L_time >= current time;
+        //      R_dist       = 1;
+        //      R_iface_addr = L_local_iface_addr of the
+        //                     associated link tuple.
+        if (!nb_main_addr)
+        {
+            NS_LOG_LOGIC("no R_dest_addr is equal to the main address of the neighbor "
+                         "=> adding additional routing entry");
+            AddEntry(nb_tuple.neighborMainAddr, lt->neighborIfaceAddr, lt->localIfaceAddr, 1);
+        }
     }
 
     //  3. for each node in N2, i.e., a 2-hop neighbor which is not a
@@ -1084,15 +1154,12 @@ RoutingProtocol::RoutingTableComputation()
     //  least one entry in the 2-hop neighbor set where
     //  N_neighbor_main_addr correspond to a neighbor node with
     //  willingness different of Willingness::NEVER,
-    const TwoHopNeighborSet& twoHopNeighbors = m_state.GetTwoHopNeighbors();
-    for (auto it = twoHopNeighbors.begin(); it != twoHopNeighbors.end(); it++)
+    for (const auto& nb2hop_tuple : m_state.GetTwoHopNeighbors())
     {
-        const TwoHopNeighborTuple& nb2hop_tuple = *it;
-
         NS_LOG_LOGIC("Looking at two-hop neighbor tuple: " << nb2hop_tuple);
 
         // a 2-hop neighbor which is not a neighbor node or the node itself
-        if (m_state.FindSymNeighborTuple(nb2hop_tuple.twoHopNeighborAddr))
+        if (symNeighbors.find(nb2hop_tuple.twoHopNeighborAddr) != symNeighbors.end())
         {
             NS_LOG_LOGIC("Two-hop neighbor tuple is also neighbor; skipped.");
             continue;
@@ -1107,17 +1174,7 @@ RoutingProtocol::RoutingTableComputation()
         // ...and such that there exist at least one entry in the 2-hop
         // neighbor set where N_neighbor_main_addr correspond to a
         // neighbor node with willingness different of Willingness::NEVER...
-        bool nb2hopOk = false;
-        for (auto neighbor = neighborSet.begin(); neighbor != neighborSet.end(); neighbor++)
-        {
-            if (neighbor->neighborMainAddr == nb2hop_tuple.neighborMainAddr &&
-                neighbor->willingness != Willingness::NEVER)
-            {
-                nb2hopOk = true;
-                break;
-            }
-        }
-        if (!nb2hopOk)
+        if (willingNeighbors.find(nb2hop_tuple.neighborMainAddr) == willingNeighbors.end())
         {
             NS_LOG_LOGIC("Two-hop neighbor tuple skipped: 2-hop neighbor "
                          << nb2hop_tuple.twoHopNeighborAddr << " is attached to neighbor "
@@ -1151,9 +1208,40 @@ RoutingProtocol::RoutingTableComputation()
         }
     }
 
-    for (uint32_t h = 2;; h++)
+    // The topology tuples, indexed by their T_last_addr
+    const TopologySet& topology = m_state.GetTopologySet();
+    std::unordered_map<Ipv4Address, std::vector<std::size_t>, Ipv4AddressHash> lastAddrTuples;
+    for (std::size_t i = 0; i < topology.size(); i++)
+    {
+        lastAddrTuples[topology[i].lastAddr].push_back(i);
+    }
+
+    // The frontier holds the destinations at distance h, only the topology
+    // tuples starting from them are looked at.  They are looked at in the
+    // order of the topology set, so that the routes do not depend on the
+    // index.
+    std::vector<Ipv4Address> frontier;
+    for (const auto& [dest, entry] : m_table)
+    {
+        if (entry.distance == 2)
+        {
+            frontier.push_back(dest);
+        }
+    }
+    std::vector<std::size_t> candidates;
+    for (uint32_t h = 2; !frontier.empty(); h++)
     {
-        bool added = false;
+        candidates.clear();
+        for (const auto& lastAddr : frontier)
+        {
+            auto tuples = lastAddrTuples.find(lastAddr);
+            if (tuples != lastAddrTuples.end())
+            {
+                candidates.insert(candidates.end(), tuples->second.begin(), tuples->second.end());
+            }
+        }
+        std::sort(candidates.begin(), candidates.end());
+        frontier.clear();
 
         // 3.1. For each topology entry in the topology table, if its
         // T_dest_addr does not correspond to R_dest_addr of any
@@ -1161,48 +1249,39 @@ RoutingProtocol::RoutingTableComputation()
         // corresponds to R_dest_addr of a route entry whose R_dist
         // is equal to h, then a new route entry MUST be recorded in
         // the routing table (if it does not already exist)
-        const TopologySet& topology = m_state.GetTopologySet();
-        for (auto it = topology.begin(); it != topology.end(); it++)
+        for (std::size_t i : candidates)
         {
-            const TopologyTuple& topology_tuple = *it;
+            const TopologyTuple& topology_tuple = topology[i];
             NS_LOG_LOGIC("Looking at topology tuple: " << topology_tuple);
 
             RoutingTableEntry destAddrEntry;
             RoutingTableEntry lastAddrEntry;
-            bool have_destAddrEntry = Lookup(topology_tuple.destAddr, destAddrEntry);
-            bool have_lastAddrEntry = Lookup(topology_tuple.lastAddr, lastAddrEntry);
-            if (!have_destAddrEntry && have_lastAddrEntry && lastAddrEntry.distance == h)
-            {
-                NS_LOG_LOGIC("Adding routing table entry based on the topology tuple.");
-                // then a new route entry MUST be recorded in
-                //                the routing table (if it does not already exist) where:
-                //                     R_dest_addr  = T_dest_addr;
-                //                     R_next_addr  = R_next_addr of the recorded
-                //                                    route entry where:
-                //                                    R_dest_addr == T_last_addr
-                //                     R_dist       = h+1; and
-                //                     R_iface_addr = R_iface_addr of the recorded
-                //                                    route entry where:
-                //                                       R_dest_addr == T_last_addr.
-                AddEntry(topology_tuple.destAddr,
-                         lastAddrEntry.nextAddr,
-                         lastAddrEntry.interface,
-                         h + 1);
-                added = true;
-            }
-            else
+            if (Lookup(topology_tuple.destAddr, destAddrEntry))
             {
                 NS_LOG_LOGIC("NOT adding routing table entry based on the topology tuple: "
-                             "have_destAddrEntry="
-                             << have_destAddrEntry << " have_lastAddrEntry=" << have_lastAddrEntry
-                             << " lastAddrEntry.distance=" << (int)lastAddrEntry.distance
-                             << " (h=" << h << ")");
+                             "destination already in the table at distance "
+                             << destAddrEntry.distance << " (h=" << h << ")");
+                continue;
             }
-        }
-
-        if (!added)
-        {
-            break;
+            Lookup(topology_tuple.lastAddr, lastAddrEntry);
+            NS_ASSERT(lastAddrEntry.distance == h);
+
+            NS_LOG_LOGIC("Adding routing table entry based on the topology tuple.");
+            // then a new route entry MUST be recorded in
+            //                the routing table (if it does not already exist) where:
+            //                     R_dest_addr  = T_dest_addr;
+            //                     R_next_addr  = R_next_addr of the recorded
+            //                                    route entry where:
+            //                                    R_dest_addr == T_last_addr
+            //                     R_dist       = h+1; and
+            //                     R_iface_addr = R_iface_addr of the recorded
+            //                                    route entry where:
+            //                                       R_dest_addr == T_last_addr.
+            AddEntry(topology_tuple.destAddr,
+                     lastAddrEntry.nextAddr,
+                     lastAddrEntry.interface,
+                     h + 1);
+            frontier.push_back(topology_tuple.destAddr);
         }
     }
 
@@ -1230,7 +1309,11 @@ RoutingProtocol::RoutingTableComputation()
             AddEntry(tuple.ifaceAddr, entry1.nextAddr, entry1.interface, entry1.distance);
         }
     }
+}
 
+void
+RoutingProtocol::ComputeHnaRoutes()
+{
     // 5. For each tuple in the association set,
     //    If there is no entry in the routing table with:
     //        R_dest_addr     == A_network_addr/A_netmask
@@ -1239,7 +1322,7 @@ RoutingProtocol::RoutingTableComputation()
     const AssociationSet& associationSet = m_state.GetAssociationSet();
 
     // Clear HNA routing table
-    for (uint32_t i = 0; i < m_hnaRoutingTable->GetNRoutes(); i++)
+    while (m_hnaRoutingTable->GetNRoutes() > 0)
     {
         m_hnaRoutingTable->RemoveRoute(0);
     }
@@ -1310,9 +1393,6 @@ RoutingProtocol::RoutingTableComputation()
                                                  gatewayEntry.distance);
         }
     }
-
-    NS_LOG_DEBUG("Node " << m_mainAddress << ": RoutingTableComputation end.");
-    m_routingTableChanged(GetSize());
 }
 
 void
@@ -1506,18 +1586,29 @@ RoutingProtocol::ProcessMid(const olsr::MessageHeader& msg, const Ipv4Address& s
     // 3. (not part of the RFC) iterate over all NeighborTuple's and
     // TwoHopNeighborTuples, update the neighbor addresses taking into account
     // the new MID information.
+    bool neighborhoodChanged = false;
     NeighborSet& neighbors = m_state.GetNeighbors();
     for (auto neighbor = neighbors.begin(); neighbor != neighbors.end(); neighbor++)
     {
-        neighbor->neighborMainAddr = GetMainAddress(neighbor->neighborMainAddr);
+        Ipv4Address mainAddr = GetMainAddress(neighbor->neighborMainAddr);
+        neighborhoodChanged |= (mainAddr != neighbor->neighborMainAddr);
+        neighbor->neighborMainAddr = mainAddr;
     }
 
     TwoHopNeighborSet& twoHopNeighbors = m_state.GetTwoHopNeighbors();
     for (auto twoHopNeighbor = twoHopNeighbors.begin(); twoHopNeighbor != twoHopNeighbors.end();
          twoHopNeighbor++)
     {
-        twoHopNeighbor->neighborMainAddr = GetMainAddress(twoHopNeighbor->neighborMainAddr);
-        twoHopNeighbor->twoHopNeighborAddr = GetMainAddress(twoHopNeighbor->twoHopNeighborAddr);
+        Ipv4Address neighborMainAddr = GetMainAddress(twoHopNeighbor->neighborMainAddr);
+        Ipv4Address twoHopNeighborAddr = GetMainAddress(twoHopNeighbor->twoHopNeighborAddr);
+        neighborhoodChanged |= (neighborMainAddr != twoHopNeighbor->neighborMainAddr ||
+                                twoHopNeighborAddr != twoHopNeighbor->twoHopNeighborAddr);
+        twoHopNeighbor->neighborMainAddr = neighborMainAddr;
+        twoHopNeighbor->twoHopNeighborAddr = twoHopNeighborAddr;
+    }
+    if (neighborhoodChanged)
+    {
+        m_state.NotifyNeighborhoodChanged();
     }
     NS_LOG_DEBUG("Node " << m_mainAddress << " ProcessMid from " << senderIface << " -> END.");
 }
@@ -1644,11 +1735,10 @@ RoutingProtocol::ForwardDefault(olsr::MessageHeader olsrMessage,
         newDup.ifaceList.push_back(localIface);
         AddDuplicateTuple(newDup);
         // Schedule dup tuple deletion
-        Simulator::Schedule(OLSR_DUP_HOLD_TIME,
-                            &RoutingProtocol::DupTupleTimerExpire,
-                            this,
-                            newDup.address,
-                            newDup.sequenceNumber);
+        if (!m_duplicateTimer.IsRunning())
+        {
+            m_duplicateTimer.Schedule(DELAY(newDup.expirationTime));
+        }
     }
 }
 
@@ -2050,6 +2140,7 @@ RoutingProtocol::LinkSensing(const olsr::MessageHeader& msg,
         NS_LOG_LOGIC("Existing link tuple already exists => will update it");
         updated = true;
     }
+    bool expired = link_tuple->time < now;
 
     link_tuple->asymTime = now + msg.GetVTime();
     for (auto linkMessage = hello.linkMessages.begin(); linkMessage != hello.linkMessages.end();
@@ -2108,6 +2199,11 @@ RoutingProtocol::LinkSensing(const olsr::MessageHeader& msg,
         NS_LOG_DEBUG("Link tuple updated: " << int(updated));
     }
     link_tuple->time = std::max(link_tuple->time, link_tuple->asymTime);
+    if (expired && link_tuple->time >= now)
+    {
+        // The routes did not use the link
+        m_state.NotifyTopologyChanged();
+    }
 
     if (updated)
     {
@@ -2131,9 +2227,10 @@ RoutingProtocol::PopulateNeighborSet(const olsr::MessageHeader& msg,
                                      const olsr::MessageHeader::Hello& hello)
 {
     NeighborTuple* nb_tuple = m_state.FindNeighborTuple(msg.GetOriginatorAddress());
-    if (nb_tuple != nullptr)
+    if (nb_tuple != nullptr && nb_tuple->willingness != hello.willingness)
     {
         nb_tuple->willingness = hello.willingness;
+        m_state.NotifyNeighborhoodChanged();
     }
 }
 
@@ -2443,6 +2540,10 @@ RoutingProtocol::LinkTupleUpdated(const LinkTuple& tuple, Willingness willingnes
             NS_LOG_DEBUG(*nb_tuple << "->status = STATUS_NOT_SYM; changed:"
                                    << int(statusBefore != nb_tuple->status));
         }
+        if (statusBefore != nb_tuple->status)
+        {
+            m_state.NotifyNeighborhoodChanged();
+        }
     }
     else
     {
@@ -2649,24 +2750,13 @@ RoutingProtocol::HnaTimerExpire()
 }
 
 void
-RoutingProtocol::DupTupleTimerExpire(Ipv4Address address, uint16_t sequenceNumber)
+RoutingProtocol::DupTupleTimerExpire()
 {
-    DuplicateTuple* tuple = m_state.FindDuplicateTuple(address, sequenceNumber);
-    if (tuple == nullptr)
-    {
-        return;
-    }
-    if (tuple->expirationTime < Simulator::Now())
-    {
-        RemoveDuplicateTuple(*tuple);
-    }
-    else
+    m_state.EraseExpiredDuplicateTuples(Simulator::Now());
+    Time expiration = m_state.GetNextDuplicateExpiration();
+    if (expiration != Time::Max())
     {
-        m_events.Track(Simulator::Schedule(DELAY(tuple->expirationTime),
-                                           &RoutingProtocol::DupTupleTimerExpire,
-                                           this,
-                                           address,
-                                           sequenceNumber));
+        m_duplicateTimer.Schedule(DELAY(expiration));
     }
 }
 
@@ -44,6 +44,8 @@
 
 /// Testcase for MPR computation mechanism
 class OlsrMprTestCase;
+/// Testcase for incremental routing table computation
+class OlsrIncrementalRoutingTestCase;
 
 namespace ns3
 {
@@ -88,6 +90,10 @@ class RoutingProtocol : public Ipv4RoutingProtocol
      * Declared friend to enable unit tests.
      */
     friend class ::OlsrMprTestCase;
+    /**
+     * Declared friend to enable unit tests.
+     */
+    friend class ::OlsrIncrementalRoutingTestCase;
 
     static const uint16_t OLSR_PORT_NUMBER; //!< port number (698)
 
@@ -262,6 +268,13 @@ class RoutingProtocol : public Ipv4RoutingProtocol
     Time m_hnaInterval;        //!< HNA messages' emission interval.
     Willingness m_willingness; //!< Willingness for forwarding packets on behalf of other nodes.
 
+    bool m_incrementalComputation;        //!< Recompute the MPR set and the routes on changes only.
+    uint32_t m_mprNeighborhoodVersion;    //!< Neighborhood version of the MPR set.
+    uint32_t m_routesNeighborhoodVersion; //!< Neighborhood version of the routes.
+    uint32_t m_routesTopologyVersion;     //!< Topology version of the routes.
+    uint32_t m_routesAssociationVersion;  //!< Association version of the HNA routes.
+    Time m_routesLinkExpiry;              //!< Expiration time of the first link used by the routes.
+
     OlsrState m_state; //!< Internal state with all needed data structs.
     Ptr<Ipv4> m_ipv4;  //!< IPv4 object the routing is linked to.
 
@@ -397,9 +410,24 @@ class RoutingProtocol : public Ipv4RoutingProtocol
 
     /**
      * \brief Creates the routing table of the node following \RFC{3626} hints.
+     *
+     * The routes are only recomputed if the state they depend on changed
+     * since the last computation, unless IncrementalComputation is false.
      */
     void RoutingTableComputation();
 
+    /**
+     * \brief Computes the routes to the nodes and interfaces of the network
+     * (steps 1 to 4 of \RFC{3626}, section 10).
+     */
+    void ComputeRoutes();
+
+    /**
+     * \brief Computes the routes to the networks associated with other nodes
+     * (step 5 of \RFC{3626}, section 10, and section 12.6).
+     */
+    void ComputeHnaRoutes();
+
   public:
     /**
      * \brief Gets the main address associated with a given interface address.
@@ -444,15 +472,13 @@ class RoutingProtocol : public Ipv4RoutingProtocol
      */
     void HnaTimerExpire();
 
+    Timer m_duplicateTimer; //!< Timer for the expiration of the duplicate tuples.
+
     /**
-     * \brief Removes tuple if expired. Else timer is rescheduled to expire at tuple.expirationTime.
-     *
-     * The task of actually removing the tuple is left to the OLSR agent.
-     *
-     * \param address The address of the tuple.
-     * \param sequenceNumber The sequence number of the tuple.
+     * \brief Removes the expired duplicate tuples. The timer is rescheduled to expire
+     * at the earliest expiration time of the remaining ones.
      */
-    void DupTupleTimerExpire(Ipv4Address address, uint16_t sequenceNumber);
+    void DupTupleTimerExpire();
 
     bool m_linkTupleTimerFirstTime; //!< Flag to indicate if it is the first time the LinkTupleTimer
                                     //!< fires.
@@ -27,52 +27,227 @@
 
 #include "olsr-state.h"
 
+#include <algorithm>
+#include <limits>
+
 namespace ns3
 {
 namespace olsr
 {
 
-/********** MPR Selector Set Manipulation **********/
+namespace
+{
 
-MprSelectorTuple*
-OlsrState::FindMprSelectorTuple(const Ipv4Address& mainAddr)
+/// Position returned when no tuple matches
+constexpr std::size_t NOT_FOUND = std::numeric_limits<std::size_t>::max();
+
+/**
+ * Gets the key of a pair of addresses.
+ * \param first The first address.
+ * \param second The second address.
+ * \returns The key.
+ */
+inline uint64_t
+PairKey(const Ipv4Address& first, const Ipv4Address& second)
 {
-    for (auto it = m_mprSelectorSet.begin(); it != m_mprSelectorSet.end(); it++)
+    return (static_cast<uint64_t>(first.Get()) << 32) | second.Get();
+}
+
+/**
+ * Finds the first tuple of a set matching a predicate, among the tuples
+ * with a given key.
+ * \param set The set.
+ * \param index The index of the set, by key.
+ * \param key The key.
+ * \param match The predicate.
+ * \returns The position of the tuple, or NOT_FOUND.
+ */
+template <typename Set, typename Index, typename Key, typename Match>
+std::size_t
+FindPosition(const Set& set, const Index& index, const Key& key, Match match)
+{
+    auto it = index.find(key);
+    if (it == index.end())
     {
-        if (it->mainAddr == mainAddr)
+        return NOT_FOUND;
+    }
+    // The index gives the first tuple with the key, the next ones follow
+    for (std::size_t i = it->second; i < set.size(); i++)
+    {
+        if (match(set[i]))
         {
-            return &(*it);
+            return i;
         }
     }
-    return nullptr;
+    return NOT_FOUND;
 }
 
+/**
+ * Indexes the tuple appended to a set.  The index keeps the position of the
+ * first tuple with each key.
+ * \param set The set.
+ * \param index The index of the set.
+ * \param keyOf The key of a tuple.
+ */
+template <typename Set, typename Index, typename KeyOf>
 void
-OlsrState::EraseMprSelectorTuple(const MprSelectorTuple& tuple)
+IndexBack(const Set& set, Index& index, KeyOf keyOf)
+{
+    index.emplace(keyOf(set.back()), set.size() - 1);
+}
+
+/**
+ * Rebuilds the index of a set.
+ * \param set The set.
+ * \param index The index of the set.
+ * \param keyOf The key of a tuple.
+ */
+template <typename Set, typename Index, typename KeyOf>
+void
+Reindex(const Set& set, Index& index, KeyOf keyOf)
 {
-    for (auto it = m_mprSelectorSet.begin(); it != m_mprSelectorSet.end(); it++)
+    index.clear();
+    for (std::size_t i = 0; i < set.size(); i++)
     {
-        if (*it == tuple)
+        index.emplace(keyOf(set[i]), i);
+    }
+}
+
+/**
+ * Erases a tuple from a set, keeping the order of the other tuples, and
+ * updates the positions of the tuples which follow it in the index.
+ * \param set The set.
+ * \param index The index of the set.
+ * \param keyOf The key of a tuple.
+ * \param position The position of the tuple.
+ */
+template <typename Set, typename Index, typename KeyOf>
+void
+EraseAt(Set& set, Index& index, KeyOf keyOf, std::size_t position)
+{
+    auto it = index.find(keyOf(set[position]));
+    if (it->second == position)
+    {
+        index.erase(it);
+    }
+    set.erase(set.begin() + position);
+    for (std::size_t i = position; i < set.size(); i++)
+    {
+        // A tuple with the key of the erased one may become the first one
+        auto [entry, inserted] = index.emplace(keyOf(set[i]), i);
+        if (!inserted && entry->second == i + 1)
         {
-            m_mprSelectorSet.erase(it);
-            break;
+            entry->second = i;
         }
     }
 }
 
+/**
+ * Erases the tuples of a set matching a predicate, keeping the order of the
+ * other tuples, and rebuilds the index if any was erased.
+ * \param set The set.
+ * \param index The index of the set.
+ * \param keyOf The key of a tuple.
+ * \param match The predicate.
+ * \returns The number of tuples erased.
+ */
+template <typename Set, typename Index, typename KeyOf, typename Match>
+std::size_t
+EraseIf(Set& set, Index& index, KeyOf keyOf, Match match)
+{
+    std::size_t size = set.size();
+    set.erase(std::remove_if(set.begin(), set.end(), match), set.end());
+    if (set.size() != size)
+    {
+        Reindex(set, index, keyOf);
+    }
+    return size - set.size();
+}
+
+/// \returns The key of a MPR selector tuple.
+const Ipv4Address&
+MprSelectorKey(const MprSelectorTuple& tuple)
+{
+    return tuple.mainAddr;
+}
+
+/// \returns The key of a neighbor tuple.
+const Ipv4Address&
+NeighborKey(const NeighborTuple& tuple)
+{
+    return tuple.neighborMainAddr;
+}
+
+/// \returns The key of a 2-hop neighbor tuple.
+uint64_t
+TwoHopNeighborKey(const TwoHopNeighborTuple& tuple)
+{
+    return PairKey(tuple.neighborMainAddr, tuple.twoHopNeighborAddr);
+}
+
+/// \returns The key of a link tuple.
+const Ipv4Address&
+LinkKey(const LinkTuple& tuple)
+{
+    return tuple.neighborIfaceAddr;
+}
+
+/// \returns The key of a topology tuple.
+uint64_t
+TopologyKey(const TopologyTuple& tuple)
+{
+    return PairKey(tuple.destAddr, tuple.lastAddr);
+}
+
+/// \returns The key of an interface association tuple.
+const Ipv4Address&
+IfaceAssocKey(const IfaceAssocTuple& tuple)
+{
+    return tuple.ifaceAddr;
+}
+
+/**
+ * Gets the key of a duplicate tuple.
+ * \param address The originator address of the message.
+ * \param sequenceNumber The sequence number of the message.
+ * \returns The key.
+ */
+inline uint64_t
+DuplicateKey(const Ipv4Address& address, uint16_t sequenceNumber)
+{
+    return (static_cast<uint64_t>(address.Get()) << 16) | sequenceNumber;
+}
+
+} // unnamed namespace
+
+/********** MPR Selector Set Manipulation **********/
+
+MprSelectorTuple*
+OlsrState::FindMprSelectorTuple(const Ipv4Address& mainAddr)
+{
+    auto it = m_mprSelectorIndex.find(mainAddr);
+    return it == m_mprSelectorIndex.end() ? nullptr : &m_mprSelectorSet[it->second];
+}
+
+void
+OlsrState::EraseMprSelectorTuple(const MprSelectorTuple& tuple)
+{
+    auto it = m_mprSelectorIndex.find(tuple.mainAddr);
+    if (it != m_mprSelectorIndex.end())
+    {
+        EraseAt(m_mprSelectorSet, m_mprSelectorIndex, MprSelectorKey, it->second);
+    }
+}
+
 void
 OlsrState::EraseMprSelectorTuples(const Ipv4Address& mainAddr)
 {
-    for (auto it = m_mprSelectorSet.begin(); it != m_mprSelectorSet.end();)
+    if (m_mprSelectorIndex.find(mainAddr) != m_mprSelectorIndex.end())
     {
-        if (it->mainAddr == mainAddr)
-        {
-            it = m_mprSelectorSet.erase(it);
-        }
-        else
-        {
-            it++;
-        }
+        EraseIf(m_mprSelectorSet,
+                m_mprSelectorIndex,
+                MprSelectorKey,
+                [&mainAddr](const MprSelectorTuple& tuple) { return tuple.mainAddr == mainAddr; });
     }
 }
 
@@ -80,6 +255,7 @@ void
 OlsrState::InsertMprSelectorTuple(const MprSelectorTuple& tuple)
 {
     m_mprSelectorSet.push_back(tuple);
+    IndexBack(m_mprSelectorSet, m_mprSelectorIndex, MprSelectorKey);
 }
 
 std::string
@@ -106,81 +282,75 @@ OlsrState::PrintMprSelectorSet() const
 NeighborTuple*
 OlsrState::FindNeighborTuple(const Ipv4Address& mainAddr)
 {
-    for (auto it = m_neighborSet.begin(); it != m_neighborSet.end(); it++)
-    {
-        if (it->neighborMainAddr == mainAddr)
-        {
-            return &(*it);
-        }
-    }
-    return nullptr;
+    auto it = m_neighborIndex.find(mainAddr);
+    return it == m_neighborIndex.end() ? nullptr : &m_neighborSet[it->second];
 }
 
 const NeighborTuple*
 OlsrState::FindSymNeighborTuple(const Ipv4Address& mainAddr) const
 {
-    for (auto it = m_neighborSet.begin(); it != m_neighborSet.end(); it++)
-    {
-        if (it->neighborMainAddr == mainAddr && it->status == NeighborTuple::STATUS_SYM)
-        {
-            return &(*it);
-        }
-    }
-    return nullptr;
+    std::size_t i =
+        FindPosition(m_neighborSet, m_neighborIndex, mainAddr, [&mainAddr](const auto& tuple) {
+            return tuple.neighborMainAddr == mainAddr && tuple.status == NeighborTuple::STATUS_SYM;
+        });
+    return i == NOT_FOUND ? nullptr : &m_neighborSet[i];
 }
 
 NeighborTuple*
 OlsrState::FindNeighborTuple(const Ipv4Address& mainAddr, Willingness willingness)
 {
-    for (auto it = m_neighborSet.begin(); it != m_neighborSet.end(); it++)
-    {
-        if (it->neighborMainAddr == mainAddr && it->willingness == willingness)
-        {
-            return &(*it);
-        }
-    }
-    return nullptr;
+    std::size_t i = FindPosition(m_neighborSet,
+                                 m_neighborIndex,
+                                 mainAddr,
+                                 [&mainAddr, willingness](const auto& tuple) {
+                                     return tuple.neighborMainAddr == mainAddr &&
+                                            tuple.willingness == willingness;
+                                 });
+    return i == NOT_FOUND ? nullptr : &m_neighborSet[i];
 }
 
 void
 OlsrState::EraseNeighborTuple(const NeighborTuple& tuple)
 {
-    for (auto it = m_neighborSet.begin(); it != m_neighborSet.end(); it++)
+    std::size_t i = FindPosition(m_neighborSet,
+                                 m_neighborIndex,
+                                 tuple.neighborMainAddr,
+                                 [&tuple](const auto& t) { return t == tuple; });
+    if (i != NOT_FOUND)
     {
-        if (*it == tuple)
-        {
-            m_neighborSet.erase(it);
-            break;
-        }
+        EraseAt(m_neighborSet, m_neighborIndex, NeighborKey, i);
+        m_neighborhoodVersion++;
     }
 }
 
 void
 OlsrState::EraseNeighborTuple(const Ipv4Address& mainAddr)
 {
-    for (auto it = m_neighborSet.begin(); it != m_neighborSet.end(); it++)
+    auto it = m_neighborIndex.find(mainAddr);
+    if (it != m_neighborIndex.end())
     {
-        if (it->neighborMainAddr == mainAddr)
-        {
-            it = m_neighborSet.erase(it);
-            break;
-        }
+        EraseAt(m_neighborSet, m_neighborIndex, NeighborKey, it->second);
+        m_neighborhoodVersion++;
     }
 }
 
 void
 OlsrState::InsertNeighborTuple(const NeighborTuple& tuple)
 {
-    for (auto it = m_neighborSet.begin(); it != m_neighborSet.end(); it++)
+    NeighborTuple* existing = FindNeighborTuple(tuple.neighborMainAddr);
+    if (existing != nullptr)
     {
-        if (it->neighborMainAddr == tuple.neighborMainAddr)
+        // Update it
+        if (!(*existing == tuple))
         {
-            // Update it
-            *it = tuple;
-            return;
+            *existing = tuple;
+            m_neighborhoodVersion++;
         }
+        return;
     }
     m_neighborSet.push_back(tuple);
+    IndexBack(m_neighborSet, m_neighborIndex, NeighborKey);
+    m_neighborhoodVersion++;
 }
 
 /********** Neighbor 2 Hop Set Manipulation **********/
@@ -189,27 +359,18 @@ TwoHopNeighborTuple*
 OlsrState::FindTwoHopNeighborTuple(const Ipv4Address& neighborMainAddr,
                                    const Ipv4Address& twoHopNeighborAddr)
 {
-    for (auto it = m_twoHopNeighborSet.begin(); it != m_twoHopNeighborSet.end(); it++)
-    {
-        if (it->neighborMainAddr == neighborMainAddr &&
-            it->twoHopNeighborAddr == twoHopNeighborAddr)
-        {
-            return &(*it);
-        }
-    }
-    return nullptr;
+    auto it = m_twoHopNeighborIndex.find(PairKey(neighborMainAddr, twoHopNeighborAddr));
+    return it == m_twoHopNeighborIndex.end() ? nullptr : &m_twoHopNeighborSet[it->second];
 }
 
 void
 OlsrState::EraseTwoHopNeighborTuple(const TwoHopNeighborTuple& tuple)
 {
-    for (auto it = m_twoHopNeighborSet.begin(); it != m_twoHopNeighborSet.end(); it++)
+    auto it = m_twoHopNeighborIndex.find(TwoHopNeighborKey(tuple));
+    if (it != m_twoHopNeighborIndex.end())
     {
-        if (*it == tuple)
-        {
-            m_twoHopNeighborSet.erase(it);
-            break;
-        }
+        EraseAt(m_twoHopNeighborSet, m_twoHopNeighborIndex, TwoHopNeighborKey, it->second);
+        m_neighborhoodVersion++;
     }
 }
 
@@ -217,40 +378,46 @@ void
 OlsrState::EraseTwoHopNeighborTuples(const Ipv4Address& neighborMainAddr,
                                      const Ipv4Address& twoHopNeighborAddr)
 {
-    for (auto it = m_twoHopNeighborSet.begin(); it != m_twoHopNeighborSet.end();)
+    if (m_twoHopNeighborIndex.find(PairKey(neighborMainAddr, twoHopNeighborAddr)) ==
+        m_twoHopNeighborIndex.end())
     {
-        if (it->neighborMainAddr == neighborMainAddr &&
-            it->twoHopNeighborAddr == twoHopNeighborAddr)
-        {
-            it = m_twoHopNeighborSet.erase(it);
-        }
-        else
-        {
-            it++;
-        }
+        return;
     }
+    m_neighborhoodVersion += EraseIf(m_twoHopNeighborSet,
+                                     m_twoHopNeighborIndex,
+                                     TwoHopNeighborKey,
+                                     [&](const TwoHopNeighborTuple& tuple) {
+                                         return tuple.neighborMainAddr == neighborMainAddr &&
+                                                tuple.twoHopNeighborAddr == twoHopNeighborAddr;
+                                     });
 }
 
 void
 OlsrState::EraseTwoHopNeighborTuples(const Ipv4Address& neighborMainAddr)
 {
-    for (auto it = m_twoHopNeighborSet.begin(); it != m_twoHopNeighborSet.end();)
-    {
-        if (it->neighborMainAddr == neighborMainAddr)
-        {
-            it = m_twoHopNeighborSet.erase(it);
-        }
-        else
-        {
-            it++;
-        }
-    }
+    m_neighborhoodVersion += EraseIf(m_twoHopNeighborSet,
+                                     m_twoHopNeighborIndex,
+                                     TwoHopNeighborKey,
+                                     [&neighborMainAddr](const TwoHopNeighborTuple& tuple) {
+                                         return tuple.neighborMainAddr == neighborMainAddr;
+                                     });
 }
 
 void
 OlsrState::InsertTwoHopNeighborTuple(const TwoHopNeighborTuple& tuple)
 {
     m_twoHopNeighborSet.push_back(tuple);
+    IndexBack(m_twoHopNeighborSet, m_twoHopNeighborIndex, TwoHopNeighborKey);
+    m_neighborhoodVersion++;
+}
+
+void
+OlsrState::NotifyNeighborhoodChanged()
+{
+    // The addresses of the tuples may have changed
+    Reindex(m_neighborSet, m_neighborIndex, NeighborKey);
+    Reindex(m_twoHopNeighborSet, m_twoHopNeighborIndex, TwoHopNeighborKey);
+    m_neighborhoodVersion++;
 }
 
 /********** MPR Set Manipulation **********/
@@ -279,80 +446,82 @@ OlsrState::GetMprSet() const
 DuplicateTuple*
 OlsrState::FindDuplicateTuple(const Ipv4Address& addr, uint16_t sequenceNumber)
 {
-    for (auto it = m_duplicateSet.begin(); it != m_duplicateSet.end(); it++)
-    {
-        if (it->address == addr && it->sequenceNumber == sequenceNumber)
-        {
-            return &(*it);
-        }
-    }
-    return nullptr;
+    auto it = m_duplicateSet.find(DuplicateKey(addr, sequenceNumber));
+    return it == m_duplicateSet.end() ? nullptr : &it->second;
 }
 
 void
 OlsrState::EraseDuplicateTuple(const DuplicateTuple& tuple)
 {
-    for (auto it = m_duplicateSet.begin(); it != m_duplicateSet.end(); it++)
-    {
-        if (*it == tuple)
-        {
-            m_duplicateSet.erase(it);
-            break;
-        }
-    }
+    // The expiration of the tuple is dropped when it comes first
+    m_duplicateSet.erase(DuplicateKey(tuple.address, tuple.sequenceNumber));
 }
 
 void
 OlsrState::InsertDuplicateTuple(const DuplicateTuple& tuple)
 {
-    m_duplicateSet.push_back(tuple);
+    uint64_t key = DuplicateKey(tuple.address, tuple.sequenceNumber);
+    m_duplicateSet[key] = tuple;
+    m_duplicateExpirations.emplace(tuple.expirationTime, key);
 }
 
-/********** Link Set Manipulation **********/
+Time
+OlsrState::GetNextDuplicateExpiration() const
+{
+    return m_duplicateExpirations.empty() ? Time::Max() : m_duplicateExpirations.top().first;
+}
 
-LinkTuple*
-OlsrState::FindLinkTuple(const Ipv4Address& ifaceAddr)
+void
+OlsrState::EraseExpiredDuplicateTuples(Time now)
 {
-    for (auto it = m_linkSet.begin(); it != m_linkSet.end(); it++)
+    while (!m_duplicateExpirations.empty() && m_duplicateExpirations.top().first < now)
     {
-        if (it->neighborIfaceAddr == ifaceAddr)
+        uint64_t key = m_duplicateExpirations.top().second;
+        m_duplicateExpirations.pop();
+        auto it = m_duplicateSet.find(key);
+        if (it == m_duplicateSet.end())
         {
-            return &(*it);
+            continue;
+        }
+        if (it->second.expirationTime < now)
+        {
+            m_duplicateSet.erase(it);
+        }
+        else
+        {
+            // The tuple was refreshed
+            m_duplicateExpirations.emplace(it->second.expirationTime, key);
         }
     }
-    return nullptr;
+}
+
+/********** Link Set Manipulation **********/
+
+LinkTuple*
+OlsrState::FindLinkTuple(const Ipv4Address& ifaceAddr)
+{
+    auto it = m_linkIndex.find(ifaceAddr);
+    return it == m_linkIndex.end() ? nullptr : &m_linkSet[it->second];
 }
 
 LinkTuple*
 OlsrState::FindSymLinkTuple(const Ipv4Address& ifaceAddr, Time now)
 {
-    for (auto it = m_linkSet.begin(); it != m_linkSet.end(); it++)
-    {
-        if (it->neighborIfaceAddr == ifaceAddr)
-        {
-            if (it->symTime > now)
-            {
-                return &(*it);
-            }
-            else
-            {
-                break;
-            }
-        }
-    }
-    return nullptr;
+    LinkTuple* tuple = FindLinkTuple(ifaceAddr);
+    return (tuple != nullptr && tuple->symTime > now) ? tuple : nullptr;
 }
 
 void
 OlsrState::EraseLinkTuple(const LinkTuple& tuple)
 {
-    for (auto it = m_linkSet.begin(); it != m_linkSet.end(); it++)
+    std::size_t i =
+        FindPosition(m_linkSet, m_linkIndex, tuple.neighborIfaceAddr, [&tuple](const auto& t) {
+            return t == tuple;
+        });
+    if (i != NOT_FOUND)
     {
-        if (*it == tuple)
-        {
-            m_linkSet.erase(it);
-            break;
-        }
+        EraseAt(m_linkSet, m_linkIndex, LinkKey, i);
+        m_topologyVersion++;
     }
 }
 
@@ -360,6 +529,8 @@ LinkTuple&
 OlsrState::InsertLinkTuple(const LinkTuple& tuple)
 {
     m_linkSet.push_back(tuple);
+    IndexBack(m_linkSet, m_linkIndex, LinkKey);
+    m_topologyVersion++;
     return m_linkSet.back();
 }
 
@@ -368,62 +539,110 @@ OlsrState::InsertLinkTuple(const LinkTuple& tuple)
 TopologyTuple*
 OlsrState::FindTopologyTuple(const Ipv4Address& destAddr, const Ipv4Address& lastAddr)
 {
-    for (auto it = m_topologySet.begin(); it != m_topologySet.end(); it++)
-    {
-        if (it->destAddr == destAddr && it->lastAddr == lastAddr)
-        {
-            return &(*it);
-        }
-    }
-    return nullptr;
+    auto it = m_topologyIndex.find(PairKey(destAddr, lastAddr));
+    return it == m_topologyIndex.end() ? nullptr : &m_topologySet[it->second];
 }
 
 TopologyTuple*
 OlsrState::FindNewerTopologyTuple(const Ipv4Address& lastAddr, uint16_t ansn)
 {
-    for (auto it = m_topologySet.begin(); it != m_topologySet.end(); it++)
+    auto dests = m_topologyDestinations.find(lastAddr);
+    if (dests == m_topologyDestinations.end())
     {
-        if (it->lastAddr == lastAddr && it->sequenceNumber > ansn)
+        return nullptr;
+    }
+    // The first one in the set
+    std::size_t first = NOT_FOUND;
+    for (const auto& destAddr : dests->second)
+    {
+        std::size_t i = m_topologyIndex.at(PairKey(destAddr, lastAddr));
+        if (m_topologySet[i].sequenceNumber > ansn)
         {
-            return &(*it);
+            first = std::min(first, i);
         }
     }
-    return nullptr;
+    return first == NOT_FOUND ? nullptr : &m_topologySet[first];
+}
+
+void
+OlsrState::EraseTopologyDestination(const TopologyTuple& tuple)
+{
+    // The destination stays while another tuple has the same addresses
+    if (m_topologyIndex.find(TopologyKey(tuple)) != m_topologyIndex.end())
+    {
+        return;
+    }
+    auto dests = m_topologyDestinations.find(tuple.lastAddr);
+    auto dest = std::find(dests->second.begin(), dests->second.end(), tuple.destAddr);
+    *dest = dests->second.back();
+    dests->second.pop_back();
+    if (dests->second.empty())
+    {
+        m_topologyDestinations.erase(dests);
+    }
 }
 
 void
 OlsrState::EraseTopologyTuple(const TopologyTuple& tuple)
 {
-    for (auto it = m_topologySet.begin(); it != m_topologySet.end(); it++)
+    std::size_t i = FindPosition(m_topologySet,
+                                 m_topologyIndex,
+                                 TopologyKey(tuple),
+                                 [&tuple](const auto& t) { return t == tuple; });
+    if (i != NOT_FOUND)
     {
-        if (*it == tuple)
-        {
-            m_topologySet.erase(it);
-            break;
-        }
+        // The tuple may be the erased one
+        TopologyTuple erased = tuple;
+        EraseAt(m_topologySet, m_topologyIndex, TopologyKey, i);
+        EraseTopologyDestination(erased);
+        m_topologyVersion++;
     }
 }
 
 void
 OlsrState::EraseOlderTopologyTuples(const Ipv4Address& lastAddr, uint16_t ansn)
 {
-    for (auto it = m_topologySet.begin(); it != m_topologySet.end();)
+    auto dests = m_topologyDestinations.find(lastAddr);
+    if (dests == m_topologyDestinations.end())
     {
-        if (it->lastAddr == lastAddr && it->sequenceNumber < ansn)
-        {
-            it = m_topologySet.erase(it);
-        }
-        else
+        return;
+    }
+    std::vector<TopologyTuple> older;
+    for (const auto& destAddr : dests->second)
+    {
+        const TopologyTuple& tuple = m_topologySet[m_topologyIndex.at(PairKey(destAddr, lastAddr))];
+        if (tuple.sequenceNumber < ansn)
         {
-            it++;
+            older.push_back(tuple);
         }
     }
+    if (older.empty())
+    {
+        return;
+    }
+    m_topologyVersion += EraseIf(m_topologySet,
+                                 m_topologyIndex,
+                                 TopologyKey,
+                                 [&lastAddr, ansn](const TopologyTuple& tuple) {
+                                     return tuple.lastAddr == lastAddr &&
+                                            tuple.sequenceNumber < ansn;
+                                 });
+    for (const auto& tuple : older)
+    {
+        EraseTopologyDestination(tuple);
+    }
 }
 
 void
 OlsrState::InsertTopologyTuple(const TopologyTuple& tuple)
 {
+    if (m_topologyIndex.find(TopologyKey(tuple)) == m_topologyIndex.end())
+    {
+        m_topologyDestinations[tuple.lastAddr].push_back(tuple.destAddr);
+    }
     m_topologySet.push_back(tuple);
+    IndexBack(m_topologySet, m_topologyIndex, TopologyKey);
+    m_topologyVersion++;
 }
 
 /********** Interface Association Set Manipulation **********/
@@ -431,39 +650,28 @@ OlsrState::InsertTopologyTuple(const TopologyTuple& tuple)
 IfaceAssocTuple*
 OlsrState::FindIfaceAssocTuple(const Ipv4Address& ifaceAddr)
 {
-    for (auto it = m_ifaceAssocSet.begin(); it != m_ifaceAssocSet.end(); it++)
-    {
-        if (it->ifaceAddr == ifaceAddr)
-        {
-            return &(*it);
-        }
-    }
-    return nullptr;
+    auto it = m_ifaceAssocIndex.find(ifaceAddr);
+    return it == m_ifaceAssocIndex.end() ? nullptr : &m_ifaceAssocSet[it->second];
 }
 
 const IfaceAssocTuple*
 OlsrState::FindIfaceAssocTuple(const Ipv4Address& ifaceAddr) const
 {
-    for (auto it = m_ifaceAssocSet.begin(); it != m_ifaceAssocSet.end(); it++)
-    {
-        if (it->ifaceAddr == ifaceAddr)
-        {
-            return &(*it);
-        }
-    }
-    return nullptr;
+    auto it = m_ifaceAssocIndex.find(ifaceAddr);
+    return it == m_ifaceAssocIndex.end() ? nullptr : &m_ifaceAssocSet[it->second];
 }
 
 void
 OlsrState::EraseIfaceAssocTuple(const IfaceAssocTuple& tuple)
 {
-    for (auto it = m_ifaceAssocSet.begin(); it != m_ifaceAssocSet.end(); it++)
+    std::size_t i =
+        FindPosition(m_ifaceAssocSet, m_ifaceAssocIndex, tuple.ifaceAddr, [&tuple](const auto& t) {
+            return t == tuple;
+        });
+    if (i != NOT_FOUND)
     {
-        if (*it == tuple)
-        {
-            m_ifaceAssocSet.erase(it);
-            break;
-        }
+        EraseAt(m_ifaceAssocSet, m_ifaceAssocIndex, IfaceAssocKey, i);
+        m_topologyVersion++;
     }
 }
 
@@ -471,6 +679,8 @@ void
 OlsrState::InsertIfaceAssocTuple(const IfaceAssocTuple& tuple)
 {
     m_ifaceAssocSet.push_back(tuple);
+    IndexBack(m_ifaceAssocSet, m_ifaceAssocIndex, IfaceAssocKey);
+    m_topologyVersion++;
 }
 
 std::vector<Ipv4Address>
@@ -513,6 +723,7 @@ OlsrState::EraseAssociationTuple(const AssociationTuple& tuple)
         if (*it == tuple)
         {
             m_associationSet.erase(it);
+            m_associationVersion++;
             break;
         }
     }
@@ -522,6 +733,7 @@ void
 OlsrState::InsertAssociationTuple(const AssociationTuple& tuple)
 {
     m_associationSet.push_back(tuple);
+    m_associationVersion++;
 }
 
 void
@@ -532,6 +744,7 @@ OlsrState::EraseAssociation(const Association& tuple)
         if (*it == tuple)
         {
             m_associations.erase(it);
+            m_associationVersion++;
             break;
         }
     }
@@ -541,6 +754,7 @@ void
 OlsrState::InsertAssociation(const Association& tuple)
 {
     m_associations.push_back(tuple);
+    m_associationVersion++;
 }
 
 } // namespace olsr
@@ -24,6 +24,10 @@
 
 #include "olsr-repositories.h"
 
+#include <functional>
+#include <queue>
+#include <unordered_map>
+
 namespace ns3
 {
 namespace olsr
@@ -32,6 +36,10 @@ namespace olsr
 /// \ingroup olsr
 /// This class encapsulates all data structures needed for maintaining internal state of an OLSR
 /// node.
+///
+/// The sets keep their tuples in insertion order, and are indexed by the
+/// addresses looked up on each received message.  The Topology Set holds at
+/// most one tuple per destination and last hop addresses.
 class OlsrState
 {
     //  friend class Olsr;
@@ -43,18 +51,96 @@ class OlsrState
     TopologySet m_topologySet;             //!< Topology Set (\RFC{3626}, section 4.4).
     MprSet m_mprSet;                       //!< MPR Set (\RFC{3626}, section 4.3.3).
     MprSelectorSet m_mprSelectorSet;       //!< MPR Selector Set (\RFC{3626}, section 4.3.4).
-    DuplicateSet m_duplicateSet;           //!< Duplicate Set (\RFC{3626}, section 3.4).
     IfaceAssocSet m_ifaceAssocSet;         //!< Interface Association Set (\RFC{3626}, section 4.1).
     AssociationSet m_associationSet; //!< Association Set (\RFC{3626}, section12.2). Associations
                                      //!< obtained from HNA messages generated by other nodes.
     Associations m_associations;     //!< The node's local Host Network Associations that will be
                                      //!< advertised using HNA messages.
 
+    /// Duplicate Set (\RFC{3626}, section 3.4), by originator address and sequence number.
+    std::unordered_map<uint64_t, DuplicateTuple> m_duplicateSet;
+    /// Expiration times of the duplicate tuples, earliest first.  A tuple refreshed in place
+    /// keeps its former expiration time here until it is reached.
+    std::priority_queue<std::pair<Time, uint64_t>,
+                        std::vector<std::pair<Time, uint64_t>>,
+                        std::greater<>>
+        m_duplicateExpirations;
+
+    // Indexes of the sets, giving the position of the first tuple with each key
+
+    /// Link tuples, by neighbor interface address.
+    std::unordered_map<Ipv4Address, std::size_t, Ipv4AddressHash> m_linkIndex;
+    /// Neighbor tuples, by neighbor main address.
+    std::unordered_map<Ipv4Address, std::size_t, Ipv4AddressHash> m_neighborIndex;
+    /// 2-hop neighbor tuples, by neighbor main address and 2-hop neighbor address.
+    std::unordered_map<uint64_t, std::size_t> m_twoHopNeighborIndex;
+    /// Topology tuples, by destination address and last hop address.
+    std::unordered_map<uint64_t, std::size_t> m_topologyIndex;
+    /// Destination addresses of the topology tuples, by last hop address.
+    std::unordered_map<Ipv4Address, std::vector<Ipv4Address>, Ipv4AddressHash>
+        m_topologyDestinations;
+    /// MPR selector tuples, by main address.
+    std::unordered_map<Ipv4Address, std::size_t, Ipv4AddressHash> m_mprSelectorIndex;
+    /// Interface association tuples, by interface address.
+    std::unordered_map<Ipv4Address, std::size_t, Ipv4AddressHash> m_ifaceAssocIndex;
+
+    uint32_t m_neighborhoodVersion{0}; //!< Changes of the Neighbor and 2-hop Neighbor Sets.
+    uint32_t m_topologyVersion{0};     //!< Changes of the Link, Topology and Interface Association
+                                       //!< Sets.
+    uint32_t m_associationVersion{0};  //!< Changes of the Association Set and local associations.
+
   public:
     OlsrState()
     {
     }
 
+    // Change tracking
+
+    /**
+     * Gets the version of the neighborhood, incremented by each change of
+     * the Neighbor Set or of the 2-hop Neighbor Set.
+     * \returns The neighborhood version.
+     */
+    uint32_t GetNeighborhoodVersion() const
+    {
+        return m_neighborhoodVersion;
+    }
+
+    /**
+     * Records a change made in place to a neighbor or 2-hop neighbor tuple.
+     * The addresses of the tuples may have changed, the tuples are indexed
+     * again.
+     */
+    void NotifyNeighborhoodChanged();
+
+    /**
+     * Gets the version of the topology, incremented by each change of the
+     * Link Set, of the Topology Set or of the Interface Association Set.
+     * \returns The topology version.
+     */
+    uint32_t GetTopologyVersion() const
+    {
+        return m_topologyVersion;
+    }
+
+    /**
+     * Records a change made in place to a link tuple.
+     */
+    void NotifyTopologyChanged()
+    {
+        m_topologyVersion++;
+    }
+
+    /**
+     * Gets the version of the associations, incremented by each change of
+     * the Association Set or of the local associations.
+     * \returns The association version.
+     */
+    uint32_t GetAssociationVersion() const
+    {
+        return m_associationVersion;
+    }
+
     // MPR selector
 
     /**
@@ -248,6 +334,17 @@ class OlsrState
      * \param tuple The tuple to insert.
      */
     void InsertDuplicateTuple(const DuplicateTuple& tuple);
+    /**
+     * Gets the earliest expiration time of the duplicate tuples.  A tuple
+     * refreshed since may expire later.
+     * \returns The expiration time, or Time::Max if there is no duplicate tuple.
+     */
+    Time GetNextDuplicateExpiration() const;
+    /**
+     * Erases the duplicate tuples which expired before a given time.
+     * \param now The time.
+     */
+    void EraseExpiredDuplicateTuples(Time now);
 
     // Link
 
@@ -339,7 +436,8 @@ class OlsrState
     }
 
     /**
-     * Gets a mutable reference to the interface association set.
+     * Gets a mutable reference to the interface association set.  The
+     * interface addresses of the tuples must not be changed in place.
      * \returns The interface association set.
      */
     IfaceAssocSet& GetIfaceAssocSetMutable()
@@ -427,6 +525,15 @@ class OlsrState
      * \returns A container of the neighbor addresses (excluding the main one).
      */
     std::vector<Ipv4Address> FindNeighborInterfaces(const Ipv4Address& neighborMainAddr) const;
+
+  private:
+    /**
+     * Drops the destination of an erased topology tuple from the
+     * destinations of its last hop, unless another tuple has the same
+     * addresses.
+     * \param tuple The erased tuple.
+     */
+    void EraseTopologyDestination(const TopologyTuple& tuple);
 };
 
 } // namespace olsr
@@ -19,11 +19,18 @@
  *          Gustavo J. A. M. Carneiro <gjc@inescporto.pt>
  */
 
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
 #include "ns3/ipv4-header.h"
 #include "ns3/olsr-repositories.h"
 #include "ns3/olsr-routing-protocol.h"
+#include "ns3/olsr-state.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
 #include "ns3/test.h"
 
+#include <tuple>
+
 /**
  * \ingroup olsr
  * \defgroup olsr-test olsr module tests
@@ -174,6 +181,296 @@ OlsrMprTestCase::DoRun()
                           "Node 1 must NOT select node 8 as MPR");
 }
 
+/**
+ * \ingroup olsr-test
+ * \ingroup tests
+ *
+ * Testcase for the incremental routing table computation: the routes are
+ * only recomputed when the state they depend on changes.
+ */
+class OlsrIncrementalRoutingTestCase : public TestCase
+{
+  public:
+    OlsrIncrementalRoutingTestCase();
+    void DoRun() override;
+
+  private:
+    /**
+     * Count the routing table computations.
+     * \param size the size of the routing table
+     */
+    void RoutingTableChanged(uint32_t size);
+
+    uint32_t m_computations; //!< Number of routing table computations
+};
+
+OlsrIncrementalRoutingTestCase::OlsrIncrementalRoutingTestCase()
+    : TestCase("Check OLSR incremental routing table computation"),
+      m_computations(0)
+{
+}
+
+void
+OlsrIncrementalRoutingTestCase::RoutingTableChanged(uint32_t size)
+{
+    m_computations++;
+}
+
+void
+OlsrIncrementalRoutingTestCase::DoRun()
+{
+    Ptr<Node> node = CreateObject<Node>();
+    InternetStackHelper internet;
+    internet.SetIpv6StackInstall(false);
+    internet.Install(node);
+    SimpleNetDeviceHelper simple;
+    Ipv4AddressHelper address("10.0.0.0", "255.255.255.0");
+    address.Assign(simple.Install(node));
+
+    Ptr<RoutingProtocol> protocol = CreateObject<RoutingProtocol>();
+    protocol->SetIpv4(node->GetObject<Ipv4>());
+    protocol->m_mainAddress = Ipv4Address("10.0.0.1");
+    protocol->TraceConnectWithoutContext(
+        "RoutingTableChanged",
+        MakeCallback(&OlsrIncrementalRoutingTestCase::RoutingTableChanged, this));
+    OlsrState& state = protocol->m_state;
+
+    /*
+     *  1 -- 2 -- 3 -- 4 -- 5
+     *            |         |
+     *            +---------+
+     *
+     * Node 1 only has a link to node 2, which reaches node 3, the topology
+     * set gives the rest.  The link expires at 10 s.
+     */
+    LinkTuple link;
+    link.localIfaceAddr = Ipv4Address("10.0.0.1");
+    link.neighborIfaceAddr = Ipv4Address("10.0.0.2");
+    link.symTime = Seconds(10);
+    link.asymTime = Seconds(10);
+    link.time = Seconds(10);
+    state.InsertLinkTuple(link);
+    NeighborTuple neighbor;
+    neighbor.neighborMainAddr = Ipv4Address("10.0.0.2");
+    neighbor.status = NeighborTuple::STATUS_SYM;
+    neighbor.willingness = Willingness::DEFAULT;
+    state.InsertNeighborTuple(neighbor);
+    TwoHopNeighborTuple twoHop;
+    twoHop.neighborMainAddr = Ipv4Address("10.0.0.2");
+    twoHop.twoHopNeighborAddr = Ipv4Address("10.0.0.3");
+    twoHop.expirationTime = Seconds(3600);
+    state.InsertTwoHopNeighborTuple(twoHop);
+    TopologyTuple topology;
+    topology.sequenceNumber = 1;
+    topology.expirationTime = Seconds(3600);
+    for (const auto& [dest, last] : {std::make_pair("10.0.0.4", "10.0.0.3"),
+                                     std::make_pair("10.0.0.5", "10.0.0.4"),
+                                     std::make_pair("10.0.0.5", "10.0.0.3")})
+    {
+        topology.destAddr = Ipv4Address(dest);
+        topology.lastAddr = Ipv4Address(last);
+        state.InsertTopologyTuple(topology);
+    }
+
+    protocol->RoutingTableComputation();
+    NS_TEST_EXPECT_MSG_EQ(m_computations, 1, "The routing table must be computed");
+    NS_TEST_EXPECT_MSG_EQ(protocol->GetSize(), 4, "Nodes 2 to 5 must be reachable");
+    RoutingTableEntry entry;
+    NS_TEST_EXPECT_MSG_EQ(protocol->Lookup(Ipv4Address("10.0.0.5"), entry),
+                          true,
+                          "Node 5 must be reachable");
+    NS_TEST_EXPECT_MSG_EQ(entry.distance, 3, "Node 5 must be reached through node 3");
+    NS_TEST_EXPECT_MSG_EQ(entry.nextAddr, Ipv4Address("10.0.0.2"), "Wrong next hop");
+
+    // Refreshing the tuples changes nothing
+    state.FindTopologyTuple(Ipv4Address("10.0.0.4"), Ipv4Address("10.0.0.3"))->expirationTime =
+        Seconds(7200);
+    state.InsertNeighborTuple(neighbor);
+    protocol->RoutingTableComputation();
+    NS_TEST_EXPECT_MSG_EQ(m_computations, 1, "The routing table must not be recomputed");
+
+    // Losing the shortcut from node 3 to node 5
+    topology.destAddr = Ipv4Address("10.0.0.5");
+    topology.lastAddr = Ipv4Address("10.0.0.3");
+    state.EraseTopologyTuple(topology);
+    protocol->RoutingTableComputation();
+    NS_TEST_EXPECT_MSG_EQ(m_computations, 2, "The routing table must be recomputed");
+    NS_TEST_EXPECT_MSG_EQ(protocol->Lookup(Ipv4Address("10.0.0.5"), entry),
+                          true,
+                          "Node 5 must be reachable");
+    NS_TEST_EXPECT_MSG_EQ(entry.distance, 4, "Node 5 must be reached through node 4");
+
+    // The routes are recomputed when the link expires, even if its tuple is
+    // not removed yet
+    Simulator::Schedule(Seconds(5), &RoutingProtocol::RoutingTableComputation, protocol);
+    Simulator::Schedule(Seconds(11), &RoutingProtocol::RoutingTableComputation, protocol);
+    Simulator::Run();
+    NS_TEST_EXPECT_MSG_EQ(m_computations, 3, "The routing table must be recomputed once");
+    NS_TEST_EXPECT_MSG_EQ(protocol->GetSize(), 0, "No node must be reachable");
+
+    protocol->Dispose();
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup olsr-test
+ * \ingroup tests
+ *
+ * Testcase for the indexes of the OLSR state: the lookups find the first
+ * matching tuple and the sets keep their order across insertions and erasures.
+ */
+class OlsrStateIndexTestCase : public TestCase
+{
+  public:
+    OlsrStateIndexTestCase();
+    void DoRun() override;
+};
+
+OlsrStateIndexTestCase::OlsrStateIndexTestCase()
+    : TestCase("Check OLSR state indexes")
+{
+}
+
+void
+OlsrStateIndexTestCase::DoRun()
+{
+    OlsrState state;
+
+    // Link tuples with the same neighbor interface are found in order
+    LinkTuple link;
+    for (const auto& [neighbor, local] : {std::make_pair("10.0.0.2", "10.0.0.1"),
+                                          std::make_pair("10.0.0.3", "10.0.0.1"),
+                                          std::make_pair("10.0.0.2", "10.0.1.1"),
+                                          std::make_pair("10.0.0.4", "10.0.0.1")})
+    {
+        link.neighborIfaceAddr = Ipv4Address(neighbor);
+        link.localIfaceAddr = Ipv4Address(local);
+        state.InsertLinkTuple(link);
+    }
+    NS_TEST_EXPECT_MSG_EQ(state.FindLinkTuple(Ipv4Address("10.0.0.2"))->localIfaceAddr,
+                          Ipv4Address("10.0.0.1"),
+                          "The first link tuple must be found");
+    state.EraseLinkTuple(*state.FindLinkTuple(Ipv4Address("10.0.0.2")));
+    NS_TEST_EXPECT_MSG_EQ(state.FindLinkTuple(Ipv4Address("10.0.0.2"))->localIfaceAddr,
+                          Ipv4Address("10.0.1.1"),
+                          "The remaining link tuple must be found");
+    NS_TEST_EXPECT_MSG_EQ(state.GetLinks().size(), 3, "One link tuple must be erased");
+    NS_TEST_EXPECT_MSG_EQ(state.GetLinks()[0].neighborIfaceAddr,
+                          Ipv4Address("10.0.0.3"),
+                          "The link tuples must keep their order");
+    NS_TEST_EXPECT_MSG_EQ(state.FindLinkTuple(Ipv4Address("10.0.0.4")),
+                          &state.GetLinks()[2],
+                          "The link tuples must be indexed again");
+
+    // 2-hop neighbor tuples erased by neighbor
+    TwoHopNeighborTuple twoHop;
+    for (const auto& [neighbor, twoHopNeighbor] : {std::make_pair("10.0.0.2", "10.0.0.5"),
+                                                   std::make_pair("10.0.0.3", "10.0.0.5"),
+                                                   std::make_pair("10.0.0.2", "10.0.0.6")})
+    {
+        twoHop.neighborMainAddr = Ipv4Address(neighbor);
+        twoHop.twoHopNeighborAddr = Ipv4Address(twoHopNeighbor);
+        state.InsertTwoHopNeighborTuple(twoHop);
+    }
+    state.EraseTwoHopNeighborTuples(Ipv4Address("10.0.0.2"));
+    NS_TEST_EXPECT_MSG_EQ(state.GetTwoHopNeighbors().size(),
+                          1,
+                          "The 2-hop tuples of the neighbor must be erased");
+    NS_TEST_EXPECT_MSG_EQ(
+        state.FindTwoHopNeighborTuple(Ipv4Address("10.0.0.2"), Ipv4Address("10.0.0.6")),
+        nullptr,
+        "The erased 2-hop tuple must not be found");
+    NS_TEST_EXPECT_MSG_EQ(
+        state.FindTwoHopNeighborTuple(Ipv4Address("10.0.0.3"), Ipv4Address("10.0.0.5")),
+        &state.GetTwoHopNeighbors()[0],
+        "The remaining 2-hop tuple must be found");
+
+    // Neighbor addresses rewritten in place
+    NeighborTuple neighbor;
+    neighbor.neighborMainAddr = Ipv4Address("10.0.0.2");
+    neighbor.status = NeighborTuple::STATUS_SYM;
+    neighbor.willingness = Willingness::DEFAULT;
+    state.InsertNeighborTuple(neighbor);
+    state.GetNeighbors()[0].neighborMainAddr = Ipv4Address("10.0.0.7");
+    state.NotifyNeighborhoodChanged();
+    NS_TEST_EXPECT_MSG_EQ(state.FindNeighborTuple(Ipv4Address("10.0.0.2")),
+                          nullptr,
+                          "The former address must not be found");
+    NS_TEST_EXPECT_MSG_NE(state.FindSymNeighborTuple(Ipv4Address("10.0.0.7")),
+                          nullptr,
+                          "The new address must be found");
+
+    // Topology tuples by last hop
+    TopologyTuple topology;
+    for (const auto& [dest, last, seq] : {std::make_tuple("10.0.0.5", "10.0.0.2", 1),
+                                          std::make_tuple("10.0.0.6", "10.0.0.2", 2),
+                                          std::make_tuple("10.0.0.5", "10.0.0.3", 1)})
+    {
+        topology.destAddr = Ipv4Address(dest);
+        topology.lastAddr = Ipv4Address(last);
+        topology.sequenceNumber = seq;
+        state.InsertTopologyTuple(topology);
+    }
+    NS_TEST_EXPECT_MSG_EQ(state.FindNewerTopologyTuple(Ipv4Address("10.0.0.2"), 1)->destAddr,
+                          Ipv4Address("10.0.0.6"),
+                          "The newer topology tuple must be found");
+    NS_TEST_EXPECT_MSG_EQ(state.FindNewerTopologyTuple(Ipv4Address("10.0.0.2"), 2),
+                          nullptr,
+                          "No topology tuple must be newer");
+    state.EraseOlderTopologyTuples(Ipv4Address("10.0.0.2"), 2);
+    NS_TEST_EXPECT_MSG_EQ(state.GetTopologySet().size(), 2, "The older tuple must be erased");
+    NS_TEST_EXPECT_MSG_EQ(
+        state.FindTopologyTuple(Ipv4Address("10.0.0.5"), Ipv4Address("10.0.0.2")),
+        nullptr,
+        "The older tuple must not be found");
+    NS_TEST_EXPECT_MSG_EQ(
+        state.FindTopologyTuple(Ipv4Address("10.0.0.5"), Ipv4Address("10.0.0.3")),
+        &state.GetTopologySet()[1],
+        "The tuples must be indexed again");
+    topology.destAddr = Ipv4Address("10.0.0.5");
+    topology.lastAddr = Ipv4Address("10.0.0.2");
+    topology.sequenceNumber = 3;
+    state.InsertTopologyTuple(topology);
+    NS_TEST_EXPECT_MSG_EQ(state.FindNewerTopologyTuple(Ipv4Address("10.0.0.2"), 1)->destAddr,
+                          Ipv4Address("10.0.0.6"),
+                          "The first newer topology tuple must be found");
+    state.EraseTopologyTuple(*state.FindNewerTopologyTuple(Ipv4Address("10.0.0.2"), 1));
+    NS_TEST_EXPECT_MSG_EQ(state.FindNewerTopologyTuple(Ipv4Address("10.0.0.2"), 1)->destAddr,
+                          Ipv4Address("10.0.0.5"),
+                          "The inserted topology tuple must be found");
+
+    // Duplicate tuples expire in order, unless refreshed
+    DuplicateTuple duplicate;
+    duplicate.address = Ipv4Address("10.0.0.5");
+    for (uint16_t seq : {1, 2})
+    {
+        duplicate.sequenceNumber = seq;
+        duplicate.expirationTime = Seconds(seq);
+        state.InsertDuplicateTuple(duplicate);
+    }
+    NS_TEST_EXPECT_MSG_EQ(state.GetNextDuplicateExpiration(), Seconds(1), "Wrong expiration");
+    state.FindDuplicateTuple(Ipv4Address("10.0.0.5"), 1)->expirationTime = Seconds(3);
+    state.EraseExpiredDuplicateTuples(Seconds(1.5));
+    NS_TEST_EXPECT_MSG_NE(state.FindDuplicateTuple(Ipv4Address("10.0.0.5"), 1),
+                          nullptr,
+                          "The refreshed tuple must be kept");
+    NS_TEST_EXPECT_MSG_EQ(state.GetNextDuplicateExpiration(), Seconds(2), "Wrong expiration");
+    state.EraseExpiredDuplicateTuples(Seconds(2));
+    NS_TEST_EXPECT_MSG_NE(state.FindDuplicateTuple(Ipv4Address("10.0.0.5"), 2),
+                          nullptr,
+                          "The tuple must be kept until it expires");
+    state.EraseExpiredDuplicateTuples(Seconds(2.5));
+    NS_TEST_EXPECT_MSG_EQ(state.FindDuplicateTuple(Ipv4Address("10.0.0.5"), 2),
+                          nullptr,
+                          "The expired tuple must be erased");
+    NS_TEST_EXPECT_MSG_EQ(state.GetNextDuplicateExpiration(), Seconds(3), "Wrong expiration");
+    state.EraseExpiredDuplicateTuples(Seconds(4));
+    NS_TEST_EXPECT_MSG_EQ(state.FindDuplicateTuple(Ipv4Address("10.0.0.5"), 1),
+                          nullptr,
+                          "The refreshed tuple must expire");
+    NS_TEST_EXPECT_MSG_EQ(state.GetNextDuplicateExpiration(), Time::Max(), "No tuple must be left");
+}
+
 /**
  * \ingroup olsr-test
  * \ingroup tests
@@ -190,6 +487,8 @@ OlsrProtocolTestSuite::OlsrProtocolTestSuite()
     : TestSuite("routing-olsr", UNIT)
 {
     AddTestCase(new OlsrMprTestCase(), TestCase::QUICK);
+    AddTestCase(new OlsrIncrementalRoutingTestCase(), TestCase::QUICK);
+    AddTestCase(new OlsrStateIndexTestCase(), TestCase::QUICK);
 }
 
 static OlsrProtocolTestSuite g_olsrProtocolTestSuite; //!< Static variable for test initialization
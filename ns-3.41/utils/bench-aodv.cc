@@ -0,0 +1,277 @@
+/*
+ * Copyright (c) 2024 Liverpool Hope University, UK
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program benchmarks AODV on large mobile ad hoc networks.  The nodes
+// move fast following the random waypoint model, so that the routes break
+// often, in a square area sized to keep the node density constant.  Random
+// pairs of nodes exchange constant bit rate UDP flows over 802.11b at 2 Mb/s.  It
+// reports the CPU time per simulated second, the delivery ratio and the
+// throughput of the flows.  With 'table', it instead churns the routing
+// table of a node holding growing numbers of routes, and reports the time
+// taken by each route lookup and update, expirations included.
+// Sample usage:  ./ns3 run 'bench-aodv --nodes=500 --flows=50 --duration=10'
+
+#include "ns3/aodv-helper.h"
+#include "ns3/aodv-rtable.h"
+#include "ns3/command-line.h"
+#include "ns3/config.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/on-off-helper.h"
+#include "ns3/packet-sink-helper.h"
+#include "ns3/packet-sink.h"
+#include "ns3/pointer.h"
+#include "ns3/position-allocator.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/yans-wifi-helper.h"
+
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/// Parameters of the benchmark
+struct BenchConfig
+{
+    uint32_t nodes;   //!< number of nodes
+    uint32_t flows;   //!< number of flows
+    double duration;  //!< simulated time of the flows, in seconds
+    double maxSpeed;  //!< maximum speed of the nodes, in m/s
+    uint32_t seed;    //!< seed of the simulation
+};
+
+/**
+ * Simulate flows over a mobile ad hoc network and report the CPU time it
+ * takes and the traffic delivered.
+ * \param config the benchmark parameters
+ */
+static void
+Bench(const BenchConfig& config)
+{
+    NodeContainer nodes;
+    nodes.Create(config.nodes);
+
+    // The broadcasts use the rate of the unicasts, else the route requests
+    // find neighbors too far away to be reached by the unicasts.  802.11b
+    // devices only receive the DSSS rates.
+    Config::SetDefault("ns3::WifiRemoteStationManager::NonUnicastMode",
+                       StringValue("DsssRate2Mbps"));
+    WifiHelper wifi;
+    wifi.SetStandard(WIFI_STANDARD_80211b);
+    wifi.SetRemoteStationManager("ns3::ConstantRateWifiManager",
+                                 "DataMode",
+                                 StringValue("DsssRate2Mbps"),
+                                 "ControlMode",
+                                 StringValue("DsssRate2Mbps"));
+    YansWifiChannelHelper channelHelper = YansWifiChannelHelper::Default();
+    YansWifiPhyHelper phy;
+    phy.SetChannel(channelHelper.Create());
+    WifiMacHelper mac;
+    mac.SetType("ns3::AdhocWifiMac");
+    NetDeviceContainer devices = wifi.Install(phy, mac, nodes);
+
+    // 1000 square meters per node, about eight neighbors within the 50 m range
+    double side = std::sqrt(config.nodes * 1000.0);
+    std::string coordinate = "ns3::UniformRandomVariable[Max=" + std::to_string(side) + "]";
+    ObjectFactory positions;
+    positions.SetTypeId("ns3::RandomRectanglePositionAllocator");
+    positions.Set("X", StringValue(coordinate));
+    positions.Set("Y", StringValue(coordinate));
+    Ptr<PositionAllocator> allocator = positions.Create()->GetObject<PositionAllocator>();
+    MobilityHelper mobility;
+    mobility.SetMobilityModel(
+        "ns3::RandomWaypointMobilityModel",
+        "Speed",
+        StringValue("ns3::UniformRandomVariable[Min=1.0|Max=" + std::to_string(config.maxSpeed) +
+                    "]"),
+        "Pause",
+        StringValue("ns3::ConstantRandomVariable[Constant=0]"),
+        "PositionAllocator",
+        PointerValue(allocator));
+    mobility.SetPositionAllocator(allocator);
+    mobility.Install(nodes);
+
+    AodvHelper aodv;
+    InternetStackHelper internet;
+    internet.SetRoutingHelper(aodv);
+    internet.SetIpv6StackInstall(false);
+    internet.Install(nodes);
+    Ipv4AddressHelper address("10.0.0.0", "255.255.0.0");
+    Ipv4InterfaceContainer interfaces = address.Assign(devices);
+
+    // Each flow sends 4 packets of 512 bytes per second between random nodes
+    std::mt19937 rng(config.seed);
+    std::uniform_int_distribution<uint32_t> drawNode(0, config.nodes - 1);
+    ApplicationContainer sinks;
+    ApplicationContainer sources;
+    Time start = Seconds(1);
+    Time stop = start + Seconds(config.duration);
+    for (uint32_t i = 0; i < config.flows; i++)
+    {
+        uint32_t src = drawNode(rng);
+        uint32_t dst = drawNode(rng);
+        if (src == dst)
+        {
+            dst = (dst + 1) % config.nodes;
+        }
+        // A port per flow, as several flows may reach the same node
+        uint16_t port = 1000 + i;
+        PacketSinkHelper sinkHelper("ns3::UdpSocketFactory",
+                                    InetSocketAddress(Ipv4Address::GetAny(), port));
+        OnOffHelper onOff("ns3::UdpSocketFactory",
+                          InetSocketAddress(interfaces.GetAddress(dst), port));
+        onOff.SetConstantRate(DataRate("16384bps"), 512);
+        sources.Add(onOff.Install(nodes.Get(src)));
+        sinks.Add(sinkHelper.Install(nodes.Get(dst)));
+    }
+    sources.Start(start + MilliSeconds(rng() % 1000));
+    sources.Stop(stop);
+
+    SystemWallClockMs clock;
+    clock.Start();
+    Simulator::Stop(stop + Seconds(1));
+    Simulator::Run();
+    int64_t elapsed = clock.End();
+
+    uint64_t rxBytes = 0;
+    for (uint32_t i = 0; i < sinks.GetN(); i++)
+    {
+        rxBytes += DynamicCast<PacketSink>(sinks.Get(i))->GetTotalRx();
+    }
+    double txBytes = config.flows * 2048.0 * config.duration;
+    std::cout << elapsed / (config.duration + 1) << " ms per simulated second, "
+              << rxBytes * 100.0 / txBytes << "% delivered, "
+              << rxBytes * 8 / config.duration / 1000 << " kbps" << std::endl;
+
+    Simulator::Destroy();
+}
+
+/**
+ * Churn a routing table: each operation looks up a route, and updates it
+ * with a new lifetime or breaks it.
+ * \param table the routing table
+ * \param nRoutes number of routes
+ * \param nOperations number of operations
+ * \param rng the workload generator
+ */
+static void
+Churn(aodv::RoutingTable* table, uint32_t nRoutes, uint32_t nOperations, std::mt19937* rng)
+{
+    std::uniform_int_distribution<uint32_t> drawRoute(1, nRoutes);
+    std::uniform_int_distribution<uint32_t> drawLifetime(1, 3000);
+    for (uint32_t i = 0; i < nOperations; i++)
+    {
+        Ipv4Address dst(0x0a000000 + drawRoute(*rng));
+        aodv::RoutingTableEntry rt;
+        if (!table->LookupRoute(dst, rt))
+        {
+            aodv::RoutingTableEntry newRt(nullptr,
+                                          dst,
+                                          true,
+                                          1,
+                                          Ipv4InterfaceAddress(),
+                                          1,
+                                          dst,
+                                          MilliSeconds(drawLifetime(*rng)));
+            table->AddRoute(newRt);
+        }
+        else if ((*rng)() % 16 == 0)
+        {
+            rt.Invalidate(table->GetBadLinkLifetime());
+            table->Update(rt);
+        }
+        else
+        {
+            rt.SetFlag(aodv::VALID);
+            rt.SetLifeTime(MilliSeconds(drawLifetime(*rng)));
+            table->Update(rt);
+        }
+    }
+}
+
+/**
+ * Report the time taken by the operations on a routing table.
+ * \param nRoutes number of routes
+ * \param seed the seed of the workload generator
+ */
+static void
+BenchTable(uint32_t nRoutes, uint32_t seed)
+{
+    aodv::RoutingTable table(Seconds(3));
+    std::mt19937 rng(seed);
+    // The operations are spread over 10 simulated seconds
+    const uint32_t nRounds = 1000;
+    const uint32_t nOperations = 100;
+    Churn(&table, nRoutes, nRoutes, &rng);
+    for (uint32_t round = 0; round < nRounds; round++)
+    {
+        Simulator::Schedule(MilliSeconds(10 * round), &Churn, &table, nRoutes, nOperations, &rng);
+    }
+    SystemWallClockMs clock;
+    clock.Start();
+    Simulator::Run();
+    int64_t elapsed = clock.End();
+    std::cout << nRoutes << " routes:\t" << elapsed * 1e6 / (nRounds * nOperations)
+              << " ns per operation" << std::endl;
+    Simulator::Destroy();
+}
+
+int
+main(int argc, char* argv[])
+{
+    BenchConfig config = {500, 50, 10, 20, 1};
+    bool table = false;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark AODV on large mobile ad hoc networks");
+    cmd.AddValue("nodes", "number of nodes", config.nodes);
+    cmd.AddValue("flows", "number of flows", config.flows);
+    cmd.AddValue("duration", "simulated time of the flows in seconds", config.duration);
+    cmd.AddValue("speed", "maximum speed of the nodes in m/s", config.maxSpeed);
+    cmd.AddValue("seed", "seed of the simulation", config.seed);
+    cmd.AddValue("table", "benchmark the routing table of a node", table);
+    cmd.Parse(argc, argv);
+
+    if (config.nodes < 2 || config.duration <= 0 || config.maxSpeed <= 1)
+    {
+        std::cerr << "Error-- there must be two nodes, a positive duration and a speed above 1 m/s"
+                  << std::endl;
+        exit(1);
+    }
+    RngSeedManager::SetSeed(config.seed);
+
+    if (table)
+    {
+        for (uint32_t size : {100, 1000, 10000, 100000})
+        {
+            BenchTable(size, config.seed);
+        }
+        return 0;
+    }
+    std::cout << config.nodes << " nodes, " << config.flows << " flows, " << config.maxSpeed
+              << " m/s maximum speed" << std::endl;
+    Bench(config);
+    return 0;
+}
@@ -0,0 +1,392 @@
+/*
+ * Copyright (c) 2024 Liverpool Hope University, UK
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program benchmarks DSR on mobile ad hoc networks.  The nodes move
+// following the random waypoint model in a square area sized to keep the
+// node density constant, and random pairs of nodes exchange constant bit rate
+// UDP flows over 802.11b at 2 Mb/s.  It reports the CPU time per simulated
+// second and the delivery ratio of the flows, with the link or the path
+// cache.  With 'cache', it instead runs the route cache operations that DSR
+// makes for each packet sent by a node of networks of 200, 500 and 1000
+// nodes, and reports the time they take.
+// Sample usage:  ./ns3 run 'bench-dsr --nodes=100 --flows=10 --duration=10'
+
+#include "ns3/command-line.h"
+#include "ns3/config.h"
+#include "ns3/dsr-helper.h"
+#include "ns3/dsr-main-helper.h"
+#include "ns3/dsr-rcache.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/on-off-helper.h"
+#include "ns3/packet-sink-helper.h"
+#include "ns3/packet-sink.h"
+#include "ns3/pointer.h"
+#include "ns3/position-allocator.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/yans-wifi-helper.h"
+
+#include <cmath>
+#include <iostream>
+#include <queue>
+#include <random>
+#include <stdlib.h> // for exit ()
+#include <vector>
+
+using namespace ns3;
+
+/// Parameters of the benchmark
+struct BenchConfig
+{
+    uint32_t nodes;  //!< number of nodes
+    uint32_t flows;  //!< number of flows
+    double duration; //!< simulated time of the flows, in seconds
+    double maxSpeed; //!< maximum speed of the nodes, in m/s
+    uint32_t seed;   //!< seed of the simulation
+};
+
+/**
+ * Simulate flows over a mobile ad hoc network and report the CPU time it
+ * takes and the traffic delivered.
+ * \param config the benchmark parameters
+ * \param cacheType the type of route cache, "LinkCache" or "PathCache"
+ */
+static void
+Bench(const BenchConfig& config, std::string cacheType)
+{
+    NodeContainer nodes;
+    nodes.Create(config.nodes);
+
+    // The broadcasts use the rate of the unicasts, else the route requests
+    // find neighbors too far away to be reached by the unicasts.  802.11b
+    // devices only receive the DSSS rates.
+    Config::SetDefault("ns3::WifiRemoteStationManager::NonUnicastMode",
+                       StringValue("DsssRate2Mbps"));
+    WifiHelper wifi;
+    wifi.SetStandard(WIFI_STANDARD_80211b);
+    wifi.SetRemoteStationManager("ns3::ConstantRateWifiManager",
+                                 "DataMode",
+                                 StringValue("DsssRate2Mbps"),
+                                 "ControlMode",
+                                 StringValue("DsssRate2Mbps"));
+    YansWifiChannelHelper channelHelper = YansWifiChannelHelper::Default();
+    Ptr<YansWifiChannel> channel = channelHelper.Create();
+    YansWifiPhyHelper phy;
+    phy.SetChannel(channel);
+    WifiMacHelper mac;
+    mac.SetType("ns3::AdhocWifiMac");
+    NetDeviceContainer devices = wifi.Install(phy, mac, nodes);
+
+    // 1000 square meters per node, about eight neighbors within the 50 m range
+    double side = std::sqrt(config.nodes * 1000.0);
+    std::string coordinate = "ns3::UniformRandomVariable[Max=" + std::to_string(side) + "]";
+    ObjectFactory positions;
+    positions.SetTypeId("ns3::RandomRectanglePositionAllocator");
+    positions.Set("X", StringValue(coordinate));
+    positions.Set("Y", StringValue(coordinate));
+    Ptr<PositionAllocator> allocator = positions.Create()->GetObject<PositionAllocator>();
+    MobilityHelper mobility;
+    mobility.SetMobilityModel(
+        "ns3::RandomWaypointMobilityModel",
+        "Speed",
+        StringValue("ns3::UniformRandomVariable[Min=1.0|Max=" + std::to_string(config.maxSpeed) +
+                    "]"),
+        "Pause",
+        StringValue("ns3::ConstantRandomVariable[Constant=0]"),
+        "PositionAllocator",
+        PointerValue(allocator));
+    mobility.SetPositionAllocator(allocator);
+    mobility.Install(nodes);
+
+    Config::SetDefault("ns3::dsr::DsrRouting::CacheType", StringValue(cacheType));
+    InternetStackHelper internet;
+    internet.SetIpv6StackInstall(false);
+    internet.Install(nodes);
+    DsrMainHelper dsrMain;
+    DsrHelper dsr;
+    dsrMain.Install(dsr, nodes);
+    Ipv4AddressHelper address("10.0.0.0", "255.255.0.0");
+    Ipv4InterfaceContainer interfaces = address.Assign(devices);
+
+    // Both caches simulate the same network
+    int64_t stream = 0;
+    stream += channelHelper.AssignStreams(channel, stream);
+    stream += wifi.AssignStreams(devices, stream);
+    stream += allocator->AssignStreams(stream);
+    stream += mobility.AssignStreams(nodes, stream);
+    internet.AssignStreams(nodes, stream);
+
+    // Each flow sends 4 packets of 512 bytes per second between random nodes
+    std::mt19937 rng(config.seed);
+    std::uniform_int_distribution<uint32_t> drawNode(0, config.nodes - 1);
+    ApplicationContainer sinks;
+    ApplicationContainer sources;
+    Time start = Seconds(1);
+    Time stop = start + Seconds(config.duration);
+    for (uint32_t i = 0; i < config.flows; i++)
+    {
+        uint32_t src = drawNode(rng);
+        uint32_t dst = drawNode(rng);
+        if (src == dst)
+        {
+            dst = (dst + 1) % config.nodes;
+        }
+        // A port per flow, as several flows may reach the same node
+        uint16_t port = 1000 + i;
+        PacketSinkHelper sinkHelper("ns3::UdpSocketFactory",
+                                    InetSocketAddress(Ipv4Address::GetAny(), port));
+        OnOffHelper onOff("ns3::UdpSocketFactory",
+                          InetSocketAddress(interfaces.GetAddress(dst), port));
+        onOff.SetConstantRate(DataRate("16384bps"), 512);
+        sources.Add(onOff.Install(nodes.Get(src)));
+        sinks.Add(sinkHelper.Install(nodes.Get(dst)));
+    }
+    sources.Start(start + MilliSeconds(rng() % 1000));
+    sources.Stop(stop);
+
+    SystemWallClockMs clock;
+    clock.Start();
+    Simulator::Stop(stop + Seconds(1));
+    Simulator::Run();
+    int64_t elapsed = clock.End();
+
+    uint64_t rxBytes = 0;
+    for (uint32_t i = 0; i < sinks.GetN(); i++)
+    {
+        rxBytes += DynamicCast<PacketSink>(sinks.Get(i))->GetTotalRx();
+    }
+    double txBytes = config.flows * 2048.0 * config.duration;
+    std::cout << cacheType << ":\t" << elapsed / (config.duration + 1)
+              << " ms per simulated second, " << rxBytes * 100.0 / txBytes << "% delivered"
+              << std::endl;
+
+    Simulator::Destroy();
+}
+
+/// The shortest routes from a node to the nodes of a random network
+struct Routes
+{
+    uint32_t source;                                          //!< the node the routes start from
+    std::vector<Ipv4Address> addresses;                       //!< the addresses of the nodes
+    std::vector<dsr::DsrRouteCacheEntry::IP_VECTOR> shortest; //!< the routes, empty if none
+};
+
+/**
+ * Draw a random network, with the node density of the simulations, and find
+ * the shortest routes from a node connected to most of the network.
+ * \param nNodes number of nodes
+ * \param rng the network generator
+ * \return the routes
+ */
+static Routes
+DrawRoutes(uint32_t nNodes, std::mt19937* rng)
+{
+    Routes routes;
+    double side = std::sqrt(nNodes * 1000.0);
+    std::uniform_real_distribution<double> drawCoordinate(0, side);
+    std::vector<std::pair<double, double>> positions;
+    for (uint32_t i = 0; i < nNodes; i++)
+    {
+        positions.emplace_back(drawCoordinate(*rng), drawCoordinate(*rng));
+        routes.addresses.emplace_back(0x0a000001 + i);
+    }
+
+    // Breadth-first search over the links shorter than the 50 m range, from
+    // the first node that reaches half of the network
+    for (uint32_t source = 0; source < nNodes; source++)
+    {
+        routes.shortest.assign(nNodes, dsr::DsrRouteCacheEntry::IP_VECTOR());
+        routes.shortest[source] = {routes.addresses[source]};
+        uint32_t nReached = 1;
+        std::queue<uint32_t> queue;
+        queue.push(source);
+        while (!queue.empty())
+        {
+            uint32_t i = queue.front();
+            queue.pop();
+            for (uint32_t j = 0; j < nNodes; j++)
+            {
+                double dx = positions[i].first - positions[j].first;
+                double dy = positions[i].second - positions[j].second;
+                if (routes.shortest[j].empty() && dx * dx + dy * dy < 50 * 50)
+                {
+                    routes.shortest[j] = routes.shortest[i];
+                    routes.shortest[j].push_back(routes.addresses[j]);
+                    queue.push(j);
+                    nReached++;
+                }
+            }
+        }
+        if (nReached > nNodes / 2)
+        {
+            routes.source = source;
+            return routes;
+        }
+    }
+    std::cerr << "Error-- the network is partitioned" << std::endl;
+    exit(1);
+}
+
+/**
+ * Send packets from the source of the routes: each packet looks up its
+ * route, learns it when missing as from a route reply, extends the lifetime
+ * of its links, and sometimes breaks one of them.
+ * \param cache the route cache of the node
+ * \param routes the routes of the network
+ * \param nPackets number of packets
+ * \param rng the workload generator
+ */
+static void
+Send(Ptr<dsr::DsrRouteCache> cache, const Routes* routes, uint32_t nPackets, std::mt19937* rng)
+{
+    std::uniform_int_distribution<uint32_t> drawNode(0, routes->addresses.size() - 1);
+    Ipv4Address source = routes->addresses[routes->source];
+    for (uint32_t i = 0; i < nPackets; i++)
+    {
+        uint32_t node = drawNode(*rng);
+        const auto& route = routes->shortest[node];
+        if (node == routes->source || route.empty())
+        {
+            continue;
+        }
+        Ipv4Address dst = routes->addresses[node];
+        dsr::DsrRouteCacheEntry rt;
+        if (!cache->LookupRoute(dst, rt))
+        {
+            if (cache->IsLinkCache())
+            {
+                cache->AddRoute_Link(route, source);
+            }
+            else
+            {
+                dsr::DsrRouteCacheEntry newRt(route, dst, cache->GetCacheTimeout());
+                cache->AddRoute(newRt);
+            }
+            if (!cache->LookupRoute(dst, rt))
+            {
+                std::cerr << "Error-- a route was not learned" << std::endl;
+                exit(1);
+            }
+        }
+        dsr::DsrRouteCacheEntry::IP_VECTOR path = rt.GetVector();
+        if (cache->IsLinkCache())
+        {
+            cache->UseExtends(path);
+        }
+        if ((*rng)() % 16 == 0)
+        {
+            std::uniform_int_distribution<std::size_t> drawLink(0, path.size() - 2);
+            std::size_t link = drawLink(*rng);
+            cache->DeleteAllRoutesIncludeLink(path[link], path[link + 1], source);
+        }
+    }
+}
+
+/**
+ * Report the time taken by the route cache operations made for each packet.
+ * \param nNodes number of nodes of the network
+ * \param cacheType the type of route cache, "LinkCache" or "PathCache"
+ * \param seed the seed of the network and workload generator
+ */
+static void
+BenchCache(uint32_t nNodes, std::string cacheType, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    Routes routes = DrawRoutes(nNodes, &rng);
+
+    // The parameters of DsrRouting
+    Ptr<dsr::DsrRouteCache> cache = CreateObject<dsr::DsrRouteCache>();
+    cache->SetCacheType(cacheType);
+    cache->SetMaxCacheLen(64);
+    cache->SetCacheTimeout(Seconds(300));
+    cache->SetMaxEntriesEachDst(20);
+    cache->SetStabilityDecrFactor(2);
+    cache->SetStabilityIncrFactor(4);
+    cache->SetInitStability(Seconds(25));
+    cache->SetMinLifeTime(Seconds(1));
+    cache->SetUseExtends(Seconds(120));
+
+    // The packets are spread over 10 simulated seconds
+    const uint32_t nRounds = 1000;
+    const uint32_t nPackets = 100;
+    for (uint32_t round = 0; round < nRounds; round++)
+    {
+        Simulator::Schedule(MilliSeconds(10 * round), &Send, cache, &routes, nPackets, &rng);
+    }
+    SystemWallClockMs clock;
+    clock.Start();
+    Simulator::Run();
+    int64_t elapsed = clock.End();
+    uint32_t nReached = 0;
+    for (const auto& route : routes.shortest)
+    {
+        nReached += !route.empty();
+    }
+    std::cout << nNodes << " nodes, " << nReached - 1 << " reached, " << cacheType << ":\t"
+              << elapsed * 1e6 / (nRounds * nPackets) << " ns per packet" << std::endl;
+    Simulator::Destroy();
+}
+
+int
+main(int argc, char* argv[])
+{
+    BenchConfig config = {100, 10, 10, 20, 1};
+    bool benchCache = false;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark DSR on mobile ad hoc networks");
+    cmd.AddValue("nodes", "number of nodes", config.nodes);
+    cmd.AddValue("flows", "number of flows", config.flows);
+    cmd.AddValue("duration", "simulated time of the flows in seconds", config.duration);
+    cmd.AddValue("speed", "maximum speed of the nodes in m/s", config.maxSpeed);
+    cmd.AddValue("seed", "seed of the simulation", config.seed);
+    cmd.AddValue("cache", "benchmark the route cache of a node", benchCache);
+    cmd.Parse(argc, argv);
+
+    if (config.nodes < 2 || config.duration <= 0 || config.maxSpeed <= 1)
+    {
+        std::cerr << "Error-- there must be two nodes, a positive duration and a speed above 1 m/s"
+                  << std::endl;
+        exit(1);
+    }
+    RngSeedManager::SetSeed(config.seed);
+
+    if (benchCache)
+    {
+        for (uint32_t size : {200, 500, 1000})
+        {
+            for (std::string cacheType : {"LinkCache", "PathCache"})
+            {
+                BenchCache(size, cacheType, config.seed);
+            }
+        }
+        return 0;
+    }
+    std::cout << config.nodes << " nodes, " << config.flows << " flows, " << config.maxSpeed
+              << " m/s maximum speed" << std::endl;
+    for (std::string cacheType : {"LinkCache", "PathCache"})
+    {
+        Bench(config, cacheType);
+    }
+    return 0;
+}
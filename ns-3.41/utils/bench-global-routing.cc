@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2024 Liverpool Hope University, UK
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program benchmarks the global routing route computation on random
+// connected topologies of point-to-point links: a random spanning tree plus
+// random links up to the requested average node degree.  It reports the
+// time taken by BuildGlobalRoutingDatabase and InitializeRoutes, which run
+// one SPF calculation per router.  Unless 'nodes' is given, the benchmark
+// runs with 1k, 5k, 10k and 20k nodes.
+// Sample usage:  ./ns3 run 'bench-global-routing --nodes=5000 --threads=4'
+
+#include "ns3/command-line.h"
+#include "ns3/config.h"
+#include "ns3/global-route-manager.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-global-routing-helper.h"
+#include "ns3/ipv4-global-routing.h"
+#include "ns3/ipv4.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/uinteger.h"
+
+#include <iostream>
+#include <random>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/**
+ * Build a random topology and time the computation of its routes.
+ * \param nNodes number of nodes
+ * \param degree average node degree
+ * \param seed seed of the topology generator
+ */
+static void
+Bench(uint32_t nNodes, double degree, uint32_t seed)
+{
+    std::cout << "*** " << nNodes << " nodes" << std::endl;
+    std::mt19937 rng(seed);
+
+    SystemWallClockMs clock;
+    clock.Start();
+    NodeContainer nodes;
+    nodes.Create(nNodes);
+    InternetStackHelper internet;
+    internet.SetIpv6StackInstall(false);
+    internet.Install(nodes);
+
+    SimpleNetDeviceHelper simple;
+    simple.SetNetDevicePointToPointMode(true);
+    Ipv4AddressHelper address("10.0.0.0", "255.255.255.252");
+    auto connect = [&](uint32_t a, uint32_t b) {
+        address.Assign(simple.Install(NodeContainer(nodes.Get(a), nodes.Get(b))));
+        address.NewNetwork();
+    };
+
+    // A random spanning tree keeps the topology connected, the other links
+    // join random pairs of distinct nodes
+    uint64_t nLinks = 0;
+    for (uint32_t i = 1; i < nNodes; i++, nLinks++)
+    {
+        connect(i, std::uniform_int_distribution<uint32_t>(0, i - 1)(rng));
+    }
+    std::uniform_int_distribution<uint32_t> draw(0, nNodes - 1);
+    uint64_t nTotalLinks = static_cast<uint64_t>(degree * nNodes / 2);
+    for (; nLinks < nTotalLinks; nLinks++)
+    {
+        uint32_t a = draw(rng);
+        uint32_t b = draw(rng);
+        while (a == b)
+        {
+            b = draw(rng);
+        }
+        connect(a, b);
+    }
+    std::cout << "Built " << nLinks << " links in " << clock.End() << " ms" << std::endl;
+
+    clock.Start();
+    GlobalRouteManager::BuildGlobalRoutingDatabase();
+    std::cout << "BuildGlobalRoutingDatabase: " << clock.End() << " ms" << std::endl;
+
+    clock.Start();
+    GlobalRouteManager::InitializeRoutes();
+    int64_t elapsed = clock.End();
+    std::cout << "InitializeRoutes: " << elapsed << " ms (" << elapsed * 1000.0 / nNodes
+              << " us per SPF calculation)" << std::endl;
+
+    // Sanity check on the node with the most links, stub nodes only get a
+    // default route
+    Ptr<Node> node = nodes.Get(0);
+    for (uint32_t i = 1; i < nNodes; i++)
+    {
+        if (nodes.Get(i)->GetNDevices() > node->GetNDevices())
+        {
+            node = nodes.Get(i);
+        }
+    }
+    Ptr<Ipv4GlobalRouting> routing = Ipv4RoutingHelper::GetRouting<Ipv4GlobalRouting>(
+        node->GetObject<Ipv4>()->GetRoutingProtocol());
+    std::cout << "Node " << node->GetId() << " has " << routing->GetNRoutes() << " routes"
+              << std::endl;
+    if (routing->GetNRoutes() < nLinks)
+    {
+        std::cerr << "Error-- missing routes" << std::endl;
+        exit(1);
+    }
+
+    GlobalRouteManager::DeleteGlobalRoutes();
+    Simulator::Destroy();
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t nNodes = 0;
+    double degree = 3;
+    uint32_t threads = 1;
+    uint32_t seed = 1;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the global routing route computation");
+    cmd.AddValue("nodes", "number of nodes, 0 for 1k, 5k, 10k and 20k", nNodes);
+    cmd.AddValue("degree", "average node degree", degree);
+    cmd.AddValue("threads", "number of threads computing the routes", threads);
+    cmd.AddValue("seed", "seed of the topology generator", seed);
+    cmd.Parse(argc, argv);
+
+    if (degree < 2 || threads == 0)
+    {
+        std::cerr << "Error-- degree must be at least 2 and threads non-zero" << std::endl;
+        exit(1);
+    }
+    Config::SetGlobal("GlobalRoutingThreads", UintegerValue(threads));
+
+    std::vector<uint32_t> sizes = {1000, 5000, 10000, 20000};
+    if (nNodes)
+    {
+        sizes = {nNodes};
+    }
+    for (uint32_t size : sizes)
+    {
+        Bench(size, degree, seed);
+    }
+    return 0;
+}
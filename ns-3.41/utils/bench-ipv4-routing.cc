@@ -0,0 +1,314 @@
+/*
+ * Copyright (c) 2024 Liverpool Hope University, UK
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program benchmarks unicast route lookups (forwarding rate) of
+// Ipv4StaticRouting and Ipv4GlobalRouting on a table of 'routes' prefixes
+// whose length distribution follows a BGP core table, against a sequential
+// scan of the same prefixes.  The results of both routing protocols are
+// checked against sequential scans implementing their selection rules.
+// Sample usage:  ./ns3 run 'bench-ipv4-routing --routes=50000 --lookups=1000000'
+
+#include "ns3/command-line.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-global-routing.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-route.h"
+#include "ns3/ipv4-static-routing.h"
+#include "ns3/ipv4.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <iostream>
+#include <random>
+#include <stdlib.h> // for exit ()
+#include <vector>
+
+using namespace ns3;
+
+/// A prefix of the synthetic table
+struct BenchPrefix
+{
+    Ipv4Address network; //!< network address
+    Ipv4Mask mask;       //!< network mask
+    uint32_t interface;  //!< outgoing interface
+};
+
+/// Number of interfaces carrying the synthetic routes
+static const uint32_t N_INTERFACES = 4;
+
+/**
+ * Draw a prefix length following the distribution of a BGP core table
+ * (about 60% /24, the rest mostly between /16 and /23).
+ * \param rng the random generator
+ * \return the prefix length
+ */
+static uint16_t
+DrawPrefixLength(std::mt19937& rng)
+{
+    static std::discrete_distribution<uint16_t> lengths(
+        {0, 0, 0, 0, 0, 0, 0, 0,  // /0../7
+         1, 1, 1, 1, 2, 3, 4, 5,  // /8../15
+         12, 4, 6, 10, 14, 14, 38, 40, // /16../23
+         600, 0, 0, 0, 0, 0, 0, 0, 0}); // /24../32
+    return lengths(rng);
+}
+
+/**
+ * Draw a random unicast address outside of 0.0.0.0/8 and of the
+ * 10.0.0.0/8 interface networks.
+ * \param rng the random generator
+ * \return the address
+ */
+static uint32_t
+MakeAddress(std::mt19937& rng)
+{
+    uint32_t address = rng() | 0x01000000;
+    if (address >= 0xe0000000)
+    {
+        address &= 0x7fffffff;
+    }
+    if ((address >> 24) == 10)
+    {
+        address ^= 0x80000000;
+    }
+    return address;
+}
+
+/**
+ * Generate the synthetic prefixes.
+ * \param n the number of prefixes
+ * \param rng the random generator
+ * \return the prefixes
+ */
+static std::vector<BenchPrefix>
+MakePrefixes(uint32_t n, std::mt19937& rng)
+{
+    std::vector<BenchPrefix> prefixes;
+    prefixes.reserve(n);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        uint16_t length = DrawPrefixLength(rng);
+        Ipv4Mask mask(length == 0 ? 0 : (0xffffffff << (32 - length)));
+        uint32_t address = MakeAddress(rng);
+        prefixes.push_back({Ipv4Address(address & mask.Get()), mask, 1 + i % N_INTERFACES});
+    }
+    return prefixes;
+}
+
+/**
+ * Sequential longest-prefix match, the reference for the indexed lookups.
+ * As in Ipv4StaticRouting, the last of several identical prefixes wins.
+ * \param prefixes the prefixes
+ * \param dest the destination
+ * \return the outgoing interface, or 0 if there is no route
+ */
+static uint32_t
+ScanLookup(const std::vector<BenchPrefix>& prefixes, Ipv4Address dest)
+{
+    uint16_t longest = 0;
+    uint32_t interface = 0;
+    for (const auto& prefix : prefixes)
+    {
+        if (prefix.mask.IsMatch(dest, prefix.network) &&
+            (interface == 0 || prefix.mask.GetPrefixLength() >= longest))
+        {
+            longest = prefix.mask.GetPrefixLength();
+            interface = prefix.interface;
+        }
+    }
+    return interface;
+}
+
+/**
+ * Sequential scan returning the first matching prefix, whatever its length,
+ * which is the route Ipv4GlobalRouting selects when random ECMP is disabled.
+ * \param prefixes the prefixes
+ * \param dest the destination
+ * \return the outgoing interface, or 0 if there is no route
+ */
+static uint32_t
+ScanFirstMatch(const std::vector<BenchPrefix>& prefixes, Ipv4Address dest)
+{
+    for (const auto& prefix : prefixes)
+    {
+        if (prefix.mask.IsMatch(dest, prefix.network))
+        {
+            return prefix.interface;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Check lookup results against the reference scan.
+ * \param name the name of the benchmark
+ * \param destinations the destinations looked up
+ * \param found the results of the lookups
+ * \param expected the results of the reference scan
+ */
+static void
+CheckResults(const char* name,
+             const std::vector<Ipv4Address>& destinations,
+             const std::vector<uint32_t>& found,
+             const std::vector<uint32_t>& expected)
+{
+    for (std::size_t i = 0; i < expected.size(); i++)
+    {
+        if (found[i] != expected[i])
+        {
+            std::cerr << "Error-- " << name << " lookup of " << destinations[i]
+                      << " returned interface " << found[i] << ", expected " << expected[i]
+                      << std::endl;
+            exit(1);
+        }
+    }
+}
+
+/**
+ * Run and time a batch of lookups.
+ * \param name the name of the benchmark
+ * \param destinations the destinations to look up
+ * \param lookup the lookup function, returning the outgoing interface
+ * \return the outgoing interface of each lookup
+ */
+template <typename Lookup>
+static std::vector<uint32_t>
+RunBench(const char* name, const std::vector<Ipv4Address>& destinations, Lookup lookup)
+{
+    std::vector<uint32_t> results;
+    results.reserve(destinations.size());
+    SystemWallClockMs clock;
+    clock.Start();
+    for (const auto& dest : destinations)
+    {
+        results.push_back(lookup(dest));
+    }
+    int64_t elapsed = std::max<int64_t>(clock.End(), 1);
+    std::cout << destinations.size() * 1000.0 / elapsed << " lookups/s (" << elapsed
+              << " ms elapsed)\t" << name << std::endl;
+    return results;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t nRoutes = 50000;
+    uint32_t nLookups = 1000000;
+    uint32_t nScanLookups = 10000;
+    uint32_t seed = 1;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark IPv4 unicast route lookups");
+    cmd.AddValue("routes", "number of prefixes in the routing table", nRoutes);
+    cmd.AddValue("lookups", "number of lookups", nLookups);
+    cmd.AddValue("scan-lookups", "number of lookups for the sequential scan", nScanLookups);
+    cmd.AddValue("seed", "seed of the prefix and destination generator", seed);
+    cmd.Parse(argc, argv);
+
+    if (nLookups == 0 || nScanLookups > nLookups)
+    {
+        std::cerr << "Error-- lookups must be non-zero and at least scan-lookups" << std::endl;
+        exit(1);
+    }
+
+    std::mt19937 rng(seed);
+    std::vector<BenchPrefix> prefixes = MakePrefixes(nRoutes, rng);
+
+    // Destinations: mostly inside a random prefix, the rest anywhere
+    std::vector<Ipv4Address> destinations;
+    destinations.reserve(nLookups);
+    for (uint32_t i = 0; i < nLookups; i++)
+    {
+        uint32_t address = MakeAddress(rng);
+        if (!prefixes.empty() && i % 8 != 0)
+        {
+            const BenchPrefix& prefix = prefixes[rng() % prefixes.size()];
+            address = prefix.network.Get() | (address & ~prefix.mask.Get());
+        }
+        destinations.emplace_back(address);
+    }
+
+    Ptr<Node> node = CreateObject<Node>();
+    InternetStackHelper internet;
+    internet.Install(node);
+    Ptr<Ipv4> ipv4 = node->GetObject<Ipv4>();
+    for (uint32_t i = 0; i < N_INTERFACES; i++)
+    {
+        Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice>();
+        device->SetAddress(Mac48Address::Allocate());
+        node->AddDevice(device);
+        uint32_t interface = ipv4->AddInterface(device);
+        ipv4->AddAddress(interface,
+                         Ipv4InterfaceAddress(Ipv4Address(0x0a000001 + (i << 8)),
+                                              Ipv4Mask("255.255.255.0")));
+        ipv4->SetUp(interface);
+    }
+
+    Ptr<Ipv4StaticRouting> staticRouting = CreateObject<Ipv4StaticRouting>();
+    staticRouting->SetIpv4(ipv4);
+    Ptr<Ipv4GlobalRouting> globalRouting = CreateObject<Ipv4GlobalRouting>();
+    globalRouting->SetIpv4(ipv4);
+
+    SystemWallClockMs clock;
+    clock.Start();
+    for (const auto& prefix : prefixes)
+    {
+        Ipv4Address gateway(0x0a000002 + ((prefix.interface - 1) << 8));
+        staticRouting->AddNetworkRouteTo(prefix.network, prefix.mask, gateway, prefix.interface);
+        globalRouting->AddNetworkRouteTo(prefix.network, prefix.mask, gateway, prefix.interface);
+    }
+    std::cout << "Installed " << nRoutes << " prefixes in both tables in " << clock.End() << " ms"
+              << std::endl;
+
+    auto routeLookup = [](Ptr<Ipv4RoutingProtocol> routing, Ptr<Ipv4> ipv4, Ipv4Address dest) {
+        Ipv4Header header;
+        header.SetDestination(dest);
+        Socket::SocketErrno sockerr;
+        Ptr<Ipv4Route> route = routing->RouteOutput(nullptr, header, nullptr, sockerr);
+        if (!route)
+        {
+            return 0u;
+        }
+        return static_cast<uint32_t>(ipv4->GetInterfaceForDevice(route->GetOutputDevice()));
+    };
+
+    std::vector<Ipv4Address> scanDestinations(destinations.begin(),
+                                              destinations.begin() + nScanLookups);
+    std::vector<uint32_t> expected =
+        RunBench("Sequential scan", scanDestinations, [&prefixes](Ipv4Address dest) {
+            return ScanLookup(prefixes, dest);
+        });
+    std::vector<uint32_t> expectedFirst =
+        RunBench("Sequential scan, first match", scanDestinations, [&prefixes](Ipv4Address dest) {
+            return ScanFirstMatch(prefixes, dest);
+        });
+    std::vector<uint32_t> found =
+        RunBench("Ipv4StaticRouting", destinations, [&](Ipv4Address dest) {
+            return routeLookup(staticRouting, ipv4, dest);
+        });
+    CheckResults("Ipv4StaticRouting", destinations, found, expected);
+    found = RunBench("Ipv4GlobalRouting", destinations, [&](Ipv4Address dest) {
+        return routeLookup(globalRouting, ipv4, dest);
+    });
+    CheckResults("Ipv4GlobalRouting", destinations, found, expectedFirst);
+
+    staticRouting->Dispose();
+    globalRouting->Dispose();
+    return 0;
+}
@@ -0,0 +1,381 @@
+/*
+ * Copyright (c) 2024 Liverpool Hope University, UK
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program benchmarks unicast and multicast route lookups of
+// Ipv6StaticRouting against a sequential scan of the same routes, which is
+// what Ipv6StaticRouting did before its routes were indexed.  Unicast
+// prefixes follow the length distribution of an IPv6 BGP table.  Unless
+// 'routes' is given, the benchmark runs with 1k, 10k and 100k routes.
+// Results of the indexed lookups are checked against the sequential scan.
+// Sample usage:  ./ns3 run 'bench-ipv6-routing --lookups=1000000'
+
+#include "ns3/command-line.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv6-header.h"
+#include "ns3/ipv6-route.h"
+#include "ns3/ipv6-static-routing.h"
+#include "ns3/ipv6.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <iostream>
+#include <random>
+#include <stdlib.h> // for exit ()
+#include <vector>
+
+using namespace ns3;
+
+/// A prefix of the synthetic table
+struct BenchPrefix
+{
+    Ipv6Address network; //!< network address
+    Ipv6Prefix prefix;   //!< network prefix
+    uint32_t interface;  //!< outgoing interface
+};
+
+/// Number of interfaces carrying the synthetic routes
+static const uint32_t N_INTERFACES = 4;
+
+/**
+ * Draw a prefix length following the distribution of an IPv6 BGP table
+ * (about half /48, then /32, /44, /40 and /36).
+ * \param rng the random generator
+ * \return the prefix length
+ */
+static uint8_t
+DrawPrefixLength(std::mt19937& rng)
+{
+    static const uint8_t lengths[] = {28, 29, 32, 33, 34, 35, 36, 40, 44, 46, 47, 48, 56, 64};
+    static std::discrete_distribution<uint32_t> weights(
+        {1, 2, 12, 2, 1, 1, 5, 8, 10, 2, 3, 50, 2, 1});
+    return lengths[weights(rng)];
+}
+
+/**
+ * Draw a random global unicast address (2000::/3) outside of the
+ * 2001:db8::/32 interface networks.
+ * \param rng the random generator
+ * \param buf the address bytes
+ */
+static void
+MakeAddress(std::mt19937& rng, uint8_t buf[16])
+{
+    for (uint32_t i = 0; i < 16; i += 4)
+    {
+        uint32_t word = rng();
+        buf[i] = word >> 24;
+        buf[i + 1] = word >> 16;
+        buf[i + 2] = word >> 8;
+        buf[i + 3] = word;
+    }
+    buf[0] = 0x20 | (buf[0] & 0x1f);
+    if (buf[0] == 0x20 && buf[1] == 0x01 && buf[2] == 0x0d && buf[3] == 0xb8)
+    {
+        buf[2] ^= 0x80;
+    }
+}
+
+/**
+ * Generate the synthetic prefixes.
+ * \param n the number of prefixes
+ * \param rng the random generator
+ * \return the prefixes
+ */
+static std::vector<BenchPrefix>
+MakePrefixes(uint32_t n, std::mt19937& rng)
+{
+    std::vector<BenchPrefix> prefixes;
+    prefixes.reserve(n);
+    for (uint32_t i = 0; i < n; i++)
+    {
+        uint8_t buf[16];
+        MakeAddress(rng, buf);
+        Ipv6Prefix prefix(DrawPrefixLength(rng));
+        prefixes.push_back(
+            {Ipv6Address(buf).CombinePrefix(prefix), prefix, 1 + i % N_INTERFACES});
+    }
+    return prefixes;
+}
+
+/**
+ * Sequential longest-prefix match, the reference for the indexed lookups.
+ * As in Ipv6StaticRouting, the last of several identical prefixes wins.
+ * \param prefixes the prefixes
+ * \param dest the destination
+ * \return the outgoing interface, or 0 if there is no route
+ */
+static uint32_t
+ScanLookup(const std::vector<BenchPrefix>& prefixes, Ipv6Address dest)
+{
+    uint8_t longest = 0;
+    uint32_t interface = 0;
+    for (const auto& prefix : prefixes)
+    {
+        if (prefix.prefix.IsMatch(dest, prefix.network) &&
+            (interface == 0 || prefix.prefix.GetPrefixLength() >= longest))
+        {
+            longest = prefix.prefix.GetPrefixLength();
+            interface = prefix.interface;
+        }
+    }
+    return interface;
+}
+
+/**
+ * Run and time a batch of lookups.
+ * \param name the name of the benchmark
+ * \param n the number of lookups
+ * \param lookup the lookup function, taking the lookup number and
+ * returning the result
+ * \return the result of each lookup
+ */
+template <typename Lookup>
+static std::vector<uint32_t>
+RunBench(const std::string& name, uint32_t n, Lookup lookup)
+{
+    std::vector<uint32_t> results;
+    results.reserve(n);
+    SystemWallClockMs clock;
+    clock.Start();
+    for (uint32_t i = 0; i < n; i++)
+    {
+        results.push_back(lookup(i));
+    }
+    int64_t elapsed = std::max<int64_t>(clock.End(), 1);
+    std::cout << n * 1000.0 / elapsed << " lookups/s (" << elapsed << " ms elapsed)\t" << name
+              << std::endl;
+    return results;
+}
+
+/**
+ * Check lookup results against the reference scan.
+ * \param name the name of the benchmark
+ * \param found the results of the lookups
+ * \param expected the results of the reference scan
+ */
+static void
+CheckResults(const std::string& name,
+             const std::vector<uint32_t>& found,
+             const std::vector<uint32_t>& expected)
+{
+    for (std::size_t i = 0; i < expected.size(); i++)
+    {
+        if (found[i] != expected[i])
+        {
+            std::cerr << "Error-- " << name << " lookup " << i << " returned " << found[i]
+                      << ", expected " << expected[i] << std::endl;
+            exit(1);
+        }
+    }
+}
+
+/**
+ * Benchmark the lookups with a given number of routes.
+ * \param nRoutes the number of unicast and of multicast routes
+ * \param nLookups the number of lookups
+ * \param nScanLookups the number of lookups for the sequential scans
+ * \param seed the seed of the prefix and destination generator
+ */
+static void
+Bench(uint32_t nRoutes, uint32_t nLookups, uint32_t nScanLookups, uint32_t seed)
+{
+    std::cout << "*** " << nRoutes << " routes" << std::endl;
+    std::mt19937 rng(seed);
+    std::vector<BenchPrefix> prefixes = MakePrefixes(nRoutes, rng);
+
+    // Destinations: mostly inside a random prefix, the rest anywhere
+    std::vector<Ipv6Address> destinations;
+    destinations.reserve(nLookups);
+    for (uint32_t i = 0; i < nLookups; i++)
+    {
+        uint8_t buf[16];
+        MakeAddress(rng, buf);
+        if (!prefixes.empty() && i % 8 != 0)
+        {
+            const BenchPrefix& prefix = prefixes[rng() % prefixes.size()];
+            uint8_t network[16];
+            uint8_t mask[16];
+            prefix.network.GetBytes(network);
+            prefix.prefix.GetBytes(mask);
+            for (uint32_t j = 0; j < 16; j++)
+            {
+                buf[j] = network[j] | (buf[j] & ~mask[j]);
+            }
+        }
+        destinations.emplace_back(buf);
+    }
+
+    Ptr<Node> node = CreateObject<Node>();
+    InternetStackHelper internet;
+    internet.SetIpv4StackInstall(false);
+    internet.Install(node);
+    Ptr<Ipv6> ipv6 = node->GetObject<Ipv6>();
+    for (uint32_t i = 0; i < N_INTERFACES; i++)
+    {
+        Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice>();
+        device->SetAddress(Mac48Address::Allocate());
+        node->AddDevice(device);
+        uint32_t interface = ipv6->AddInterface(device);
+        uint8_t buf[16] = {0x20, 0x01, 0x0d, 0xb8, 0, static_cast<uint8_t>(i)};
+        buf[15] = 1;
+        ipv6->AddAddress(interface, Ipv6InterfaceAddress(Ipv6Address(buf), Ipv6Prefix(64)));
+        ipv6->SetUp(interface);
+    }
+
+    Ptr<Ipv6StaticRouting> routing = CreateObject<Ipv6StaticRouting>();
+    routing->SetIpv6(ipv6);
+
+    // Multicast groups, one route per group, coming in on a random interface
+    std::vector<Ipv6Address> groups;
+    std::vector<uint32_t> groupInterfaces;
+    for (uint32_t i = 0; i < nRoutes; i++)
+    {
+        uint8_t buf[16] = {0xff, 0x0e};
+        buf[12] = i >> 24;
+        buf[13] = i >> 16;
+        buf[14] = i >> 8;
+        buf[15] = i;
+        groups.emplace_back(buf);
+        groupInterfaces.push_back(1 + rng() % N_INTERFACES);
+    }
+
+    SystemWallClockMs clock;
+    clock.Start();
+    for (const auto& prefix : prefixes)
+    {
+        uint8_t gateway[16] = {0xfe, 0x80};
+        gateway[15] = prefix.interface + 1;
+        routing->AddNetworkRouteTo(prefix.network,
+                                   prefix.prefix,
+                                   Ipv6Address(gateway),
+                                   prefix.interface);
+    }
+    for (uint32_t i = 0; i < nRoutes; i++)
+    {
+        routing->AddMulticastRoute(Ipv6Address::GetAny(),
+                                   groups[i],
+                                   groupInterfaces[i],
+                                   {1 + groupInterfaces[i] % N_INTERFACES});
+    }
+    std::cout << "Installed " << nRoutes << " unicast and multicast routes in " << clock.End()
+              << " ms" << std::endl;
+
+    auto routeLookup = [&routing, &ipv6](Ipv6Address dest) {
+        Ipv6Header header;
+        header.SetDestination(dest);
+        Socket::SocketErrno sockerr;
+        Ptr<Ipv6Route> route = routing->RouteOutput(nullptr, header, nullptr, sockerr);
+        if (!route)
+        {
+            return 0u;
+        }
+        return static_cast<uint32_t>(ipv6->GetInterfaceForDevice(route->GetOutputDevice()));
+    };
+
+    // Multicast lookups go through RouteInput, reporting the output interface
+    Ptr<Packet> packet = Create<Packet>();
+    uint32_t multicastResult = 0;
+    Ipv6RoutingProtocol::MulticastForwardCallback mcb(
+        [&multicastResult](Ptr<const NetDevice>,
+                           Ptr<Ipv6MulticastRoute> route,
+                           Ptr<const Packet>,
+                           const Ipv6Header&) {
+            multicastResult = route->GetOutputTtlMap().begin()->first;
+        });
+    auto multicastLookup = [&](uint32_t i) {
+        uint32_t group = i % groups.size();
+        // One lookup in four comes in on the wrong interface and finds no route
+        uint32_t interface = groupInterfaces[group] + (i % 4 == 0 ? 1 : 0);
+        interface = 1 + (interface - 1) % N_INTERFACES;
+        Ipv6Header header;
+        header.SetSource(Ipv6Address("2001:db8:ffff::1"));
+        header.SetDestination(groups[group]);
+        multicastResult = 0;
+        routing->RouteInput(packet,
+                            header,
+                            ipv6->GetNetDevice(interface),
+                            Ipv6RoutingProtocol::UnicastForwardCallback(),
+                            mcb,
+                            Ipv6RoutingProtocol::LocalDeliverCallback(),
+                            Ipv6RoutingProtocol::ErrorCallback());
+        return multicastResult;
+    };
+    auto multicastScan = [&](uint32_t i) {
+        uint32_t group = i % groups.size();
+        uint32_t interface = groupInterfaces[group] + (i % 4 == 0 ? 1 : 0);
+        interface = 1 + (interface - 1) % N_INTERFACES;
+        for (uint32_t j = 0; j < groups.size(); j++)
+        {
+            if (groups[j] == groups[group] && groupInterfaces[j] == interface)
+            {
+                return 1 + groupInterfaces[j] % N_INTERFACES;
+            }
+        }
+        return 0u;
+    };
+
+    std::vector<uint32_t> expected =
+        RunBench("Sequential scan", nScanLookups, [&](uint32_t i) {
+            return ScanLookup(prefixes, destinations[i]);
+        });
+    std::vector<uint32_t> found = RunBench("Ipv6StaticRouting unicast", nLookups, [&](uint32_t i) {
+        return routeLookup(destinations[i]);
+    });
+    CheckResults("Ipv6StaticRouting unicast", found, expected);
+
+    expected = RunBench("Sequential scan multicast", nScanLookups, multicastScan);
+    found = RunBench("Ipv6StaticRouting multicast", nLookups, multicastLookup);
+    CheckResults("Ipv6StaticRouting multicast", found, expected);
+
+    routing->Dispose();
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t nRoutes = 0;
+    uint32_t nLookups = 200000;
+    uint32_t nScanLookups = 1000;
+    uint32_t seed = 1;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark IPv6 unicast and multicast route lookups");
+    cmd.AddValue("routes", "number of routes, 0 for 1k, 10k and 100k", nRoutes);
+    cmd.AddValue("lookups", "number of lookups", nLookups);
+    cmd.AddValue("scan-lookups", "number of lookups for the sequential scan", nScanLookups);
+    cmd.AddValue("seed", "seed of the prefix and destination generator", seed);
+    cmd.Parse(argc, argv);
+
+    if (nLookups == 0 || nScanLookups > nLookups)
+    {
+        std::cerr << "Error-- lookups must be non-zero and at least scan-lookups" << std::endl;
+        exit(1);
+    }
+
+    std::vector<uint32_t> sizes = {1000, 10000, 100000};
+    if (nRoutes)
+    {
+        sizes = {nRoutes};
+    }
+    for (uint32_t size : sizes)
+    {
+        Bench(size, nLookups, nScanLookups, seed);
+    }
+    return 0;
+}
@@ -0,0 +1,293 @@
+/*
+ * Copyright (c) 2024 Liverpool Hope University, UK
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program benchmarks the nix-vector route caches under link flaps.
+// The topology is a random connected graph of point-to-point links.  A set
+// of flows between random nodes look up their routes; then, each round, a
+// random link goes down and up again, and the flows look up their routes
+// after each change.  The workload runs twice: once letting the routing
+// drop the cached routes affected by each change, and once flushing all
+// the caches after each change, as nix-vector routing used to do.  It
+// reports the hit rate of the nix-vector caches and the number of
+// breadth first searches run to build nix-vectors.  With 'precompute', it
+// then reports the time taken to precompute the nix-vectors between all the
+// nodes, the memory they use, and the time taken by the first lookups of
+// the flows from the table and from breadth first searches.
+// Sample usage:  ./ns3 run 'bench-nix-vector-routing --nodes=1000 --precompute=1'
+
+#include "ns3/boolean.h"
+#include "ns3/command-line.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4.h"
+#include "ns3/nix-vector-helper.h"
+#include "ns3/nix-vector-routing.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/uinteger.h"
+
+#include <iostream>
+#include <random>
+#include <stdlib.h> // for exit ()
+#include <vector>
+
+using namespace ns3;
+
+/// Parameters of the benchmark
+struct BenchConfig
+{
+    uint32_t nodes;   //!< number of nodes
+    double degree;    //!< average node degree
+    uint32_t flows;   //!< number of flows
+    uint32_t rounds;  //!< number of link flaps
+    uint32_t seed;    //!< seed of the topology and workload generator
+    uint32_t threads; //!< number of threads precomputing the nix-vectors
+};
+
+/// A flow: the routing protocol of the source and the destination address
+using Flow = std::pair<Ptr<Ipv4RoutingProtocol>, Ipv4Address>;
+
+/**
+ * Build the random topology and the flows.
+ * \param config the benchmark parameters
+ * \param nixRouting the nix-vector routing helper
+ * \param rng the topology and workload generator
+ * \param links the links of the topology
+ * \param flows the flows
+ */
+static void
+BuildTopology(const BenchConfig& config,
+              const Ipv4NixVectorHelper& nixRouting,
+              std::mt19937& rng,
+              std::vector<Ipv4InterfaceContainer>& links,
+              std::vector<Flow>& flows)
+{
+    NodeContainer nodes;
+    nodes.Create(config.nodes);
+    InternetStackHelper internet;
+    internet.SetRoutingHelper(nixRouting);
+    internet.SetIpv6StackInstall(false);
+    internet.Install(nodes);
+
+    // A random spanning tree keeps the topology connected, the other links
+    // join random pairs of distinct nodes
+    SimpleNetDeviceHelper simple;
+    simple.SetNetDevicePointToPointMode(true);
+    Ipv4AddressHelper address("10.0.0.0", "255.255.255.252");
+    auto connect = [&](uint32_t a, uint32_t b) {
+        links.push_back(
+            address.Assign(simple.Install(NodeContainer(nodes.Get(a), nodes.Get(b)))));
+        address.NewNetwork();
+    };
+    for (uint32_t i = 1; i < config.nodes; i++)
+    {
+        connect(i, std::uniform_int_distribution<uint32_t>(0, i - 1)(rng));
+    }
+    std::uniform_int_distribution<uint32_t> drawNode(0, config.nodes - 1);
+    auto nLinks = static_cast<std::size_t>(config.degree * config.nodes / 2);
+    while (links.size() < nLinks)
+    {
+        uint32_t a = drawNode(rng);
+        uint32_t b = drawNode(rng);
+        if (a != b)
+        {
+            connect(a, b);
+        }
+    }
+
+    // Each flow goes from a node to an address of another node
+    std::uniform_int_distribution<std::size_t> drawLink(0, links.size() - 1);
+    while (flows.size() < config.flows)
+    {
+        const Ipv4InterfaceContainer& link = links[drawLink(rng)];
+        Ptr<Node> source = nodes.Get(drawNode(rng));
+        Ipv4Address dest = link.GetAddress(0);
+        if (link.Get(0).first->GetObject<Node>() != source)
+        {
+            flows.emplace_back(source->GetObject<Ipv4>()->GetRoutingProtocol(), dest);
+        }
+    }
+}
+
+/**
+ * Look up the routes of the flows.
+ * \param flows the flows
+ * \return the number of routes found
+ */
+static uint64_t
+Lookup(const std::vector<Flow>& flows)
+{
+    uint64_t nRoutes = 0;
+    for (const auto& [protocol, dest] : flows)
+    {
+        Ipv4Header header;
+        header.SetDestination(dest);
+        Socket::SocketErrno sockerr;
+        if (protocol->RouteOutput(nullptr, header, nullptr, sockerr))
+        {
+            nRoutes++;
+        }
+    }
+    return nRoutes;
+}
+
+/**
+ * Run the link flap workload and report the cache counters.
+ * \param config the benchmark parameters
+ * \param flush whether to flush all the caches after each change
+ */
+static void
+Bench(const BenchConfig& config, bool flush)
+{
+    std::mt19937 rng(config.seed);
+    std::vector<Ipv4InterfaceContainer> links;
+    std::vector<Flow> flows;
+    BuildTopology(config, Ipv4NixVectorHelper(), rng, links, flows);
+
+    Ptr<Ipv4NixVectorRouting> routing =
+        links[0].Get(0).first->GetObject<Node>()->GetObject<Ipv4NixVectorRouting>();
+    uint64_t nRoutes = 0;
+    auto lookup = [&]() { nRoutes += Lookup(flows); };
+    std::uniform_int_distribution<std::size_t> drawLink(0, links.size() - 1);
+
+    SystemWallClockMs clock;
+    clock.Start();
+    lookup();
+    Ipv4NixVectorRouting::ResetCacheStatistics();
+    for (uint32_t round = 0; round < config.rounds; round++)
+    {
+        const Ipv4InterfaceContainer& link = links[drawLink(rng)];
+        link.Get(0).first->SetDown(link.Get(0).second);
+        if (flush)
+        {
+            routing->FlushGlobalNixRoutingCache();
+        }
+        lookup();
+        link.Get(0).first->SetUp(link.Get(0).second);
+        if (flush)
+        {
+            routing->FlushGlobalNixRoutingCache();
+        }
+        lookup();
+    }
+    int64_t elapsed = clock.End();
+
+    auto stats = Ipv4NixVectorRouting::GetCacheStatistics();
+    uint64_t nLookups = stats.hits + stats.misses;
+    std::cout << (flush ? "Global flush" : "Scoped invalidation") << ":\t"
+              << stats.hits * 100.0 / nLookups << "% hits, " << stats.bfs << " BFS, "
+              << stats.invalidated << " nix-vectors dropped, " << nRoutes << " routes found, "
+              << elapsed << " ms" << std::endl;
+
+    routing = nullptr;
+    Simulator::Destroy();
+}
+
+/**
+ * Precompute the nix-vectors between all the nodes and report the time
+ * taken, the memory used and the time of the first lookups of the flows.
+ * \param config the benchmark parameters
+ */
+static void
+BenchPrecompute(const BenchConfig& config)
+{
+    std::mt19937 rng(config.seed);
+    std::vector<Ipv4InterfaceContainer> links;
+    std::vector<Flow> flows;
+    Ipv4NixVectorHelper nixRouting;
+    nixRouting.Set("Precompute", BooleanValue(true));
+    nixRouting.Set("PrecomputeThreads", UintegerValue(config.threads));
+    BuildTopology(config, nixRouting, rng, links, flows);
+
+    // The table is built when the simulation starts
+    SystemWallClockMs clock;
+    clock.Start();
+    Simulator::Stop(NanoSeconds(1));
+    Simulator::Run();
+    int64_t elapsed = clock.End();
+    auto size = Ipv4NixVectorRouting::GetNixTableSize();
+    std::cout << "Precomputed table:\t" << size.pairs << " node pairs in " << elapsed << " ms, "
+              << size.bytes / 1048576.0 << " MiB, " << size.bytes / double(size.pairs)
+              << " bytes per pair" << std::endl;
+
+    Ipv4NixVectorRouting::ResetCacheStatistics();
+    clock.Start();
+    uint64_t nRoutes = Lookup(flows);
+    elapsed = clock.End();
+    auto stats = Ipv4NixVectorRouting::GetCacheStatistics();
+    std::cout << "Table lookups:\t\t" << stats.precomputed << " nix-vectors, " << nRoutes
+              << " routes found, " << elapsed << " ms" << std::endl;
+
+    // A link flap drops the table, the nix-vectors are then built on demand
+    const Ipv4InterfaceContainer& link = links.back();
+    link.Get(0).first->SetDown(link.Get(0).second);
+    link.Get(0).first->SetUp(link.Get(0).second);
+    Ipv4NixVectorRouting::ResetCacheStatistics();
+    clock.Start();
+    uint64_t nOnDemandRoutes = Lookup(flows);
+    elapsed = clock.End();
+    stats = Ipv4NixVectorRouting::GetCacheStatistics();
+    std::cout << "On-demand lookups:\t" << stats.bfs << " BFS, " << nOnDemandRoutes
+              << " routes found, " << elapsed << " ms" << std::endl;
+    if (nRoutes != nOnDemandRoutes)
+    {
+        std::cerr << "Error-- the table and the BFS disagree" << std::endl;
+        exit(1);
+    }
+
+    flows.clear();
+    Simulator::Destroy();
+}
+
+int
+main(int argc, char* argv[])
+{
+    BenchConfig config = {1000, 3, 1000, 50, 1, 0};
+    bool precompute = false;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the nix-vector route caches under link flaps");
+    cmd.AddValue("nodes", "number of nodes", config.nodes);
+    cmd.AddValue("degree", "average node degree", config.degree);
+    cmd.AddValue("flows", "number of flows", config.flows);
+    cmd.AddValue("rounds", "number of link flaps", config.rounds);
+    cmd.AddValue("seed", "seed of the topology and workload generator", config.seed);
+    cmd.AddValue("precompute", "benchmark the precomputed nix-vectors", precompute);
+    cmd.AddValue("threads",
+                 "number of threads precomputing the nix-vectors, 0 for all",
+                 config.threads);
+    cmd.Parse(argc, argv);
+
+    if (config.nodes < 2 || config.degree < 2 || config.flows == 0)
+    {
+        std::cerr << "Error-- there must be two nodes, a degree of two and a flow" << std::endl;
+        exit(1);
+    }
+
+    std::cout << config.nodes << " nodes, " << config.flows << " flows, " << config.rounds
+              << " link flaps" << std::endl;
+    Bench(config, false);
+    Bench(config, true);
+    if (precompute)
+    {
+        BenchPrecompute(config);
+    }
+    return 0;
+}
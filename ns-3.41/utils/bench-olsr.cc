@@ -0,0 +1,278 @@
+/*
+ * Copyright (c) 2024 Liverpool Hope University, UK
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program benchmarks OLSR on mobile ad hoc networks.  The nodes move
+// following the random waypoint model in a square area sized to keep the
+// node density constant, and only run OLSR over 802.11b.  It reports the
+// CPU time per simulated second and the number of routing table
+// computations, with and without the incremental computation of the MPR set
+// and of the routing table.  Unless 'nodes' is given, the benchmark runs
+// with 50, 100, 200 and 300 nodes.  With 'state', it instead fills the
+// state of a node with growing numbers of neighbors and topology tuples, and
+// reports the time taken by the lookups made on each received message.
+// Sample usage:  ./ns3 run 'bench-olsr --nodes=300 --duration=20'
+
+#include "ns3/boolean.h"
+#include "ns3/command-line.h"
+#include "ns3/config.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/mac48-address.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/olsr-helper.h"
+#include "ns3/olsr-routing-protocol.h"
+#include "ns3/olsr-state.h"
+#include "ns3/pointer.h"
+#include "ns3/position-allocator.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/yans-wifi-helper.h"
+
+#include <cmath>
+#include <iostream>
+#include <stdlib.h> // for exit ()
+#include <vector>
+
+using namespace ns3;
+
+/// Number of routing table computations
+static uint64_t g_computations = 0;
+
+/**
+ * Count the routing table computations.
+ * \param size the size of the routing table
+ */
+static void
+RoutingTableChanged(uint32_t size)
+{
+    g_computations++;
+}
+
+/**
+ * Simulate a mobile ad hoc network and report the CPU time it takes.
+ * \param nNodes number of nodes
+ * \param duration simulated time
+ * \param incremental whether to recompute the routes on changes only
+ */
+static void
+Bench(uint32_t nNodes, Time duration, bool incremental)
+{
+    NodeContainer nodes;
+    nodes.Create(nNodes);
+
+    WifiHelper wifi;
+    wifi.SetStandard(WIFI_STANDARD_80211b);
+    wifi.SetRemoteStationManager("ns3::ConstantRateWifiManager",
+                                 "DataMode",
+                                 StringValue("DsssRate11Mbps"),
+                                 "ControlMode",
+                                 StringValue("DsssRate11Mbps"));
+    YansWifiChannelHelper channelHelper = YansWifiChannelHelper::Default();
+    Ptr<YansWifiChannel> channel = channelHelper.Create();
+    YansWifiPhyHelper phy;
+    phy.SetChannel(channel);
+    WifiMacHelper mac;
+    mac.SetType("ns3::AdhocWifiMac");
+    NetDeviceContainer devices = wifi.Install(phy, mac, nodes);
+
+    // 2500 square meters per node, so that the nodes have several neighbors
+    double side = std::sqrt(nNodes * 2500.0);
+    std::string coordinate = "ns3::UniformRandomVariable[Max=" + std::to_string(side) + "]";
+    ObjectFactory positions;
+    positions.SetTypeId("ns3::RandomRectanglePositionAllocator");
+    positions.Set("X", StringValue(coordinate));
+    positions.Set("Y", StringValue(coordinate));
+    Ptr<PositionAllocator> allocator = positions.Create()->GetObject<PositionAllocator>();
+    MobilityHelper mobility;
+    mobility.SetMobilityModel("ns3::RandomWaypointMobilityModel",
+                              "Speed",
+                              StringValue("ns3::UniformRandomVariable[Min=1.0|Max=20.0]"),
+                              "Pause",
+                              StringValue("ns3::ConstantRandomVariable[Constant=0]"),
+                              "PositionAllocator",
+                              PointerValue(allocator));
+    mobility.SetPositionAllocator(allocator);
+    mobility.Install(nodes);
+
+    OlsrHelper olsr;
+    olsr.Set("IncrementalComputation", BooleanValue(incremental));
+    InternetStackHelper internet;
+    internet.SetRoutingHelper(olsr);
+    internet.SetIpv6StackInstall(false);
+    internet.Install(nodes);
+    Ipv4AddressHelper address("10.0.0.0", "255.255.0.0");
+    address.Assign(devices);
+
+    // Both computations simulate the same network
+    int64_t stream = 0;
+    stream += channelHelper.AssignStreams(channel, stream);
+    stream += wifi.AssignStreams(devices, stream);
+    stream += allocator->AssignStreams(stream);
+    stream += mobility.AssignStreams(nodes, stream);
+    stream += internet.AssignStreams(nodes, stream);
+    olsr.AssignStreams(nodes, stream);
+
+    g_computations = 0;
+    Config::ConnectWithoutContext("/NodeList/*/$ns3::olsr::RoutingProtocol/RoutingTableChanged",
+                                  MakeCallback(&RoutingTableChanged));
+
+    SystemWallClockMs clock;
+    clock.Start();
+    Simulator::Stop(duration);
+    Simulator::Run();
+    int64_t elapsed = clock.End();
+
+    // Both computations must find the same routes
+    uint64_t nRoutes = 0;
+    for (uint32_t i = 0; i < nNodes; i++)
+    {
+        Ptr<olsr::RoutingProtocol> olsr = nodes.Get(i)->GetObject<olsr::RoutingProtocol>();
+        nRoutes += olsr->GetRoutingTableEntries().size();
+    }
+    std::cout << (incremental ? "Incremental:\t" : "Full:\t\t") << elapsed / duration.GetSeconds()
+              << " ms per simulated second, " << g_computations / duration.GetSeconds()
+              << " routing table computations per second, " << nRoutes << " routes" << std::endl;
+
+    Simulator::Destroy();
+    Mac48Address::ResetAllocationIndex();
+}
+
+/**
+ * Report the time taken by the state lookups made on each received message.
+ * \param nNeighbors number of neighbors, each with ten 2-hop neighbors and ten
+ *        advertised topology tuples
+ */
+static void
+BenchState(uint32_t nNeighbors)
+{
+    olsr::OlsrState state;
+    auto address = [](uint32_t i) { return Ipv4Address(0x0a000000 + i); };
+    const uint32_t fanout = 10;
+    for (uint32_t i = 1; i <= nNeighbors; i++)
+    {
+        olsr::LinkTuple link;
+        link.neighborIfaceAddr = address(i);
+        link.symTime = Seconds(100);
+        state.InsertLinkTuple(link);
+        olsr::NeighborTuple neighbor;
+        neighbor.neighborMainAddr = address(i);
+        neighbor.status = olsr::NeighborTuple::STATUS_SYM;
+        neighbor.willingness = olsr::Willingness::DEFAULT;
+        state.InsertNeighborTuple(neighbor);
+        for (uint32_t j = 1; j <= fanout; j++)
+        {
+            olsr::TwoHopNeighborTuple twoHop;
+            twoHop.neighborMainAddr = address(i);
+            twoHop.twoHopNeighborAddr = address(i * fanout + j);
+            state.InsertTwoHopNeighborTuple(twoHop);
+            olsr::TopologyTuple topology;
+            topology.destAddr = address(i * fanout + j);
+            topology.lastAddr = address(i);
+            topology.sequenceNumber = 1;
+            state.InsertTopologyTuple(topology);
+        }
+    }
+
+    // Each message checks the duplicate set, the link and the neighbor of its
+    // sender, and the tuples it advertises
+    const uint32_t nMessages = 100000;
+    uint64_t found = 0;
+    SystemWallClockMs clock;
+    clock.Start();
+    for (uint32_t m = 0; m < nMessages; m++)
+    {
+        uint32_t i = 1 + m % nNeighbors;
+        auto seq = static_cast<uint16_t>(m);
+        if (state.FindDuplicateTuple(address(i), seq) == nullptr)
+        {
+            olsr::DuplicateTuple duplicate;
+            duplicate.address = address(i);
+            duplicate.sequenceNumber = seq;
+            duplicate.expirationTime = MilliSeconds(m);
+            state.InsertDuplicateTuple(duplicate);
+        }
+        state.EraseExpiredDuplicateTuples(MilliSeconds(m) - Seconds(30));
+        found += state.FindSymLinkTuple(address(i), Seconds(1)) != nullptr;
+        found += state.FindSymNeighborTuple(address(i)) != nullptr;
+        found += state.FindNewerTopologyTuple(address(i), 1) == nullptr;
+        for (uint32_t j = 1; j <= fanout; j++)
+        {
+            found += state.FindTwoHopNeighborTuple(address(i), address(i * fanout + j)) != nullptr;
+            found += state.FindTopologyTuple(address(i * fanout + j), address(i)) != nullptr;
+        }
+    }
+    int64_t elapsed = clock.End();
+    if (found != uint64_t{nMessages} * (3 + 2 * fanout))
+    {
+        std::cerr << "Error-- a tuple was not found" << std::endl;
+        exit(1);
+    }
+    std::cout << nNeighbors << " neighbors, " << nNeighbors * fanout << " topology tuples:\t"
+              << elapsed * 1e6 / nMessages << " ns per message" << std::endl;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t nNodes = 0;
+    double duration = 20;
+    uint32_t seed = 1;
+    bool benchState = false;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark OLSR on mobile ad hoc networks");
+    cmd.AddValue("nodes", "number of nodes, 0 for 50, 100, 200 and 300", nNodes);
+    cmd.AddValue("duration", "simulated time in seconds", duration);
+    cmd.AddValue("seed", "seed of the mobility", seed);
+    cmd.AddValue("state", "benchmark the lookups in the state of a node", benchState);
+    cmd.Parse(argc, argv);
+
+    if (duration <= 0)
+    {
+        std::cerr << "Error-- the duration must be positive" << std::endl;
+        exit(1);
+    }
+    RngSeedManager::SetSeed(seed);
+
+    if (benchState)
+    {
+        // The messages are processed while the simulation runs
+        for (uint32_t size : {10, 100, 1000, 10000})
+        {
+            Simulator::ScheduleNow(&BenchState, size);
+        }
+        Simulator::Run();
+        Simulator::Destroy();
+        return 0;
+    }
+
+    std::vector<uint32_t> sizes = {50, 100, 200, 300};
+    if (nNodes)
+    {
+        sizes = {nNodes};
+    }
+    for (uint32_t size : sizes)
+    {
+        std::cout << "*** " << size << " nodes" << std::endl;
+        Bench(size, Seconds(duration), true);
+        Bench(size, Seconds(duration), false);
+    }
+    return 0;
+}
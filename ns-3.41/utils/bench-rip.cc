@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2024 Liverpool Hope University, UK
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program benchmarks RIP on large routing tables.  The routers form a
+// random connected graph of point-to-point links, and each router has a stub
+// interface with many networks, so that every router learns thousands of
+// routes.  Every few seconds a random link goes down or comes back up, which
+// triggers updates across the network.  It reports the CPU time per simulated
+// second, the number of routes per router and the time taken by a route
+// lookup.
+// Sample usage:  ./ns3 run 'bench-rip --routers=20 --stubs=200 --duration=300'
+
+#include "ns3/command-line.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4.h"
+#include "ns3/node-container.h"
+#include "ns3/rip-helper.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <iostream>
+#include <random>
+#include <stdlib.h> // for exit ()
+#include <vector>
+
+using namespace ns3;
+
+/// Parameters of the benchmark
+struct BenchConfig
+{
+    uint32_t routers; //!< number of routers
+    double degree;    //!< average router degree
+    uint32_t stubs;   //!< number of stub networks per router
+    double duration;  //!< simulated time, in seconds
+    double flaps;     //!< time between two link state changes, in seconds
+    uint32_t seed;    //!< seed of the topology and workload generator
+};
+
+/**
+ * Bring a link down if it is up, else up.
+ * \param link the link
+ */
+static void
+FlapLink(const Ipv4InterfaceContainer& link)
+{
+    auto [ipv4, interface] = link.Get(0);
+    if (ipv4->IsUp(interface))
+    {
+        ipv4->SetDown(interface);
+    }
+    else
+    {
+        ipv4->SetUp(interface);
+    }
+}
+
+/**
+ * Look up the route to every stub network from a router and report the
+ * time taken.
+ * \param routing the routing protocol of the router
+ * \param stubs the stub networks
+ */
+static void
+Lookup(Ptr<Ipv4RoutingProtocol> routing, const std::vector<Ipv4Address>* stubs)
+{
+    const uint32_t nRounds = 10;
+    uint64_t nRoutes = 0;
+    SystemWallClockMs clock;
+    clock.Start();
+    for (uint32_t round = 0; round < nRounds; round++)
+    {
+        for (const auto& stub : *stubs)
+        {
+            Ipv4Header header;
+            header.SetDestination(stub);
+            Socket::SocketErrno sockerr;
+            if (routing->RouteOutput(nullptr, header, nullptr, sockerr))
+            {
+                nRoutes++;
+            }
+        }
+    }
+    int64_t elapsed = clock.End();
+    std::cout << nRoutes / nRounds << " of " << stubs->size() << " stub networks reached, "
+              << elapsed * 1e6 / (nRounds * stubs->size()) << " ns per lookup" << std::endl;
+}
+
+int
+main(int argc, char* argv[])
+{
+    BenchConfig config = {20, 3, 200, 300, 5, 1};
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark RIP on large routing tables");
+    cmd.AddValue("routers", "number of routers", config.routers);
+    cmd.AddValue("degree", "average router degree", config.degree);
+    cmd.AddValue("stubs", "number of stub networks per router", config.stubs);
+    cmd.AddValue("duration", "simulated time in seconds", config.duration);
+    cmd.AddValue("flaps", "time between two link state changes in seconds", config.flaps);
+    cmd.AddValue("seed", "seed of the topology and workload generator", config.seed);
+    cmd.Parse(argc, argv);
+
+    if (config.routers < 2 || config.stubs == 0 || config.routers * config.stubs > (1 << 20) ||
+        config.duration <= 0 || config.flaps <= 0)
+    {
+        std::cerr << "Error-- there must be two routers, a stub per router, up to 2^20 stubs, a "
+                     "positive duration and time between flaps"
+                  << std::endl;
+        exit(1);
+    }
+    std::mt19937 rng(config.seed);
+
+    NodeContainer routers;
+    routers.Create(config.routers);
+    RipHelper rip;
+    InternetStackHelper internet;
+    internet.SetRoutingHelper(rip);
+    internet.SetIpv6StackInstall(false);
+    internet.Install(routers);
+
+    // A random spanning tree keeps the topology connected, the other links
+    // join random pairs of distinct routers
+    SimpleNetDeviceHelper simple;
+    simple.SetNetDevicePointToPointMode(true);
+    Ipv4AddressHelper address("10.0.0.0", "255.255.255.252");
+    std::vector<Ipv4InterfaceContainer> links;
+    auto connect = [&](uint32_t a, uint32_t b) {
+        links.push_back(
+            address.Assign(simple.Install(NodeContainer(routers.Get(a), routers.Get(b)))));
+        address.NewNetwork();
+    };
+    for (uint32_t i = 1; i < config.routers; i++)
+    {
+        connect(i, std::uniform_int_distribution<uint32_t>(0, i - 1)(rng));
+    }
+    std::uniform_int_distribution<uint32_t> drawRouter(0, config.routers - 1);
+    auto nLinks = static_cast<std::size_t>(config.degree * config.routers / 2);
+    while (links.size() < nLinks)
+    {
+        uint32_t a = drawRouter(rng);
+        uint32_t b = drawRouter(rng);
+        if (a != b)
+        {
+            connect(a, b);
+        }
+    }
+
+    // The stub networks are /24 networks from 16.0.0.0 on, each router has
+    // its own on its stub interface
+    std::vector<Ipv4Address> stubs;
+    for (uint32_t i = 0; i < config.routers; i++)
+    {
+        Ptr<NetDevice> stubDev = simple.Install(routers.Get(i)).Get(0);
+        Ptr<Ipv4> ipv4 = routers.Get(i)->GetObject<Ipv4>();
+        int32_t interface = ipv4->AddInterface(stubDev);
+        for (uint32_t j = 0; j < config.stubs; j++)
+        {
+            Ipv4Address network((16 << 24) + ((i * config.stubs + j) << 8));
+            ipv4->AddAddress(interface,
+                             Ipv4InterfaceAddress(Ipv4Address(network.Get() + 1),
+                                                  Ipv4Mask("255.255.255.0")));
+            stubs.push_back(network);
+        }
+        ipv4->SetUp(interface);
+    }
+    rip.AssignStreams(routers, 0);
+
+    // Links flap once the routes converged, and are all up at the end
+    std::uniform_int_distribution<std::size_t> drawLink(0, links.size() - 1);
+    std::vector<uint32_t> flapCounts(links.size());
+    for (double t = 60; t < config.duration - 60; t += config.flaps)
+    {
+        std::size_t link = drawLink(rng);
+        Simulator::Schedule(Seconds(t), &FlapLink, links[link]);
+        flapCounts[link]++;
+    }
+    for (std::size_t link = 0; link < links.size(); link++)
+    {
+        if (flapCounts[link] % 2)
+        {
+            Simulator::Schedule(Seconds(config.duration - 60), &FlapLink, links[link]);
+        }
+    }
+    Ptr<Ipv4RoutingProtocol> routing = routers.Get(0)->GetObject<Ipv4>()->GetRoutingProtocol();
+    Simulator::Schedule(Seconds(config.duration), &Lookup, routing, &stubs);
+
+    std::cout << config.routers << " routers, " << links.size() << " links, "
+              << config.routers * config.stubs + links.size() << " networks" << std::endl;
+    SystemWallClockMs clock;
+    clock.Start();
+    Simulator::Stop(Seconds(config.duration));
+    Simulator::Run();
+    int64_t elapsed = clock.End();
+    std::cout << elapsed / config.duration << " ms per simulated second" << std::endl;
+
+    routing = nullptr;
+    Simulator::Destroy();
+    return 0;
+}